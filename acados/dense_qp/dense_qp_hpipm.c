@@ -126,7 +126,30 @@ void dense_qp_hpipm_opts_set(void *config_, void *opts_, const char *field, void
 {
     dense_qp_hpipm_opts *opts = opts_;
 
-    d_dense_qp_ipm_arg_set((char *) field, value, opts->hpipm_opts);
+    if (!strcmp(field, "mode"))
+    {
+        // switch the algorithmic settings to the ones of the mode (enum hpipm_mode),
+        // keep tolerances and limits set so far
+        struct d_dense_qp_ipm_arg *arg = opts->hpipm_opts;
+        struct d_dense_qp_ipm_arg tmp = *arg;
+        int *mode = value;
+
+        d_dense_qp_ipm_arg_set_default((enum hpipm_mode) *mode, arg);
+
+        arg->mu0 = tmp.mu0;
+        arg->alpha_min = tmp.alpha_min;
+        arg->res_g_max = tmp.res_g_max;
+        arg->res_b_max = tmp.res_b_max;
+        arg->res_d_max = tmp.res_d_max;
+        arg->res_m_max = tmp.res_m_max;
+        arg->iter_max = tmp.iter_max;
+        arg->stat_max = tmp.stat_max;
+        arg->warm_start = tmp.warm_start;
+    }
+    else
+    {
+        d_dense_qp_ipm_arg_set((char *) field, value, opts->hpipm_opts);
+    }
 
     return;
 }
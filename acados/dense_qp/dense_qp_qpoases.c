@@ -122,6 +122,9 @@ void dense_qp_qpoases_opts_initialize_default(void *config_, dense_qp_dims *dims
     opts->set_acado_opts = 1;
     opts->compute_t = 1;
     opts->tolerance = 1e-4;
+    opts->guess_active_set = 0;
+    opts->guess_lam_min = 1e-4;
+    opts->guess_t_max = 1e-4;
 
     return;
 }
@@ -190,6 +193,21 @@ void dense_qp_qpoases_opts_set(void *config_, void *opts_, const char *field, vo
         int *max_iter = value;
         opts->max_nwsr = *max_iter;
     }
+    else if (!strcmp(field, "guess_active_set"))
+    {
+        int *guess_active_set = value;
+        opts->guess_active_set = *guess_active_set;
+    }
+    else if (!strcmp(field, "guess_lam_min"))
+    {
+        double *lam_min = value;
+        opts->guess_lam_min = *lam_min;
+    }
+    else if (!strcmp(field, "guess_t_max"))
+    {
+        double *t_max = value;
+        opts->guess_t_max = *t_max;
+    }
     else
     {
         printf("\nerror: dense_qp_qpoases_opts_set: wrong field: %s\n", field);
@@ -398,6 +416,35 @@ int dense_qp_qpoases_workspace_calculate_size(void *config_, dense_qp_dims *dims
  * functions
  ************************************************/
 
+// qpOASES guesses the working set from the sign of the dual solution: positive for active lower,
+// negative for active upper bounds, zero for inactive ones
+static void dense_qp_qpoases_guess_dual_sol(dense_qp_out *qp_out, dense_qp_qpoases_opts *opts,
+                                            int *idxb, double *dual_sol)
+{
+    int nv = qp_out->dim->nv;
+    int nb = qp_out->dim->nb;
+    int ng = qp_out->dim->ng;
+
+    double *lam = qp_out->lam->pa;
+    double *t = qp_out->t->pa;
+
+    for (int ii = 0; ii < nv + ng; ii++) dual_sol[ii] = 0.0;
+
+    for (int ii = 0; ii < nb + ng; ii++)
+    {
+        int jj = ii < nb ? idxb[ii] : nv + ii - nb;
+        int lo = ii;
+        int up = nb + ng + ii;
+
+        if (lam[lo] > opts->guess_lam_min && t[lo] < opts->guess_t_max)
+            dual_sol[jj] = lam[lo];
+        if (lam[up] > opts->guess_lam_min && t[up] < opts->guess_t_max && lam[up] > dual_sol[jj])
+            dual_sol[jj] = -lam[up];
+    }
+}
+
+
+
 int dense_qp_qpoases(void *config_, dense_qp_in *qp_in, dense_qp_out *qp_out, void *opts_,
                      void *memory_, void *work_)
 {
@@ -501,6 +548,11 @@ int dense_qp_qpoases(void *config_, dense_qp_in *qp_in, dense_qp_out *qp_out, vo
     // extract R
     // blasfeo_unpack_dmat(nvd, nvd, sR, 0, 0, R, nvd);
 
+    // working set guessed from the solution in qp_out (without slacks, not for hotstart)
+    int guess_active_set = opts->guess_active_set && opts->hotstart == 0 && ns == 0;
+    if (guess_active_set)
+        dense_qp_qpoases_guess_dual_sol(qp_out, opts, idxb, dual_sol);
+
     info->interface_time = acados_toc(&interface_timer);
     acados_tic(&qp_timer);
 
@@ -610,7 +662,7 @@ int dense_qp_qpoases(void *config_, dense_qp_in *qp_in, dense_qp_out *qp_out, vo
                     options.terminationTolerance = opts->tolerance;
                     QProblem_setOptions(QP, options);
                 }
-                if (opts->warm_start)
+                if (opts->warm_start || guess_active_set)
                 {
                     qpoases_status = (ns > 0) ?
                         QProblem_initW(QP, HH, gg, CC, d_lb, d_ub, d_lg, d_ug, &nwsr, &cputime,
@@ -656,7 +708,7 @@ int dense_qp_qpoases(void *config_, dense_qp_in *qp_in, dense_qp_out *qp_out, vo
                     options.terminationTolerance = opts->tolerance;
                     QProblemB_setOptions(QPB, options);
                 }
-                if (opts->warm_start)
+                if (opts->warm_start || guess_active_set)
                 {
                     qpoases_status = QProblemB_initW(QPB, H, g, d_lb, d_ub, &nwsr, &cputime,
                                                      /* primal sol */ NULL, /* dual sol */ dual_sol,
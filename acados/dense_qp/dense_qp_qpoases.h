@@ -57,6 +57,9 @@ typedef struct dense_qp_qpoases_opts_
     int set_acado_opts;  // use same options as in acado code generation
     int compute_t;       // compute t in qp_out (to have correct residuals in NLP)
     double tolerance;  // terminationTolerance
+    int guess_active_set;  // warm start from the active set of the lam and t in qp_out
+    double guess_lam_min;  // a constraint is guessed active if lam > guess_lam_min ...
+    double guess_t_max;    // ... and t < guess_t_max
 } dense_qp_qpoases_opts;
 
 typedef struct dense_qp_qpoases_memory_
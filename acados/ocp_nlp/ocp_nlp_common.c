@@ -46,6 +46,8 @@
 #include "hpipm/include/hpipm_d_ocp_qp_dim.h"
 // acados
 #include "acados/utils/mem.h"
+#include "acados/utils/threads.h"
+#include "acados/utils/timing.h"
 // openmp
 #if defined(ACADOS_WITH_OPENMP)
 #include <omp.h>
@@ -972,6 +974,8 @@ int ocp_nlp_opts_calculate_size(void *config_, void *dims_)
         size += constraints[ii]->opts_calculate_size(constraints[ii], dims->constraints[ii]);
     }
 
+    size += (N + 1) * sizeof(int);  // parallel_cores
+
     size += 2*8;  // 2 aligns
 
     return size;
@@ -1038,6 +1042,9 @@ void *ocp_nlp_opts_assign(void *config_, void *dims_, void *raw_memory)
         c_ptr += constraints[ii]->opts_calculate_size(constraints[ii], dims->constraints[ii]);
     }
 
+    // parallel_cores
+    assign_and_advance_int(N + 1, &opts->parallel_cores, &c_ptr);
+
     assert((char *) raw_memory + ocp_nlp_opts_calculate_size(config, dims) >= c_ptr);
 
     return opts;
@@ -1072,6 +1079,9 @@ void ocp_nlp_opts_initialize_default(void *config_, void *dims_, void *opts_)
     #endif
 #endif
     // printf("\nocp_nlp: openmp threads = %d\n", opts->num_threads);
+    opts->parallel_schedule = PARALLEL_STATIC;
+    opts->parallel_bind = PARALLEL_BIND_NONE;
+    opts->num_parallel_cores = 0;
 
     opts->globalization = FIXED_STEP;
     opts->step_length = 1.0;
@@ -1188,6 +1198,85 @@ void ocp_nlp_opts_set(void *config_, void *opts_, const char *field, void* value
             int* num_threads = (int *) value;
             opts->num_threads = *num_threads;
         }
+        else if (!strcmp(field, "parallel_schedule"))
+        {
+            char* parallel_schedule = (char *) value;
+            if (!strcmp(parallel_schedule, "static"))
+            {
+                opts->parallel_schedule = PARALLEL_STATIC;
+            }
+            else if (!strcmp(parallel_schedule, "dynamic"))
+            {
+                opts->parallel_schedule = PARALLEL_DYNAMIC;
+            }
+            else if (!strcmp(parallel_schedule, "weighted"))
+            {
+                opts->parallel_schedule = PARALLEL_WEIGHTED;
+            }
+            else
+            {
+                printf("\nerror: ocp_nlp_opts_set: not supported value for parallel_schedule, got: %s\n",
+                       parallel_schedule);
+                exit(1);
+            }
+        }
+        else if (!strcmp(field, "parallel_bind"))
+        {
+            char* parallel_bind = (char *) value;
+            if (!strcmp(parallel_bind, "none"))
+            {
+                opts->parallel_bind = PARALLEL_BIND_NONE;
+            }
+            else if (!strcmp(parallel_bind, "close"))
+            {
+                opts->parallel_bind = PARALLEL_BIND_CLOSE;
+            }
+            else if (!strcmp(parallel_bind, "spread"))
+            {
+                opts->parallel_bind = PARALLEL_BIND_SPREAD;
+            }
+            else
+            {
+                printf("\nerror: ocp_nlp_opts_set: not supported value for parallel_bind, got: %s\n",
+                       parallel_bind);
+                exit(1);
+            }
+        }
+        else if (!strcmp(field, "parallel_cores"))
+        {
+            // one core per thread, set num_threads before; NULL removes the pinning
+            int* parallel_cores = (int *) value;
+            int N = config->N;
+#if defined(ACADOS_WITH_OPENMP)
+            int num_threads = opts->num_threads;
+#else
+            int num_threads = 1;  // only the calling thread
+#endif
+            if (parallel_cores == NULL)
+            {
+                opts->num_parallel_cores = 0;
+            }
+            else
+            {
+                if (num_threads > N + 1)
+                {
+                    printf("\nerror: ocp_nlp_opts_set: parallel_cores supports at most N+1 = %d threads, got num_threads = %d\n",
+                           N + 1, num_threads);
+                    exit(1);
+                }
+                for (ii = 0; ii < num_threads; ii++)
+                {
+                    if (parallel_cores[ii] < 0)
+                    {
+                        printf("\nerror: ocp_nlp_opts_set: invalid value for parallel_cores, need int >=0, got %d.\n",
+                               parallel_cores[ii]);
+                        exit(1);
+                    }
+                    opts->parallel_cores[ii] = parallel_cores[ii];
+                }
+                opts->num_parallel_cores = num_threads;
+            }
+        }
         else if (!strcmp(field, "step_length"))
         {
             double* step_length = (double *) value;
@@ -1204,6 +1293,10 @@ void ocp_nlp_opts_set(void *config_, void *opts_, const char *field, void* value
             {
                 opts->globalization = MERIT_BACKTRACKING;
             }
+            else if (!strcmp(globalization, "filter_line_search"))
+            {
+                opts->globalization = FILTER_LINE_SEARCH;
+            }
             else
             {
                 printf("\nerror: ocp_nlp_opts_set: not supported value for globalization, got: %s\n",
@@ -1376,6 +1469,12 @@ int ocp_nlp_memory_calculate_size(ocp_nlp_config *config, ocp_nlp_dims *dims, oc
 
     size += (N+1)*sizeof(bool); // set_sim_guess
 
+    size += (N+1)*sizeof(bool); // fun_key_valid
+    size += (N+1)*sizeof(struct blasfeo_dvec); // fun_key
+    size += 2*OCP_NLP_FILTER_SIZE*sizeof(double); // filter_theta filter_phi
+    size += (N+1)*sizeof(double); // stage_time
+    size += (N+2)*sizeof(int); // stage_chunk
+
     size += (N+1)*sizeof(struct blasfeo_dmat); // dzduxt
     size += 6*(N+1)*sizeof(struct blasfeo_dvec);  // cost_grad ineq_fun ineq_adj dyn_adj sim_guess z_alg
     size += 1*N*sizeof(struct blasfeo_dvec);        // dyn_fun
@@ -1389,7 +1488,9 @@ int ocp_nlp_memory_calculate_size(ocp_nlp_config *config, ocp_nlp_dims *dims, oc
         size += 1*blasfeo_memsize_dvec(nx[ii + 1]);       // dyn_fun
         size += 1*blasfeo_memsize_dvec(2 * ni[ii]);       // ineq_fun
         size += 1*blasfeo_memsize_dvec(nx[ii] + nz[ii]); // sim_guess
+        size += 1*blasfeo_memsize_dvec(nv[ii]); // fun_key
     }
+    size += 1*blasfeo_memsize_dvec(nv[N]); // fun_key
     size += 1*blasfeo_memsize_dmat(nu[N]+nx[N], nz[N]); // dzduxt
     size += 1*blasfeo_memsize_dvec(nz[N]); // z_alg
     size += 2*blasfeo_memsize_dvec(nv[N]);          // cost_grad ineq_adj
@@ -1400,6 +1501,7 @@ int ocp_nlp_memory_calculate_size(ocp_nlp_config *config, ocp_nlp_dims *dims, oc
     size += 8;   // initial align
     size += 8;   // middle align
     size += 8;   // blasfeo_struct align
+    size += 8;   // filter align
     size += 64;  // blasfeo_mem align
 
     make_int_multiple_of(8, &size);
@@ -1515,6 +1617,8 @@ ocp_nlp_memory *ocp_nlp_memory_assign(ocp_nlp_config *config, ocp_nlp_dims *dims
     assign_and_advance_blasfeo_dvec_structs(N + 1, &mem->dyn_adj, &c_ptr);
     // sim_guess
     assign_and_advance_blasfeo_dvec_structs(N + 1, &mem->sim_guess, &c_ptr);
+    // fun_key
+    assign_and_advance_blasfeo_dvec_structs(N + 1, &mem->fun_key, &c_ptr);
 
     // set_sim_guess
     assign_and_advance_bool(N+1, &mem->set_sim_guess, &c_ptr);
@@ -1523,6 +1627,32 @@ ocp_nlp_memory *ocp_nlp_memory_assign(ocp_nlp_config *config, ocp_nlp_dims *dims
         mem->set_sim_guess[ii] = false;
     }
 
+    // fun_key_valid
+    assign_and_advance_bool(N+1, &mem->fun_key_valid, &c_ptr);
+    for (int ii = 0; ii <= N; ++ii)
+    {
+        mem->fun_key_valid[ii] = false;
+    }
+
+    mem->alpha = 1.0;
+    mem->freeze_dyn_jac = false;
+
+    // filter
+    align_char_to(8, &c_ptr);
+    assign_and_advance_double(OCP_NLP_FILTER_SIZE, &mem->filter_theta, &c_ptr);
+    assign_and_advance_double(OCP_NLP_FILTER_SIZE, &mem->filter_phi, &c_ptr);
+    mem->filter_size = 0;
+    mem->filter_theta_max = ACADOS_POS_INFTY;
+    mem->filter_failed = false;
+
+    // weighted schedule
+    assign_and_advance_double(N+1, &mem->stage_time, &c_ptr);
+    assign_and_advance_int(N+2, &mem->stage_chunk, &c_ptr);
+    for (int ii = 0; ii <= N; ii++)
+    {
+        mem->stage_time[ii] = 0.0;
+    }
+
     // blasfeo_mem align
     align_char_to(64, &c_ptr);
 
@@ -1571,6 +1701,11 @@ ocp_nlp_memory *ocp_nlp_memory_assign(ocp_nlp_config *config, ocp_nlp_dims *dims
         blasfeo_dvecse(nx[ii] + nz[ii], 0.0, mem->sim_guess+ii, 0);
         // printf("sim_guess ii %d: %p\n", ii, mem->sim_guess+ii);
     }
+    // fun_key
+    for (int ii = 0; ii <= N; ii++)
+    {
+        assign_and_advance_blasfeo_dvec_mem(nv[ii], mem->fun_key + ii, &c_ptr);
+    }
     // printf("created memory %p\n", mem);
 
     return mem;
@@ -1592,7 +1727,8 @@ int ocp_nlp_workspace_calculate_size(ocp_nlp_config *config, ocp_nlp_dims *dims,
     int ii;
 
     int N = dims->N;
-    // int *nx = dims->nx;
+    int *nx = dims->nx;
+    int *ni = dims->ni;
     // int *nu = dims->nu;
     // int *nz = dims->nz;
 
@@ -1607,6 +1743,17 @@ int ocp_nlp_workspace_calculate_size(ocp_nlp_config *config, ocp_nlp_dims *dims,
     // weight_merit_fun
     size += ocp_nlp_out_calculate_size(config, dims);
 
+    // tmp_qp_out
+    size += ocp_qp_out_calculate_size(dims->qp_solver->orig_dims);
+
+    // tmp_qp_b, tmp_qp_d
+    size += N*sizeof(struct blasfeo_dvec) + (N+1)*sizeof(struct blasfeo_dvec);
+    for (ii = 0; ii < N; ii++)
+        size += blasfeo_memsize_dvec(nx[ii+1]);
+    for (ii = 0; ii <= N; ii++)
+        size += blasfeo_memsize_dvec(2*ni[ii]);
+    size += 64;  // blasfeo_mem align
+
     // array of pointers
     // cost
     size += (N+1)*sizeof(void *);
@@ -1719,7 +1866,8 @@ ocp_nlp_workspace *ocp_nlp_workspace_assign(ocp_nlp_config *config, ocp_nlp_dims
     ocp_nlp_constraints_config **constraints = config->constraints;
 
     int N = dims->N;
-    // int *nx = dims->nx;
+    int *nx = dims->nx;
+    int *ni = dims->ni;
     // int *nu = dims->nu;
     // int *nz = dims->nz;
 
@@ -1750,6 +1898,21 @@ ocp_nlp_workspace *ocp_nlp_workspace_assign(ocp_nlp_config *config, ocp_nlp_dims
     work->weight_merit_fun = ocp_nlp_out_assign(config, dims, c_ptr);
     c_ptr += ocp_nlp_out_calculate_size(config, dims);
 
+    // tmp_qp_out
+    work->tmp_qp_out = ocp_qp_out_assign(dims->qp_solver->orig_dims, c_ptr);
+    c_ptr += ocp_qp_out_calculate_size(dims->qp_solver->orig_dims);
+
+    // tmp_qp_b, tmp_qp_d
+    assign_and_advance_blasfeo_dvec_structs(N, &work->tmp_qp_b, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N + 1, &work->tmp_qp_d, &c_ptr);
+
+    align_char_to(64, &c_ptr);
+
+    for (int ii = 0; ii < N; ii++)
+        assign_and_advance_blasfeo_dvec_mem(nx[ii + 1], work->tmp_qp_b + ii, &c_ptr);
+    for (int ii = 0; ii <= N; ii++)
+        assign_and_advance_blasfeo_dvec_mem(2 * ni[ii], work->tmp_qp_d + ii, &c_ptr);
+
     if (opts->reuse_workspace)
     {
 
@@ -1861,6 +2024,56 @@ ocp_nlp_workspace *ocp_nlp_workspace_assign(ocp_nlp_config *config, ocp_nlp_dims
  * functions
  ************************************************/
 
+/************************************************
+ * function evaluation cache
+ ************************************************/
+
+// the modules keep the function values of their last evaluation in memory;
+// fun_key records at which primal point they were computed, so that evaluations at the
+// same point (e.g. the current iterate in the line search) are not repeated
+
+void ocp_nlp_fun_key_invalidate(ocp_nlp_dims *dims, ocp_nlp_memory *mem)
+{
+    for (int ii = 0; ii <= dims->N; ii++)
+        mem->fun_key_valid[ii] = false;
+
+    return;
+}
+
+
+
+static void ocp_nlp_fun_key_set(ocp_nlp_dims *dims, ocp_nlp_memory *mem, ocp_nlp_out *at)
+{
+    int *nv = dims->nv;
+
+    for (int ii = 0; ii <= dims->N; ii++)
+    {
+        blasfeo_dveccp(nv[ii], at->ux+ii, 0, mem->fun_key+ii, 0);
+        mem->fun_key_valid[ii] = true;
+    }
+
+    return;
+}
+
+
+
+static bool ocp_nlp_fun_key_match(ocp_nlp_dims *dims, ocp_nlp_memory *mem,
+                                  struct blasfeo_dvec *ux, int stage)
+{
+    if (!mem->fun_key_valid[stage])
+        return false;
+
+    for (int jj = 0; jj < dims->nv[stage]; jj++)
+    {
+        if (BLASFEO_DVECEL(ux, jj) != BLASFEO_DVECEL(mem->fun_key+stage, jj))
+            return false;
+    }
+
+    return true;
+}
+
+
+
 void ocp_nlp_initialize_qp(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in,
          ocp_nlp_out *out, ocp_nlp_opts *opts, ocp_nlp_memory *mem, ocp_nlp_workspace *work)
 {
@@ -1869,8 +2082,11 @@ void ocp_nlp_initialize_qp(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_i
 
     int N = dims->N;
 
+    // new parameters and bounds may have been set since the last call
+    ocp_nlp_fun_key_invalidate(dims, mem);
+
 #if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(opts->num_threads)
 #endif
     for (ii = 0; ii <= N; ii++)
     {
@@ -1902,7 +2118,7 @@ void ocp_nlp_initialize_t_slacks(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp
     int *nu = dims->nu;
 
 #if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(opts->num_threads)
 #endif
     for (ii = 0; ii <= N; ii++)
     {
@@ -1918,132 +2134,299 @@ void ocp_nlp_initialize_t_slacks(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp
         blasfeo_dveccpsc(2 * ni[ii], -1.0, ineq_fun, 0, out->t + ii, 0);
     }
 
+    // only the constraints have been evaluated
+    ocp_nlp_fun_key_invalidate(dims, mem);
+
     return;
 }
 
 
 
-void ocp_nlp_approximate_qp_matrices(ocp_nlp_config *config, ocp_nlp_dims *dims,
+static void ocp_nlp_approximate_qp_matrices_stage(ocp_nlp_config *config, ocp_nlp_dims *dims,
     ocp_nlp_in *in, ocp_nlp_out *out, ocp_nlp_opts *opts, ocp_nlp_memory *mem,
-    ocp_nlp_workspace *work)
+    ocp_nlp_workspace *work, int i)
 {
+    int N = dims->N;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
 
-    int i;
+    // init Hessian to 0
+    blasfeo_dgese(nu[i] + nx[i], nu[i] + nx[i], 0.0, mem->qp_in->RSQrq+i, 0, 0);
 
+    if (i < N)
+    {
+        // Levenberg Marquardt term: Ts[i] * levenberg_marquardt * eye()
+        if (opts->levenberg_marquardt > 0.0)
+            blasfeo_ddiare(nu[i] + nx[i], in->Ts[i] * opts->levenberg_marquardt,
+                           mem->qp_in->RSQrq+i, 0, 0);
+
+        // dynamics
+        if (mem->freeze_dyn_jac)
+            config->dynamics[i]->compute_fun_and_adj(config->dynamics[i], dims->dynamics[i],
+                    in->dynamics[i], opts->dynamics[i], mem->dynamics[i], work->dynamics[i]);
+        else
+            config->dynamics[i]->update_qp_matrices(config->dynamics[i], dims->dynamics[i],
+                    in->dynamics[i], opts->dynamics[i], mem->dynamics[i], work->dynamics[i]);
+    }
+    else
+    {
+        // Levenberg Marquardt term: 1.0 * levenberg_marquardt * eye()
+        if (opts->levenberg_marquardt > 0.0)
+            blasfeo_ddiare(nu[i] + nx[i], opts->levenberg_marquardt,
+                           mem->qp_in->RSQrq+i, 0, 0);
+    }
+
+    // cost
+    config->cost[i]->update_qp_matrices(config->cost[i], dims->cost[i], in->cost[i],
+            opts->cost[i], mem->cost[i], work->cost[i]);
+
+    // constraints
+    config->constraints[i]->update_qp_matrices(config->constraints[i], dims->constraints[i],
+            in->constraints[i], opts->constraints[i], mem->constraints[i], work->constraints[i]);
+
+    // frozen dynamics sensitivities leave BAbt untouched
+    if (i < N && !mem->freeze_dyn_jac)
+        ocp_qp_in_mark_changed(mem->qp_in, i, OCP_QP_IN_DYN_MAT);
+    ocp_qp_in_mark_changed(mem->qp_in, i, OCP_QP_IN_COST_MAT | OCP_QP_IN_CON_MAT);
+
+    return;
+}
+
+
+
+static void ocp_nlp_collect_stage_evaluations(ocp_nlp_config *config, ocp_nlp_dims *dims,
+    ocp_nlp_memory *mem, int i)
+{
     int N = dims->N;
     int *nv = dims->nv;
     int *nx = dims->nx;
     int *nu = dims->nu;
     int *ni = dims->ni;
 
-    /* stage-wise multiple shooting lagrangian evaluation */
+    // nlp mem: cost_grad
+    struct blasfeo_dvec *cost_grad = config->cost[i]->memory_get_grad_ptr(mem->cost[i]);
+    blasfeo_dveccp(nv[i], cost_grad, 0, mem->cost_grad + i, 0);
 
-#if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
-#endif
-    for (i = 0; i <= N; i++)
+    // nlp mem: dyn_fun
+    if (i < N)
     {
-        // init Hessian to 0 
-        blasfeo_dgese(nu[i] + nx[i], nu[i] + nx[i], 0.0, mem->qp_in->RSQrq+i, 0, 0);
+        struct blasfeo_dvec *dyn_fun
+            = config->dynamics[i]->memory_get_fun_ptr(mem->dynamics[i]);
+        blasfeo_dveccp(nx[i + 1], dyn_fun, 0, mem->dyn_fun + i, 0);
+    }
 
+    // nlp mem: dyn_adj
+    if (i < N)
+    {
+        struct blasfeo_dvec *dyn_adj
+            = config->dynamics[i]->memory_get_adj_ptr(mem->dynamics[i]);
+        blasfeo_dveccp(nu[i] + nx[i], dyn_adj, 0, mem->dyn_adj + i, 0);
+    }
+    else
+    {
+        blasfeo_dvecse(nu[N] + nx[N], 0.0, mem->dyn_adj + N, 0);
+    }
+    if (i > 0)
+    {
+        struct blasfeo_dvec *dyn_adj
+            = config->dynamics[i-1]->memory_get_adj_ptr(mem->dynamics[i-1]);
+        blasfeo_daxpy(nx[i], 1.0, dyn_adj, nu[i-1]+nx[i-1], mem->dyn_adj+i, nu[i],
+            mem->dyn_adj+i, nu[i]);
+    }
 
-        if (i < N)
-        {
-            // Levenberg Marquardt term: Ts[i] * levenberg_marquardt * eye()
-            if (opts->levenberg_marquardt > 0.0)
-                blasfeo_ddiare(nu[i] + nx[i], in->Ts[i] * opts->levenberg_marquardt,
-                               mem->qp_in->RSQrq+i, 0, 0);
+    // nlp mem: ineq_fun
+    struct blasfeo_dvec *ineq_fun =
+        config->constraints[i]->memory_get_fun_ptr(mem->constraints[i]);
+    blasfeo_dveccp(2 * ni[i], ineq_fun, 0, mem->ineq_fun + i, 0);
 
-            // dynamics
-            config->dynamics[i]->update_qp_matrices(config->dynamics[i], dims->dynamics[i],
-                    in->dynamics[i], opts->dynamics[i], mem->dynamics[i], work->dynamics[i]);
-        }
-        else
-        {
-            // Levenberg Marquardt term: 1.0 * levenberg_marquardt * eye()
-            if (opts->levenberg_marquardt > 0.0)
-                blasfeo_ddiare(nu[i] + nx[i], opts->levenberg_marquardt,
-                               mem->qp_in->RSQrq+i, 0, 0);
-        }
+    // nlp mem: ineq_adj
+    struct blasfeo_dvec *ineq_adj =
+        config->constraints[i]->memory_get_adj_ptr(mem->constraints[i]);
+    blasfeo_dveccp(nv[i], ineq_adj, 0, mem->ineq_adj + i, 0);
 
-        // cost
-        config->cost[i]->update_qp_matrices(config->cost[i], dims->cost[i], in->cost[i],
-                opts->cost[i], mem->cost[i], work->cost[i]);
+    return;
+}
 
-        // constraints
-        config->constraints[i]->update_qp_matrices(config->constraints[i], dims->constraints[i],
-                in->constraints[i], opts->constraints[i], mem->constraints[i], work->constraints[i]);
+
+
+// splits the stages into num_chunks contiguous chunks of about equal evaluation time,
+// chunk k holds the stages chunk[k], ..., chunk[k+1]-1
+static void ocp_nlp_weighted_chunks(int N, int num_chunks, double *stage_time, int *chunk)
+{
+    int i, k;
+
+    double total = 0.0;
+    for (i = 0; i <= N; i++)
+        total += stage_time[i];
+
+    // no timings yet, equal number of stages
+    if (total <= 0.0)
+    {
+        for (i = 0; i <= N; i++)
+            stage_time[i] = 1.0;
+        total = N + 1;
     }
 
-    /* collect stage-wise evaluations */
+    double acc = 0.0;
+    i = 0;
+    chunk[0] = 0;
+    for (k = 1; k < num_chunks; k++)
+    {
+        double target = total * k / num_chunks;
+        // at least one stage for this and each of the remaining chunks
+        do
+        {
+            acc += stage_time[i];
+            i++;
+        } while (i < N + 1 - (num_chunks - k) && acc + 0.5 * stage_time[i] < target);
+        chunk[k] = i;
+    }
+    chunk[num_chunks] = N + 1;
+
+    return;
+}
+
+
+
+// body executed by each thread of the team, the worksharing loops are orphaned
+static void ocp_nlp_approximate_qp_matrices_team(ocp_nlp_config *config, ocp_nlp_dims *dims,
+    ocp_nlp_in *in, ocp_nlp_out *out, ocp_nlp_opts *opts, ocp_nlp_memory *mem,
+    ocp_nlp_workspace *work)
+{
+    int i;
+
+    int N = dims->N;
 
 #if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
+    int thread_id = omp_get_thread_num();
+    int num_threads = omp_get_num_threads();
+#else
+    int thread_id = 0;
+    int num_threads = 1;
 #endif
-    for (i=0; i <= N; i++)
-    {
-
-        // nlp mem: cost_grad
-        struct blasfeo_dvec *cost_grad = config->cost[i]->memory_get_grad_ptr(mem->cost[i]);
-        blasfeo_dveccp(nv[i], cost_grad, 0, mem->cost_grad + i, 0);
 
-        // nlp mem: dyn_fun
-        if (i < N)
+    // pinned on every call, the runtime may hand out other threads after a change of the team;
+    // thread 0 is the calling thread and stays pinned after the call
+    if (thread_id < opts->num_parallel_cores)
+    {
+        if (acados_thread_pin(opts->parallel_cores[thread_id]))
         {
-            struct blasfeo_dvec *dyn_fun
-                = config->dynamics[i]->memory_get_fun_ptr(mem->dynamics[i]);
-            blasfeo_dveccp(nx[i + 1], dyn_fun, 0, mem->dyn_fun + i, 0);
+            printf("\nerror: ocp_nlp_approximate_qp_matrices: failed to pin thread %d to core %d\n",
+                   thread_id, opts->parallel_cores[thread_id]);
+            exit(1);
         }
+    }
 
-        // nlp mem: dyn_adj
-        if (i < N)
-        {
-            struct blasfeo_dvec *dyn_adj
-                = config->dynamics[i]->memory_get_adj_ptr(mem->dynamics[i]);
-            blasfeo_dveccp(nu[i] + nx[i], dyn_adj, 0, mem->dyn_adj + i, 0);
-        }
-        else
+    /* stage-wise multiple shooting lagrangian evaluation */
+    if (opts->parallel_schedule == PARALLEL_WEIGHTED)
+    {
+        // chunks balanced with the stage times of the last call
+        int num_chunks = (num_threads < N + 1) ? num_threads : N + 1;
+
+#if defined(ACADOS_WITH_OPENMP)
+        #pragma omp single
+#endif
+        ocp_nlp_weighted_chunks(N, num_chunks, mem->stage_time, mem->stage_chunk);
+
+        if (thread_id < num_chunks)
         {
-            blasfeo_dvecse(nu[N] + nx[N], 0.0, mem->dyn_adj + N, 0);
+            acados_timer timer;
+            for (i = mem->stage_chunk[thread_id]; i < mem->stage_chunk[thread_id + 1]; i++)
+            {
+                acados_tic(&timer);
+                ocp_nlp_approximate_qp_matrices_stage(config, dims, in, out, opts, mem, work, i);
+                mem->stage_time[i] = acados_toc(&timer);
+            }
         }
-        if (i > 0)
+
+#if defined(ACADOS_WITH_OPENMP)
+        #pragma omp barrier
+#endif
+    }
+    else
+    {
+#if defined(ACADOS_WITH_OPENMP)
+        #pragma omp for schedule(runtime)
+#endif
+        for (i = 0; i <= N; i++)
         {
-            struct blasfeo_dvec *dyn_adj
-                = config->dynamics[i-1]->memory_get_adj_ptr(mem->dynamics[i-1]);
-            blasfeo_daxpy(nx[i], 1.0, dyn_adj, nu[i-1]+nx[i-1], mem->dyn_adj+i, nu[i],
-                mem->dyn_adj+i, nu[i]);
+            ocp_nlp_approximate_qp_matrices_stage(config, dims, in, out, opts, mem, work, i);
         }
+    }
+    // NOTE: the barrier is needed, stage i collects the adjoint of stage i-1
 
-        // nlp mem: ineq_fun
-        struct blasfeo_dvec *ineq_fun =
-            config->constraints[i]->memory_get_fun_ptr(mem->constraints[i]);
-        blasfeo_dveccp(2 * ni[i], ineq_fun, 0, mem->ineq_fun + i, 0);
+    /* collect stage-wise evaluations */
+#if defined(ACADOS_WITH_OPENMP)
+    #pragma omp for schedule(static)
+#endif
+    for (i = 0; i <= N; i++)
+    {
+        ocp_nlp_collect_stage_evaluations(config, dims, mem, i);
+    }
 
-        // nlp mem: ineq_adj
-        struct blasfeo_dvec *ineq_adj =
-            config->constraints[i]->memory_get_adj_ptr(mem->constraints[i]);
-        blasfeo_dveccp(nv[i], ineq_adj, 0, mem->ineq_adj + i, 0);
+    return;
+}
 
-    }
 
-    for (i = 0; i <= N; i++)
+
+void ocp_nlp_approximate_qp_matrices(ocp_nlp_config *config, ocp_nlp_dims *dims,
+    ocp_nlp_in *in, ocp_nlp_out *out, ocp_nlp_opts *opts, ocp_nlp_memory *mem,
+    ocp_nlp_workspace *work)
+{
+
+#if defined(ACADOS_WITH_OPENMP)
+    // the schedule ICV only affects the schedule(runtime) loop in the team body
+    omp_sched_t sched_kind_bkp;
+    int sched_chunk_bkp;
+    omp_get_schedule(&sched_kind_bkp, &sched_chunk_bkp);
+    if (opts->parallel_schedule == PARALLEL_DYNAMIC)
+        omp_set_schedule(omp_sched_dynamic, 1);
+    else
+        omp_set_schedule(omp_sched_static, 0);
+
+    // one single parallel region per linearization;
+    // the openmp runtime keeps the thread team alive in between calls
+#if _OPENMP >= 201307  // proc_bind requires openmp 4.0
+    if (opts->parallel_bind == PARALLEL_BIND_CLOSE)
+    {
+        #pragma omp parallel num_threads(opts->num_threads) proc_bind(close)
+        ocp_nlp_approximate_qp_matrices_team(config, dims, in, out, opts, mem, work);
+    }
+    else if (opts->parallel_bind == PARALLEL_BIND_SPREAD)
+    {
+        #pragma omp parallel num_threads(opts->num_threads) proc_bind(spread)
+        ocp_nlp_approximate_qp_matrices_team(config, dims, in, out, opts, mem, work);
+    }
+    else
+#endif
     {
-        // TODO(rien) where should the update happen??? move to qp update ???
-        // TODO(all): fix and move where appropriate
-        //  if (i<N)
-        //  {
-        //   ocp_nlp_dynamics_opts *dynamics_opts = opts->dynamics[i];
-        //   sim_opts *opts = dynamics_opts->sim_solver;
-        //   if (opts->scheme != NULL && opts->scheme->type != exact)
-        //   {
-        //    for (int_t j = 0; j < nx; j++)
-        //     BLASFEO_DVECEL(nlp_mem->cost_grad+i, nu+j) += work->sim_out[i]->grad[j];
-        //    for (int_t j = 0; j < nu; j++)
-        //     BLASFEO_DVECEL(nlp_mem->cost_grad+i, j) += work->sim_out[i]->grad[nx+j];
-        //   }
-        //  }
+        #pragma omp parallel num_threads(opts->num_threads)
+        ocp_nlp_approximate_qp_matrices_team(config, dims, in, out, opts, mem, work);
     }
 
+    omp_set_schedule(sched_kind_bkp, sched_chunk_bkp);
+#else
+    ocp_nlp_approximate_qp_matrices_team(config, dims, in, out, opts, mem, work);
+#endif
+
+    // all module functions have been evaluated at out
+    ocp_nlp_fun_key_set(dims, mem, out);
+
+    // TODO(rien) where should the update happen??? move to qp update ???
+    // TODO(all): fix and move where appropriate
+    //  if (i<N)
+    //  {
+    //   ocp_nlp_dynamics_opts *dynamics_opts = opts->dynamics[i];
+    //   sim_opts *opts = dynamics_opts->sim_solver;
+    //   if (opts->scheme != NULL && opts->scheme->type != exact)
+    //   {
+    //    for (int_t j = 0; j < nx; j++)
+    //     BLASFEO_DVECEL(nlp_mem->cost_grad+i, nu+j) += work->sim_out[i]->grad[j];
+    //    for (int_t j = 0; j < nu; j++)
+    //     BLASFEO_DVECEL(nlp_mem->cost_grad+i, j) += work->sim_out[i]->grad[nx+j];
+    //   }
+    //  }
+
     return;
 }
 
@@ -2060,23 +2443,39 @@ void ocp_nlp_approximate_qp_vectors_sqp(ocp_nlp_config *config,
     int N = dims->N;
     int *nv = dims->nv;
     int *nx = dims->nx;
-    // int *nu = dims->nu;
+    int *nu = dims->nu;
     int *ni = dims->ni;
 
 #if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(opts->num_threads)
 #endif
     for (i = 0; i <= N; i++)
     {
         // g
         blasfeo_dveccp(nv[i], mem->cost_grad + i, 0, mem->qp_in->rqz + i, 0);
 
+        // adjoint-based gradient correction for frozen dynamics sensitivities:
+        // g += (J - BAbt)' * pi, with J' * pi taken from the exact adjoints in dyn_adj
+        if (mem->freeze_dyn_jac)
+        {
+            blasfeo_daxpy(nu[i]+nx[i], -1.0, mem->dyn_adj+i, 0, mem->qp_in->rqz+i, 0,
+                          mem->qp_in->rqz+i, 0);
+            if (i > 0)
+                blasfeo_daxpy(nx[i], 1.0, out->pi+i-1, 0, mem->qp_in->rqz+i, nu[i],
+                              mem->qp_in->rqz+i, nu[i]);
+            if (i < N)
+                blasfeo_dgemv_n(nu[i]+nx[i], nx[i+1], -1.0, mem->qp_in->BAbt+i, 0, 0, out->pi+i, 0,
+                                1.0, mem->qp_in->rqz+i, 0, mem->qp_in->rqz+i, 0);
+        }
+
         // b
         if (i < N)
             blasfeo_dveccp(nx[i + 1], mem->dyn_fun + i, 0, mem->qp_in->b + i, 0);
 
         // d
         blasfeo_dveccp(2 * ni[i], mem->ineq_fun + i, 0, mem->qp_in->d + i, 0);
+
+        ocp_qp_in_mark_changed(mem->qp_in, i, OCP_QP_IN_VEC);
     }
 
     return;
@@ -2094,6 +2493,7 @@ void ocp_nlp_embed_initial_value(ocp_nlp_config *config, ocp_nlp_dims *dims,
     // constraints
     config->constraints[0]->bounds_update(config->constraints[0], dims->constraints[0],
             in->constraints[0], opts->constraints[0], mem->constraints[0], work->constraints[0]);
+    mem->fun_key_valid[0] = false;
 
     // nlp mem: ineq_fun
     struct blasfeo_dvec *ineq_fun =
@@ -2102,54 +2502,79 @@ void ocp_nlp_embed_initial_value(ocp_nlp_config *config, ocp_nlp_dims *dims,
 
     // d
     blasfeo_dveccp(2 * ni[0], mem->ineq_fun, 0, mem->qp_in->d, 0);
+    ocp_qp_in_mark_changed(mem->qp_in, 0, OCP_QP_IN_VEC);
 
     return;
 }
 
 
 
-double ocp_nlp_evaluate_merit_fun(ocp_nlp_config *config, ocp_nlp_dims *dims,
-                                  ocp_nlp_in *in, ocp_nlp_out *out, ocp_nlp_opts *opts,
-                                  ocp_nlp_memory *mem, ocp_nlp_workspace *work)
+// evaluate cost, dynamics and constraints functions at the trial point in work->tmp_nlp_out
+static void ocp_nlp_evaluate_trial_fun(ocp_nlp_config *config, ocp_nlp_dims *dims,
+                                       ocp_nlp_in *in, ocp_nlp_opts *opts,
+                                       ocp_nlp_memory *mem, ocp_nlp_workspace *work)
 {
-    int i, j;
+    int i;
 
     int N = dims->N;
-    int *nx = dims->nx;
-    int *ni = dims->ni;
 
-    double merit_fun = 0.0;
+    struct blasfeo_dvec *tmp_ux = work->tmp_nlp_out->ux;
 
-    // compute fun value
 #if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(opts->num_threads)
 #endif
     for (i=0; i<=N; i++)
     {
         // cost
-        config->cost[i]->compute_fun(config->cost[i], dims->cost[i], in->cost[i], opts->cost[i],
-                                    mem->cost[i], work->cost[i]);
+        if (!ocp_nlp_fun_key_match(dims, mem, tmp_ux+i, i))
+            config->cost[i]->compute_fun(config->cost[i], dims->cost[i], in->cost[i], opts->cost[i],
+                                        mem->cost[i], work->cost[i]);
     }
 #if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(opts->num_threads)
 #endif
     for (i=0; i<N; i++)
     {
         // dynamics
-        config->dynamics[i]->compute_fun(config->dynamics[i], dims->dynamics[i], in->dynamics[i],
-                                         opts->dynamics[i], mem->dynamics[i], work->dynamics[i]);
+        if (!ocp_nlp_fun_key_match(dims, mem, tmp_ux+i, i) ||
+            !ocp_nlp_fun_key_match(dims, mem, tmp_ux+i+1, i+1))
+            config->dynamics[i]->compute_fun(config->dynamics[i], dims->dynamics[i], in->dynamics[i],
+                                             opts->dynamics[i], mem->dynamics[i], work->dynamics[i]);
     }
 #if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(opts->num_threads)
 #endif
     for (i=0; i<=N; i++)
     {
         // constr
-        config->constraints[i]->compute_fun(config->constraints[i], dims->constraints[i],
-                                            in->constraints[i], opts->constraints[i],
-                                            mem->constraints[i], work->constraints[i]);
+        if (!ocp_nlp_fun_key_match(dims, mem, tmp_ux+i, i))
+            config->constraints[i]->compute_fun(config->constraints[i], dims->constraints[i],
+                                                in->constraints[i], opts->constraints[i],
+                                                mem->constraints[i], work->constraints[i]);
     }
 
+    ocp_nlp_fun_key_set(dims, mem, work->tmp_nlp_out);
+
+    return;
+}
+
+
+
+double ocp_nlp_evaluate_merit_fun(ocp_nlp_config *config, ocp_nlp_dims *dims,
+                                  ocp_nlp_in *in, ocp_nlp_out *out, ocp_nlp_opts *opts,
+                                  ocp_nlp_memory *mem, ocp_nlp_workspace *work)
+{
+    int i, j;
+
+    int N = dims->N;
+    int *nx = dims->nx;
+    int *ni = dims->ni;
+
+    double merit_fun = 0.0;
+
+    // compute fun value
+    ocp_nlp_evaluate_trial_fun(config, dims, in, opts, mem, work);
+
     double *tmp_fun;
     double tmp;
     struct blasfeo_dvec *tmp_fun_vec;
@@ -2200,6 +2625,318 @@ double ocp_nlp_evaluate_merit_fun(ocp_nlp_config *config, ocp_nlp_dims *dims,
 
 
 
+/************************************************
+ * filter line search
+ ************************************************/
+
+// Waechter & Biegler 2006, parameters as in their section 3
+#define FILTER_GAMMA_THETA 1e-5
+#define FILTER_GAMMA_PHI 1e-5
+#define FILTER_DELTA 1.0
+#define FILTER_S_THETA 1.1
+#define FILTER_S_PHI 2.3
+#define FILTER_ETA 1e-4
+#define FILTER_ALPHA_RED 0.5
+#define FILTER_ALPHA_MIN 1e-4
+
+
+
+// constraint violation (l1) and cost of the last evaluation in the modules
+static void ocp_nlp_filter_trial_values(ocp_nlp_config *config, ocp_nlp_dims *dims,
+                                        ocp_nlp_memory *mem, double *theta, double *phi)
+{
+    int i, j;
+
+    int N = dims->N;
+    int *nx = dims->nx;
+    int *ni = dims->ni;
+
+    double tmp;
+    struct blasfeo_dvec *tmp_fun_vec;
+
+    *theta = 0.0;
+    *phi = 0.0;
+
+    for (i = 0; i <= N; i++)
+    {
+        *phi += *config->cost[i]->memory_get_fun_ptr(mem->cost[i]);
+
+        if (i < N)
+        {
+            tmp_fun_vec = config->dynamics[i]->memory_get_fun_ptr(mem->dynamics[i]);
+            for (j = 0; j < nx[i+1]; j++)
+                *theta += fabs(BLASFEO_DVECEL(tmp_fun_vec, j));
+        }
+
+        tmp_fun_vec = config->constraints[i]->memory_get_fun_ptr(mem->constraints[i]);
+        for (j = 0; j < 2*ni[i]; j++)
+        {
+            tmp = BLASFEO_DVECEL(tmp_fun_vec, j);
+            *theta += tmp > 0.0 ? tmp : 0.0;
+        }
+    }
+
+    return;
+}
+
+
+
+static bool ocp_nlp_filter_acceptable(ocp_nlp_memory *mem, double theta, double phi)
+{
+    if (theta > mem->filter_theta_max)
+        return false;
+
+    for (int k = 0; k < mem->filter_size; k++)
+    {
+        if (theta >= mem->filter_theta[k] && phi >= mem->filter_phi[k])
+            return false;
+    }
+
+    return true;
+}
+
+
+
+static void ocp_nlp_filter_add(ocp_nlp_memory *mem, double theta, double phi)
+{
+    int k, n = 0;
+
+    // drop the entries dominated by the new one
+    for (k = 0; k < mem->filter_size; k++)
+    {
+        if (mem->filter_theta[k] < theta || mem->filter_phi[k] < phi)
+        {
+            mem->filter_theta[n] = mem->filter_theta[k];
+            mem->filter_phi[n] = mem->filter_phi[k];
+            n++;
+        }
+    }
+
+    // full: forget the oldest entry
+    if (n == OCP_NLP_FILTER_SIZE)
+    {
+        for (k = 1; k < n; k++)
+        {
+            mem->filter_theta[k-1] = mem->filter_theta[k];
+            mem->filter_phi[k-1] = mem->filter_phi[k];
+        }
+        n--;
+    }
+
+    mem->filter_theta[n] = theta;
+    mem->filter_phi[n] = phi;
+    mem->filter_size = n+1;
+
+    return;
+}
+
+
+
+// acceptance test of the trial point; f_type is set if the switching condition holds
+static bool ocp_nlp_filter_accept(ocp_nlp_memory *mem, double theta0, double phi0, double dphi,
+                                  double alpha, double theta1, double phi1, bool *f_type)
+{
+    if (!ocp_nlp_filter_acceptable(mem, theta1, phi1))
+        return false;
+
+    *f_type = dphi < 0.0 &&
+              alpha * pow(-dphi, FILTER_S_PHI) > FILTER_DELTA * pow(theta0, FILTER_S_THETA);
+
+    // Armijo condition on the cost
+    if (*f_type)
+        return phi1 <= phi0 + FILTER_ETA * alpha * dphi;
+
+    // sufficient decrease w.r.t. the current iterate
+    return theta1 <= (1.0 - FILTER_GAMMA_THETA) * theta0 ||
+           phi1 <= phi0 - FILTER_GAMMA_PHI * theta0;
+}
+
+
+
+static void ocp_nlp_copy_qp_out(ocp_nlp_dims *dims, ocp_qp_out *from, ocp_qp_out *to)
+{
+    int N = dims->N;
+    int *nv = dims->nv;
+    int *nx = dims->nx;
+    int *ni = dims->ni;
+
+    for (int i = 0; i <= N; i++)
+    {
+        blasfeo_dveccp(nv[i], from->ux+i, 0, to->ux+i, 0);
+        blasfeo_dveccp(2*ni[i], from->lam+i, 0, to->lam+i, 0);
+        blasfeo_dveccp(2*ni[i], from->t+i, 0, to->t+i, 0);
+        if (i < N)
+            blasfeo_dveccp(nx[i+1], from->pi+i, 0, to->pi+i, 0);
+    }
+
+    return;
+}
+
+
+
+// second order correction of the full step: re-solve the QP with the dynamics rhs and the
+// constraint bounds shifted by the nonlinearity observed at the rejected trial point;
+// returns true if the QP was solved, qp_in is restored in any case
+static bool ocp_nlp_filter_soc(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_opts *opts,
+                               ocp_nlp_memory *mem, ocp_nlp_workspace *work)
+{
+    int i;
+
+    int N = dims->N;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
+    int *ni = dims->ni;
+
+    ocp_qp_xcond_solver_config *qp_solver = config->qp_solver;
+    ocp_qp_in *qp_in = mem->qp_in;
+    ocp_qp_out *qp_out = mem->qp_out;
+
+    // keep the uncorrected step in case the correction is rejected, and the qp rhs
+    ocp_nlp_copy_qp_out(dims, qp_out, work->tmp_qp_out);
+    for (i = 0; i <= N; i++)
+    {
+        if (i < N)
+            blasfeo_dveccp(nx[i+1], qp_in->b+i, 0, work->tmp_qp_b+i, 0);
+        blasfeo_dveccp(2*ni[i], qp_in->d+i, 0, work->tmp_qp_d+i, 0);
+    }
+
+    // b += fun(x+d) - (fun(x) + BAbt' * d - dx1)
+    for (i = 0; i < N; i++)
+    {
+        struct blasfeo_dvec *fun_trial = config->dynamics[i]->memory_get_fun_ptr(mem->dynamics[i]);
+        blasfeo_daxpy(nx[i+1], 1.0, fun_trial, 0, qp_in->b+i, 0, qp_in->b+i, 0);
+        blasfeo_daxpy(nx[i+1], -1.0, mem->dyn_fun+i, 0, qp_in->b+i, 0, qp_in->b+i, 0);
+        blasfeo_dgemv_t(nu[i]+nx[i], nx[i+1], -1.0, qp_in->BAbt+i, 0, 0, qp_out->ux+i, 0,
+                        1.0, qp_in->b+i, 0, qp_in->b+i, 0);
+        blasfeo_daxpy(nx[i+1], 1.0, qp_out->ux+i+1, nu[i+1], qp_in->b+i, 0, qp_in->b+i, 0);
+    }
+
+    // d += fun(x+d) - fun_lin(x+d), the linearized constraint function at the trial point
+    // is fun_lin = -t with the qp slacks t (as t = -fun at a feasible point), slacks included
+    for (i = 0; i <= N; i++)
+    {
+        struct blasfeo_dvec *fun_trial = config->constraints[i]->memory_get_fun_ptr(mem->constraints[i]);
+        blasfeo_daxpy(2*ni[i], 1.0, fun_trial, 0, qp_in->d+i, 0, qp_in->d+i, 0);
+        blasfeo_daxpy(2*ni[i], 1.0, qp_out->t+i, 0, qp_in->d+i, 0, qp_in->d+i, 0);
+    }
+    ocp_qp_in_mark_changed_all(qp_in, OCP_QP_IN_VEC);
+
+    int qp_status = qp_solver->evaluate(qp_solver, dims->qp_solver, qp_in, qp_out,
+                                        opts->qp_solver_opts, mem->qp_solver_mem, work->qp_work);
+
+    // qp rhs of the linearization, as used by the residuals and later solves
+    for (i = 0; i <= N; i++)
+    {
+        if (i < N)
+            blasfeo_dveccp(nx[i+1], work->tmp_qp_b+i, 0, qp_in->b+i, 0);
+        blasfeo_dveccp(2*ni[i], work->tmp_qp_d+i, 0, qp_in->d+i, 0);
+    }
+    ocp_qp_in_mark_changed_all(qp_in, OCP_QP_IN_VEC);
+
+    if (qp_status != ACADOS_SUCCESS && qp_status != ACADOS_MAXITER)
+    {
+        ocp_nlp_copy_qp_out(dims, work->tmp_qp_out, qp_out);
+        return false;
+    }
+
+    config->regularize->correct_dual_sol(config->regularize, dims->regularize,
+                                         opts->regularize, mem->regularize_mem);
+
+    return true;
+}
+
+
+
+static double ocp_nlp_filter_line_search(ocp_nlp_config *config, ocp_nlp_dims *dims,
+            ocp_nlp_in *in, ocp_nlp_out *out, ocp_nlp_opts *opts, ocp_nlp_memory *mem,
+            ocp_nlp_workspace *work)
+{
+    int i;
+
+    int N = dims->N;
+    int *nv = dims->nv;
+    int *nx = dims->nx;
+    int *ni = dims->ni;
+
+    double theta0, phi0, theta1, phi1;
+    bool f_type, soc_done = false;
+
+    // current iterate: values from the last linearization
+    theta0 = 0.0;
+    phi0 = 0.0;
+    double dphi = 0.0;  // directional derivative of the cost along the step
+    for (i = 0; i <= N; i++)
+    {
+        phi0 += *config->cost[i]->memory_get_fun_ptr(mem->cost[i]);
+        dphi += blasfeo_ddot(nv[i], mem->cost_grad+i, 0, mem->qp_out->ux+i, 0);
+
+        if (i < N)
+        {
+            for (int j = 0; j < nx[i+1]; j++)
+                theta0 += fabs(BLASFEO_DVECEL(mem->dyn_fun+i, j));
+        }
+        for (int j = 0; j < 2*ni[i]; j++)
+            theta0 += BLASFEO_DVECEL(mem->ineq_fun+i, j) > 0.0 ? BLASFEO_DVECEL(mem->ineq_fun+i, j) : 0.0;
+    }
+
+    // reset the filter at the first iteration
+    if (mem->sqp_iter[0] == 0)
+    {
+        mem->filter_size = 0;
+        mem->filter_theta_max = 1e4 * (theta0 > 1.0 ? theta0 : 1.0);
+    }
+
+    double alpha = 1.0;
+
+    while (alpha >= FILTER_ALPHA_MIN)
+    {
+        for (i = 0; i <= N; i++)
+            blasfeo_daxpy(nv[i], alpha, mem->qp_out->ux+i, 0, out->ux+i, 0, work->tmp_nlp_out->ux+i, 0);
+
+        ocp_nlp_evaluate_trial_fun(config, dims, in, opts, mem, work);
+        ocp_nlp_filter_trial_values(config, dims, mem, &theta1, &phi1);
+
+        if (ocp_nlp_filter_accept(mem, theta0, phi0, dphi, alpha, theta1, phi1, &f_type))
+            break;
+
+        // try the second order correction if the full step increased the infeasibility
+        if (alpha == 1.0 && !soc_done && theta1 >= theta0)
+        {
+            soc_done = true;
+            if (ocp_nlp_filter_soc(config, dims, opts, mem, work))
+            {
+                for (i = 0; i <= N; i++)
+                    blasfeo_daxpy(nv[i], 1.0, mem->qp_out->ux+i, 0, out->ux+i, 0,
+                                  work->tmp_nlp_out->ux+i, 0);
+
+                ocp_nlp_evaluate_trial_fun(config, dims, in, opts, mem, work);
+                ocp_nlp_filter_trial_values(config, dims, mem, &theta1, &phi1);
+
+                if (ocp_nlp_filter_accept(mem, theta0, phi0, dphi, alpha, theta1, phi1, &f_type))
+                    break;
+
+                // rejected, back to the uncorrected step
+                ocp_nlp_copy_qp_out(dims, work->tmp_qp_out, mem->qp_out);
+            }
+        }
+
+        alpha *= FILTER_ALPHA_RED;
+    }
+
+    // no acceptable step, and there is no restoration phase: no step, the solver stops
+    mem->filter_failed = alpha < FILTER_ALPHA_MIN;
+    if (mem->filter_failed)
+        return 0.0;
+
+    // h-type iterations augment the filter
+    if (!f_type)
+        ocp_nlp_filter_add(mem, (1.0 - FILTER_GAMMA_THETA) * theta0, phi0 - FILTER_GAMMA_PHI * theta0);
+
+    return alpha;
+}
+
+
+
 static double ocp_nlp_line_search(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in,
             ocp_nlp_out *out, ocp_nlp_opts *opts, ocp_nlp_memory *mem, ocp_nlp_workspace *work)
 {
@@ -2214,6 +2951,11 @@ static double ocp_nlp_line_search(ocp_nlp_config *config, ocp_nlp_dims *dims, oc
     double tmp0, tmp1;
     int j;
 
+    mem->filter_failed = false;
+
+    if (opts->globalization == FILTER_LINE_SEARCH)
+        return ocp_nlp_filter_line_search(config, dims, in, out, opts, mem, work);
+
 
 #if 0 // Line Search Gianluca version
     // current point
@@ -2412,10 +3154,11 @@ void ocp_nlp_update_variables_sqp(ocp_nlp_config *config, ocp_nlp_dims *dims, oc
 
     // step length
     double alpha = ocp_nlp_line_search(config, dims, in, out, opts, mem, work);
+    mem->alpha = alpha;
 
 
 #if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(opts->num_threads)
 #endif
     for (i = 0; i <= N; i++)
     {
@@ -2628,6 +3371,9 @@ void ocp_nlp_cost_compute(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in
     }
     mem->cost_value = total_cost;
 
+    // only the cost has been evaluated
+    ocp_nlp_fun_key_invalidate(dims, mem);
+
     // printf("\ncomputed total cost: %e\n", total_cost);
     return;
 }
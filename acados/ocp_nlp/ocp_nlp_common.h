@@ -254,8 +254,28 @@ typedef enum
 {
     FIXED_STEP,
     MERIT_BACKTRACKING,
+    FILTER_LINE_SEARCH,
 } ocp_nlp_globalization_t;
 
+/// Maximum number of (infeasibility, cost) pairs in the line search filter
+#define OCP_NLP_FILTER_SIZE 32
+
+/// Scheduling of the stage-wise loops over the openmp thread team
+typedef enum
+{
+    PARALLEL_STATIC,   // contiguous blocks of stages per thread
+    PARALLEL_DYNAMIC,  // one stage at a time, idle threads steal the remaining stages
+    PARALLEL_WEIGHTED, // contiguous blocks of stages with equal time in the last linearization
+} ocp_nlp_parallel_schedule_t;
+
+/// Binding of the openmp threads to the places (cores) given in OMP_PLACES
+typedef enum
+{
+    PARALLEL_BIND_NONE,    // leave it to the openmp runtime
+    PARALLEL_BIND_CLOSE,   // pack threads on consecutive places
+    PARALLEL_BIND_SPREAD,  // spread threads evenly over the places
+} ocp_nlp_parallel_bind_t;
+
 typedef struct ocp_nlp_opts
 {
     ocp_nlp_globalization_t globalization;
@@ -268,6 +288,10 @@ typedef struct ocp_nlp_opts
     double levenberg_marquardt;  // LM factor to be added to the hessian before regularization
     int reuse_workspace;
     int num_threads;
+    ocp_nlp_parallel_schedule_t parallel_schedule;  // stage scheduling in the linearization
+    ocp_nlp_parallel_bind_t parallel_bind;  // thread binding in the linearization
+    int *parallel_cores;  // core of each thread in the linearization, overrides parallel_bind
+    int num_parallel_cores;  // number of pinned threads, 0 if not pinned
 
 } ocp_nlp_opts;
 
@@ -337,6 +361,25 @@ typedef struct ocp_nlp_memory
     struct blasfeo_dvec *dyn_adj;
 
     double cost_value;
+    double alpha;  // step length of the last update of the variables
+
+    // reuse the dynamics sensitivities in BAbt, only fun and adj are evaluated
+    bool freeze_dyn_jac;
+
+    // evaluation point of the function values currently held by the modules
+    struct blasfeo_dvec *fun_key;
+    bool *fun_key_valid;
+
+    // line search filter
+    double *filter_theta;  // constraint violation
+    double *filter_phi;    // cost
+    int filter_size;
+    double filter_theta_max;
+    bool filter_failed;  // no acceptable step in the last line search, alpha = 0
+
+    // weighted schedule of the linearization
+    double *stage_time;  // time of the stage evaluations in the last linearization
+    int *stage_chunk;    // first stage of each thread
 
     bool *set_sim_guess; // indicate if there is new explicitly provided guess for integration variables
     struct blasfeo_dvec *sim_guess;
@@ -367,6 +410,9 @@ typedef struct ocp_nlp_workspace
 
 	ocp_nlp_out *tmp_nlp_out;
 	ocp_nlp_out *weight_merit_fun;
+	ocp_qp_out *tmp_qp_out;  // backup of the QP step for the second order correction
+	struct blasfeo_dvec *tmp_qp_b;  // backup of the QP rhs b and d for the second order correction
+	struct blasfeo_dvec *tmp_qp_d;
 
 } ocp_nlp_workspace;
 
@@ -407,6 +453,8 @@ void ocp_nlp_initialize_t_slacks(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp
 void ocp_nlp_res_compute(ocp_nlp_dims *dims, ocp_nlp_in *in, ocp_nlp_out *out,
                          ocp_nlp_res *res, ocp_nlp_memory *mem);
 //
+void ocp_nlp_fun_key_invalidate(ocp_nlp_dims *dims, ocp_nlp_memory *mem);
+//
 void ocp_nlp_cost_compute(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in,
             ocp_nlp_out *out, ocp_nlp_opts *opts, ocp_nlp_memory *mem, ocp_nlp_workspace *work);
 
@@ -43,6 +43,8 @@
 #include "blasfeo/include/blasfeo_d_aux.h"
 #include "blasfeo/include/blasfeo_d_blas.h"
 // acados
+#include "acados/sim/sim_gnsf.h"
+#include "acados/sim/sim_lifted_irk_integrator.h"
 #include "acados/utils/mem.h"
 
 
@@ -925,6 +927,121 @@ void ocp_nlp_dynamics_cont_compute_fun(void *config_, void *dims_, void *model_,
 
 
 
+// integrators without an adjoint-only sweep: lifted IRK has no adjoint sensitivities,
+// GNSF computes the algebraic sensitivities only together with the forward ones
+static bool ocp_nlp_dynamics_cont_adj_by_forw(ocp_nlp_dynamics_config *config,
+    ocp_nlp_dynamics_cont_opts *opts)
+{
+    sim_opts *sim_opts_ = opts->sim_solver;
+
+    if (config->sim_solver->evaluate == &sim_lifted_irk)
+        return true;
+    if (config->sim_solver->evaluate == &sim_gnsf && sim_opts_->sens_algebraic)
+        return true;
+
+    return false;
+}
+
+
+
+void ocp_nlp_dynamics_cont_compute_fun_and_adj(void *config_, void *dims_, void *model_, void *opts_, void *mem_, void *work_)
+{
+    ocp_nlp_dynamics_cont_cast_workspace(config_, dims_, opts_, work_);
+
+    ocp_nlp_dynamics_config *config = config_;
+    ocp_nlp_dynamics_cont_dims *dims = dims_;
+    ocp_nlp_dynamics_cont_opts *opts = opts_;
+    ocp_nlp_dynamics_cont_workspace *work = work_;
+    ocp_nlp_dynamics_cont_memory *mem = mem_;
+    ocp_nlp_dynamics_cont_model *model = model_;
+
+    int ii, jj;
+
+    int nx = dims->nx;
+    int nu = dims->nu;
+    int nz = dims->nz;
+    int nx1 = dims->nx1;
+    int nu1 = dims->nu1;
+
+    bool adj_by_forw = opts->compute_adj && ocp_nlp_dynamics_cont_adj_by_forw(config, opts);
+
+    // setup model
+    work->sim_in->model = model->sim_model;
+    work->sim_in->T = model->T;
+
+    // pass state and control to integrator
+    blasfeo_unpack_dvec(nu, mem->ux, 0, work->sim_in->u, 1);
+    blasfeo_unpack_dvec(nx, mem->ux, nu, work->sim_in->x, 1);
+
+    if (mem->set_sim_guess!=NULL && mem->set_sim_guess[0])
+    {
+        config->sim_solver->memory_set(config->sim_solver, work->sim_in->dims, mem->sim_solver,
+                                        "guesses_blasfeo", mem->sim_guess);
+        // only use/pass the initial guess once
+        mem->set_sim_guess[0] = false;
+    }
+
+    // adjoint seed
+    for(jj = 0; jj < nx + nu; jj++)
+        work->sim_in->S_adj[jj] = 0.0;
+    blasfeo_unpack_dvec(nx1, mem->pi, 0, work->sim_in->S_adj, 1);
+
+    // backup sens options
+    bool sens_forw_bkp, sens_adj_bkp, sens_hess_bkp;
+    config->sim_solver->opts_get(config->sim_solver, opts->sim_solver, "sens_forw", &sens_forw_bkp);
+    config->sim_solver->opts_get(config->sim_solver, opts->sim_solver, "sens_adj", &sens_adj_bkp);
+    config->sim_solver->opts_get(config->sim_solver, opts->sim_solver, "sens_hess", &sens_hess_bkp);
+
+    // adjoint sweep only, the forward sensitivities in BAbt are kept;
+    // without adjoint sweep, the adjoint is computed from the forward sensitivities
+    bool sens_false = false;
+    bool sens_forw = adj_by_forw;
+    bool sens_adj = opts->compute_adj && !adj_by_forw;
+    config->sim_solver->opts_set(config->sim_solver, opts->sim_solver, "sens_forw", &sens_forw);
+    config->sim_solver->opts_set(config->sim_solver, opts->sim_solver, "sens_adj", &sens_adj);
+    config->sim_solver->opts_set(config->sim_solver, opts->sim_solver, "sens_hess", &sens_false);
+
+    // call integrator
+    config->sim_solver->evaluate(config->sim_solver, work->sim_in, work->sim_out, opts->sim_solver,
+            mem->sim_solver, work->sim_solver);
+
+    // restore sens options
+    config->sim_solver->opts_set(config->sim_solver, opts->sim_solver, "sens_forw", &sens_forw_bkp);
+    config->sim_solver->opts_set(config->sim_solver, opts->sim_solver, "sens_adj", &sens_adj_bkp);
+    config->sim_solver->opts_set(config->sim_solver, opts->sim_solver, "sens_hess", &sens_hess_bkp);
+
+    // function
+    blasfeo_pack_dvec(nx1, work->sim_out->xn, 1, &mem->fun, 0);
+    blasfeo_daxpy(nx1, -1.0, mem->ux1, nu1, &mem->fun, 0, &mem->fun, 0);
+    blasfeo_pack_dvec(nz, work->sim_out->zn, 1, mem->z_alg, 0);
+
+    // adjoint at the current iterate
+    if (adj_by_forw)
+    {
+        // S_adj = S_forw' * pi, S_forw is nx1 x (nx+nu), column major
+        double *S_forw = work->sim_out->S_forw;
+        for (jj = 0; jj < nx + nu; jj++)
+        {
+            double tmp = 0.0;
+            for (ii = 0; ii < nx1; ii++)
+                tmp += S_forw[ii + jj * nx1] * work->sim_in->S_adj[ii];
+            work->sim_out->S_adj[jj] = tmp;
+        }
+    }
+    if (opts->compute_adj)
+    {
+        blasfeo_pack_dvec(nu, work->sim_out->S_adj+nx, 1, &mem->adj, 0);
+        blasfeo_pack_dvec(nx, work->sim_out->S_adj+0, 1, &mem->adj, nu);
+        blasfeo_dvecsc(nu+nx, -1.0, &mem->adj, 0);
+        blasfeo_dveccp(nx1, mem->pi, 0, &mem->adj, nu+nx);
+    }
+
+    return;
+
+}
+
+
+
 int ocp_nlp_dynamics_cont_precompute(void *config_, void *dims_, void *model_, void *opts_,
                                         void *mem_, void *work_)
 {
@@ -988,6 +1105,7 @@ void ocp_nlp_dynamics_cont_config_initialize_default(void *config_)
     config->initialize = &ocp_nlp_dynamics_cont_initialize;
     config->update_qp_matrices = &ocp_nlp_dynamics_cont_update_qp_matrices;
     config->compute_fun = &ocp_nlp_dynamics_cont_compute_fun;
+    config->compute_fun_and_adj = &ocp_nlp_dynamics_cont_compute_fun_and_adj;
     config->precompute = &ocp_nlp_dynamics_cont_precompute;
     config->config_initialize_default = &ocp_nlp_dynamics_cont_config_initialize_default;
 
@@ -833,6 +833,8 @@ void ocp_nlp_dynamics_disc_config_initialize_default(void *config_)
     config->initialize = &ocp_nlp_dynamics_disc_initialize;
     config->update_qp_matrices = &ocp_nlp_dynamics_disc_update_qp_matrices;
     config->compute_fun = &ocp_nlp_dynamics_disc_compute_fun;
+    // no adjoint-only evaluation of the discrete model, fall back to the full linearization
+    config->compute_fun_and_adj = &ocp_nlp_dynamics_disc_update_qp_matrices;
     config->precompute = &ocp_nlp_dynamics_disc_precompute;
     config->config_initialize_default = &ocp_nlp_dynamics_disc_config_initialize_default;
 
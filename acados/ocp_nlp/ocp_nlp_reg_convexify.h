@@ -137,6 +137,8 @@ void *ocp_nlp_reg_convexify_assign_memory(void *config, ocp_nlp_reg_dims *dims,
  * functions
  ************************************************/
 
+//
+void ocp_nlp_reg_convexify_regularize_hessian(void *config, ocp_nlp_reg_dims *dims, void *opts_, void *mem_);
 //
 void ocp_nlp_reg_convexify_config_initialize_default(ocp_nlp_reg_config *config);
 
@@ -40,19 +40,20 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
-#if defined(ACADOS_WITH_OPENMP)
-#include <omp.h>
-#endif
 
 // blasfeo
 #include "blasfeo/include/blasfeo_d_aux.h"
 #include "blasfeo/include/blasfeo_d_aux_ext_dep.h"
 #include "blasfeo/include/blasfeo_d_blas.h"
+// hpipm
+#include "hpipm/include/hpipm_common.h"
 // acados
 #include "acados/ocp_nlp/ocp_nlp_common.h"
 #include "acados/ocp_nlp/ocp_nlp_dynamics_cont.h"
 #include "acados/ocp_nlp/ocp_nlp_reg_common.h"
 #include "acados/ocp_qp/ocp_qp_common.h"
+#include "acados/ocp_qp/ocp_qp_hpipm.h"
+#include "acados/dense_qp/dense_qp_hpipm.h"
 #include "acados/utils/mem.h"
 #include "acados/utils/print.h"
 #include "acados/utils/timing.h"
@@ -76,6 +77,10 @@ int ocp_nlp_sqp_opts_calculate_size(void *config_, void *dims_)
 
     size += ocp_nlp_opts_calculate_size(config, dims);
 
+    size += (dims->N+1)*sizeof(ocp_nlp_hess_update_t);  // hess_update
+
+    size += 8;  // align
+
     return size;
 }
 
@@ -94,6 +99,12 @@ void *ocp_nlp_sqp_opts_assign(void *config_, void *dims_, void *raw_memory)
     opts->nlp_opts = ocp_nlp_opts_assign(config, dims, c_ptr);
     c_ptr += ocp_nlp_opts_calculate_size(config, dims);
 
+    align_char_to(8, &c_ptr);
+
+    // hess_update
+    opts->hess_update = (ocp_nlp_hess_update_t *) c_ptr;
+    c_ptr += (dims->N+1)*sizeof(ocp_nlp_hess_update_t);
+
     assert((char *) raw_memory + ocp_nlp_sqp_opts_calculate_size(config, dims) >= c_ptr);
 
     return opts;
@@ -129,6 +140,14 @@ void ocp_nlp_sqp_opts_initialize_default(void *config_, void *dims_, void *opts_
     opts->rti_phase = 0;
     opts->print_level = 0;
     opts->initialize_t_slacks = 0;
+    opts->dyn_sens_reuse = 0;
+    opts->time_budget = 0.0;
+    opts->inexact_qp = 0;
+    opts->inexact_qp_kappa = 1e-1;
+    opts->inexact_qp_tol_max = 1e-2;
+    opts->snapshot_writer = NULL;
+    for (int ii = 0; ii <= dims->N; ii++)
+        opts->hess_update[ii] = NO_HESS_UPDATE;
 
     // overwrite default submodules opts
 
@@ -157,6 +176,22 @@ void ocp_nlp_sqp_opts_update(void *config_, void *dims_, void *opts_)
 
 
 
+static ocp_nlp_hess_update_t ocp_nlp_sqp_parse_hess_update(const char *value)
+{
+    if (!strcmp(value, "none"))
+        return NO_HESS_UPDATE;
+    else if (!strcmp(value, "bfgs"))
+        return BFGS_UPDATE;
+    else if (!strcmp(value, "sr1"))
+        return SR1_UPDATE;
+
+    printf("\nerror: ocp_nlp_sqp_opts_set: not supported value for hess_update, got: %s\n", value);
+    printf("possible values are: none, bfgs, sr1\n");
+    exit(1);
+}
+
+
+
 void ocp_nlp_sqp_opts_set(void *config_, void *opts_, const char *field, void* value)
 {
     ocp_nlp_config *config = config_;
@@ -265,6 +300,65 @@ void ocp_nlp_sqp_opts_set(void *config_, void *opts_, const char *field, void* v
             }
             opts->initialize_t_slacks = *initialize_t_slacks;
         }
+        else if (!strcmp(field, "dyn_sens_reuse"))
+        {
+            int* dyn_sens_reuse = (int *) value;
+            if (*dyn_sens_reuse < 0)
+            {
+                printf("\nerror: ocp_nlp_sqp_opts_set: invalid value for dyn_sens_reuse field, need int >=0, got %d.", *dyn_sens_reuse);
+                exit(1);
+            }
+            opts->dyn_sens_reuse = *dyn_sens_reuse;
+        }
+        else if (!strcmp(field, "hess_update"))
+        {
+            ocp_nlp_hess_update_t hess_update = ocp_nlp_sqp_parse_hess_update((char *) value);
+            for (ii = 0; ii <= config->N; ii++)
+                opts->hess_update[ii] = hess_update;
+        }
+        else if (!strcmp(field, "time_budget"))
+        {
+            double* time_budget = (double *) value;
+            if (*time_budget < 0.0)
+            {
+                printf("\nerror: ocp_nlp_sqp_opts_set: invalid value for time_budget field, need double >=0, got %f.", *time_budget);
+                exit(1);
+            }
+            opts->time_budget = *time_budget;
+        }
+        else if (!strcmp(field, "inexact_qp"))
+        {
+            int* inexact_qp = (int *) value;
+            // the HPIPM mode is escalated on QP failure
+            qp_solver_config *qp_solver = config->qp_solver->qp_solver;
+            if (*inexact_qp && qp_solver->evaluate != &ocp_qp_hpipm &&
+                qp_solver->evaluate != &dense_qp_hpipm)
+            {
+                printf("\nerror: ocp_nlp_sqp_opts_set: inexact_qp requires HPIPM as QP solver\n");
+                exit(1);
+            }
+            opts->inexact_qp = *inexact_qp;
+        }
+        else if (!strcmp(field, "inexact_qp_kappa"))
+        {
+            double* kappa = (double *) value;
+            if (*kappa <= 0.0)
+            {
+                printf("\nerror: ocp_nlp_sqp_opts_set: invalid value for inexact_qp_kappa field, need double >0, got %f.", *kappa);
+                exit(1);
+            }
+            opts->inexact_qp_kappa = *kappa;
+        }
+        else if (!strcmp(field, "inexact_qp_tol_max"))
+        {
+            double* tol_max = (double *) value;
+            opts->inexact_qp_tol_max = *tol_max;
+        }
+        else if (!strcmp(field, "snapshot_writer"))
+        {
+            // value is an ocp_qp_snapshot_writer *, NULL stops logging
+            opts->snapshot_writer = (ocp_qp_snapshot_writer *) value;
+        }
         else
         {
             ocp_nlp_opts_set(config, nlp_opts, field, value);
@@ -283,7 +377,14 @@ void ocp_nlp_sqp_opts_set_at_stage(void *config_, void *opts_, int stage, const
     ocp_nlp_sqp_opts *opts = (ocp_nlp_sqp_opts *) opts_;
     ocp_nlp_opts *nlp_opts = opts->nlp_opts;
 
-    ocp_nlp_opts_set_at_stage(config, nlp_opts, stage, field, value);
+    if (!strcmp(field, "hess_update"))
+    {
+        opts->hess_update[stage] = ocp_nlp_sqp_parse_hess_update((char *) value);
+    }
+    else
+    {
+        ocp_nlp_opts_set_at_stage(config, nlp_opts, stage, field, value);
+    }
 
     return;
 
@@ -302,9 +403,9 @@ int ocp_nlp_sqp_memory_calculate_size(void *config_, void *dims_, void *opts_)
     ocp_nlp_sqp_opts *opts = opts_;
     ocp_nlp_opts *nlp_opts = opts->nlp_opts;
 
-    // int N = dims->N;
-    // int *nx = dims->nx;
-    // int *nu = dims->nu;
+    int N = dims->N;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
     // int *nz = dims->nz;
 
     int size = 0;
@@ -321,7 +422,20 @@ int ocp_nlp_sqp_memory_calculate_size(void *config_, void *dims_, void *opts_)
         stat_n += 4;
     size += stat_n*stat_m*sizeof(double);
 
-    size += 3*8;  // align
+    // quasi-Newton Hessian blocks
+    size += (N+1)*sizeof(struct blasfeo_dmat);     // hess_B
+    size += 3*(N+1)*sizeof(struct blasfeo_dvec);   // hess_s hess_y hess_Bs
+    for (int ii = 0; ii <= N; ii++)
+    {
+        size += blasfeo_memsize_dmat(nu[ii]+nx[ii], nu[ii]+nx[ii]);  // hess_B
+        size += 3*blasfeo_memsize_dvec(nu[ii]+nx[ii]);  // hess_s hess_y hess_Bs
+    }
+
+    // qp solver opts of the user, restored after an inexact SQP solve
+    size += config->qp_solver->opts_calculate_size(config->qp_solver, dims->qp_solver);
+
+    size += 4*8;  // align
+    size += 64;  // blasfeo_mem align
 
     make_int_multiple_of(8, &size);
 
@@ -344,9 +458,9 @@ void *ocp_nlp_sqp_memory_assign(void *config_, void *dims_, void *opts_, void *r
 
     char *c_ptr = (char *) raw_memory;
 
-    // int N = dims->N;
-    // int *nx = dims->nx;
-    // int *nu = dims->nu;
+    int N = dims->N;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
     // int *nz = dims->nz;
 
     // initial align
@@ -370,9 +484,35 @@ void *ocp_nlp_sqp_memory_assign(void *config_, void *dims_, void *opts_, void *r
     c_ptr += mem->stat_m*mem->stat_n*sizeof(double);
 
     mem->status = ACADOS_READY;
+    mem->time_iter_pred = 0.0;
+    mem->qp_mode = SPEED;
+
+    align_char_to(8, &c_ptr);
+
+    // quasi-Newton Hessian blocks
+    assign_and_advance_blasfeo_dmat_structs(N+1, &mem->hess_B, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N+1, &mem->hess_s, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N+1, &mem->hess_y, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N+1, &mem->hess_Bs, &c_ptr);
+
+    align_char_to(64, &c_ptr);
+
+    for (int ii = 0; ii <= N; ii++)
+        assign_and_advance_blasfeo_dmat_mem(nu[ii]+nx[ii], nu[ii]+nx[ii], mem->hess_B+ii, &c_ptr);
+    for (int ii = 0; ii <= N; ii++)
+    {
+        assign_and_advance_blasfeo_dvec_mem(nu[ii]+nx[ii], mem->hess_s+ii, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(nu[ii]+nx[ii], mem->hess_y+ii, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(nu[ii]+nx[ii], mem->hess_Bs+ii, &c_ptr);
+    }
+    mem->hess_update_ready = false;
 
     align_char_to(8, &c_ptr);
 
+    // qp solver opts backup
+    mem->qp_opts_backup = c_ptr;
+    c_ptr += config->qp_solver->opts_calculate_size(config->qp_solver, dims->qp_solver);
+
     assert((char *) raw_memory + ocp_nlp_sqp_memory_calculate_size(config, dims, opts) >= c_ptr);
 
     return mem;
@@ -405,6 +545,9 @@ int ocp_nlp_sqp_workspace_calculate_size(void *config_, void *dims_, void *opts_
     // tmp qp out
     size += ocp_qp_out_calculate_size(dims->qp_solver->orig_dims);
 
+    // best nlp out
+    size += ocp_nlp_out_calculate_size(config, dims);
+
     if (opts->ext_qp_res)
     {
         // qp res
@@ -441,6 +584,10 @@ static void ocp_nlp_sqp_cast_workspace(ocp_nlp_config *config, ocp_nlp_dims *dim
     work->tmp_qp_out = ocp_qp_out_assign(dims->qp_solver->orig_dims, c_ptr);
     c_ptr += ocp_qp_out_calculate_size(dims->qp_solver->orig_dims);
 
+    // best nlp out
+    work->best_nlp_out = ocp_nlp_out_assign(config, dims, c_ptr);
+    c_ptr += ocp_nlp_out_calculate_size(config, dims);
+
     if (opts->ext_qp_res)
     {
         // qp res
@@ -463,8 +610,183 @@ static void ocp_nlp_sqp_cast_workspace(ocp_nlp_config *config, ocp_nlp_dims *dim
  * functions
  ************************************************/
 
-int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
-                void *opts_, void *mem_, void *work_)
+// after the update of the variables: s = alpha * d and the Lagrangian gradient at the old
+// point with the new multipliers, which by the QP stationarity is (1-alpha) * res_stat - alpha * H * d
+static void ocp_nlp_sqp_hess_update_prepare(ocp_nlp_dims *dims, ocp_nlp_sqp_opts *opts,
+                                            ocp_nlp_sqp_memory *mem)
+{
+    ocp_nlp_memory *nlp_mem = mem->nlp_mem;
+
+    int N = dims->N;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
+
+    double alpha = nlp_mem->alpha;
+
+    for (int ii = 0; ii <= N; ii++)
+    {
+        if (opts->hess_update[ii] == NO_HESS_UPDATE)
+            continue;
+
+        int nv = nu[ii]+nx[ii];
+        blasfeo_dveccpsc(nv, alpha, nlp_mem->qp_out->ux+ii, 0, mem->hess_s+ii, 0);
+        blasfeo_dsymv_l(nv, nv, 1.0, nlp_mem->qp_in->RSQrq+ii, 0, 0, nlp_mem->qp_out->ux+ii, 0,
+                        0.0, mem->hess_Bs+ii, 0, mem->hess_Bs+ii, 0);
+        blasfeo_dveccpsc(nv, 1.0-alpha, nlp_mem->nlp_res->res_stat+ii, 0, mem->hess_y+ii, 0);
+        blasfeo_daxpy(nv, -alpha, mem->hess_Bs+ii, 0, mem->hess_y+ii, 0, mem->hess_y+ii, 0);
+    }
+
+    mem->hess_update_ready = true;
+
+    return;
+}
+
+
+
+// B += a * v * v'
+static void ocp_nlp_sqp_hess_rank1(int n, double a, struct blasfeo_dvec *v, struct blasfeo_dmat *B)
+{
+    for (int jj = 0; jj < n; jj++)
+        for (int kk = 0; kk < n; kk++)
+            BLASFEO_DMATEL(B, kk, jj) += a * BLASFEO_DVECEL(v, kk) * BLASFEO_DVECEL(v, jj);
+
+    return;
+}
+
+
+
+// quasi-Newton update of the Hessian blocks with the residuals at the new iterate,
+// the blocks replace the [u; x] part of RSQrq; the first iteration takes the module Hessian
+static void ocp_nlp_sqp_hess_update(ocp_nlp_dims *dims, ocp_nlp_sqp_opts *opts,
+                                    ocp_nlp_sqp_memory *mem, int sqp_iter)
+{
+    ocp_nlp_memory *nlp_mem = mem->nlp_mem;
+
+    int N = dims->N;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
+
+    int ii, jj, kk;
+    double sBs, sy, sr, theta;
+
+    for (ii = 0; ii <= N; ii++)
+    {
+        if (opts->hess_update[ii] == NO_HESS_UPDATE)
+            continue;
+
+        int nv = nu[ii]+nx[ii];
+        struct blasfeo_dmat *B = mem->hess_B+ii;
+        struct blasfeo_dvec *s = mem->hess_s+ii;
+        struct blasfeo_dvec *y = mem->hess_y+ii;
+        struct blasfeo_dvec *Bs = mem->hess_Bs+ii;
+
+        if (sqp_iter == 0 || !mem->hess_update_ready)
+        {
+            // initial block from the lower triangle of the module Hessian
+            for (jj = 0; jj < nv; jj++)
+            {
+                for (kk = jj; kk < nv; kk++)
+                {
+                    BLASFEO_DMATEL(B, kk, jj) = BLASFEO_DMATEL(nlp_mem->qp_in->RSQrq+ii, kk, jj);
+                    BLASFEO_DMATEL(B, jj, kk) = BLASFEO_DMATEL(B, kk, jj);
+                }
+            }
+        }
+        else
+        {
+            // y = grad_lag(x_new, lam_new) - grad_lag(x_old, lam_new)
+            blasfeo_daxpy(nv, -1.0, y, 0, nlp_mem->nlp_res->res_stat+ii, 0, y, 0);
+
+            blasfeo_dsymv_l(nv, nv, 1.0, B, 0, 0, s, 0, 0.0, Bs, 0, Bs, 0);
+            sBs = blasfeo_ddot(nv, s, 0, Bs, 0);
+            sy = blasfeo_ddot(nv, s, 0, y, 0);
+
+            if (opts->hess_update[ii] == BFGS_UPDATE)
+            {
+                if (sBs > ACADOS_EPS)
+                {
+                    // Powell damping: r = theta * y + (1-theta) * B * s, s' * r >= 0.2 * s' * B * s
+                    if (sy < 0.2 * sBs)
+                    {
+                        theta = 0.8 * sBs / (sBs - sy);
+                        blasfeo_dvecsc(nv, theta, y, 0);
+                        blasfeo_daxpy(nv, 1.0-theta, Bs, 0, y, 0, y, 0);
+                    }
+                    sr = blasfeo_ddot(nv, s, 0, y, 0);
+
+                    ocp_nlp_sqp_hess_rank1(nv, 1.0/sr, y, B);
+                    ocp_nlp_sqp_hess_rank1(nv, -1.0/sBs, Bs, B);
+                }
+            }
+            else  // SR1_UPDATE
+            {
+                // r = y - B * s
+                blasfeo_daxpy(nv, -1.0, Bs, 0, y, 0, y, 0);
+                sr = blasfeo_ddot(nv, s, 0, y, 0);
+
+                // skip small denominators and negative curvature updates
+                if (sr > 1e-8 * sqrt(blasfeo_ddot(nv, s, 0, s, 0) * blasfeo_ddot(nv, y, 0, y, 0)))
+                    ocp_nlp_sqp_hess_rank1(nv, 1.0/sr, y, B);
+            }
+        }
+
+        blasfeo_dgecp(nv, nv, B, 0, 0, nlp_mem->qp_in->RSQrq+ii, 0, 0);
+    }
+
+    return;
+}
+
+
+
+static void ocp_nlp_sqp_copy_iterate(ocp_nlp_dims *dims, ocp_nlp_out *from, ocp_nlp_out *to)
+{
+    int N = dims->N;
+    int *nv = dims->nv;
+    int *nx = dims->nx;
+    int *nz = dims->nz;
+    int *ni = dims->ni;
+
+    for (int ii = 0; ii <= N; ii++)
+    {
+        blasfeo_dveccp(nv[ii], from->ux+ii, 0, to->ux+ii, 0);
+        blasfeo_dveccp(nz[ii], from->z+ii, 0, to->z+ii, 0);
+        blasfeo_dveccp(2*ni[ii], from->lam+ii, 0, to->lam+ii, 0);
+        blasfeo_dveccp(2*ni[ii], from->t+ii, 0, to->t+ii, 0);
+        if (ii < N)
+            blasfeo_dveccp(nx[ii+1], from->pi+ii, 0, to->pi+ii, 0);
+    }
+    to->inf_norm_res = from->inf_norm_res;
+
+    return;
+}
+
+
+
+// inexact SQP: solve the QP only as accurately as the current NLP residuals require,
+// but never looser than inexact_qp_tol_max nor tighter than the NLP tolerances
+static void ocp_nlp_sqp_inexact_qp_tol(ocp_nlp_config *config, ocp_nlp_sqp_opts *opts,
+                                       ocp_nlp_res *nlp_res)
+{
+    ocp_qp_xcond_solver_config *qp_solver = config->qp_solver;
+    void *qp_opts = opts->nlp_opts->qp_solver_opts;
+    double kappa = opts->inexact_qp_kappa;
+    double tol_max = opts->inexact_qp_tol_max;
+    double tol;
+
+    tol = fmax(opts->tol_stat, fmin(tol_max, kappa * nlp_res->inf_norm_res_stat));
+    qp_solver->opts_set(qp_solver, qp_opts, "tol_stat", &tol);
+    tol = fmax(opts->tol_eq, fmin(tol_max, kappa * nlp_res->inf_norm_res_eq));
+    qp_solver->opts_set(qp_solver, qp_opts, "tol_eq", &tol);
+    tol = fmax(opts->tol_ineq, fmin(tol_max, kappa * nlp_res->inf_norm_res_ineq));
+    qp_solver->opts_set(qp_solver, qp_opts, "tol_ineq", &tol);
+    tol = fmax(opts->tol_comp, fmin(tol_max, kappa * nlp_res->inf_norm_res_comp));
+    qp_solver->opts_set(qp_solver, qp_opts, "tol_comp", &tol);
+}
+
+
+
+static int ocp_nlp_sqp_iterate(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
+                               void *opts_, void *mem_, void *work_)
 {
 
     acados_timer timer0, timer1;
@@ -502,19 +824,19 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
     int qp_iter = 0;
     int qp_status = 0;
 
-#if defined(ACADOS_WITH_OPENMP)
-    // backup number of threads
-    int num_threads_bkp = omp_get_num_threads();
-    // set number of threads
-    omp_set_num_threads(opts->nlp_opts->num_threads);
-    #pragma omp parallel
-    { // beginning of parallel region
-#endif
+    // time budget
+    double time_iter_start;
+    double best_res = ACADOS_POS_INFTY;
+    int best_iter = -1;
+
+    // inexact SQP starts in the fastest HPIPM mode
+    if (opts->inexact_qp)
+    {
+        mem->qp_mode = SPEED;
+        qp_solver->opts_set(qp_solver, opts->nlp_opts->qp_solver_opts, "mode", &mem->qp_mode);
+    }
 
     // alias to dynamics_memory
-#if defined(ACADOS_WITH_OPENMP)
-    #pragma omp for
-#endif
     for (ii = 0; ii < N; ii++)
     {
         config->dynamics[ii]->memory_set_ux_ptr(nlp_out->ux+ii, nlp_mem->dynamics[ii]);
@@ -531,9 +853,6 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
     }
 
     // alias to cost_memory
-#if defined(ACADOS_WITH_OPENMP)
-    #pragma omp for
-#endif
     for (ii = 0; ii <= N; ii++)
     {
         config->cost[ii]->memory_set_ux_ptr(nlp_out->ux+ii, nlp_mem->cost[ii]);
@@ -544,9 +863,6 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
         config->cost[ii]->memory_set_Z_ptr(nlp_mem->qp_in->Z+ii, nlp_mem->cost[ii]);
     }
     // alias to constraints_memory
-#if defined(ACADOS_WITH_OPENMP)
-    #pragma omp for
-#endif
     for (ii = 0; ii <= N; ii++)
     {
         config->constraints[ii]->memory_set_ux_ptr(nlp_out->ux+ii, nlp_mem->constraints[ii]);
@@ -574,10 +890,6 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
     config->regularize->memory_set_lam_ptr(dims->regularize, nlp_mem->qp_out->lam, nlp_mem->regularize_mem);
 
     // copy sampling times into dynamics model
-#if defined(ACADOS_WITH_OPENMP)
-    #pragma omp for
-#endif
-
     // NOTE(oj): this will lead in an error for irk_gnsf, T must be set in precompute;
     //    -> remove here and make sure precompute is called everywhere.
     for (ii = 0; ii < N; ii++)
@@ -586,10 +898,6 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
                                          nlp_in->dynamics[ii], "T", nlp_in->Ts+ii);
     }
 
-#if defined(ACADOS_WITH_OPENMP)
-    } // end of parallel region
-#endif
-
     //
     if (opts->initialize_t_slacks > 0)
         ocp_nlp_initialize_t_slacks(config, dims, nlp_in, nlp_out, nlp_opts, nlp_mem, nlp_work);
@@ -603,6 +911,12 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
 
     for (; sqp_iter < opts->max_iter; sqp_iter++)
     {
+        time_iter_start = acados_toc(&timer0);
+
+        // full dynamics sensitivities every dyn_sens_reuse+1 iterations,
+        // in between only fun and adjoints are evaluated and the gradient is corrected
+        nlp_mem->freeze_dyn_jac = opts->dyn_sens_reuse > 0 && sqp_iter % (opts->dyn_sens_reuse + 1) != 0;
+
         // linearizate NLP and update QP matrices
         acados_tic(&timer1);
         ocp_nlp_approximate_qp_matrices(config, dims, nlp_in, nlp_out, nlp_opts, nlp_mem, nlp_work);
@@ -611,6 +925,8 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
         // update QP rhs for SQP (step prim var, abs dual var)
         ocp_nlp_approximate_qp_vectors_sqp(config, dims, nlp_in, nlp_out, nlp_opts, nlp_mem, nlp_work);
 
+        nlp_mem->freeze_dyn_jac = false;
+
         // compute nlp residuals
         ocp_nlp_res_compute(dims, nlp_in, nlp_out, nlp_mem->nlp_res, nlp_mem);
 
@@ -654,10 +970,6 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
             nlp_out->total_time = total_time;
             mem->time_tot = total_time;
 
-#if defined(ACADOS_WITH_OPENMP)
-            // restore number of threads
-            omp_set_num_threads(num_threads_bkp);
-#endif
             mem->status = ACADOS_SUCCESS;
 
             if (opts->print_level > 0)
@@ -671,6 +983,44 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
             return mem->status;
         }
 
+        // stop if another iteration does not fit in the time budget
+        if (opts->time_budget > 0.0)
+        {
+            if (nlp_out->inf_norm_res < best_res)
+            {
+                best_res = nlp_out->inf_norm_res;
+                best_iter = sqp_iter;
+                ocp_nlp_sqp_copy_iterate(dims, nlp_out, work->best_nlp_out);
+            }
+
+            // the rest of this iteration plus the next linearization amount to one iteration
+            if (acados_toc(&timer0) + mem->time_iter_pred > opts->time_budget)
+            {
+                if (best_iter != sqp_iter)
+                    ocp_nlp_sqp_copy_iterate(dims, work->best_nlp_out, nlp_out);
+
+                // save sqp iterations number
+                mem->sqp_iter = sqp_iter;
+                nlp_out->sqp_iter = sqp_iter;
+
+                // stop timer
+                total_time += acados_toc(&timer0);
+
+                // save time
+                mem->time_tot = total_time;
+                nlp_out->total_time = total_time;
+
+                mem->status = ACADOS_TIMEOUT;
+#ifndef ACADOS_SILENT
+                printf("\n ocp_nlp_sqp: time budget exceeded in iteration %d, returning iterate %d\n",
+                       sqp_iter, best_iter);
+#endif
+                return mem->status;
+            }
+        }
+
+        // quasi-Newton Hessian blocks
+        ocp_nlp_sqp_hess_update(dims, opts, mem, sqp_iter);
 
         // regularize Hessian
         acados_tic(&timer1);
@@ -686,12 +1036,43 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
                                          "warm_start", &tmp_int);
         }
 
+        if (opts->inexact_qp)
+            ocp_nlp_sqp_inexact_qp_tol(config, opts, nlp_mem->nlp_res);
+
         // solve qp
         acados_tic(&timer1);
         qp_status = qp_solver->evaluate(qp_solver, dims->qp_solver, nlp_mem->qp_in, nlp_mem->qp_out,
                                         opts->nlp_opts->qp_solver_opts, nlp_mem->qp_solver_mem, nlp_work->qp_work);
+
+        // inexact SQP: on QP failure, solve again in a more robust mode, kept for later iterations
+        while (opts->inexact_qp && (qp_status!=ACADOS_SUCCESS) & (qp_status!=ACADOS_MAXITER) &&
+               mem->qp_mode < ROBUST)
+        {
+            qp_solver->memory_get(qp_solver, nlp_mem->qp_solver_mem, "time_qp_solver_call", &tmp_time);
+            mem->time_qp_solver_call += tmp_time;
+            qp_solver->memory_get(qp_solver, nlp_mem->qp_solver_mem, "time_qp_xcond", &tmp_time);
+            mem->time_qp_xcond += tmp_time;
+
+            mem->qp_mode++;
+            qp_solver->opts_set(qp_solver, opts->nlp_opts->qp_solver_opts, "mode", &mem->qp_mode);
+
+            // the failed solution is no initial guess
+            int tmp_int = 0;
+            qp_solver->opts_set(qp_solver, opts->nlp_opts->qp_solver_opts, "warm_start", &tmp_int);
+            qp_status = qp_solver->evaluate(qp_solver, dims->qp_solver, nlp_mem->qp_in, nlp_mem->qp_out,
+                                            opts->nlp_opts->qp_solver_opts, nlp_mem->qp_solver_mem, nlp_work->qp_work);
+            qp_solver->opts_set(qp_solver, opts->nlp_opts->qp_solver_opts, "warm_start",
+                                sqp_iter==0 && !opts->warm_start_first_qp ? &tmp_int : &opts->qp_warm_start);
+        }
         mem->time_qp_sol += acados_toc(&timer1);
 
+        // log the QP as seen by the QP solver
+        if (opts->snapshot_writer)
+        {
+            ocp_qp_snapshot_write_in(opts->snapshot_writer, nlp_mem->qp_in);
+            ocp_qp_snapshot_write_out(opts->snapshot_writer, nlp_mem->qp_out);
+        }
+
         qp_solver->memory_get(qp_solver, nlp_mem->qp_solver_mem, "time_qp_solver_call", &tmp_time);
         mem->time_qp_solver_call += tmp_time;
         qp_solver->memory_get(qp_solver, nlp_mem->qp_solver_mem, "time_qp_xcond", &tmp_time);
@@ -757,10 +1138,6 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
 #ifndef ACADOS_SILENT
             printf("QP solver returned error status %d in iteration %d\n", qp_status, sqp_iter);
 #endif
-#if defined(ACADOS_WITH_OPENMP)
-            // restore number of threads
-            omp_set_num_threads(num_threads_bkp);
-#endif
 
             if (opts->print_level > 1)
             {
@@ -775,6 +1152,37 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
 
         ocp_nlp_update_variables_sqp(config, dims, nlp_in, nlp_out, nlp_opts, nlp_mem, nlp_work);
 
+        // the filter line search found no acceptable step, the iterate is unchanged
+        if (nlp_mem->filter_failed)
+        {
+            // save sqp iterations number
+            mem->sqp_iter = sqp_iter;
+            nlp_out->sqp_iter = sqp_iter;
+
+            // stop timer
+            total_time += acados_toc(&timer0);
+
+            // save time
+            mem->time_tot = total_time;
+            nlp_out->total_time = total_time;
+
+            mem->status = ACADOS_MINSTEP;
+#ifndef ACADOS_SILENT
+            printf("\n ocp_nlp_sqp: no acceptable step in the filter line search in iteration %d\n",
+                   sqp_iter);
+#endif
+            return mem->status;
+        }
+
+        ocp_nlp_sqp_hess_update_prepare(dims, opts, mem);
+
+        // conservative running estimate of the iteration time (line search and second order
+        // correction included), follows increases immediately
+        tmp_time = acados_toc(&timer0) - time_iter_start;
+        mem->time_iter_pred = 0.5 * (mem->time_iter_pred + tmp_time);
+        if (tmp_time > mem->time_iter_pred)
+            mem->time_iter_pred = tmp_time;
+
         // ocp_nlp_dims_print(nlp_out->dims);
         // ocp_nlp_out_print(nlp_out);
         // exit(1);
@@ -825,10 +1233,6 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
     nlp_out->total_time = total_time;
 
     // maximum number of iterations reached
-#if defined(ACADOS_WITH_OPENMP)
-    // restore number of threads
-    omp_set_num_threads(num_threads_bkp);
-#endif
     mem->status = ACADOS_MAXITER;
 #ifndef ACADOS_SILENT
     printf("\n ocp_nlp_sqp: maximum iterations reached\n");
@@ -839,6 +1243,32 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
 
 
 
+int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
+                void *opts_, void *mem_, void *work_)
+{
+    ocp_nlp_dims *dims = dims_;
+    ocp_nlp_config *config = config_;
+    ocp_nlp_sqp_opts *opts = opts_;
+    ocp_nlp_sqp_memory *mem = mem_;
+    ocp_qp_xcond_solver_config *qp_solver = config->qp_solver;
+
+    if (!opts->inexact_qp)
+        return ocp_nlp_sqp_iterate(config_, dims_, nlp_in_, nlp_out_, opts_, mem_, work_);
+
+    // the inexact SQP overwrites the HPIPM mode and tolerances in the qp solver opts,
+    // restore the ones of the user after the solve
+    int qp_opts_size = qp_solver->opts_calculate_size(qp_solver, dims->qp_solver);
+    void *qp_opts = opts->nlp_opts->qp_solver_opts;
+
+    memcpy(mem->qp_opts_backup, qp_opts, qp_opts_size);
+    int status = ocp_nlp_sqp_iterate(config_, dims_, nlp_in_, nlp_out_, opts_, mem_, work_);
+    memcpy(qp_opts, mem->qp_opts_backup, qp_opts_size);
+
+    return status;
+}
+
+
+
 int ocp_nlp_sqp_precompute(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
                 void *opts_, void *mem_, void *work_)
 {
@@ -1005,6 +1435,11 @@ void ocp_nlp_sqp_get(void *config_, void *dims_, void *mem_, const char *field,
         double *value = return_value_;
         *value = mem->time_reg;
     }
+    else if (!strcmp("time_iter_pred", field))
+    {
+        double *value = return_value_;
+        *value = mem->time_iter_pred;
+    }
     else if (!strcmp("time_sim", field) || !strcmp("time_sim_ad", field) || !strcmp("time_sim_la", field))
     {
         double tmp = 0.0;
@@ -48,6 +48,7 @@ extern "C" {
 
 // acados
 #include "acados/ocp_nlp/ocp_nlp_common.h"
+#include "acados/ocp_qp/ocp_qp_snapshot.h"
 #include "acados/utils/types.h"
 
 
@@ -56,6 +57,14 @@ extern "C" {
  * options
  ************************************************/
 
+/// Quasi-Newton update of the stage Hessian blocks
+typedef enum
+{
+    NO_HESS_UPDATE,  // Hessian as provided by the modules (Gauss-Newton or exact)
+    BFGS_UPDATE,     // damped BFGS
+    SR1_UPDATE,      // SR1, updates that would lose positive definiteness are skipped
+} ocp_nlp_hess_update_t;
+
 typedef struct
 {
     ocp_nlp_opts *nlp_opts;
@@ -70,6 +79,13 @@ typedef struct
     int rti_phase;       // only phase 0 at the moment 
     int print_level;     // verbosity
     int initialize_t_slacks;  // 0-false or 1-true
+    int dyn_sens_reuse;  // number of iterations reusing the dynamics sensitivities (adjoint-based inexact SQP)
+    double time_budget;  // wall time of the solve [s], 0: no limit
+    int inexact_qp;      // QP tolerances from the NLP residuals, HPIPM mode escalated on QP failure
+    double inexact_qp_kappa;    // QP tolerance relative to the NLP residual
+    double inexact_qp_tol_max;  // loosest QP tolerance
+    ocp_qp_snapshot_writer *snapshot_writer;  // if not NULL, every QP and its solution are logged
+    ocp_nlp_hess_update_t *hess_update;  // per stage, N+1 entries
 
 } ocp_nlp_sqp_opts;
 
@@ -104,6 +120,21 @@ typedef struct
     double time_reg;
     double time_tot;
 
+    // predicted wall time of one SQP iteration, kept across calls
+    double time_iter_pred;
+
+    // HPIPM mode (enum hpipm_mode) of the inexact SQP
+    int qp_mode;
+    // qp solver opts of the user, the inexact SQP restores them after the solve
+    void *qp_opts_backup;
+
+    // quasi-Newton Hessian blocks of [u; x] per stage
+    struct blasfeo_dmat *hess_B;
+    struct blasfeo_dvec *hess_s;   // step
+    struct blasfeo_dvec *hess_y;   // gradient difference of the Lagrangian
+    struct blasfeo_dvec *hess_Bs;
+    bool hess_update_ready;  // hess_s and hess_y hold the last step
+
     // statistics
     double *stat;
     int stat_m;
@@ -137,6 +168,9 @@ typedef struct
     ocp_qp_res *qp_res;
     ocp_qp_res_ws *qp_res_ws;
 
+    // best iterate w.r.t. inf_norm_res, returned on timeout
+    ocp_nlp_out *best_nlp_out;
+
 } ocp_nlp_sqp_workspace;
 
 //
@@ -40,9 +40,6 @@
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
-#if defined(ACADOS_WITH_OPENMP)
-#include <omp.h>
-#endif
 
 // blasfeo
 #include "blasfeo/include/blasfeo_d_aux.h"
@@ -52,6 +49,7 @@
 #include "acados/ocp_nlp/ocp_nlp_common.h"
 #include "acados/ocp_nlp/ocp_nlp_dynamics_cont.h"
 #include "acados/ocp_nlp/ocp_nlp_reg_common.h"
+#include "acados/ocp_nlp/ocp_nlp_reg_convexify.h"
 #include "acados/ocp_qp/ocp_qp_common.h"
 #include "acados/utils/mem.h"
 #include "acados/utils/print.h"
@@ -125,6 +123,8 @@ void ocp_nlp_sqp_rti_opts_initialize_default(void *config_,
     opts->ext_qp_res = 0;
     opts->warm_start_first_qp = false;
     opts->rti_phase = 0;
+    opts->cond_in_prep = 0;
+    opts->rti_level = 3;
     opts->print_level = 0;
 
     // overwrite default submodules opts
@@ -221,6 +221,22 @@ void ocp_nlp_sqp_rti_opts_set(void *config_, void *opts_,
                 exit(1);
             } else opts->rti_phase = *rti_phase;
         }
+        else if (!strcmp(field, "cond_in_prep"))
+        {
+            int* cond_in_prep = (int *) value;
+            opts->cond_in_prep = *cond_in_prep;
+        }
+        else if (!strcmp(field, "rti_level"))
+        {
+            int* rti_level = (int *) value;
+            if (*rti_level < 0 || *rti_level > 3)
+            {
+                printf("\nerror: ocp_nlp_sqp_rti_opts_set: invalid value for rti_level field.");
+                printf("possible values are: 0 (A), 1 (B), 2 (C), 3 (D)\n");
+                exit(1);
+            }
+            opts->rti_level = *rti_level;
+        }
         else if (!strcmp(field, "print_level"))
         {
             int* print_level = (int *) value;
@@ -275,15 +291,24 @@ int ocp_nlp_sqp_rti_memory_calculate_size(void *config_,
     // ocp_nlp_cost_config **cost = config->cost;
     // ocp_nlp_constraints_config **constraints = config->constraints;
 
-    // int N = dims->N;
-    // int *nx = dims->nx;
-    // int *nu = dims->nu;
+    int N = dims->N;
+    int *nv = dims->nv;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
     // int *nz = dims->nz;
 
     int size = 0;
 
     size += sizeof(ocp_nlp_sqp_rti_memory);
 
+    // ux_lin adj_corr
+    size += 2*(N+1)*sizeof(struct blasfeo_dvec);
+    for (int ii = 0; ii <= N; ii++)
+    {
+        size += blasfeo_memsize_dvec(nv[ii]);  // ux_lin
+        size += blasfeo_memsize_dvec(nu[ii]+nx[ii]);  // adj_corr
+    }
+
     // nlp mem
     size += ocp_nlp_memory_calculate_size(config, dims, nlp_opts);
 
@@ -295,6 +320,7 @@ int ocp_nlp_sqp_rti_memory_calculate_size(void *config_,
     size += stat_n*stat_m*sizeof(double);
 
     size += 8;  // initial align
+    size += 64;  // blasfeo_mem align
 
     make_int_multiple_of(8, &size);
 
@@ -318,11 +344,12 @@ void *ocp_nlp_sqp_rti_memory_assign(void *config_, void *dims_,
 
     char *c_ptr = (char *) raw_memory;
 
-    // int ii;
+    int ii;
 
-    // int N = dims->N;
-    // int *nx = dims->nx;
-    // int *nu = dims->nu;
+    int N = dims->N;
+    int *nv = dims->nv;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
     // int *nz = dims->nz;
 
     // initial align
@@ -343,6 +370,21 @@ void *ocp_nlp_sqp_rti_memory_assign(void *config_, void *dims_,
         mem->stat_n += 4;
     c_ptr += mem->stat_m*mem->stat_n*sizeof(double);
 
+    // ux_lin adj_corr
+    assign_and_advance_blasfeo_dvec_structs(N+1, &mem->ux_lin, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N+1, &mem->adj_corr, &c_ptr);
+
+    align_char_to(64, &c_ptr);
+
+    for (ii = 0; ii <= N; ii++)
+    {
+        assign_and_advance_blasfeo_dvec_mem(nv[ii], mem->ux_lin+ii, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(nu[ii]+nx[ii], mem->adj_corr+ii, &c_ptr);
+    }
+
+    mem->qp_lin_valid = 0;
+    mem->adj_corr_valid = 0;
+
     mem->status = ACADOS_READY;
 
     assert((char *) raw_memory+ocp_nlp_sqp_rti_memory_calculate_size(
@@ -388,6 +430,29 @@ int ocp_nlp_sqp_rti_workspace_calculate_size(void *config_,
         size += ocp_qp_res_workspace_calculate_size(dims->qp_solver->orig_dims);
     }
 
+    // multi-level iteration
+    int N = dims->N;
+    int *nv = dims->nv;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
+    int *ni = dims->ni;
+    int *ng = dims->qp_solver->orig_dims->ng;
+
+    size += 2*(N+1)*sizeof(struct blasfeo_dvec);  // tmp_dux tmp_ni
+    size += 3*(N+1)*sizeof(struct blasfeo_dmat);  // tmp_RSQrq tmp_BAbt tmp_DCt
+    for (int ii = 0; ii <= N; ii++)
+    {
+        size += blasfeo_memsize_dvec(nv[ii]);  // tmp_dux
+        size += blasfeo_memsize_dvec(ni[ii]);  // tmp_ni
+        size += blasfeo_memsize_dmat(nu[ii]+nx[ii]+1, nu[ii]+nx[ii]);  // tmp_RSQrq
+        size += blasfeo_memsize_dmat(nu[ii]+nx[ii], ng[ii]);  // tmp_DCt
+    }
+    for (int ii = 0; ii < N; ii++)
+        size += blasfeo_memsize_dmat(nu[ii]+nx[ii]+1, nx[ii+1]);  // tmp_BAbt
+
+    size += 8;  // blasfeo_struct align
+    size += 64;  // blasfeo_mem align
+
     return size;
 }
 
@@ -430,6 +495,39 @@ static void ocp_nlp_sqp_rti_cast_workspace(
             dims->qp_solver->orig_dims);
     }
 
+    // multi-level iteration
+    int N = dims->N;
+    int *nv = dims->nv;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
+    int *ni = dims->ni;
+    int *ng = dims->qp_solver->orig_dims->ng;
+
+    align_char_to(8, &c_ptr);
+
+    assign_and_advance_blasfeo_dvec_structs(N+1, &work->tmp_dux, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N+1, &work->tmp_ni, &c_ptr);
+    assign_and_advance_blasfeo_dmat_structs(N+1, &work->tmp_RSQrq, &c_ptr);
+    assign_and_advance_blasfeo_dmat_structs(N+1, &work->tmp_BAbt, &c_ptr);
+    assign_and_advance_blasfeo_dmat_structs(N+1, &work->tmp_DCt, &c_ptr);
+
+    align_char_to(64, &c_ptr);
+
+    // matrices first, to keep them 64-byte aligned
+    for (int ii = 0; ii <= N; ii++)
+    {
+        assign_and_advance_blasfeo_dmat_mem(nu[ii]+nx[ii]+1, nu[ii]+nx[ii], work->tmp_RSQrq+ii, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nu[ii]+nx[ii], ng[ii], work->tmp_DCt+ii, &c_ptr);
+    }
+    for (int ii = 0; ii < N; ii++)
+        assign_and_advance_blasfeo_dmat_mem(nu[ii]+nx[ii]+1, nx[ii+1], work->tmp_BAbt+ii, &c_ptr);
+
+    for (int ii = 0; ii <= N; ii++)
+    {
+        assign_and_advance_blasfeo_dvec_mem(nv[ii], work->tmp_dux+ii, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(ni[ii], work->tmp_ni+ii, &c_ptr);
+    }
+
     assert((char *) work + ocp_nlp_sqp_rti_workspace_calculate_size(config,
         dims, opts) >= c_ptr);
 
@@ -498,6 +596,228 @@ int ocp_nlp_sqp_rti(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
 
 
 
+// z += A * x, with A symmetric and only its lower triangle stored
+static void ocp_nlp_sqp_rti_symv_l_acc(int n, struct blasfeo_dmat *A, struct blasfeo_dvec *x,
+    struct blasfeo_dvec *z)
+{
+    int ii, jj;
+    double a;
+
+    for (jj = 0; jj < n; jj++)
+    {
+        BLASFEO_DVECEL(z, jj) += BLASFEO_DMATEL(A, jj, jj) * BLASFEO_DVECEL(x, jj);
+        for (ii = jj+1; ii < n; ii++)
+        {
+            a = BLASFEO_DMATEL(A, ii, jj);
+            BLASFEO_DVECEL(z, ii) += a * BLASFEO_DVECEL(x, jj);
+            BLASFEO_DVECEL(z, jj) += a * BLASFEO_DVECEL(x, ii);
+        }
+    }
+}
+
+
+
+// multi-level iteration levels A, B and C: keep the QP matrices of the last level D
+// preparation and update the QP vectors at the current iterate,
+// either from the QP model (A), or from new residuals (B),
+// or from new residuals, new objective gradient and the adjoint-based correction
+// (J_old - J)' * lambda of the stale Jacobians (C)
+static void ocp_nlp_sqp_rti_update_qp_vectors_mli(ocp_nlp_config *config, ocp_nlp_dims *dims,
+    ocp_nlp_in *nlp_in, ocp_nlp_out *nlp_out, ocp_nlp_sqp_rti_opts *opts,
+    ocp_nlp_sqp_rti_memory *mem, ocp_nlp_sqp_rti_workspace *work)
+{
+    ocp_nlp_opts *nlp_opts = opts->nlp_opts;
+    ocp_nlp_memory *nlp_mem = mem->nlp_mem;
+    ocp_nlp_workspace *nlp_work = work->nlp_work;
+    ocp_qp_in *qp_in = nlp_mem->qp_in;
+
+    int N = dims->N;
+    int *nv = dims->nv;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
+    int *ni = dims->ni;
+    int *ns = dims->ns;
+    int *nb = qp_in->dim->nb;
+    int *ng = qp_in->dim->ng;
+
+    int level = opts->rti_level;
+
+    int ii, jj;
+
+    // the module function values are overwritten by the first order models below
+    ocp_nlp_fun_key_invalidate(dims, nlp_mem);
+
+    // step from the point of the last update
+#if defined(ACADOS_WITH_OPENMP)
+    #pragma omp parallel for num_threads(nlp_opts->num_threads)
+#endif
+    for (ii = 0; ii <= N; ii++)
+    {
+        blasfeo_daxpy(nv[ii], -1.0, mem->ux_lin+ii, 0, nlp_out->ux+ii, 0, work->tmp_dux+ii, 0);
+        // evaluation point of compute_fun
+        blasfeo_dveccp(nv[ii], nlp_out->ux+ii, 0, nlp_work->tmp_nlp_out->ux+ii, 0);
+    }
+
+#if defined(ACADOS_WITH_OPENMP)
+    #pragma omp parallel for num_threads(nlp_opts->num_threads) private(jj)
+#endif
+    for (ii = 0; ii <= N; ii++)
+    {
+        struct blasfeo_dvec *cost_grad = config->cost[ii]->memory_get_grad_ptr(nlp_mem->cost[ii]);
+        struct blasfeo_dvec *ineq_fun =
+            config->constraints[ii]->memory_get_fun_ptr(nlp_mem->constraints[ii]);
+        struct blasfeo_dvec *dux = work->tmp_dux+ii;
+
+        int nbg = ni[ii] - ns[ii];
+
+        // objective gradient
+        if (level == 2)
+        {
+            // the modules write the exact QP matrices at the current iterate,
+            // keep the ones of the last level D
+            blasfeo_dgecp(nu[ii]+nx[ii]+1, nu[ii]+nx[ii], qp_in->RSQrq+ii, 0, 0,
+                work->tmp_RSQrq+ii, 0, 0);
+            if (ii < N)
+                blasfeo_dgecp(nu[ii]+nx[ii]+1, nx[ii+1], qp_in->BAbt+ii, 0, 0,
+                    work->tmp_BAbt+ii, 0, 0);
+            blasfeo_dgecp(nu[ii]+nx[ii], ng[ii], qp_in->DCt+ii, 0, 0, work->tmp_DCt+ii, 0, 0);
+
+            config->cost[ii]->update_qp_matrices(config->cost[ii], dims->cost[ii],
+                nlp_in->cost[ii], nlp_opts->cost[ii], nlp_mem->cost[ii], nlp_work->cost[ii]);
+        }
+        else
+        {
+            // first order model of the gradient: g += H * dux
+            ocp_nlp_sqp_rti_symv_l_acc(nu[ii]+nx[ii], qp_in->RSQrq+ii, dux, cost_grad);
+            blasfeo_dvecmulacc(2*ns[ii], qp_in->Z+ii, 0, dux, nu[ii]+nx[ii], cost_grad, nu[ii]+nx[ii]);
+        }
+
+        if (level == 0)
+        {
+            // dynamics residual: b += BAbt' * dux - dx1
+            if (ii < N)
+            {
+                struct blasfeo_dvec *dyn_fun =
+                    config->dynamics[ii]->memory_get_fun_ptr(nlp_mem->dynamics[ii]);
+                blasfeo_dgemv_t(nu[ii]+nx[ii], nx[ii+1], 1.0, qp_in->BAbt+ii, 0, 0, dux, 0,
+                    1.0, dyn_fun, 0, dyn_fun, 0);
+                blasfeo_daxpy(nx[ii+1], -1.0, work->tmp_dux+ii+1, nu[ii+1], dyn_fun, 0,
+                    dyn_fun, 0);
+            }
+
+            // inequality residuals: lower -= D * dux, upper += D * dux
+            blasfeo_dvecex_sp(nb[ii], 1.0, qp_in->idxb[ii], dux, 0, work->tmp_ni+ii, 0);
+            blasfeo_dgemv_t(nu[ii]+nx[ii], nbg-nb[ii], 1.0, qp_in->DCt+ii, 0, 0, dux, 0,
+                0.0, work->tmp_ni+ii, nb[ii], work->tmp_ni+ii, nb[ii]);
+            blasfeo_daxpy(nbg, -1.0, work->tmp_ni+ii, 0, ineq_fun, 0, ineq_fun, 0);
+            blasfeo_daxpy(nbg, 1.0, work->tmp_ni+ii, 0, ineq_fun, nbg, ineq_fun, nbg);
+
+            // soft constraints
+            for (jj = 0; jj < nbg; jj++)
+            {
+                int js = qp_in->idxs_rev[ii][jj];
+                if (js >= 0)
+                {
+                    BLASFEO_DVECEL(ineq_fun, jj) -= BLASFEO_DVECEL(dux, nu[ii]+nx[ii]+js);
+                    BLASFEO_DVECEL(ineq_fun, nbg+jj) -= BLASFEO_DVECEL(dux, nu[ii]+nx[ii]+ns[ii]+js);
+                }
+            }
+            blasfeo_daxpy(2*ns[ii], -1.0, dux, nu[ii]+nx[ii], ineq_fun, 2*nbg, ineq_fun, 2*nbg);
+        }
+        else if (level == 1)
+        {
+            // new residuals at the current iterate
+            if (ii < N)
+                config->dynamics[ii]->compute_fun(config->dynamics[ii], dims->dynamics[ii],
+                    nlp_in->dynamics[ii], nlp_opts->dynamics[ii], nlp_mem->dynamics[ii],
+                    nlp_work->dynamics[ii]);
+
+            config->constraints[ii]->compute_fun(config->constraints[ii], dims->constraints[ii],
+                nlp_in->constraints[ii], nlp_opts->constraints[ii], nlp_mem->constraints[ii],
+                nlp_work->constraints[ii]);
+        }
+        else
+        {
+            // new residuals and exact adjoints at the current iterate
+            if (ii < N)
+                config->dynamics[ii]->compute_fun_and_adj(config->dynamics[ii],
+                    dims->dynamics[ii], nlp_in->dynamics[ii], nlp_opts->dynamics[ii],
+                    nlp_mem->dynamics[ii], nlp_work->dynamics[ii]);
+
+            config->constraints[ii]->update_qp_matrices(config->constraints[ii],
+                dims->constraints[ii], nlp_in->constraints[ii], nlp_opts->constraints[ii],
+                nlp_mem->constraints[ii], nlp_work->constraints[ii]);
+
+            // adjoint-based gradient correction (J_old - J)' * lambda
+            struct blasfeo_dvec *adj_corr = mem->adj_corr+ii;
+            blasfeo_dvecse(nu[ii]+nx[ii], 0.0, adj_corr, 0);
+
+            // dynamics: the adjoint of the module is -J' * pi
+            if (ii < N)
+            {
+                struct blasfeo_dvec *dyn_adj =
+                    config->dynamics[ii]->memory_get_adj_ptr(nlp_mem->dynamics[ii]);
+                blasfeo_daxpy(nu[ii]+nx[ii], -1.0, dyn_adj, 0, adj_corr, 0, adj_corr, 0);
+                blasfeo_dgemv_n(nu[ii]+nx[ii], nx[ii+1], -1.0, work->tmp_BAbt+ii, 0, 0,
+                    nlp_out->pi+ii, 0, 1.0, adj_corr, 0, adj_corr, 0);
+            }
+
+            // general and nonlinear constraints: multipliers lam_lg - lam_ug
+            blasfeo_daxpy(ng[ii], -1.0, nlp_out->lam+ii, nbg+nb[ii], nlp_out->lam+ii, nb[ii],
+                work->tmp_ni+ii, 0);
+            blasfeo_dgemv_n(nu[ii]+nx[ii], ng[ii], 1.0, work->tmp_DCt+ii, 0, 0, work->tmp_ni+ii, 0,
+                1.0, adj_corr, 0, adj_corr, 0);
+            blasfeo_dgemv_n(nu[ii]+nx[ii], ng[ii], -1.0, qp_in->DCt+ii, 0, 0, work->tmp_ni+ii, 0,
+                1.0, adj_corr, 0, adj_corr, 0);
+
+            // restore the QP matrices of the last level D
+            blasfeo_dgecp(nu[ii]+nx[ii]+1, nu[ii]+nx[ii], work->tmp_RSQrq+ii, 0, 0,
+                qp_in->RSQrq+ii, 0, 0);
+            if (ii < N)
+                blasfeo_dgecp(nu[ii]+nx[ii]+1, nx[ii+1], work->tmp_BAbt+ii, 0, 0,
+                    qp_in->BAbt+ii, 0, 0);
+            blasfeo_dgecp(nu[ii]+nx[ii], ng[ii], work->tmp_DCt+ii, 0, 0, qp_in->DCt+ii, 0, 0);
+
+            // nlp mem: ineq_adj
+            blasfeo_dveccp(nv[ii],
+                config->constraints[ii]->memory_get_adj_ptr(nlp_mem->constraints[ii]), 0,
+                nlp_mem->ineq_adj+ii, 0);
+        }
+
+        // nlp mem: cost_grad, dyn_fun, ineq_fun
+        blasfeo_dveccp(nv[ii], cost_grad, 0, nlp_mem->cost_grad+ii, 0);
+        if (ii < N)
+            blasfeo_dveccp(nx[ii+1],
+                config->dynamics[ii]->memory_get_fun_ptr(nlp_mem->dynamics[ii]), 0,
+                nlp_mem->dyn_fun+ii, 0);
+        blasfeo_dveccp(2*ni[ii], ineq_fun, 0, nlp_mem->ineq_fun+ii, 0);
+    }
+
+    // nlp mem: dyn_adj
+    if (level == 2)
+    {
+        for (ii = 0; ii <= N; ii++)
+        {
+            if (ii < N)
+                blasfeo_dveccp(nu[ii]+nx[ii],
+                    config->dynamics[ii]->memory_get_adj_ptr(nlp_mem->dynamics[ii]), 0,
+                    nlp_mem->dyn_adj+ii, 0);
+            else
+                blasfeo_dvecse(nu[N]+nx[N], 0.0, nlp_mem->dyn_adj+N, 0);
+            if (ii > 0)
+                blasfeo_daxpy(nx[ii], 1.0,
+                    config->dynamics[ii-1]->memory_get_adj_ptr(nlp_mem->dynamics[ii-1]),
+                    nu[ii-1]+nx[ii-1], nlp_mem->dyn_adj+ii, nu[ii], nlp_mem->dyn_adj+ii, nu[ii]);
+        }
+    }
+
+    mem->adj_corr_valid = level == 2;
+
+    return;
+}
+
+
+
 void ocp_nlp_sqp_rti_preparation_step(void *config_, void *dims_,
     void *nlp_in_, void *nlp_out_, void *opts_, void *mem_, void *work_)
 {
@@ -511,32 +831,22 @@ void ocp_nlp_sqp_rti_preparation_step(void *config_, void *dims_,
     ocp_nlp_in *nlp_in = nlp_in_;
     ocp_nlp_out *nlp_out = nlp_out_;
     ocp_nlp_memory *nlp_mem = mem->nlp_mem;
-    // ocp_qp_xcond_solver_config *qp_solver = config->qp_solver;
+    ocp_qp_xcond_solver_config *qp_solver = config->qp_solver;
 
     ocp_nlp_sqp_rti_workspace *work = work_;
     ocp_nlp_sqp_rti_cast_workspace(config, dims, opts, mem, work);
     ocp_nlp_workspace *nlp_work = work->nlp_work;
 
+    double tmp_time;
     mem->time_lin = 0.0;
     mem->time_reg = 0.0;
+    mem->time_qp_xcond = 0.0;
 
     int N = dims->N;
 
     int ii;
 
-#if defined(ACADOS_WITH_OPENMP)
-    // backup number of threads
-    int num_threads_bkp = omp_get_num_threads();
-    // set number of threads
-    omp_set_num_threads(opts->nlp_opts->num_threads);
-    #pragma omp parallel
-    { // beginning of parallel region
-#endif
-
     // alias to dynamics_memory
-#if defined(ACADOS_WITH_OPENMP)
-    #pragma omp for nowait
-#endif
     for (ii = 0; ii < N; ii++)
     {
         config->dynamics[ii]->memory_set_ux_ptr(
@@ -575,9 +885,6 @@ void ocp_nlp_sqp_rti_preparation_step(void *config_, void *dims_,
     }
 
     // alias to cost_memory
-#if defined(ACADOS_WITH_OPENMP)
-    #pragma omp for nowait
-#endif
     for (ii = 0; ii <= N; ii++)
     {
         config->cost[ii]->memory_set_ux_ptr(
@@ -600,9 +907,6 @@ void ocp_nlp_sqp_rti_preparation_step(void *config_, void *dims_,
     }
 
     // alias to constraints_memory
-#if defined(ACADOS_WITH_OPENMP)
-    #pragma omp for nowait
-#endif
     for (ii = 0; ii <= N; ii++)
     {
         config->constraints[ii]->memory_set_ux_ptr(
@@ -668,10 +972,6 @@ void ocp_nlp_sqp_rti_preparation_step(void *config_, void *dims_,
         dims->regularize, nlp_mem->qp_out->lam, nlp_mem->regularize_mem);
 
     // copy sampling times into dynamics model
-#if defined(ACADOS_WITH_OPENMP)
-    #pragma omp for nowait
-#endif
-
     // NOTE(oj): this will lead in an error for irk_gnsf, T must be set in precompute;
     //    -> remove here and make sure precompute is called everywhere (e.g. Python interface).
     for (ii = 0; ii < N; ii++)
@@ -680,10 +980,6 @@ void ocp_nlp_sqp_rti_preparation_step(void *config_, void *dims_,
                                          nlp_in->dynamics[ii], "T", nlp_in->Ts+ii);
     }
 
-#if defined(ACADOS_WITH_OPENMP)
-    } // end of parallel region
-#endif
-
     // initialize QP
     ocp_nlp_initialize_qp(config, dims, nlp_in, nlp_out, nlp_opts, nlp_mem, nlp_work);
 
@@ -691,18 +987,56 @@ void ocp_nlp_sqp_rti_preparation_step(void *config_, void *dims_,
     int sqp_iter = 0;
     nlp_mem->sqp_iter = &sqp_iter;
 
-    // linearizate NLP and update QP matrices
+    // convexify modifies the gradient and dynamics rhs, which are only known in feedback
+    if ((opts->cond_in_prep || opts->rti_level < 3) &&
+        config->regularize->regularize_hessian == &ocp_nlp_reg_convexify_regularize_hessian)
+    {
+        printf("\nerror: ocp_nlp_sqp_rti: cond_in_prep and rti_level < 3 not supported with CONVEXIFY regularization\n");
+        exit(1);
+    }
+
+    // levels A-C need the QP matrices of a previous full linearization
+    int full_lin = opts->rti_level == 3 || !mem->qp_lin_valid;
+
     acados_tic(&timer1);
-    ocp_nlp_approximate_qp_matrices(config, dims, nlp_in,
-        nlp_out, nlp_opts, nlp_mem, nlp_work);
+    if (full_lin)
+    {
+        // linearizate NLP and update QP matrices
+        ocp_nlp_approximate_qp_matrices(config, dims, nlp_in,
+            nlp_out, nlp_opts, nlp_mem, nlp_work);
+
+        mem->qp_lin_valid = 1;
+        mem->adj_corr_valid = 0;
+    }
+    else
+    {
+        // keep QP matrices, update QP vectors
+        ocp_nlp_sqp_rti_update_qp_vectors_mli(config, dims, nlp_in, nlp_out, opts, mem, work);
+    }
+
+    for (ii = 0; ii <= N; ii++)
+        blasfeo_dveccp(dims->nv[ii], nlp_out->ux+ii, 0, mem->ux_lin+ii, 0);
 
     mem->time_lin += acados_toc(&timer1);
 
-#if defined(ACADOS_WITH_OPENMP)
-    // restore number of threads
-    omp_set_num_threads(num_threads_bkp);
-#endif
-	
+    // matrices are unchanged (and regularized) after levels A-C
+    if (opts->cond_in_prep && full_lin)
+    {
+
+        // regularize Hessian
+        acados_tic(&timer1);
+        config->regularize->regularize_hessian(config->regularize,
+            dims->regularize, opts->nlp_opts->regularize, nlp_mem->regularize_mem);
+        mem->time_reg += acados_toc(&timer1);
+
+        // condense QP matrices
+        qp_solver->condense_lhs(qp_solver, dims->qp_solver, nlp_mem->qp_in,
+            opts->nlp_opts->qp_solver_opts, nlp_mem->qp_solver_mem, nlp_work->qp_work);
+
+        qp_solver->memory_get(qp_solver, nlp_mem->qp_solver_mem, "time_qp_xcond", &tmp_time);
+        mem->time_qp_xcond += tmp_time;
+    }
+
 	return;
 
 }
@@ -733,7 +1067,8 @@ void ocp_nlp_sqp_rti_feedback_step(void *config_, void *dims_,
     double tmp_time;
     mem->time_qp_sol = 0.0;
     mem->time_qp_solver_call = 0.0;
-    mem->time_qp_xcond = 0.0;
+    if (!opts->cond_in_prep)
+        mem->time_qp_xcond = 0.0;
 
     // embed initial value (this actually updates all bounds at stage 0...)
     ocp_nlp_embed_initial_value(config, dims, nlp_in,
@@ -743,11 +1078,22 @@ void ocp_nlp_sqp_rti_feedback_step(void *config_, void *dims_,
     ocp_nlp_approximate_qp_vectors_sqp(config, dims, nlp_in,
         nlp_out, nlp_opts, nlp_mem, nlp_work);
 
-    // regularize Hessian
-    acados_tic(&timer1);
-    config->regularize->regularize_hessian(config->regularize,
-        dims->regularize, opts->nlp_opts->regularize, nlp_mem->regularize_mem);
-    mem->time_reg += acados_toc(&timer1);
+    // level C: adjoint-based gradient correction for the QP matrices of the last level D
+    if (mem->adj_corr_valid)
+    {
+        for (int ii = 0; ii <= dims->N; ii++)
+            blasfeo_daxpy(dims->nu[ii]+dims->nx[ii], 1.0, mem->adj_corr+ii, 0,
+                nlp_mem->qp_in->rqz+ii, 0, nlp_mem->qp_in->rqz+ii, 0);
+    }
+
+    // regularize Hessian (done in preparation if cond_in_prep)
+    if (!opts->cond_in_prep)
+    {
+        acados_tic(&timer1);
+        config->regularize->regularize_hessian(config->regularize,
+            dims->regularize, opts->nlp_opts->regularize, nlp_mem->regularize_mem);
+        mem->time_reg += acados_toc(&timer1);
+    }
 
     if (opts->print_level > 0) {
         printf("\n------- qp_in --------\n");
@@ -763,9 +1109,19 @@ void ocp_nlp_sqp_rti_feedback_step(void *config_, void *dims_,
 
     // solve qp
     acados_tic(&timer1);
-    qp_status = qp_solver->evaluate(qp_solver, dims->qp_solver,
-        nlp_mem->qp_in, nlp_mem->qp_out, opts->nlp_opts->qp_solver_opts,
-        nlp_mem->qp_solver_mem, nlp_work->qp_work);
+    if (opts->cond_in_prep)
+    {
+        // matrices have been condensed in preparation step
+        qp_status = qp_solver->condense_rhs_and_solve(qp_solver, dims->qp_solver,
+            nlp_mem->qp_in, nlp_mem->qp_out, opts->nlp_opts->qp_solver_opts,
+            nlp_mem->qp_solver_mem, nlp_work->qp_work);
+    }
+    else
+    {
+        qp_status = qp_solver->evaluate(qp_solver, dims->qp_solver,
+            nlp_mem->qp_in, nlp_mem->qp_out, opts->nlp_opts->qp_solver_opts,
+            nlp_mem->qp_solver_mem, nlp_work->qp_work);
+    }
 
     mem->time_qp_sol += acados_toc(&timer1);
 
@@ -825,6 +1181,13 @@ void ocp_nlp_sqp_rti_feedback_step(void *config_, void *dims_,
 
     // print_ocp_qp_in(mem->qp_in);
 
+    // the filter line search found no acceptable step, the iterate is unchanged
+    if (nlp_mem->filter_failed)
+    {
+        mem->status = ACADOS_MINSTEP;
+        return;
+    }
+
     mem->status = ACADOS_SUCCESS;
 
 }
@@ -64,6 +64,8 @@ typedef struct
     int qp_warm_start;        // NOTE: this is not actually setting the warm_start! Just for compatibility with sqp.
     bool warm_start_first_qp; // to set qp_warm_start in first iteration
     int rti_phase;            // phase of RTI. Possible values 1 (preparation), 2 (feedback) 0 (both)
+    int cond_in_prep;         // regularize and condense QP matrices in preparation, only rhs in feedback
+    int rti_level;            // multi-level iteration in preparation: 0 (A), 1 (B), 2 (C), 3 (D, full)
     int print_level;     // verbosity
 
 } ocp_nlp_sqp_rti_opts;
@@ -107,6 +109,12 @@ typedef struct
 
     int status;
 
+    // multi-level iteration
+    struct blasfeo_dvec *ux_lin;  // iterate at which the QP vectors were last updated
+    int qp_lin_valid;             // QP matrices available from a previous level D preparation
+    struct blasfeo_dvec *adj_corr;  // level C gradient correction (J_old - J)' * lambda
+    int adj_corr_valid;             // adj_corr belongs to the last preparation
+
 } ocp_nlp_sqp_rti_memory;
 
 //
@@ -133,6 +141,12 @@ typedef struct
     ocp_qp_res *qp_res;
     ocp_qp_res_ws *qp_res_ws;
 
+    // multi-level iteration
+    struct blasfeo_dvec *tmp_dux;    // ux - ux_lin
+    struct blasfeo_dvec *tmp_ni;     // linearized change of the constraints
+    struct blasfeo_dmat *tmp_RSQrq;  // backup of the Hessian in level C
+    struct blasfeo_dmat *tmp_BAbt;   // backup of the dynamics Jacobian in level C
+    struct blasfeo_dmat *tmp_DCt;    // backup of the constraints Jacobian in level C
 
 } ocp_nlp_sqp_rti_workspace;
 
@@ -172,6 +172,7 @@ int ocp_qp_in_calculate_size(ocp_qp_dims *dims)
     int size = sizeof(ocp_qp_in);
     size += d_ocp_qp_memsize(dims);
     size += ocp_qp_dims_calculate_size(dims->N);  // TODO(all): remove !!!
+    size += (1 + OCP_QP_IN_NUM_BLOCKS*(dims->N+1))*sizeof(long long);  // generation, stamps
     size += 2*8; // aligns
 
     make_int_multiple_of(8, &size);
@@ -200,6 +201,13 @@ ocp_qp_in *ocp_qp_in_assign(ocp_qp_dims *dims, void *raw_memory)
 
     qp_in->dim = dims_copy;
 
+    // generation and per-stage block stamps, right after the dims copy (see ocp_qp_in_stamps)
+    long long *stamps = (long long *) c_ptr;
+    c_ptr += (1 + OCP_QP_IN_NUM_BLOCKS*(dims->N+1))*sizeof(long long);
+
+    for (int ii = 0; ii < 1 + OCP_QP_IN_NUM_BLOCKS*(dims->N+1); ii++)
+        stamps[ii] = 0;
+
     assert((char *) raw_memory + ocp_qp_in_calculate_size(dims) >= c_ptr);
 
     return qp_in;
@@ -207,6 +215,108 @@ ocp_qp_in *ocp_qp_in_assign(ocp_qp_dims *dims, void *raw_memory)
 
 
 
+// generation, followed by the stamps of the blocks of stage 0, 1, ..., N
+static long long *ocp_qp_in_stamps(const ocp_qp_in *qp_in)
+{
+    return (long long *) ((char *) qp_in->dim + ocp_qp_dims_calculate_size(qp_in->dim->N));
+}
+
+
+
+long long ocp_qp_in_generation(const ocp_qp_in *qp_in)
+{
+    return ocp_qp_in_stamps(qp_in)[0];
+}
+
+
+
+void ocp_qp_in_mark_changed(ocp_qp_in *qp_in, int stage, int blocks)
+{
+    long long *stamps = ocp_qp_in_stamps(qp_in);
+    long long *stage_stamps = stamps + 1 + OCP_QP_IN_NUM_BLOCKS*stage;
+
+    stamps[0]++;
+
+    for (int jj = 0; jj < OCP_QP_IN_NUM_BLOCKS; jj++)
+    {
+        if (blocks & (1 << jj))
+            stage_stamps[jj] = stamps[0];
+    }
+}
+
+
+
+void ocp_qp_in_mark_changed_all(ocp_qp_in *qp_in, int blocks)
+{
+    long long *stamps = ocp_qp_in_stamps(qp_in);
+
+    stamps[0]++;
+
+    for (int ii = 0; ii <= qp_in->dim->N; ii++)
+    {
+        for (int jj = 0; jj < OCP_QP_IN_NUM_BLOCKS; jj++)
+        {
+            if (blocks & (1 << jj))
+                stamps[1 + OCP_QP_IN_NUM_BLOCKS*ii + jj] = stamps[0];
+        }
+    }
+}
+
+
+
+bool ocp_qp_in_stage_changed(const ocp_qp_in *qp_in, int stage, int blocks, long long since)
+{
+    long long *stage_stamps = ocp_qp_in_stamps(qp_in) + 1 + OCP_QP_IN_NUM_BLOCKS*stage;
+
+    for (int jj = 0; jj < OCP_QP_IN_NUM_BLOCKS; jj++)
+    {
+        if ((blocks & (1 << jj)) && stage_stamps[jj] > since)
+            return true;
+    }
+
+    return false;
+}
+
+
+
+bool ocp_qp_in_changed(const ocp_qp_in *qp_in, int blocks, long long since)
+{
+    for (int ii = 0; ii <= qp_in->dim->N; ii++)
+    {
+        if (ocp_qp_in_stage_changed(qp_in, ii, blocks, since))
+            return true;
+    }
+
+    return false;
+}
+
+
+
+int ocp_qp_in_field_block(const char *field)
+{
+    if (!strcmp(field, "A") || !strcmp(field, "B"))
+    {
+        return OCP_QP_IN_DYN_MAT;
+    }
+    else if (!strcmp(field, "Q") || !strcmp(field, "S") || !strcmp(field, "R") ||
+             !strcmp(field, "Z") || !strcmp(field, "Zl") || !strcmp(field, "Zu"))
+    {
+        return OCP_QP_IN_COST_MAT;
+    }
+    else if (!strcmp(field, "C") || !strcmp(field, "D") || !strncmp(field, "idx", 3) ||
+             field[0] == 'J')
+    {
+        // constraint matrices, bound and slack indices (Jbx, Jsbu, idxb, idxs, ...)
+        return OCP_QP_IN_CON_MAT;
+    }
+    else
+    {
+        return OCP_QP_IN_VEC;
+    }
+}
+
+
+
 /************************************************
  * out
  ************************************************/
@@ -611,7 +721,7 @@ void ocp_qp_stack_slacks(ocp_qp_in *in, ocp_qp_in *out)
 void ocp_qp_compute_t(ocp_qp_in *qp_in, ocp_qp_out *qp_out)
 {
     // loop index
-    int ii;
+    int ii, jj;
 
     //
     int N = qp_in->dim->N;
@@ -619,15 +729,17 @@ void ocp_qp_compute_t(ocp_qp_in *qp_in, ocp_qp_out *qp_out)
     int *nu = qp_in->dim->nu;
     int *nb = qp_in->dim->nb;
     int *ng = qp_in->dim->ng;
+    int *ns = qp_in->dim->ns;
 
     struct blasfeo_dmat *DCt = qp_in->DCt;
     struct blasfeo_dvec *d = qp_in->d;
     int **idxb = qp_in->idxb;
+    int **idxs_rev = qp_in->idxs_rev;
 
     struct blasfeo_dvec *ux = qp_out->ux;
     struct blasfeo_dvec *t = qp_out->t;
 
-    int nx_i, nu_i, nb_i, ng_i;
+    int nx_i, nu_i, nb_i, ng_i, ns_i;
 
     for (ii = 0; ii <= N; ii++)
     {
@@ -635,6 +747,7 @@ void ocp_qp_compute_t(ocp_qp_in *qp_in, ocp_qp_out *qp_out)
         nu_i = nu[ii];
         nb_i = nb[ii];
         ng_i = ng[ii];
+        ns_i = ns[ii];
 
         // compute slacks for bounds
         blasfeo_dvecex_sp(nb_i, 1.0, idxb[ii], ux + ii, 0, t+ii, nb_i + ng_i);
@@ -647,5 +760,71 @@ void ocp_qp_compute_t(ocp_qp_in *qp_in, ocp_qp_out *qp_out)
                         t + ii, nb_i);
         blasfeo_dgemv_t(nu_i + nx_i, ng_i, -1.0, DCt + ii, 0, 0, ux + ii, 0, -1.0, d + ii,
                         2 * nb_i + ng_i, t + ii, 2 * nb_i + ng_i);
+
+        // add the slacks of softened constraints, lb - sl <= C ux <= ub + su
+        for (jj = 0; jj < nb_i + ng_i; jj++)
+        {
+            int js = idxs_rev[ii][jj];
+            if (js != -1)
+            {
+                BLASFEO_DVECEL(t + ii, jj) += BLASFEO_DVECEL(ux + ii, nu_i + nx_i + js);
+                BLASFEO_DVECEL(t + ii, nb_i + ng_i + jj) +=
+                    BLASFEO_DVECEL(ux + ii, nu_i + nx_i + ns_i + js);
+            }
+        }
+
+        // compute slacks for the slack bounds
+        blasfeo_daxpby(2 * ns_i, 1.0, ux + ii, nu_i + nx_i, -1.0, d + ii, 2 * nb_i + 2 * ng_i,
+                       t + ii, 2 * nb_i + 2 * ng_i);
+    }
+}
+
+
+
+void ocp_qp_out_get_lam_index(ocp_qp_out *probe, int num_lam, int *idx)
+{
+    int N = probe->dim->N;
+    int *nb = probe->dim->nb;
+    int *ng = probe->dim->ng;
+    int *ns = probe->dim->ns;
+
+    for (int ii = 0; ii < 2 * num_lam; ii++) idx[ii] = -1;
+
+    // the multipliers of eliminated equality constraints at stage 0 are computed, not copied:
+    // visit stage 0 last and keep the first match, so that they can not shadow a copied one
+    for (int kk = N; kk >= 0; kk--)
+    {
+        for (int jj = 0; jj < 2 * (nb[kk] + ng[kk] + ns[kk]); jj++)
+        {
+            double code = -probe->lam[kk].pa[jj];
+            if (code >= 1.0 && code <= num_lam && code == (int) code)
+            {
+                int ii = (int) code - 1;
+                if (idx[2 * ii] < 0)
+                {
+                    idx[2 * ii] = kk;
+                    idx[2 * ii + 1] = jj;
+                }
+            }
+        }
+    }
+}
+
+
+
+void ocp_qp_out_gather_lam(ocp_qp_out *qp_out, int num_lam, const int *idx, double *lam, double *t)
+{
+    for (int ii = 0; ii < num_lam; ii++)
+    {
+        if (idx[2 * ii] < 0)
+        {
+            lam[ii] = 0.0;
+            t[ii] = 0.0;
+        }
+        else
+        {
+            lam[ii] = qp_out->lam[idx[2 * ii]].pa[idx[2 * ii + 1]];
+            t[ii] = qp_out->t[idx[2 * ii]].pa[idx[2 * ii + 1]];
+        }
     }
 }
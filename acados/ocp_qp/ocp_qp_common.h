@@ -57,6 +57,25 @@ typedef struct d_ocp_qp_res_ws ocp_qp_res_ws;
 
 
 
+// change tracking of an ocp_qp_in, kept in the memory of ocp_qp_in_assign: every write of
+// blocks bumps the generation of the qp_in and stamps the written blocks of the stage with it.
+// Consumers keep the qp_in and the generation they last read, and compare against them, so any
+// number of solvers can read the same qp_in. Code that writes into the hpipm structure directly
+// (e.g. through d_ocp_qp_set_*) has to call ocp_qp_in_mark_changed for the blocks it writes.
+typedef enum
+{
+    OCP_QP_IN_DYN_MAT = 1,   // BAbt
+    OCP_QP_IN_COST_MAT = 2,  // RSQrq, Z
+    OCP_QP_IN_CON_MAT = 4,   // DCt, idxb, idxs_rev, idxe
+    OCP_QP_IN_VEC = 8,       // b, rqz, d, d_mask, m
+} ocp_qp_in_block;
+
+#define OCP_QP_IN_MAT (OCP_QP_IN_DYN_MAT | OCP_QP_IN_COST_MAT | OCP_QP_IN_CON_MAT)
+#define OCP_QP_IN_ALL (OCP_QP_IN_MAT | OCP_QP_IN_VEC)
+#define OCP_QP_IN_NUM_BLOCKS 4
+
+
+
 #ifndef QP_SOLVER_CONFIG_
 #define QP_SOLVER_CONFIG_
 typedef struct
@@ -97,6 +116,9 @@ typedef struct
     int (*condensing)(void *qp_in, void *qp_out, void *opts, void *mem, void *work);
     int (*condensing_rhs)(void *qp_in, void *qp_out, void *opts, void *mem, void *work);
     int (*expansion)(void *qp_in, void *qp_out, void *opts, void *mem, void *work);
+    // maps the multipliers and slacks of an ocp qp solution to the xcond qp solution,
+    // to guess the active set of the xcond qp; call after condensing
+    int (*condensing_sol)(void *qp_out, void *xcond_qp_out, void *opts, void *mem, void *work);
 } ocp_qp_xcond_config;
 
 
@@ -144,6 +166,19 @@ void ocp_qp_dims_get(void *config_, void *dims, int stage, const char *field, in
 int ocp_qp_in_calculate_size(ocp_qp_dims *dims);
 //
 ocp_qp_in *ocp_qp_in_assign(ocp_qp_dims *dims, void *raw_memory);
+// generation of the last write, 0 after assign
+long long ocp_qp_in_generation(const ocp_qp_in *qp_in);
+//
+void ocp_qp_in_mark_changed(ocp_qp_in *qp_in, int stage, int blocks);
+//
+void ocp_qp_in_mark_changed_all(ocp_qp_in *qp_in, int blocks);
+// returns true if any of the blocks of the stage was written after generation since;
+// since = -1 (nothing read yet) always returns true
+bool ocp_qp_in_stage_changed(const ocp_qp_in *qp_in, int stage, int blocks, long long since);
+// returns true if any of the blocks was written at any stage after generation since
+bool ocp_qp_in_changed(const ocp_qp_in *qp_in, int blocks, long long since);
+// blocks written by the d_ocp_qp_set field
+int ocp_qp_in_field_block(const char *field);
 
 
 /* out */
@@ -174,6 +209,11 @@ void ocp_qp_stack_slacks_dims(ocp_qp_dims *in, ocp_qp_dims *out);
 void ocp_qp_stack_slacks(ocp_qp_in *in, ocp_qp_in *out);
 //
 void ocp_qp_compute_t(ocp_qp_in *qp_in, ocp_qp_out *qp_out);
+// finds where the expansion of an xcond qp solution with multipliers lam[ii] = -(ii+1) put them
+// in probe: idx[2*ii] is the stage and idx[2*ii+1] the position of lam[ii], or -1 if not copied
+void ocp_qp_out_get_lam_index(ocp_qp_out *probe, int num_lam, int *idx);
+// gathers the multipliers and slacks of qp_out at the positions idx, zero where idx is -1
+void ocp_qp_out_gather_lam(ocp_qp_out *qp_out, int num_lam, const int *idx, double *lam, double *t);
 
 #ifdef __cplusplus
 } /* extern "C" */
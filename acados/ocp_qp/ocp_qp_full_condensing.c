@@ -325,6 +325,11 @@ int ocp_qp_full_condensing_memory_calculate_size(void *dims_, void *opts_)
 
     size += ocp_qp_out_calculate_size(dims->red_dims);
 
+    size += ocp_qp_out_calculate_size(dims->orig_dims);  // probe_sol
+
+    dense_qp_dims *fcond_dims = dims->fcond_dims;
+    size += 4 * (fcond_dims->nb + fcond_dims->ng + fcond_dims->ns) * sizeof(int);  // lam_idx
+
     size += sizeof(struct d_cond_qp_ws);
     size += d_cond_qp_ws_memsize(dims->red_dims, opts->hpipm_cond_opts);
 
@@ -382,6 +387,13 @@ void *ocp_qp_full_condensing_memory_assign(void *dims_, void *opts_, void *raw_m
     mem->red_sol = ocp_qp_out_assign(dims->red_dims, c_ptr);
     c_ptr += ocp_qp_out_calculate_size(dims->red_dims);
 
+    mem->probe_sol = ocp_qp_out_assign(dims->orig_dims, c_ptr);
+    c_ptr += ocp_qp_out_calculate_size(dims->orig_dims);
+
+    dense_qp_dims *fcond_dims = dims->fcond_dims;
+    assign_and_advance_int(4 * (fcond_dims->nb + fcond_dims->ng + fcond_dims->ns), &mem->lam_idx,
+                           &c_ptr);
+
     mem->qp_out_info = (qp_info *) mem->fcond_qp_out->misc;
 
     assert((char *) raw_memory + ocp_qp_full_condensing_memory_calculate_size(dims, opts) >= c_ptr);
@@ -552,6 +564,49 @@ int ocp_qp_full_expansion(void *fcond_qp_out_, void *qp_out_, void *opts_, void
 
 
 
+int ocp_qp_full_condensing_sol(void *qp_out_, void *fcond_qp_out_, void *opts_, void *mem_, void *work)
+{
+    ocp_qp_out *qp_out = qp_out_;
+    dense_qp_out *fcond_qp_out = fcond_qp_out_;
+    ocp_qp_full_condensing_opts *opts = opts_;
+    ocp_qp_full_condensing_memory *mem = mem_;
+
+    int nv = fcond_qp_out->dim->nv;
+    int ne = fcond_qp_out->dim->ne;
+    int nb = fcond_qp_out->dim->nb;
+    int ng = fcond_qp_out->dim->ng;
+    int ns = fcond_qp_out->dim->ns;
+    int nlam = 2 * (nb + ng + ns);
+
+    acados_timer timer;
+
+    // start timer
+    acados_tic(&timer);
+
+    // every inequality of the dense qp comes from one inequality of the ocp qp, and the expansion
+    // copies its multiplier: expand multipliers set to their (negative) index to find where to
+    blasfeo_dvecse(nv + 2 * ns, 0.0, fcond_qp_out->v, 0);
+    blasfeo_dvecse(ne, 0.0, fcond_qp_out->pi, 0);
+    blasfeo_dvecse(nlam, 0.0, fcond_qp_out->t, 0);
+    for (int ii = 0; ii < nlam; ii++)
+        fcond_qp_out->lam->pa[ii] = -(ii + 1.0);
+
+    d_cond_qp_expand_sol(mem->red_qp, fcond_qp_out, mem->red_sol, opts->hpipm_cond_opts, mem->hpipm_cond_work);
+    d_ocp_qp_restore_eq_dof(mem->ptr_qp_in, mem->red_sol, mem->probe_sol, opts->hpipm_red_opts, mem->hpipm_red_work);
+
+    ocp_qp_out_get_lam_index(mem->probe_sol, nlam, mem->lam_idx);
+
+    // multipliers and slacks of qp_out in the dense qp
+    ocp_qp_out_gather_lam(qp_out, nlam, mem->lam_idx, fcond_qp_out->lam->pa, fcond_qp_out->t->pa);
+
+    // stop timer
+    mem->time_qp_xcond += acados_toc(&timer);
+
+    return ACADOS_SUCCESS;
+}
+
+
+
 void ocp_qp_full_condensing_config_initialize_default(void *config_)
 {
     ocp_qp_xcond_config *config = config_;
@@ -572,6 +627,7 @@ void ocp_qp_full_condensing_config_initialize_default(void *config_)
     config->condensing = &ocp_qp_full_condensing;
     config->condensing_rhs = &ocp_qp_full_condensing_rhs;
     config->expansion = &ocp_qp_full_expansion;
+    config->condensing_sol = &ocp_qp_full_condensing_sol;
 
     return;
 }
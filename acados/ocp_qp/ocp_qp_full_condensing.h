@@ -79,6 +79,8 @@ typedef struct ocp_qp_full_condensing_memory_
     dense_qp_out *fcond_qp_out;
     ocp_qp_in *red_qp; // reduced qp
     ocp_qp_out *red_sol; // reduced qp sol
+    ocp_qp_out *probe_sol; // expansion of the index probe in ocp_qp_full_condensing_sol
+    int *lam_idx; // stage and position of each dense multiplier in the ocp qp sol
     // only pointer
     ocp_qp_in *ptr_qp_in;
     qp_info *qp_out_info; // info in fcond_qp_in
@@ -108,6 +110,8 @@ int ocp_qp_full_condensing(void *in, void *out, void *opts, void *mem, void *wor
 //
 int ocp_qp_full_expansion(void *in, void *out, void *opts, void *mem, void *work);
 //
+int ocp_qp_full_condensing_sol(void *qp_out, void *fcond_qp_out, void *opts, void *mem, void *work);
+//
 void ocp_qp_full_condensing_config_initialize_default(void *config_);
 
 #ifdef __cplusplus
@@ -221,7 +221,7 @@ static int acados_osqp_num_vars(ocp_qp_dims *dims)
 
     for (int ii = 0; ii <= dims->N; ii++)
     {
-        n += dims->nx[ii] + dims->nu[ii];
+        n += dims->nx[ii] + dims->nu[ii] + 2 * dims->ns[ii];
     }
 
     return n;
@@ -237,6 +237,7 @@ static int acados_osqp_num_constr(ocp_qp_dims *dims)
     {
         m += dims->nb[ii];
         m += dims->ng[ii];
+        m += 2 * dims->ns[ii];  // bounds on the slacks
 
         if (ii < dims->N)
         {
@@ -258,6 +259,7 @@ static int acados_osqp_nnzmax_P(const ocp_qp_dims *dims)
         nnz += dims->nx[ii] * dims->nx[ii];      // Q
         nnz += dims->nu[ii] * dims->nu[ii];      // R
         nnz += 2 * dims->nx[ii] * dims->nu[ii];  // S
+        nnz += 2 * dims->ns[ii];                  // Z
     }
 
     return nnz;
@@ -275,6 +277,7 @@ static int acados_osqp_nnzmax_A(const ocp_qp_dims *dims)
         nnz += dims->nb[ii];                 // eye
         nnz += dims->ng[ii] * dims->nx[ii];  // C
         nnz += dims->ng[ii] * dims->nu[ii];  // D
+        nnz += 4 * dims->ns[ii];             // slacks in the soft constraints and their bounds
 
         // equality constraints
         if (ii < dims->N)
@@ -297,8 +300,10 @@ static void update_gradient(const ocp_qp_in *in, ocp_qp_osqp_memory *mem)
 
     for (kk = 0; kk <= dims->N; kk++)
     {
-        blasfeo_unpack_dvec(dims->nu[kk] + dims->nx[kk], in->rqz + kk, 0, &mem->q[nn], 1);
-        nn += dims->nu[kk] + dims->nx[kk];
+        // r, q and the gradient of the slacks z
+        blasfeo_unpack_dvec(dims->nu[kk] + dims->nx[kk] + 2 * dims->ns[kk], in->rqz + kk, 0,
+                            &mem->q[nn], 1);
+        nn += dims->nu[kk] + dims->nx[kk] + 2 * dims->ns[kk];
     }
 }
 
@@ -324,7 +329,14 @@ static void update_hessian_structure(const ocp_qp_in *in, ocp_qp_osqp_memory *me
             }
         }
 
-        offset += dims->nx[kk] + dims->nu[kk];
+        // writing Z[kk], diagonal
+        for (jj = 0; jj < 2 * dims->ns[kk]; jj++)
+        {
+            mem->P_p[col++] = nn;
+            mem->P_i[nn++] = offset + dims->nx[kk] + dims->nu[kk] + jj;
+        }
+
+        offset += dims->nx[kk] + dims->nu[kk] + 2 * dims->ns[kk];
     }
 
     mem->P_p[col] = nn;
@@ -332,7 +344,7 @@ static void update_hessian_structure(const ocp_qp_in *in, ocp_qp_osqp_memory *me
 
 
 
-static void update_hessian_data(const ocp_qp_in *in, ocp_qp_osqp_memory *mem)
+static void update_hessian_data(const ocp_qp_in *in, c_float *P_x)
 {
     c_int ii, jj, kk, nn = 0;
     ocp_qp_dims *dims = in->dim;
@@ -348,28 +360,51 @@ static void update_hessian_data(const ocp_qp_in *in, ocp_qp_osqp_memory *mem)
                 // we write the lower triangular part in row-major order
                 // that's the same as writing the upper triangular part in
                 // column-major order
-                mem->P_x[nn++] = BLASFEO_DMATEL(&in->RSQrq[kk], ii, jj);
+                P_x[nn++] = BLASFEO_DMATEL(&in->RSQrq[kk], ii, jj);
             }
         }
+
+        // writing Z[kk]
+        for (ii = 0; ii < 2 * dims->ns[kk]; ii++)
+        {
+            P_x[nn++] = BLASFEO_DVECEL(&in->Z[kk], ii);
+        }
     }
 }
 
 
 
+// index in [0, nb+ng) of the constraint softened by slack jj at stage kk
+static int soft_constraint_index(const ocp_qp_in *in, int kk, int jj)
+{
+    for (int ii = 0; ii < in->dim->nb[kk] + in->dim->ng[kk]; ii++)
+    {
+        if (in->idxs_rev[kk][ii] == jj) return ii;
+    }
+
+    return -1;
+}
+
+
+
+// rows of A: dynamics, general constraints, bounds, bounds on the slacks;
+// as in ocp_qp_stack_slacks, a softened constraint reads lb <= C ux + sl - su <= ub
 static void update_constraints_matrix_structure(const ocp_qp_in *in, ocp_qp_osqp_memory *mem)
 {
     c_int ii, jj, kk, nn = 0, col = 0;
-    c_int con_start = 0, bnd_start = 0;
-    c_int row_offset_dyn = 0, row_offset_con = 0, row_offset_bnd = 0;
+    c_int con_start = 0, bnd_start = 0, slk_start = 0;
+    c_int row_offset_dyn = 0, row_offset_con = 0, row_offset_bnd = 0, row_offset_slk = 0;
     ocp_qp_dims *dims = in->dim;
 
     for (kk = 0; kk <= dims->N; kk++)
     {
         con_start += kk < dims->N ? dims->nx[kk + 1] : 0;
         bnd_start += dims->ng[kk];
+        slk_start += dims->nb[kk];
     }
 
     bnd_start += con_start;
+    slk_start += bnd_start;
 
     // CSC format: A_i are row indices and A_p are column pointers
     for (kk = 0; kk <= dims->N; kk++)
@@ -443,6 +478,22 @@ static void update_constraints_matrix_structure(const ocp_qp_in *in, ocp_qp_osqp
             }
         }
 
+        for (jj = 0; jj < 2 * dims->ns[kk]; jj++)
+        {
+            mem->A_p[col++] = nn;
+
+            // write sl (su) in the softened constraint
+            int js = soft_constraint_index(in, kk, jj % dims->ns[kk]);
+            if (js < dims->nb[kk])
+                mem->A_i[nn++] = js + bnd_start + row_offset_bnd;
+            else
+                mem->A_i[nn++] = js - dims->nb[kk] + con_start + row_offset_con;
+
+            // write bound on sl (su)
+            mem->A_i[nn++] = jj + slk_start + row_offset_slk;
+        }
+
+        row_offset_slk += 2 * dims->ns[kk];
         row_offset_bnd += dims->nb[kk];
         row_offset_con += dims->ng[kk];
         row_offset_dyn += kk < dims->N ? dims->nx[kk + 1] : 0;
@@ -453,7 +504,7 @@ static void update_constraints_matrix_structure(const ocp_qp_in *in, ocp_qp_osqp
 
 
 
-static void update_constraints_matrix_data(const ocp_qp_in *in, ocp_qp_osqp_memory *mem)
+static void update_constraints_matrix_data(const ocp_qp_in *in, c_float *A_x)
 {
     c_int ii, jj, kk, nn = 0;
     ocp_qp_dims *dims = in->dim;
@@ -470,14 +521,14 @@ static void update_constraints_matrix_data(const ocp_qp_in *in, ocp_qp_osqp_memo
                 // write column from B
                 for (ii = 0; ii < dims->nx[kk + 1]; ii++)
                 {
-                    mem->A_x[nn++] = BLASFEO_DMATEL(&in->BAbt[kk], jj, ii);
+                    A_x[nn++] = BLASFEO_DMATEL(&in->BAbt[kk], jj, ii);
                 }
             }
 
             // write column from D
             for (ii = 0; ii < dims->ng[kk]; ii++)
             {
-                mem->A_x[nn++] = BLASFEO_DMATEL(&in->DCt[kk], jj, ii);
+                A_x[nn++] = BLASFEO_DMATEL(&in->DCt[kk], jj, ii);
             }
 
             // write bound on u
@@ -485,7 +536,7 @@ static void update_constraints_matrix_data(const ocp_qp_in *in, ocp_qp_osqp_memo
             {
                 if (in->idxb[kk][ii] == jj)
                 {
-                    mem->A_x[nn++] = 1.0;
+                    A_x[nn++] = 1.0;
                     nbu++;
                     break;
                 }
@@ -497,7 +548,7 @@ static void update_constraints_matrix_data(const ocp_qp_in *in, ocp_qp_osqp_memo
             if (kk > 0)
             {
                 // write column from -I
-                mem->A_x[nn++] = -1.0;
+                A_x[nn++] = -1.0;
             }
 
             if (kk < dims->N)
@@ -505,14 +556,14 @@ static void update_constraints_matrix_data(const ocp_qp_in *in, ocp_qp_osqp_memo
                 // write column from A
                 for (ii = 0; ii < dims->nx[kk + 1]; ii++)
                 {
-                    mem->A_x[nn++] = BLASFEO_DMATEL(&in->BAbt[kk], jj + dims->nu[kk], ii);
+                    A_x[nn++] = BLASFEO_DMATEL(&in->BAbt[kk], jj + dims->nu[kk], ii);
                 }
             }
 
             // write column from C
             for (ii = 0; ii < dims->ng[kk]; ii++)
             {
-                mem->A_x[nn++] = BLASFEO_DMATEL(&in->DCt[kk], jj + dims->nu[kk], ii);
+                A_x[nn++] = BLASFEO_DMATEL(&in->DCt[kk], jj + dims->nu[kk], ii);
             }
 
             // write bound on x
@@ -520,10 +571,19 @@ static void update_constraints_matrix_data(const ocp_qp_in *in, ocp_qp_osqp_memo
             {
                 if (in->idxb[kk][ii] == jj + dims->nu[kk])
                 {
-                    mem->A_x[nn++] = 1.0;
+                    A_x[nn++] = 1.0;
                 }
             }
         }
+
+        for (jj = 0; jj < 2 * dims->ns[kk]; jj++)
+        {
+            // write sl (su) in the softened constraint
+            A_x[nn++] = jj < dims->ns[kk] ? 1.0 : -1.0;
+
+            // write bound on sl (su)
+            A_x[nn++] = 1.0;
+        }
     }
 }
 
@@ -579,6 +639,38 @@ static void update_bounds(const ocp_qp_in *in, ocp_qp_osqp_memory *mem)
 
         nn += dims->nb[kk];
     }
+
+    // write ls and us, the slacks have no upper bounds
+    for (kk = 0; kk <= dims->N; kk++)
+    {
+        blasfeo_unpack_dvec(2 * dims->ns[kk], in->d + kk, 2 * dims->nb[kk] + 2 * dims->ng[kk],
+                            &mem->l[nn], 1);
+        set_vec(2 * dims->ns[kk], OSQP_INFTY, &mem->u[nn]);
+
+        nn += 2 * dims->ns[kk];
+    }
+}
+
+
+
+// compacts the nonzeros of x_new that differ from x into x_new and idx, and copies them to x;
+// returns their number
+static c_int diff_nonzeros(c_int nnz, c_float *x_new, c_int *idx, c_float *x)
+{
+    c_int nn = 0;
+
+    for (c_int ii = 0; ii < nnz; ii++)
+    {
+        if (x_new[ii] != x[ii])
+        {
+            x[ii] = x_new[ii];
+            x_new[nn] = x_new[ii];
+            idx[nn] = ii;
+            nn++;
+        }
+    }
+
+    return nn;
 }
 
 
@@ -594,8 +686,41 @@ static void ocp_qp_osqp_update_memory(const ocp_qp_in *in, const ocp_qp_osqp_opt
 
     update_bounds(in, mem);
     update_gradient(in, mem);
-    update_hessian_data(in, mem);
-    update_constraints_matrix_data(in, mem);
+
+    // matrix data only if changed since the last call, all of it for another qp_in
+    long long since = (in == mem->last_qp_in) ? mem->last_generation : -1;
+    mem->P_changed = mem->first_run || ocp_qp_in_changed(in, OCP_QP_IN_COST_MAT, since);
+    mem->A_changed = mem->first_run ||
+                     ocp_qp_in_changed(in, OCP_QP_IN_DYN_MAT | OCP_QP_IN_CON_MAT, since);
+
+    mem->last_qp_in = in;
+    mem->last_generation = ocp_qp_in_generation(in);
+
+    mem->P_x_upd_n = 0;
+    mem->A_x_upd_n = 0;
+
+    if (mem->first_run)
+    {
+        update_hessian_data(in, mem->P_x);
+        update_constraints_matrix_data(in, mem->A_x);
+        return;
+    }
+
+    // after the setup, only the nonzeros that changed are passed to osqp
+    int n = acados_osqp_num_vars(in->dim);
+
+    if (mem->P_changed)
+    {
+        update_hessian_data(in, mem->P_x_upd);
+        mem->P_x_upd_n = diff_nonzeros(mem->P_p[n], mem->P_x_upd, mem->P_x_upd_idx,
+                                       mem->P_x);
+    }
+    if (mem->A_changed)
+    {
+        update_constraints_matrix_data(in, mem->A_x_upd);
+        mem->A_x_upd_n = diff_nonzeros(mem->A_p[n], mem->A_x_upd, mem->A_x_upd_idx,
+                                       mem->A_x);
+    }
 }
 
 
@@ -819,6 +944,11 @@ int ocp_qp_osqp_memory_calculate_size(void *config_, void *dims_, void *opts_)
     size += A_nnzmax * sizeof(c_int);    // A_i
     size += (n + 1) * sizeof(c_int);     // A_p
 
+    size += P_nnzmax * sizeof(c_float);  // P_x_upd
+    size += P_nnzmax * sizeof(c_int);    // P_x_upd_idx
+    size += A_nnzmax * sizeof(c_float);  // A_x_upd
+    size += A_nnzmax * sizeof(c_int);    // A_x_upd_idx
+
     size += sizeof(OSQPData);
     size += 2 * sizeof(csc);  // matrices P and A
     size += osqp_workspace_calculate_size(n, m, P_nnzmax, A_nnzmax);
@@ -1130,6 +1260,12 @@ void *ocp_qp_osqp_memory_assign(void *config_, void *dims_, void *opts_, void *r
     mem->P_nnzmax = P_nnzmax;
     mem->A_nnzmax = A_nnzmax;
     mem->first_run = 1;
+    mem->P_changed = 1;
+    mem->A_changed = 1;
+    mem->last_qp_in = NULL;
+    mem->last_generation = 0;
+    mem->P_x_upd_n = 0;
+    mem->A_x_upd_n = 0;
 
     align_char_to(8, &c_ptr);
 
@@ -1149,6 +1285,12 @@ void *ocp_qp_osqp_memory_assign(void *config_, void *dims_, void *opts_, void *r
     mem->A_x = (c_float *) c_ptr;
     c_ptr += (mem->A_nnzmax) * sizeof(c_float);
 
+    mem->P_x_upd = (c_float *) c_ptr;
+    c_ptr += (mem->P_nnzmax) * sizeof(c_float);
+
+    mem->A_x_upd = (c_float *) c_ptr;
+    c_ptr += (mem->A_nnzmax) * sizeof(c_float);
+
     // ints
     mem->P_i = (c_int *) c_ptr;
     c_ptr += (mem->P_nnzmax) * sizeof(c_int);
@@ -1162,6 +1304,12 @@ void *ocp_qp_osqp_memory_assign(void *config_, void *dims_, void *opts_, void *r
     mem->A_p = (c_int *) c_ptr;
     c_ptr += (n + 1) * sizeof(c_int);
 
+    mem->P_x_upd_idx = (c_int *) c_ptr;
+    c_ptr += (mem->P_nnzmax) * sizeof(c_int);
+
+    mem->A_x_upd_idx = (c_int *) c_ptr;
+    c_ptr += (mem->A_nnzmax) * sizeof(c_int);
+
     mem->osqp_data = (OSQPData *) c_ptr;
     c_ptr += sizeof(OSQPData);
 
@@ -1239,20 +1387,23 @@ int ocp_qp_osqp_workspace_calculate_size(void *config_, void *dims_, void *opts_
 
 static void fill_in_qp_out(const ocp_qp_in *in, ocp_qp_out *out, ocp_qp_osqp_memory *mem)
 {
-    int ii, kk, nn = 0, mm, con_start = 0, bnd_start = 0;
+    int ii, kk, nn = 0, mm, ss, con_start = 0, bnd_start = 0, slk_start = 0;
     ocp_qp_dims *dims = in->dim;
     OSQPSolution *sol = mem->osqp_work->solution;
 
     for (kk = 0; kk <= dims->N; kk++)
     {
-        blasfeo_pack_dvec(dims->nx[kk] + dims->nu[kk], &sol->x[nn], 1, out->ux + kk, 0);
-        nn += dims->nx[kk] + dims->nu[kk];
+        blasfeo_pack_dvec(dims->nx[kk] + dims->nu[kk] + 2 * dims->ns[kk], &sol->x[nn], 1,
+                          out->ux + kk, 0);
+        nn += dims->nx[kk] + dims->nu[kk] + 2 * dims->ns[kk];
 
         con_start += kk < dims->N ? dims->nx[kk + 1] : 0;
         bnd_start += dims->ng[kk];
+        slk_start += dims->nb[kk];
     }
 
     bnd_start += con_start;
+    slk_start += bnd_start;
 
     nn = 0;
     for (kk = 0; kk < dims->N; kk++)
@@ -1263,6 +1414,7 @@ static void fill_in_qp_out(const ocp_qp_in *in, ocp_qp_out *out, ocp_qp_osqp_mem
 
     nn = 0;
     mm = 0;
+    ss = 0;
     for (kk = 0; kk <= dims->N; kk++)
     {
         for (ii = 0; ii < 2 * dims->nb[kk] + 2 * dims->ng[kk] + 2 * dims->ns[kk]; ii++)
@@ -1289,6 +1441,22 @@ static void fill_in_qp_out(const ocp_qp_in *in, ocp_qp_out *out, ocp_qp_osqp_mem
         }
 
         mm += dims->ng[kk];
+
+        // slack bounds are lower bounds only; sl (su) also enters the softened constraint row,
+        // whose upper (lower) multiplier is removed to get the multipliers of the
+        // convention lb - sl <= C ux, C ux <= ub + su
+        for (ii = 0; ii < 2 * dims->ns[kk]; ii++)
+        {
+            int js = soft_constraint_index(in, kk, ii % dims->ns[kk]);
+            double offset = ii < dims->ns[kk] ?
+                out->lam[kk].pa[dims->nb[kk] + dims->ng[kk] + js] : out->lam[kk].pa[js];
+
+            double lam = sol->y[slk_start + ss + ii];
+            lam = lam <= 0 ? -lam : 0.0;
+            out->lam[kk].pa[2 * dims->nb[kk] + 2 * dims->ng[kk] + ii] = lam - offset;
+        }
+
+        ss += 2 * dims->ns[kk];
     }
 }
 
@@ -1299,20 +1467,8 @@ int ocp_qp_osqp(void *config_, void *qp_in_, void *qp_out_, void *opts_, void *m
     ocp_qp_in *qp_in = qp_in_;
     ocp_qp_out *qp_out = qp_out_;
 
-    int N = qp_in->dim->N;
-    int *ns = qp_in->dim->ns;
-
     // print_ocp_qp_dims(qp_in->dim);
 
-    for (int ii = 0; ii <= N; ii++)
-    {
-        if (ns[ii] > 0)
-        {
-            printf("\nOSQP interface can not handle ns>0 yet: what about implementing it? :)\n");
-            exit(1);
-        }
-    }
-
     // print_ocp_qp_in(qp_in);
 
     qp_info *info = (qp_info *) qp_out->misc;
@@ -1333,8 +1489,14 @@ int ocp_qp_osqp(void *config_, void *qp_in_, void *qp_out_, void *opts_, void *m
     if (!mem->first_run)
     {
         osqp_update_lin_cost(mem->osqp_work, mem->q);
-        osqp_update_P_A(mem->osqp_work, mem->P_x, NULL, mem->P_nnzmax, mem->A_x, NULL,
-                        mem->A_nnzmax);
+        // the KKT system is refactorized only if a matrix nonzero changed
+        if (mem->P_x_upd_n > 0 && mem->A_x_upd_n > 0)
+            osqp_update_P_A(mem->osqp_work, mem->P_x_upd, mem->P_x_upd_idx, mem->P_x_upd_n,
+                            mem->A_x_upd, mem->A_x_upd_idx, mem->A_x_upd_n);
+        else if (mem->P_x_upd_n > 0)
+            osqp_update_P(mem->osqp_work, mem->P_x_upd, mem->P_x_upd_idx, mem->P_x_upd_n);
+        else if (mem->A_x_upd_n > 0)
+            osqp_update_A(mem->osqp_work, mem->A_x_upd, mem->A_x_upd_idx, mem->A_x_upd_n);
         osqp_update_bounds(mem->osqp_work, mem->l, mem->u);
         // TODO(oj): update OSQP options here if they were updated?
     }
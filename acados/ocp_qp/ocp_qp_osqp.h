@@ -55,6 +55,10 @@ typedef struct ocp_qp_osqp_opts_
 typedef struct ocp_qp_osqp_memory_
 {
     c_int first_run;
+    c_int P_changed;  // matrix data updated in the last call
+    c_int A_changed;
+    const ocp_qp_in *last_qp_in;  // qp_in and generation read by the last call
+    long long last_generation;
 
     c_float *q;
     c_float *l;
@@ -70,6 +74,15 @@ typedef struct ocp_qp_osqp_memory_
     c_int *A_p;
     c_float *A_x;
 
+    // nonzeros of P and A changed in the last call, passed to osqp by index
+    c_int P_x_upd_n;
+    c_int *P_x_upd_idx;
+    c_float *P_x_upd;
+
+    c_int A_x_upd_n;
+    c_int *A_x_upd_idx;
+    c_float *A_x_upd;
+
     OSQPData *osqp_data;
     OSQPWorkspace *osqp_work;
 
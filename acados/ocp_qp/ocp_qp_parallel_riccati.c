@@ -0,0 +1,972 @@
+/*
+ * Copyright 2019 Gianluca Frison, Dimitris Kouzoupis, Robin Verschueren,
+ * Andrea Zanelli, Niels van Duijkeren, Jonathan Frey, Tommaso Sartor,
+ * Branimir Novoselnik, Rien Quirynen, Rezart Qelibari, Dang Doan,
+ * Jonas Koenemann, Yutao Chen, Tobias Schöls, Jonas Schlagenhauf, Moritz Diehl
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+
+// external
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+// blasfeo
+#include "blasfeo/include/blasfeo_d_aux.h"
+#include "blasfeo/include/blasfeo_d_blas.h"
+// hpipm
+#include "hpipm/include/hpipm_d_ocp_qp.h"
+#include "hpipm/include/hpipm_d_ocp_qp_sol.h"
+// acados
+#include "acados/ocp_qp/ocp_qp_common.h"
+#include "acados/ocp_qp/ocp_qp_hpipm.h"
+#include "acados/ocp_qp/ocp_qp_parallel_riccati.h"
+#include "acados/ocp_qp/ocp_qp_riccati.h"
+#include "acados/utils/mem.h"
+#include "acados/utils/timing.h"
+#include "acados/utils/types.h"
+
+#if defined(ACADOS_WITH_OPENMP)
+#include <omp.h>
+#endif
+
+
+
+/************************************************
+ * opts
+ ************************************************/
+
+int ocp_qp_parallel_riccati_opts_calculate_size(void *config_, void *dims_)
+{
+    int size = 0;
+    size += sizeof(ocp_qp_parallel_riccati_opts);
+    size += ocp_qp_hpipm_opts_calculate_size(config_, dims_);
+
+    size += 1 * 8;
+    make_int_multiple_of(8, &size);
+
+    return size;
+}
+
+
+
+void *ocp_qp_parallel_riccati_opts_assign(void *config_, void *dims_, void *raw_memory)
+{
+    ocp_qp_parallel_riccati_opts *opts;
+
+    char *c_ptr = (char *) raw_memory;
+
+    opts = (ocp_qp_parallel_riccati_opts *) c_ptr;
+    c_ptr += sizeof(ocp_qp_parallel_riccati_opts);
+
+    align_char_to(8, &c_ptr);
+
+    opts->hpipm_opts = ocp_qp_hpipm_opts_assign(config_, dims_, c_ptr);
+    c_ptr += ocp_qp_hpipm_opts_calculate_size(config_, dims_);
+
+    assert((char *) raw_memory + ocp_qp_parallel_riccati_opts_calculate_size(config_, dims_) >= c_ptr);
+
+    return (void *) opts;
+}
+
+
+
+void ocp_qp_parallel_riccati_opts_initialize_default(void *config_, void *dims_, void *opts_)
+{
+    ocp_qp_parallel_riccati_opts *opts = opts_;
+
+    ocp_qp_hpipm_opts_initialize_default(config_, dims_, opts->hpipm_opts);
+
+    opts->fallback = 1;
+#if defined(ACADOS_WITH_OPENMP)
+    #if defined(ACADOS_NUM_THREADS)
+    opts->num_threads = ACADOS_NUM_THREADS;
+    #else
+    opts->num_threads = omp_get_max_threads();
+    #endif
+#else
+    opts->num_threads = 1;
+#endif
+
+    return;
+}
+
+
+
+void ocp_qp_parallel_riccati_opts_update(void *config_, void *dims_, void *opts_)
+{
+    ocp_qp_parallel_riccati_opts *opts = opts_;
+
+    ocp_qp_hpipm_opts_update(config_, dims_, opts->hpipm_opts);
+
+    return;
+}
+
+
+
+void ocp_qp_parallel_riccati_opts_set(void *config_, void *opts_, const char *field, void *value)
+{
+    ocp_qp_parallel_riccati_opts *opts = opts_;
+
+    if (!strcmp(field, "fallback"))
+    {
+        int *tmp_ptr = value;
+        opts->fallback = *tmp_ptr;
+    }
+    else if (!strcmp(field, "num_threads"))
+    {
+        int *tmp_ptr = value;
+        if (*tmp_ptr < 1)
+        {
+            printf("\nerror: ocp_qp_parallel_riccati_opts_set: num_threads has to be positive, got %d\n",
+                   *tmp_ptr);
+            exit(1);
+        }
+        opts->num_threads = *tmp_ptr;
+    }
+    else // pass options to the fallback solver
+    {
+        ocp_qp_hpipm_opts_set(config_, opts->hpipm_opts, field, value);
+    }
+
+    return;
+}
+
+
+
+/************************************************
+ * memory
+ ************************************************/
+
+static int ocp_qp_parallel_riccati_elem_calculate_size(int nx, int ny)
+{
+    int size = 0;
+
+    size += blasfeo_memsize_dmat(ny, nx); // A
+    size += blasfeo_memsize_dmat(ny, ny); // C
+    size += blasfeo_memsize_dmat(nx, nx); // J
+    size += blasfeo_memsize_dvec(ny); // b
+    size += blasfeo_memsize_dvec(nx); // eta
+
+    return size;
+}
+
+
+
+// the matrices and the vectors of an element are assigned separately,
+// to keep all matrices 64-byte aligned
+static void ocp_qp_parallel_riccati_elem_assign_mat(int nx, int ny, ocp_qp_parallel_riccati_elem *E,
+                                                    char **c_ptr)
+{
+    assign_and_advance_blasfeo_dmat_mem(ny, nx, &E->A, c_ptr);
+    assign_and_advance_blasfeo_dmat_mem(ny, ny, &E->C, c_ptr);
+    assign_and_advance_blasfeo_dmat_mem(nx, nx, &E->J, c_ptr);
+
+    E->nx = nx;
+    E->ny = ny;
+
+    return;
+}
+
+
+
+static void ocp_qp_parallel_riccati_elem_assign_vec(int nx, int ny, ocp_qp_parallel_riccati_elem *E,
+                                                    char **c_ptr)
+{
+    assign_and_advance_blasfeo_dvec_mem(ny, &E->b, c_ptr);
+    assign_and_advance_blasfeo_dvec_mem(nx, &E->eta, c_ptr);
+
+    return;
+}
+
+
+
+int ocp_qp_parallel_riccati_memory_calculate_size(void *config_, void *dims_, void *opts_)
+{
+    ocp_qp_dims *dims = dims_;
+    ocp_qp_parallel_riccati_opts *opts = opts_;
+
+    int N = dims->N;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
+
+    int ii, nx1;
+
+    int nuM = 0;
+    int nxM = 0;
+    for (ii = 0; ii <= N; ii++)
+    {
+        nuM = nu[ii] > nuM ? nu[ii] : nuM;
+        nxM = nx[ii] > nxM ? nx[ii] : nxM;
+    }
+
+    int num_chunks = opts->num_threads < N+1 ? opts->num_threads : N+1;
+
+    int size = 0;
+    size += sizeof(ocp_qp_parallel_riccati_memory);
+
+    size += ocp_qp_hpipm_memory_calculate_size(config_, dims, opts->hpipm_opts);
+
+    size += 2*(N+1)*sizeof(ocp_qp_parallel_riccati_elem); // E S
+    size += 2*(N+1)*sizeof(struct blasfeo_dmat); // F Phit
+    size += (N+1)*sizeof(struct blasfeo_dvec); // phi
+    size += num_chunks*sizeof(ocp_qp_parallel_riccati_chunk); // chunk
+
+    size += num_chunks*nxM*sizeof(int); // ipiv
+
+    for (ii = 0; ii <= N; ii++)
+    {
+        nx1 = ii < N ? nx[ii+1] : 0;
+        size += ocp_qp_parallel_riccati_elem_calculate_size(nx[ii], nx1); // E
+        size += ocp_qp_parallel_riccati_elem_calculate_size(nx[ii], 0); // S
+        size += blasfeo_memsize_dmat(nu[ii]+nx[ii]+1, nu[ii]); // F
+        size += blasfeo_memsize_dmat(nx[ii], nx1); // Phit
+        size += blasfeo_memsize_dvec(nx1); // phi
+    }
+
+    for (ii = 0; ii < num_chunks; ii++)
+    {
+        size += 2*ocp_qp_parallel_riccati_elem_calculate_size(nxM, nxM); // G tmp
+        size += ocp_qp_parallel_riccati_elem_calculate_size(nxM, 0); // T
+        size += 7*blasfeo_memsize_dmat(nxM, nxM); // Psit M WA WC WAt T1 T2
+        size += blasfeo_memsize_dmat(nuM+nxM, nxM); // BP
+        size += blasfeo_memsize_dmat(nxM, nuM); // BL
+        size += 3*blasfeo_memsize_dvec(nxM); // psi wb tmp_nx
+        size += blasfeo_memsize_dvec(nuM); // tmp_nu
+    }
+
+    size += blasfeo_memsize_dvec(nuM+nxM); // tmp_nux
+
+    size += 2 * 8;
+    size += 1 * 64;
+    make_int_multiple_of(8, &size);
+
+    return size;
+}
+
+
+
+void *ocp_qp_parallel_riccati_memory_assign(void *config_, void *dims_, void *opts_, void *raw_memory)
+{
+    ocp_qp_dims *dims = dims_;
+    ocp_qp_parallel_riccati_opts *opts = opts_;
+    ocp_qp_parallel_riccati_memory *mem;
+
+    int N = dims->N;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
+
+    int ii, nx1;
+
+    int nuM = 0;
+    int nxM = 0;
+    for (ii = 0; ii <= N; ii++)
+    {
+        nuM = nu[ii] > nuM ? nu[ii] : nuM;
+        nxM = nx[ii] > nxM ? nx[ii] : nxM;
+    }
+
+    int num_chunks = opts->num_threads < N+1 ? opts->num_threads : N+1;
+
+    // char pointer
+    char *c_ptr = (char *) raw_memory;
+
+    mem = (ocp_qp_parallel_riccati_memory *) c_ptr;
+    c_ptr += sizeof(ocp_qp_parallel_riccati_memory);
+
+    mem->num_chunks = num_chunks;
+
+    align_char_to(8, &c_ptr);
+
+    // hpipm memory
+    mem->hpipm_mem = ocp_qp_hpipm_memory_assign(config_, dims, opts->hpipm_opts, c_ptr);
+    c_ptr += ocp_qp_hpipm_memory_calculate_size(config_, dims, opts->hpipm_opts);
+
+    align_char_to(8, &c_ptr);
+
+    // structs
+    mem->E = (ocp_qp_parallel_riccati_elem *) c_ptr;
+    c_ptr += (N+1)*sizeof(ocp_qp_parallel_riccati_elem);
+    mem->S = (ocp_qp_parallel_riccati_elem *) c_ptr;
+    c_ptr += (N+1)*sizeof(ocp_qp_parallel_riccati_elem);
+    mem->chunk = (ocp_qp_parallel_riccati_chunk *) c_ptr;
+    c_ptr += num_chunks*sizeof(ocp_qp_parallel_riccati_chunk);
+
+    // blasfeo structs
+    assign_and_advance_blasfeo_dmat_structs(N+1, &mem->F, &c_ptr);
+    assign_and_advance_blasfeo_dmat_structs(N+1, &mem->Phit, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N+1, &mem->phi, &c_ptr);
+
+    // ipiv
+    for (ii = 0; ii < num_chunks; ii++)
+        assign_and_advance_int(nxM, &mem->chunk[ii].ipiv, &c_ptr);
+
+    // blasfeo mem: matrices first, to keep them 64-byte aligned
+    align_char_to(64, &c_ptr);
+
+    for (ii = 0; ii <= N; ii++)
+    {
+        nx1 = ii < N ? nx[ii+1] : 0;
+        ocp_qp_parallel_riccati_elem_assign_mat(nx[ii], nx1, mem->E+ii, &c_ptr);
+        ocp_qp_parallel_riccati_elem_assign_mat(nx[ii], 0, mem->S+ii, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nu[ii]+nx[ii]+1, nu[ii], mem->F+ii, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nx[ii], nx1, mem->Phit+ii, &c_ptr);
+    }
+
+    for (ii = 0; ii < num_chunks; ii++)
+    {
+        ocp_qp_parallel_riccati_chunk *chunk = mem->chunk+ii;
+
+        ocp_qp_parallel_riccati_elem_assign_mat(nxM, nxM, &chunk->G, &c_ptr);
+        ocp_qp_parallel_riccati_elem_assign_mat(nxM, nxM, &chunk->tmp, &c_ptr);
+        ocp_qp_parallel_riccati_elem_assign_mat(nxM, 0, &chunk->T, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nxM, nxM, &chunk->Psit, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nxM, nxM, &chunk->M, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nxM, nxM, &chunk->WA, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nxM, nxM, &chunk->WC, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nxM, nxM, &chunk->WAt, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nxM, nxM, &chunk->T1, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nxM, nxM, &chunk->T2, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nuM+nxM, nxM, &chunk->BP, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nxM, nuM, &chunk->BL, &c_ptr);
+    }
+
+    // vectors
+    for (ii = 0; ii <= N; ii++)
+    {
+        nx1 = ii < N ? nx[ii+1] : 0;
+        ocp_qp_parallel_riccati_elem_assign_vec(nx[ii], nx1, mem->E+ii, &c_ptr);
+        ocp_qp_parallel_riccati_elem_assign_vec(nx[ii], 0, mem->S+ii, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(nx1, mem->phi+ii, &c_ptr);
+    }
+
+    for (ii = 0; ii < num_chunks; ii++)
+    {
+        ocp_qp_parallel_riccati_chunk *chunk = mem->chunk+ii;
+
+        ocp_qp_parallel_riccati_elem_assign_vec(nxM, nxM, &chunk->G, &c_ptr);
+        ocp_qp_parallel_riccati_elem_assign_vec(nxM, nxM, &chunk->tmp, &c_ptr);
+        ocp_qp_parallel_riccati_elem_assign_vec(nxM, 0, &chunk->T, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(nxM, &chunk->psi, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(nxM, &chunk->wb, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(nxM, &chunk->tmp_nx, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(nuM, &chunk->tmp_nu, &c_ptr);
+        chunk->status = 1;
+    }
+
+    assign_and_advance_blasfeo_dvec_mem(nuM+nxM, &mem->tmp_nux, &c_ptr);
+
+    mem->time_qp_solver_call = 0.0;
+    mem->iter = 0;
+    mem->riccati = 0;
+
+    assert((char *) raw_memory + ocp_qp_parallel_riccati_memory_calculate_size(config_, dims, opts_) >= c_ptr);
+
+    return mem;
+}
+
+
+
+void ocp_qp_parallel_riccati_memory_get(void *config_, void *mem_, const char *field, void* value)
+{
+    ocp_qp_parallel_riccati_memory *mem = mem_;
+
+    if (!strcmp(field, "time_qp_solver_call"))
+    {
+        double *tmp_ptr = value;
+        *tmp_ptr = mem->time_qp_solver_call;
+    }
+    else if (!strcmp(field, "iter"))
+    {
+        int *tmp_ptr = value;
+        *tmp_ptr = mem->iter;
+    }
+    else if (!strcmp(field, "riccati"))
+    {
+        int *tmp_ptr = value;
+        *tmp_ptr = mem->riccati;
+    }
+    else
+    {
+        printf("\nerror: ocp_qp_parallel_riccati_memory_get: field %s not available\n", field);
+        exit(1);
+    }
+
+    return;
+
+}
+
+
+
+/************************************************
+ * workspace
+ ************************************************/
+
+int ocp_qp_parallel_riccati_workspace_calculate_size(void *config_, void *dims_, void *opts_)
+{
+    return 0;
+}
+
+
+
+/************************************************
+ * functions
+ ************************************************/
+
+// returns 0 if the cholesky factor in the first n columns of L is singular
+static int ocp_qp_parallel_riccati_check_factor(int n, struct blasfeo_dmat *L)
+{
+    int jj;
+
+    // blasfeo sets non positive pivots to zero
+    for (jj = 0; jj < n; jj++)
+    {
+        if (!(blasfeo_dgeex1(L, jj, jj) > 0.0))
+            return 0;
+    }
+
+    return 1;
+}
+
+
+
+static void ocp_qp_parallel_riccati_elem_copy(ocp_qp_parallel_riccati_elem *E,
+                                              ocp_qp_parallel_riccati_elem *D)
+{
+    int nx = E->nx;
+    int ny = E->ny;
+
+    blasfeo_dgecp(ny, nx, &E->A, 0, 0, &D->A, 0, 0);
+    blasfeo_dgecp(ny, ny, &E->C, 0, 0, &D->C, 0, 0);
+    blasfeo_dgecp(nx, nx, &E->J, 0, 0, &D->J, 0, 0);
+    blasfeo_dveccp(ny, &E->b, 0, &D->b, 0);
+    blasfeo_dveccp(nx, &E->eta, 0, &D->eta, 0);
+
+    D->nx = nx;
+    D->ny = ny;
+
+    return;
+}
+
+
+
+// element of stage ii, obtained by eliminating u from the stage cost and dynamics;
+// the factor of [R; S; r'] is stored in F[ii]
+static int ocp_qp_parallel_riccati_stage_elem(ocp_qp_in *qp_in, int ii,
+                                              ocp_qp_parallel_riccati_memory *mem,
+                                              ocp_qp_parallel_riccati_chunk *chunk)
+{
+    int N = qp_in->dim->N;
+    int *nx = qp_in->dim->nx;
+    int *nu = qp_in->dim->nu;
+
+    int nu0 = nu[ii];
+    int nx0 = nx[ii];
+    int nx1 = ii < N ? nx[ii+1] : 0;
+
+    ocp_qp_parallel_riccati_elem *E = mem->E+ii;
+    struct blasfeo_dmat *F = mem->F+ii;
+
+    // F = [Lr; Ls; lr] = chol([R; S; r'])
+    blasfeo_dgecp(nu0+nx0, nu0, qp_in->RSQrq+ii, 0, 0, F, 0, 0);
+    blasfeo_drowin(nu0, 1.0, qp_in->rqz+ii, 0, F, nu0+nx0, 0);
+    blasfeo_dpotrf_l_mn(nu0+nx0+1, nu0, F, 0, 0, F, 0, 0);
+    if (!ocp_qp_parallel_riccati_check_factor(nu0, F))
+        return 0;
+
+    // J = Q - S R^-1 S'
+    blasfeo_dtrcp_l(nx0, qp_in->RSQrq+ii, nu0, nu0, &E->J, 0, 0);
+    blasfeo_dsyrk_ln(nx0, nu0, -1.0, F, nu0, 0, F, nu0, 0, 1.0, &E->J, 0, 0, &E->J, 0, 0);
+    blasfeo_dtrtr_l(nx0, &E->J, 0, 0, &E->J, 0, 0);
+
+    // eta = - q + S R^-1 r
+    blasfeo_drowex(nu0, 1.0, F, nu0+nx0, 0, &chunk->tmp_nu, 0);
+    blasfeo_dgemv_n(nx0, nu0, 1.0, F, nu0, 0, &chunk->tmp_nu, 0, -1.0, qp_in->rqz+ii, nu0,
+                    &E->eta, 0);
+
+    if (ii < N)
+    {
+        // BL = B Lr^-T
+        blasfeo_dgetr(nu0, nx1, qp_in->BAbt+ii, 0, 0, &chunk->BL, 0, 0);
+        blasfeo_dtrsm_rltn(nx1, nu0, 1.0, F, 0, 0, &chunk->BL, 0, 0, &chunk->BL, 0, 0);
+
+        // C = B R^-1 B'
+        blasfeo_dgemm_nt(nx1, nx1, nu0, 1.0, &chunk->BL, 0, 0, &chunk->BL, 0, 0, 0.0, &E->C, 0, 0,
+                         &E->C, 0, 0);
+
+        // A = A - B R^-1 S'
+        blasfeo_dgetr(nx0, nx1, qp_in->BAbt+ii, nu0, 0, &E->A, 0, 0);
+        blasfeo_dgemm_nt(nx1, nx0, nu0, -1.0, &chunk->BL, 0, 0, F, nu0, 0, 1.0, &E->A, 0, 0,
+                         &E->A, 0, 0);
+
+        // b = b - B R^-1 r
+        blasfeo_dgemv_n(nx1, nu0, -1.0, &chunk->BL, 0, 0, &chunk->tmp_nu, 0, 1.0, qp_in->b+ii, 0,
+                        &E->b, 0);
+    }
+
+    E->nx = nx0;
+    E->ny = nx1;
+
+    return 1;
+}
+
+
+
+// D = Ei * Ej, the element of the stages of Ei followed by the stages of Ej;
+// D must not alias Ei or Ej
+static void ocp_qp_parallel_riccati_combine(ocp_qp_parallel_riccati_elem *Ei,
+                                            ocp_qp_parallel_riccati_elem *Ej,
+                                            ocp_qp_parallel_riccati_elem *D,
+                                            ocp_qp_parallel_riccati_chunk *chunk)
+{
+    int nx = Ei->nx;
+    int ny = Ei->ny;
+    int nz = Ej->ny;
+
+    if (ny == 0)
+    {
+        ocp_qp_parallel_riccati_elem_copy(Ei, D);
+        return;
+    }
+
+    struct blasfeo_dmat *M = &chunk->M;
+    struct blasfeo_dmat *WA = &chunk->WA;
+    struct blasfeo_dmat *WC = &chunk->WC;
+    struct blasfeo_dvec *wb = &chunk->wb;
+    int *ipiv = chunk->ipiv;
+
+    // M = I + Ci Jj
+    blasfeo_dgemm_nn(ny, ny, ny, 1.0, &Ei->C, 0, 0, &Ej->J, 0, 0, 0.0, M, 0, 0, M, 0, 0);
+    blasfeo_ddiare(ny, 1.0, M, 0, 0);
+    blasfeo_dgetrf_rp(ny, ny, M, 0, 0, M, 0, 0, ipiv);
+
+    // WA = M^-1 Ai
+    blasfeo_dgecp(ny, nx, &Ei->A, 0, 0, WA, 0, 0);
+    blasfeo_drowpe(ny, ipiv, WA);
+    blasfeo_dtrsm_llnu(ny, nx, 1.0, M, 0, 0, WA, 0, 0, WA, 0, 0);
+    blasfeo_dtrsm_lunn(ny, nx, 1.0, M, 0, 0, WA, 0, 0, WA, 0, 0);
+
+    // WC = M^-1 Ci
+    blasfeo_dgecp(ny, ny, &Ei->C, 0, 0, WC, 0, 0);
+    blasfeo_drowpe(ny, ipiv, WC);
+    blasfeo_dtrsm_llnu(ny, ny, 1.0, M, 0, 0, WC, 0, 0, WC, 0, 0);
+    blasfeo_dtrsm_lunn(ny, ny, 1.0, M, 0, 0, WC, 0, 0, WC, 0, 0);
+
+    // wb = M^-1 (bi + Ci etaj)
+    blasfeo_dgemv_n(ny, ny, 1.0, &Ei->C, 0, 0, &Ej->eta, 0, 1.0, &Ei->b, 0, wb, 0);
+    blasfeo_dvecpe(ny, ipiv, wb, 0);
+    blasfeo_dtrsv_lnu(ny, M, 0, 0, wb, 0, wb, 0);
+    blasfeo_dtrsv_unn(ny, M, 0, 0, wb, 0, wb, 0);
+
+    // eta = WA' (etaj - Jj bi) + etai
+    blasfeo_dgemv_n(ny, ny, -1.0, &Ej->J, 0, 0, &Ei->b, 0, 1.0, &Ej->eta, 0, &chunk->tmp_nx, 0);
+    blasfeo_dgemv_t(ny, nx, 1.0, WA, 0, 0, &chunk->tmp_nx, 0, 1.0, &Ei->eta, 0, &D->eta, 0);
+
+    // J = WA' Jj Ai + Ji
+    blasfeo_dgemm_nn(ny, nx, ny, 1.0, &Ej->J, 0, 0, &Ei->A, 0, 0, 0.0, &chunk->T1, 0, 0,
+                     &chunk->T1, 0, 0);
+    blasfeo_dgetr(ny, nx, WA, 0, 0, &chunk->WAt, 0, 0);
+    blasfeo_dgemm_nn(nx, nx, ny, 1.0, &chunk->WAt, 0, 0, &chunk->T1, 0, 0, 1.0, &Ei->J, 0, 0,
+                     &D->J, 0, 0);
+
+    if (nz > 0)
+    {
+        // A = Aj WA
+        blasfeo_dgemm_nn(nz, nx, ny, 1.0, &Ej->A, 0, 0, WA, 0, 0, 0.0, &D->A, 0, 0, &D->A, 0, 0);
+
+        // b = Aj wb + bj
+        blasfeo_dgemv_n(nz, ny, 1.0, &Ej->A, 0, 0, wb, 0, 1.0, &Ej->b, 0, &D->b, 0);
+
+        // C = Aj WC Aj' + Cj
+        blasfeo_dgemm_nn(nz, ny, ny, 1.0, &Ej->A, 0, 0, WC, 0, 0, 0.0, &chunk->T2, 0, 0,
+                         &chunk->T2, 0, 0);
+        blasfeo_dgemm_nt(nz, nz, ny, 1.0, &chunk->T2, 0, 0, &Ej->A, 0, 0, 1.0, &Ej->C, 0, 0,
+                         &D->C, 0, 0);
+    }
+
+    D->nx = nx;
+    D->ny = nz;
+
+    return;
+}
+
+
+
+// factor F[ii] of the hessian in u of the stage cost plus the cost-to-go S[ii+1],
+// and closed-loop dynamics x_next = Phit' x + phi
+static int ocp_qp_parallel_riccati_stage_feedback(ocp_qp_in *qp_in, int ii,
+                                                  ocp_qp_parallel_riccati_memory *mem,
+                                                  ocp_qp_parallel_riccati_chunk *chunk)
+{
+    int *nx = qp_in->dim->nx;
+    int *nu = qp_in->dim->nu;
+
+    int nu0 = nu[ii];
+    int nx0 = nx[ii];
+    int nx1 = nx[ii+1];
+
+    struct blasfeo_dmat *F = mem->F+ii;
+    struct blasfeo_dmat *P = &mem->S[ii+1].J;
+    struct blasfeo_dvec *eta = &mem->S[ii+1].eta;
+
+    // [R; S] + [B'; A'] P B
+    blasfeo_dgemm_nn(nu0+nx0, nx1, nx1, 1.0, qp_in->BAbt+ii, 0, 0, P, 0, 0, 0.0, &chunk->BP, 0, 0,
+                     &chunk->BP, 0, 0);
+    blasfeo_dgemm_nt(nu0+nx0, nu0, nx1, 1.0, &chunk->BP, 0, 0, qp_in->BAbt+ii, 0, 0, 1.0,
+                     qp_in->RSQrq+ii, 0, 0, F, 0, 0);
+
+    // r + B' (P b + p)
+    blasfeo_dgemv_n(nx1, nx1, 1.0, P, 0, 0, qp_in->b+ii, 0, -1.0, eta, 0, &chunk->tmp_nx, 0);
+    blasfeo_dgemv_n(nu0, nx1, 1.0, qp_in->BAbt+ii, 0, 0, &chunk->tmp_nx, 0, 1.0, qp_in->rqz+ii, 0,
+                    &chunk->tmp_nu, 0);
+    blasfeo_drowin(nu0, 1.0, &chunk->tmp_nu, 0, F, nu0+nx0, 0);
+
+    blasfeo_dpotrf_l_mn(nu0+nx0+1, nu0, F, 0, 0, F, 0, 0);
+    if (!ocp_qp_parallel_riccati_check_factor(nu0, F))
+        return 0;
+
+    // Z = B Lu^-T
+    blasfeo_dgetr(nu0, nx1, qp_in->BAbt+ii, 0, 0, &chunk->BL, 0, 0);
+    blasfeo_dtrsm_rltn(nx1, nu0, 1.0, F, 0, 0, &chunk->BL, 0, 0, &chunk->BL, 0, 0);
+
+    // Phit = A' - Lxu Z', phi = b - Z lu'
+    blasfeo_dgemm_nt(nx0, nx1, nu0, -1.0, F, nu0, 0, &chunk->BL, 0, 0, 1.0, qp_in->BAbt+ii, nu0, 0,
+                     mem->Phit+ii, 0, 0);
+    blasfeo_drowex(nu0, 1.0, F, nu0+nx0, 0, &chunk->tmp_nu, 0);
+    blasfeo_dgemv_n(nx1, nu0, -1.0, &chunk->BL, 0, 0, &chunk->tmp_nu, 0, 1.0, qp_in->b+ii, 0,
+                    mem->phi+ii, 0);
+
+    return 1;
+}
+
+
+
+// first stage of chunk ii out of nc over the stages 0..N
+static int ocp_qp_parallel_riccati_chunk_start(int N, int nc, int ii)
+{
+    return ii*(N+1)/nc;
+}
+
+
+
+// backward pass: cost-to-go of all stages and feedback factors
+static int ocp_qp_parallel_riccati_factorize(ocp_qp_in *qp_in, int nc,
+                                             ocp_qp_parallel_riccati_memory *mem)
+{
+    int N = qp_in->dim->N;
+    int *nx = qp_in->dim->nx;
+
+    ocp_qp_parallel_riccati_chunk *chunk = mem->chunk;
+
+    int ii;
+
+    // stage elements and chunk aggregates
+#if defined(ACADOS_WITH_OPENMP)
+    #pragma omp parallel for num_threads(nc)
+#endif
+    for (ii = 0; ii < nc; ii++)
+    {
+        int k0 = ocp_qp_parallel_riccati_chunk_start(N, nc, ii);
+        int k1 = ocp_qp_parallel_riccati_chunk_start(N, nc, ii+1);
+        int kk;
+
+        chunk[ii].status = 1;
+        for (kk = k0; kk < k1; kk++)
+            chunk[ii].status &= ocp_qp_parallel_riccati_stage_elem(qp_in, kk, mem, chunk+ii);
+
+        // the aggregate of the first chunk is not needed
+        if (ii > 0 && chunk[ii].status)
+        {
+            ocp_qp_parallel_riccati_elem_copy(mem->E+k1-1, &chunk[ii].G);
+            for (kk = k1-2; kk >= k0; kk--)
+            {
+                ocp_qp_parallel_riccati_combine(mem->E+kk, &chunk[ii].G, &chunk[ii].tmp, chunk+ii);
+                ocp_qp_parallel_riccati_elem_copy(&chunk[ii].tmp, &chunk[ii].G);
+            }
+        }
+    }
+
+    for (ii = 0; ii < nc; ii++)
+    {
+        if (!chunk[ii].status)
+            return 0;
+    }
+
+    // cost-to-go at the end of each chunk, the aggregate of the last chunk contains the last stage
+    if (nc > 1)
+        ocp_qp_parallel_riccati_elem_copy(&chunk[nc-1].G, &chunk[nc-2].T);
+    for (ii = nc-3; ii >= 0; ii--)
+        ocp_qp_parallel_riccati_combine(&chunk[ii+1].G, &chunk[ii+1].T, &chunk[ii].T, chunk+ii);
+
+    // cost-to-go within the chunks
+#if defined(ACADOS_WITH_OPENMP)
+    #pragma omp parallel for num_threads(nc)
+#endif
+    for (ii = 0; ii < nc; ii++)
+    {
+        int k0 = ocp_qp_parallel_riccati_chunk_start(N, nc, ii);
+        int k1 = ocp_qp_parallel_riccati_chunk_start(N, nc, ii+1);
+        int kk;
+
+        if (ii == nc-1)
+            ocp_qp_parallel_riccati_elem_copy(mem->E+N, mem->S+N);
+        else
+            ocp_qp_parallel_riccati_combine(mem->E+k1-1, &chunk[ii].T, mem->S+k1-1, chunk+ii);
+        for (kk = k1-2; kk >= k0; kk--)
+            ocp_qp_parallel_riccati_combine(mem->E+kk, mem->S+kk+1, mem->S+kk, chunk+ii);
+    }
+
+    // feedback within the chunks, needs the cost-to-go of the first stage of the next chunk
+#if defined(ACADOS_WITH_OPENMP)
+    #pragma omp parallel for num_threads(nc)
+#endif
+    for (ii = 0; ii < nc; ii++)
+    {
+        int k0 = ocp_qp_parallel_riccati_chunk_start(N, nc, ii);
+        int k1 = ocp_qp_parallel_riccati_chunk_start(N, nc, ii+1);
+        int kk;
+
+        chunk[ii].status = 1;
+        for (kk = k0; kk < k1 && kk < N; kk++)
+            chunk[ii].status &= ocp_qp_parallel_riccati_stage_feedback(qp_in, kk, mem, chunk+ii);
+
+        // closed-loop map over the chunk
+        if (ii < nc-1 && chunk[ii].status)
+        {
+            blasfeo_dgecp(nx[k0], nx[k0+1], mem->Phit+k0, 0, 0, &chunk[ii].Psit, 0, 0);
+            blasfeo_dveccp(nx[k0+1], mem->phi+k0, 0, &chunk[ii].psi, 0);
+            for (kk = k0+1; kk < k1; kk++)
+            {
+                blasfeo_dgemm_nn(nx[k0], nx[kk+1], nx[kk], 1.0, &chunk[ii].Psit, 0, 0, mem->Phit+kk,
+                                 0, 0, 0.0, &chunk[ii].T1, 0, 0, &chunk[ii].T1, 0, 0);
+                blasfeo_dgecp(nx[k0], nx[kk+1], &chunk[ii].T1, 0, 0, &chunk[ii].Psit, 0, 0);
+                blasfeo_dgemv_t(nx[kk], nx[kk+1], 1.0, mem->Phit+kk, 0, 0, &chunk[ii].psi, 0, 1.0,
+                                mem->phi+kk, 0, &chunk[ii].tmp_nx, 0);
+                blasfeo_dveccp(nx[kk+1], &chunk[ii].tmp_nx, 0, &chunk[ii].psi, 0);
+            }
+        }
+    }
+
+    for (ii = 0; ii < nc; ii++)
+    {
+        if (!chunk[ii].status)
+            return 0;
+    }
+
+    return 1;
+}
+
+
+
+// forward pass: states at the chunk boundaries, then the chunks in parallel
+static void ocp_qp_parallel_riccati_solve(ocp_qp_in *qp_in, ocp_qp_out *qp_out, int x0_fixed,
+                                          int nc, ocp_qp_parallel_riccati_memory *mem)
+{
+    int N = qp_in->dim->N;
+    int *nx = qp_in->dim->nx;
+    int *nu = qp_in->dim->nu;
+    int *nb = qp_in->dim->nb;
+
+    ocp_qp_parallel_riccati_chunk *chunk = mem->chunk;
+
+    int ii, k0, k1;
+
+    // initial state
+    if (x0_fixed)
+    {
+        blasfeo_dvecse(nx[0], 0.0, qp_out->ux+0, nu[0]);
+        blasfeo_dvecad_sp(nb[0], 1.0, qp_in->d+0, 0, qp_in->idxb[0], qp_out->ux+0, 0);
+    }
+    else
+    {
+        // minimizer of the cost-to-go of the first stage, P x = -p
+        blasfeo_dpotrf_l(nx[0], &mem->S[0].J, 0, 0, &mem->S[0].J, 0, 0);
+        blasfeo_dveccp(nx[0], &mem->S[0].eta, 0, qp_out->ux+0, nu[0]);
+        blasfeo_dtrsv_lnn(nx[0], &mem->S[0].J, 0, 0, qp_out->ux+0, nu[0], qp_out->ux+0, nu[0]);
+        blasfeo_dtrsv_ltn(nx[0], &mem->S[0].J, 0, 0, qp_out->ux+0, nu[0], qp_out->ux+0, nu[0]);
+    }
+
+    for (ii = 0; ii < nc-1; ii++)
+    {
+        k0 = ocp_qp_parallel_riccati_chunk_start(N, nc, ii);
+        k1 = ocp_qp_parallel_riccati_chunk_start(N, nc, ii+1);
+        blasfeo_dgemv_t(nx[k0], nx[k1], 1.0, &chunk[ii].Psit, 0, 0, qp_out->ux+k0, nu[k0], 1.0,
+                        &chunk[ii].psi, 0, qp_out->ux+k1, nu[k1]);
+    }
+
+#if defined(ACADOS_WITH_OPENMP)
+    #pragma omp parallel for num_threads(nc)
+#endif
+    for (ii = 0; ii < nc; ii++)
+    {
+        int k0 = ocp_qp_parallel_riccati_chunk_start(N, nc, ii);
+        int k1 = ocp_qp_parallel_riccati_chunk_start(N, nc, ii+1);
+        int kk, nu0, nx0, nu1, nx1;
+
+        for (kk = k0; kk < k1; kk++)
+        {
+            nu0 = nu[kk];
+            nx0 = nx[kk];
+
+            // u = - Lu^-T (Lxu' x + lu')
+            blasfeo_drowex(nu0, 1.0, mem->F+kk, nu0+nx0, 0, qp_out->ux+kk, 0);
+            blasfeo_dgemv_t(nx0, nu0, 1.0, mem->F+kk, nu0, 0, qp_out->ux+kk, nu0, 1.0,
+                            qp_out->ux+kk, 0, qp_out->ux+kk, 0);
+            blasfeo_dtrsv_ltn(nu0, mem->F+kk, 0, 0, qp_out->ux+kk, 0, qp_out->ux+kk, 0);
+            blasfeo_dvecsc(nu0, -1.0, qp_out->ux+kk, 0);
+
+            if (kk < N)
+            {
+                nu1 = nu[kk+1];
+                nx1 = nx[kk+1];
+
+                // x_next = B u + A x + b, the first state of the next chunk is already known
+                if (kk+1 < k1)
+                    blasfeo_dgemv_t(nu0+nx0, nx1, 1.0, qp_in->BAbt+kk, 0, 0, qp_out->ux+kk, 0, 1.0,
+                                    qp_in->b+kk, 0, qp_out->ux+kk+1, nu1);
+
+                // pi = P x_next + p
+                blasfeo_dgemv_n(nx1, nx1, 1.0, &mem->S[kk+1].J, 0, 0, qp_out->ux+kk+1, nu1, -1.0,
+                                &mem->S[kk+1].eta, 0, qp_out->pi+kk, 0);
+            }
+
+            blasfeo_dvecse(2*nb[kk], 0.0, qp_out->lam+kk, 0);
+            blasfeo_dvecse(2*nb[kk], 0.0, qp_out->t+kk, 0);
+        }
+    }
+
+    if (x0_fixed)
+        ocp_qp_riccati_x0_multipliers(qp_in, qp_out, &mem->tmp_nux);
+
+    return;
+}
+
+
+
+int ocp_qp_parallel_riccati(void *config_, void *qp_in_, void *qp_out_, void *opts_, void *mem_, void *work_)
+{
+    ocp_qp_in *qp_in = qp_in_;
+    ocp_qp_out *qp_out = qp_out_;
+
+    ocp_qp_parallel_riccati_opts *opts = opts_;
+    ocp_qp_parallel_riccati_memory *mem = mem_;
+
+    qp_info *info = qp_out->misc;
+    acados_timer tot_timer, qp_timer;
+
+    acados_tic(&tot_timer);
+
+    int N = qp_in->dim->N;
+    int nc = opts->num_threads < mem->num_chunks ? opts->num_threads : mem->num_chunks;
+    nc = nc < N+1 ? nc : N+1;
+
+    int structure = ocp_qp_riccati_check_structure(qp_in);
+
+    // factorize and solve
+    acados_tic(&qp_timer);
+    if (structure != 0 && ocp_qp_parallel_riccati_factorize(qp_in, nc, mem))
+        ocp_qp_parallel_riccati_solve(qp_in, qp_out, structure == 2, nc, mem);
+    else
+        structure = 0;
+
+    if (structure == 0)
+    {
+        mem->riccati = 0;
+        if (!opts->fallback)
+            return ACADOS_QP_FAILURE;
+
+        int status = ocp_qp_hpipm(config_, qp_in, qp_out, opts->hpipm_opts, mem->hpipm_mem, work_);
+
+        mem->time_qp_solver_call = mem->hpipm_mem->time_qp_solver_call;
+        mem->iter = mem->hpipm_mem->iter;
+
+        return status;
+    }
+
+    info->solve_QP_time = acados_toc(&qp_timer);
+    info->interface_time = 0;
+    info->total_time = acados_toc(&tot_timer);
+    info->num_iter = 1;
+    info->t_computed = 1;
+
+    mem->time_qp_solver_call = info->solve_QP_time;
+    mem->iter = 1;
+    mem->riccati = structure;
+
+    return ACADOS_SUCCESS;
+}
+
+
+
+void ocp_qp_parallel_riccati_eval_sens(void *config_, void *param_qp_in_, void *sens_qp_out_, void *opts_, void *mem_, void *work_)
+{
+    ocp_qp_in *param_qp_in = param_qp_in_;
+    ocp_qp_out *sens_qp_out = sens_qp_out_;
+
+    ocp_qp_parallel_riccati_opts *opts = opts_;
+    ocp_qp_parallel_riccati_memory *mem = mem_;
+
+    if (mem->riccati == 0)
+    {
+        ocp_qp_hpipm_eval_sens(config_, param_qp_in, sens_qp_out, opts->hpipm_opts, mem->hpipm_mem, work_);
+        return;
+    }
+
+    int N = param_qp_in->dim->N;
+    int nc = opts->num_threads < mem->num_chunks ? opts->num_threads : mem->num_chunks;
+    nc = nc < N+1 ? nc : N+1;
+
+    // the qp is linear, the sensitivities solve the same kkt system with the parametric vectors
+    ocp_qp_parallel_riccati_factorize(param_qp_in, nc, mem);
+    ocp_qp_parallel_riccati_solve(param_qp_in, sens_qp_out, mem->riccati == 2, nc, mem);
+
+    return;
+}
+
+
+
+void ocp_qp_parallel_riccati_config_initialize_default(void *config_)
+{
+    qp_solver_config *config = config_;
+
+    config->dims_set = &ocp_qp_dims_set;
+    config->opts_calculate_size = &ocp_qp_parallel_riccati_opts_calculate_size;
+    config->opts_assign = &ocp_qp_parallel_riccati_opts_assign;
+    config->opts_initialize_default = &ocp_qp_parallel_riccati_opts_initialize_default;
+    config->opts_update = &ocp_qp_parallel_riccati_opts_update;
+    config->opts_set = &ocp_qp_parallel_riccati_opts_set;
+    config->memory_calculate_size = &ocp_qp_parallel_riccati_memory_calculate_size;
+    config->memory_assign = &ocp_qp_parallel_riccati_memory_assign;
+    config->memory_get = &ocp_qp_parallel_riccati_memory_get;
+    config->workspace_calculate_size = &ocp_qp_parallel_riccati_workspace_calculate_size;
+    config->evaluate = &ocp_qp_parallel_riccati;
+    config->eval_sens = &ocp_qp_parallel_riccati_eval_sens;
+
+    return;
+}
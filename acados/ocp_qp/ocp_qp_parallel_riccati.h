@@ -0,0 +1,159 @@
+/*
+ * Copyright 2019 Gianluca Frison, Dimitris Kouzoupis, Robin Verschueren,
+ * Andrea Zanelli, Niels van Duijkeren, Jonathan Frey, Tommaso Sartor,
+ * Branimir Novoselnik, Rien Quirynen, Rezart Qelibari, Dang Doan,
+ * Jonas Koenemann, Yutao Chen, Tobias Schöls, Jonas Schlagenhauf, Moritz Diehl
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+
+#ifndef ACADOS_OCP_QP_OCP_QP_PARALLEL_RICCATI_H_
+#define ACADOS_OCP_QP_OCP_QP_PARALLEL_RICCATI_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// blasfeo
+#include "blasfeo/include/blasfeo_common.h"
+// acados
+#include "acados/ocp_qp/ocp_qp_common.h"
+#include "acados/ocp_qp/ocp_qp_hpipm.h"
+#include "acados/utils/types.h"
+
+
+
+// Chunked Riccati recursion for ocp qps without inequalities: the stages are split into
+// num_threads contiguous chunks. Each chunk combines its conditional value function elements
+// serially, in parallel to the other chunks; the chunk aggregates are then combined serially
+// into the cost-to-go at the chunk boundaries, and the stages within each chunk are again
+// processed serially, in parallel to the other chunks. The forward substitution is chunked
+// the same way. The depth is O(N/num_threads + num_threads), not the O(log N) of a cyclic
+// reduction, so it only pays off for horizons much longer than the number of threads
+// (see examples/c/no_interface_examples/mass_spring_parallel_riccati_benchmark.c).
+// Requires positive definite input hessians R; all other qps are passed to hpipm.
+typedef struct ocp_qp_parallel_riccati_opts_
+{
+    ocp_qp_hpipm_opts *hpipm_opts; // opts of the fallback solver
+    int fallback; // use hpipm if the qp can not be solved, otherwise return ACADOS_QP_FAILURE
+    int num_threads; // number of chunks the horizon is split into
+} ocp_qp_parallel_riccati_opts;
+
+
+
+// value function element of the stages i..j-1, as a function of x_i and x_j:
+// V(x_i, x_j) = max_lam lam' (x_j - A x_i - b) - 1/2 lam' C lam + 1/2 x_i' J x_i - eta' x_i
+typedef struct ocp_qp_parallel_riccati_elem_
+{
+    struct blasfeo_dmat A; // ny x nx
+    struct blasfeo_dmat C; // ny x ny
+    struct blasfeo_dmat J; // nx x nx
+    struct blasfeo_dvec b; // ny
+    struct blasfeo_dvec eta; // nx
+    int nx;
+    int ny; // 0 if the element contains the last stage
+} ocp_qp_parallel_riccati_elem;
+
+
+
+// aggregates and scratch of one chunk of stages
+typedef struct ocp_qp_parallel_riccati_chunk_
+{
+    ocp_qp_parallel_riccati_elem G; // aggregate of the chunk elements
+    ocp_qp_parallel_riccati_elem T; // cost-to-go at the first stage of the next chunk
+    ocp_qp_parallel_riccati_elem tmp;
+    struct blasfeo_dmat Psit; // transposed closed-loop map over the chunk
+    struct blasfeo_dvec psi;
+    struct blasfeo_dmat M;
+    struct blasfeo_dmat WA;
+    struct blasfeo_dmat WC;
+    struct blasfeo_dmat WAt;
+    struct blasfeo_dmat T1;
+    struct blasfeo_dmat T2;
+    struct blasfeo_dmat BP;
+    struct blasfeo_dmat BL;
+    struct blasfeo_dvec wb;
+    struct blasfeo_dvec tmp_nx;
+    struct blasfeo_dvec tmp_nu;
+    int *ipiv;
+    int status; // 0 if a non positive definite factor was encountered
+} ocp_qp_parallel_riccati_chunk;
+
+
+
+typedef struct ocp_qp_parallel_riccati_memory_
+{
+    ocp_qp_parallel_riccati_elem *E; // stage elements
+    ocp_qp_parallel_riccati_elem *S; // cost-to-go: P = J, p = -eta
+    struct blasfeo_dmat *F; // (nu+nx+1)x(nu) factor of the input hessian and feedback, one per stage
+    struct blasfeo_dmat *Phit; // transposed closed-loop dynamics, one per stage
+    struct blasfeo_dvec *phi;
+    ocp_qp_parallel_riccati_chunk *chunk;
+    struct blasfeo_dvec tmp_nux;
+    ocp_qp_hpipm_memory *hpipm_mem;
+    int num_chunks; // maximum number of chunks
+    double time_qp_solver_call;
+    int iter;
+    int riccati; // structure of the last qp solved by the riccati recursion, 0 if solved by hpipm
+} ocp_qp_parallel_riccati_memory;
+
+
+
+//
+int ocp_qp_parallel_riccati_opts_calculate_size(void *config, void *dims);
+//
+void *ocp_qp_parallel_riccati_opts_assign(void *config, void *dims, void *raw_memory);
+//
+void ocp_qp_parallel_riccati_opts_initialize_default(void *config, void *dims, void *opts_);
+//
+void ocp_qp_parallel_riccati_opts_update(void *config, void *dims, void *opts_);
+//
+void ocp_qp_parallel_riccati_opts_set(void *config_, void *opts_, const char *field, void *value);
+//
+int ocp_qp_parallel_riccati_memory_calculate_size(void *config, void *dims, void *opts_);
+//
+void *ocp_qp_parallel_riccati_memory_assign(void *config, void *dims, void *opts_, void *raw_memory);
+//
+void ocp_qp_parallel_riccati_memory_get(void *config_, void *mem_, const char *field, void* value);
+//
+int ocp_qp_parallel_riccati_workspace_calculate_size(void *config, void *dims, void *opts_);
+//
+int ocp_qp_parallel_riccati(void *config, void *qp_in, void *qp_out, void *opts_, void *mem_, void *work_);
+//
+void ocp_qp_parallel_riccati_eval_sens(void *config, void *qp_in, void *qp_out, void *opts_, void *mem_, void *work_);
+//
+void ocp_qp_parallel_riccati_config_initialize_default(void *config);
+
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif  // ACADOS_OCP_QP_OCP_QP_PARALLEL_RICCATI_H_
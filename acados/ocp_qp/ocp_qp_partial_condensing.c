@@ -43,6 +43,7 @@
 #include "hpipm/include/hpipm_d_ocp_qp_red.h"
 // hpipm
 #include "hpipm/include/hpipm_d_cond.h"
+#include "hpipm/include/hpipm_d_cond_aux.h"
 #include "hpipm/include/hpipm_d_dense_qp.h"
 #include "hpipm/include/hpipm_d_dense_qp_sol.h"
 #include "hpipm/include/hpipm_d_ocp_qp.h"
@@ -50,6 +51,10 @@
 #include "hpipm/include/hpipm_d_ocp_qp_sol.h"
 #include "hpipm/include/hpipm_d_part_cond.h"
 #include "acados/utils/timing.h"
+// openmp
+#if defined(ACADOS_WITH_OPENMP)
+#include <omp.h>
+#endif
 
 
 
@@ -254,6 +259,7 @@ void ocp_qp_partial_condensing_opts_initialize_default(void *dims_, void *opts_)
     d_ocp_qp_reduce_eq_dof_arg_set_alias_unchanged(opts->hpipm_red_opts, 1);
 
     opts->mem_qp_in = 1;
+    opts->num_threads = 1;
 
     return;
 }
@@ -297,6 +303,11 @@ void ocp_qp_partial_condensing_opts_set(void *opts_, const char *field, void* va
         int *tmp_ptr = value;
         opts->ric_alg = *tmp_ptr;
     }
+    else if(!strcmp(field, "num_threads"))
+    {
+        int *tmp_ptr = value;
+        opts->num_threads = *tmp_ptr;
+    }
     // TODO dual_sol ???
     else
     {
@@ -347,6 +358,17 @@ int ocp_qp_partial_condensing_memory_calculate_size(void *dims_, void *opts_)
     size += sizeof(struct d_ocp_qp_reduce_eq_dof_ws);
     size += d_ocp_qp_reduce_eq_dof_ws_memsize(dims->orig_dims);
 
+    size += ocp_qp_out_calculate_size(dims->orig_dims);  // probe_sol
+
+    // block_offset
+    size += (dims->orig_dims->N + 1) * sizeof(int);
+
+    // lam_idx, condensing keeps the number of inequalities
+    int nlam = 0;
+    for (int ii = 0; ii <= dims->orig_dims->N; ii++)
+        nlam += 2 * (dims->orig_dims->nb[ii] + dims->orig_dims->ng[ii] + dims->orig_dims->ns[ii]);
+    size += 2 * nlam * sizeof(int);
+
     size += 2*8;
     make_int_multiple_of(8, &size);
 
@@ -398,8 +420,24 @@ void *ocp_qp_partial_condensing_memory_assign(void *dims_, void *opts_, void *ra
     mem->red_sol = ocp_qp_out_assign(dims->red_dims, c_ptr);
     c_ptr += ocp_qp_out_calculate_size(dims->red_dims);
 
+    mem->probe_sol = ocp_qp_out_assign(dims->orig_dims, c_ptr);
+    c_ptr += ocp_qp_out_calculate_size(dims->orig_dims);
+
     mem->qp_out_info = (qp_info *) mem->pcond_qp_out->misc;
 
+    // lam_idx
+    int nlam = 0;
+    for (int ii = 0; ii <= dims->orig_dims->N; ii++)
+        nlam += 2 * (dims->orig_dims->nb[ii] + dims->orig_dims->ng[ii] + dims->orig_dims->ns[ii]);
+    assign_and_advance_int(2 * nlam, &mem->lam_idx, &c_ptr);
+
+    // block_offset
+    assign_and_advance_int(dims->orig_dims->N + 1, &mem->block_offset, &c_ptr);
+    d_part_cond_qp_compute_block_size(dims->red_dims->N, opts->N2, dims->block_size);
+    mem->block_offset[0] = 0;
+    for (int ii = 0; ii < opts->N2; ii++)
+        mem->block_offset[ii+1] = mem->block_offset[ii] + dims->block_size[ii];
+
     assert((char *) raw_memory + ocp_qp_partial_condensing_memory_calculate_size(dims, opts) >= c_ptr);
 
     return mem;
@@ -458,6 +496,142 @@ int ocp_qp_partial_condensing_workspace_calculate_size(void *dims_, void *opts_)
  * functions
  ************************************************/
 
+#if defined(ACADOS_WITH_OPENMP)
+// alias the stages of one block of qp as a stand-alone qp of horizon bs (as hpipm does internally),
+// so that each block can be processed by the per-block hpipm routines without copying data
+static void ocp_qp_partial_condensing_alias_block(ocp_qp_in *qp, int k0, int bs,
+                                                  ocp_qp_dims *blk_dims, ocp_qp_in *blk_qp)
+{
+    ocp_qp_dims *dims = qp->dim;
+
+    *blk_dims = *dims;
+    blk_dims->N = bs;
+    blk_dims->nx = dims->nx + k0;
+    blk_dims->nu = dims->nu + k0;
+    blk_dims->nb = dims->nb + k0;
+    blk_dims->nbx = dims->nbx + k0;
+    blk_dims->nbu = dims->nbu + k0;
+    blk_dims->ng = dims->ng + k0;
+    blk_dims->ns = dims->ns + k0;
+    blk_dims->nsbx = dims->nsbx + k0;
+    blk_dims->nsbu = dims->nsbu + k0;
+    blk_dims->nsg = dims->nsg + k0;
+    blk_dims->nbxe = dims->nbxe + k0;
+    blk_dims->nbue = dims->nbue + k0;
+    blk_dims->nge = dims->nge + k0;
+
+    *blk_qp = *qp;
+    blk_qp->dim = blk_dims;
+    blk_qp->BAbt = qp->BAbt + k0;
+    blk_qp->b = qp->b + k0;
+    blk_qp->RSQrq = qp->RSQrq + k0;
+    blk_qp->rqz = qp->rqz + k0;
+    blk_qp->DCt = qp->DCt + k0;
+    blk_qp->d = qp->d + k0;
+    blk_qp->d_mask = qp->d_mask + k0;
+    blk_qp->m = qp->m + k0;
+    blk_qp->Z = qp->Z + k0;
+    blk_qp->idxb = qp->idxb + k0;
+    blk_qp->idxs_rev = qp->idxs_rev + k0;
+    blk_qp->idxe = qp->idxe + k0;
+    blk_qp->diag_H_flag = qp->diag_H_flag + k0;
+
+    return;
+}
+
+
+
+// condense the N2 blocks and the last stage in parallel, one block per task;
+// block ii only writes stage ii of pcond_qp_in and uses its own hpipm cond workspace;
+// the last stage (bs = 0) has no dynamics, as in hpipm only its cost and constraints are condensed
+static void ocp_qp_partial_condensing_blocks(ocp_qp_in *red_qp, ocp_qp_in *pcond_qp_in,
+    ocp_qp_partial_condensing_opts *opts, ocp_qp_partial_condensing_memory *mem, int rhs_only)
+{
+    struct d_part_cond_qp_arg *arg = opts->hpipm_pcond_opts;
+    struct d_part_cond_qp_ws *ws = mem->hpipm_pcond_work;
+
+    int N2 = opts->N2;
+
+    #pragma omp parallel for num_threads(opts->num_threads)
+    for (int ii = 0; ii <= N2; ii++)
+    {
+        ocp_qp_dims blk_dims;
+        ocp_qp_in blk_qp;
+        int k0 = mem->block_offset[ii];
+        int bs = ii < N2 ? mem->block_offset[ii+1] - k0 : 0;
+
+        ocp_qp_partial_condensing_alias_block(red_qp, k0, bs, &blk_dims, &blk_qp);
+
+        if (rhs_only)
+        {
+            if (ii < N2)
+                d_cond_b(&blk_qp, pcond_qp_in->b+ii, arg->cond_arg+ii, ws->cond_workspace+ii);
+            d_cond_rq(&blk_qp, pcond_qp_in->rqz+ii, arg->cond_arg+ii, ws->cond_workspace+ii);
+            d_cond_d(&blk_qp, pcond_qp_in->d+ii, pcond_qp_in->d_mask+ii, pcond_qp_in->rqz+ii,
+                     arg->cond_arg+ii, ws->cond_workspace+ii);
+        }
+        else
+        {
+            if (ii < N2)
+                d_cond_BAbt(&blk_qp, pcond_qp_in->BAbt+ii, pcond_qp_in->b+ii,
+                            arg->cond_arg+ii, ws->cond_workspace+ii);
+            d_cond_RSQrq(&blk_qp, pcond_qp_in->RSQrq+ii, pcond_qp_in->rqz+ii,
+                         arg->cond_arg+ii, ws->cond_workspace+ii);
+            d_cond_DCtd(&blk_qp, pcond_qp_in->idxb[ii], pcond_qp_in->DCt+ii, pcond_qp_in->d+ii,
+                        pcond_qp_in->d_mask+ii, pcond_qp_in->idxs_rev[ii], pcond_qp_in->Z+ii,
+                        pcond_qp_in->rqz+ii, arg->cond_arg+ii, ws->cond_workspace+ii);
+        }
+    }
+
+    return;
+}
+
+
+
+// expand the solution of the N2 blocks and the last stage in parallel, one block per task
+static void ocp_qp_partial_expansion_blocks(ocp_qp_in *red_qp, ocp_qp_out *pcond_qp_out,
+    ocp_qp_out *red_sol, ocp_qp_partial_condensing_opts *opts, ocp_qp_partial_condensing_memory *mem)
+{
+    struct d_part_cond_qp_arg *arg = opts->hpipm_pcond_opts;
+    struct d_part_cond_qp_ws *ws = mem->hpipm_pcond_work;
+
+    int N2 = opts->N2;
+
+    #pragma omp parallel for num_threads(opts->num_threads)
+    for (int ii = 0; ii <= N2; ii++)
+    {
+        ocp_qp_dims blk_dims;
+        ocp_qp_in blk_qp;
+        ocp_qp_out blk_sol;
+        struct d_dense_qp_sol dense_sol;
+        int k0 = mem->block_offset[ii];
+        int bs = ii < N2 ? mem->block_offset[ii+1] - k0 : 0;
+
+        ocp_qp_partial_condensing_alias_block(red_qp, k0, bs, &blk_dims, &blk_qp);
+
+        // stages of the block in the solution of the reduced qp
+        blk_sol = *red_sol;
+        blk_sol.dim = &blk_dims;
+        blk_sol.ux = red_sol->ux + k0;
+        blk_sol.pi = red_sol->pi + k0;
+        blk_sol.lam = red_sol->lam + k0;
+        blk_sol.t = red_sol->t + k0;
+
+        // stage ii of the partially condensed solution, seen as a dense qp solution
+        dense_sol.v = pcond_qp_out->ux + ii;
+        dense_sol.pi = pcond_qp_out->pi + ii;
+        dense_sol.lam = pcond_qp_out->lam + ii;
+        dense_sol.t = pcond_qp_out->t + ii;
+
+        d_expand_sol(&blk_qp, &dense_sol, &blk_sol, arg->cond_arg+ii, ws->cond_workspace+ii);
+    }
+
+    return;
+}
+#endif
+
+
+
 int ocp_qp_partial_condensing(void *qp_in_, void *pcond_qp_in_, void *opts_, void *mem_, void *work)
 {
     ocp_qp_in *qp_in = qp_in_;
@@ -486,7 +660,13 @@ int ocp_qp_partial_condensing(void *qp_in_, void *pcond_qp_in_, void *opts_, voi
 
     // convert to partially condensed qp structure
     // TODO only if N2<N
+#if defined(ACADOS_WITH_OPENMP)
+    if (opts->num_threads > 1)
+        ocp_qp_partial_condensing_blocks(mem->red_qp, pcond_qp_in, opts, mem, 0);
+    else
+#endif
     d_part_cond_qp_cond(mem->red_qp, pcond_qp_in, opts->hpipm_pcond_opts, mem->hpipm_pcond_work);
+    ocp_qp_in_mark_changed_all(pcond_qp_in, OCP_QP_IN_ALL);
 
     // stop timer
     mem->time_qp_xcond = acados_toc(&timer);
@@ -519,7 +699,13 @@ int ocp_qp_partial_condensing_rhs(void *qp_in_, void *pcond_qp_in_, void *opts_,
 
     // convert to partially condensed qp structure
     // TODO only if N2<N
+#if defined(ACADOS_WITH_OPENMP)
+    if (opts->num_threads > 1)
+        ocp_qp_partial_condensing_blocks(mem->red_qp, pcond_qp_in, opts, mem, 1);
+    else
+#endif
     d_part_cond_qp_cond_rhs(mem->red_qp, pcond_qp_in, opts->hpipm_pcond_opts, mem->hpipm_pcond_work);
+    ocp_qp_in_mark_changed_all(pcond_qp_in, OCP_QP_IN_VEC);
 
     // stop timer
     mem->time_qp_xcond = acados_toc(&timer);
@@ -545,6 +731,11 @@ int ocp_qp_partial_expansion(void *pcond_qp_out_, void *qp_out_, void *opts_, vo
 
     // expand solution
     // TODO only if N2<N
+#if defined(ACADOS_WITH_OPENMP)
+    if (opts->num_threads > 1)
+        ocp_qp_partial_expansion_blocks(mem->red_qp, pcond_qp_out, mem->red_sol, opts, mem);
+    else
+#endif
     d_part_cond_qp_expand_sol(mem->red_qp, mem->ptr_pcond_qp_in, pcond_qp_out, mem->red_sol, opts->hpipm_pcond_opts, mem->hpipm_pcond_work);
 
     // restore solution
@@ -558,6 +749,69 @@ int ocp_qp_partial_expansion(void *pcond_qp_out_, void *qp_out_, void *opts_, vo
 
 
 
+int ocp_qp_partial_condensing_sol(void *qp_out_, void *pcond_qp_out_, void *opts_, void *mem_, void *work)
+{
+    ocp_qp_out *qp_out = qp_out_;
+    ocp_qp_out *pcond_qp_out = pcond_qp_out_;
+    ocp_qp_partial_condensing_opts *opts = opts_;
+    ocp_qp_partial_condensing_memory *mem = mem_;
+
+    int N2 = pcond_qp_out->dim->N;
+    int *nx = pcond_qp_out->dim->nx;
+    int *nu = pcond_qp_out->dim->nu;
+    int *nb = pcond_qp_out->dim->nb;
+    int *ng = pcond_qp_out->dim->ng;
+    int *ns = pcond_qp_out->dim->ns;
+
+    assert(opts->N2 == opts->N2_bkp);
+
+    // every inequality of the pcond qp comes from one inequality of the ocp qp, and the expansion
+    // copies its multiplier: expand multipliers set to their (negative) index to find where to
+    int nlam = 0;
+    for (int ii = 0; ii <= N2; ii++)
+    {
+        int nt = 2 * (nb[ii] + ng[ii] + ns[ii]);
+        blasfeo_dvecse(nu[ii] + nx[ii] + 2 * ns[ii], 0.0, pcond_qp_out->ux + ii, 0);
+        if (ii < N2)
+            blasfeo_dvecse(nx[ii + 1], 0.0, pcond_qp_out->pi + ii, 0);
+        blasfeo_dvecse(nt, 0.0, pcond_qp_out->t + ii, 0);
+        for (int jj = 0; jj < nt; jj++)
+            pcond_qp_out->lam[ii].pa[jj] = -(nlam + jj + 1.0);
+        nlam += nt;
+    }
+
+    ocp_qp_partial_expansion(pcond_qp_out, mem->probe_sol, opts, mem, work);
+
+    acados_timer timer;
+
+    // start timer
+    acados_tic(&timer);
+
+    ocp_qp_out_get_lam_index(mem->probe_sol, nlam, mem->lam_idx);
+
+    // multipliers and slacks of qp_out in the pcond qp
+    nlam = 0;
+    for (int ii = 0; ii <= N2; ii++)
+    {
+        int nt = 2 * (nb[ii] + ng[ii] + ns[ii]);
+        ocp_qp_out_gather_lam(qp_out, nt, mem->lam_idx + 2 * nlam, pcond_qp_out->lam[ii].pa,
+                              pcond_qp_out->t[ii].pa);
+        nlam += nt;
+    }
+
+    // the dynamics of block ii are the ones of the last stage of the block
+    for (int ii = 0; ii < N2; ii++)
+        blasfeo_dveccp(nx[ii + 1], qp_out->pi + mem->block_offset[ii + 1] - 1, 0,
+                       pcond_qp_out->pi + ii, 0);
+
+    // stop timer
+    mem->time_qp_xcond += acados_toc(&timer);
+
+    return ACADOS_SUCCESS;
+}
+
+
+
 void ocp_qp_partial_condensing_config_initialize_default(void *config_)
 {
     ocp_qp_xcond_config *config = config_;
@@ -578,6 +832,7 @@ void ocp_qp_partial_condensing_config_initialize_default(void *config_)
     config->condensing = &ocp_qp_partial_condensing;
     config->condensing_rhs = &ocp_qp_partial_condensing_rhs;
     config->expansion = &ocp_qp_partial_expansion;
+    config->condensing_sol = &ocp_qp_partial_condensing_sol;
 
     return;
 }
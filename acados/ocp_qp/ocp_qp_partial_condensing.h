@@ -69,6 +69,7 @@ typedef struct ocp_qp_partial_condensing_opts_
 //    int expand_dual_sol; // 0 primal sol only, 1 primal + dual sol
     int ric_alg;
     int mem_qp_in; // allocate qp_in in memory
+    int num_threads; // condense and expand the blocks in parallel if > 1 (openmp only)
 } ocp_qp_partial_condensing_opts;
 
 
@@ -82,10 +83,13 @@ typedef struct ocp_qp_partial_condensing_memory_
     ocp_qp_out *pcond_qp_out;
     ocp_qp_in *red_qp; // reduced qp
     ocp_qp_out *red_sol; // reduced qp sol
+    ocp_qp_out *probe_sol; // expansion of the index probe in ocp_qp_partial_condensing_sol
+    int *lam_idx; // stage and position of each pcond multiplier in the ocp qp sol
     // only pointer
     ocp_qp_in *ptr_qp_in;
     ocp_qp_in *ptr_pcond_qp_in;
     qp_info *qp_out_info; // info in pcond_qp_in
+    int *block_offset; // first stage of each block in the reduced qp
     double time_qp_xcond;
 } ocp_qp_partial_condensing_memory;
 
@@ -112,6 +116,8 @@ int ocp_qp_partial_condensing(void *in, void *out, void *opts, void *mem, void *
 //
 int ocp_qp_partial_expansion(void *in, void *out, void *opts, void *mem, void *work);
 //
+int ocp_qp_partial_condensing_sol(void *qp_out, void *pcond_qp_out, void *opts, void *mem, void *work);
+//
 void ocp_qp_partial_condensing_config_initialize_default(void *config_);
 
 
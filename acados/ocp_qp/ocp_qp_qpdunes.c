@@ -173,6 +173,7 @@ void ocp_qp_qpdunes_opts_initialize_default(void *config_, ocp_qp_dims *dims, vo
     opts->options.printLevel = 0;
     opts->options.stationarityTolerance = 1e-12;
     opts->warmstart = 1;
+    opts->guess_active_set = 0;
 
     if (qpdunes_opts == QPDUNES_DEFAULT_ARGUMENTS)
     {
@@ -257,6 +258,11 @@ void ocp_qp_qpdunes_opts_set(void *config_, void *opts_, const char *field, void
         int *iter_max = value;
         opts->options.maxIter = *iter_max;
     }
+    else if (!strcmp(field, "guess_active_set"))
+    {
+        int *guess_active_set = value;
+        opts->guess_active_set = *guess_active_set;
+    }
     else
     {
         printf("\nerror: ocp_qp_qpdunes_opts_set: wrong field: %s\n", field);
@@ -302,6 +308,8 @@ void *ocp_qp_qpdunes_memory_assign(void *config_, ocp_qp_dims *dims, void *opts_
     nu = dims->nu[0];
 
     mem->firstRun = 1;
+    mem->last_qp_in = NULL;
+    mem->last_generation = 0;
     mem->nx = nx;
     mem->nu = nu;
     mem->nz = nx + nu;
@@ -686,9 +694,20 @@ static int update_memory(ocp_qp_in *in, ocp_qp_qpdunes_opts *opts, ocp_qp_qpdune
     {  // if mem->firstRun == 0
         if (opts->isLinearMPC == 0)
         {
+            // matrices that did not change since the last call are not passed to qpDUNES,
+            // which then keeps them (and the factorization of the stage Hessian);
+            // all of them are passed for another qp_in
+            long long since = (in == mem->last_qp_in) ? mem->last_generation : -1;
+            double *H, *ABt, *Ct;
+
             for (int kk = 0; kk < N; kk++)
             {
-                form_H(work->H, nx, nu, &in->RSQrq[kk]);
+                H = ocp_qp_in_stage_changed(in, kk, OCP_QP_IN_COST_MAT, since) ? work->H : 0;
+                ABt = ocp_qp_in_stage_changed(in, kk, OCP_QP_IN_DYN_MAT, since) ? work->ABt : 0;
+                Ct = ocp_qp_in_stage_changed(in, kk, OCP_QP_IN_CON_MAT, since) ? work->Ct : 0;
+
+                if (H != 0)
+                    form_H(work->H, nx, nu, &in->RSQrq[kk]);
                 form_g(work->g, nx, nu, &in->rqz[kk]);
                 form_dynamics(work->ABt, work->b, nx, nu, &in->BAbt[kk], &in->b[kk]);
 
@@ -697,7 +716,7 @@ static int update_memory(ocp_qp_in *in, ocp_qp_qpdunes_opts *opts, ocp_qp_qpdune
                 if (ng[kk] == 0)
                 {
                     value = qpDUNES_updateIntervalData(&(mem->qpData), mem->qpData.intervals[kk],
-                                                       work->H, work->g, work->ABt, work->b,
+                                                       H, work->g, ABt, work->b,
                                                        work->zLow, work->zUpp, 0, 0, 0, 0);
                 }
                 else
@@ -705,8 +724,8 @@ static int update_memory(ocp_qp_in *in, ocp_qp_qpdunes_opts *opts, ocp_qp_qpdune
                     form_inequalities(work->Ct, work->lc, work->uc, nx, nu, nb[kk], ng[kk],
                                       &in->DCt[kk], &in->d[kk]);
                     value = qpDUNES_updateIntervalData(
-                        &(mem->qpData), mem->qpData.intervals[kk], work->H, work->g, work->ABt,
-                        work->b, work->zLow, work->zUpp, work->Ct, work->lc, work->uc, 0);
+                        &(mem->qpData), mem->qpData.intervals[kk], H, work->g, ABt,
+                        work->b, work->zLow, work->zUpp, Ct, work->lc, work->uc, 0);
                 }
                 if (value != QPDUNES_OK)
                 {
@@ -715,14 +734,18 @@ static int update_memory(ocp_qp_in *in, ocp_qp_qpdunes_opts *opts, ocp_qp_qpdune
                 }
                 // qpDUNES_printMatrixData( work->ABt, nx, nx+nu, "AB[%d]", kk);
             }
+            H = ocp_qp_in_stage_changed(in, N, OCP_QP_IN_COST_MAT, since) ? work->Q : 0;
+            Ct = ocp_qp_in_stage_changed(in, N, OCP_QP_IN_CON_MAT, since) ? work->Ct : 0;
+
             form_bounds(work->zLow, work->zUpp, nx, 0, nb[N], ng[N], in->idxb[N], &in->d[N],
                         opts->options.QPDUNES_INFTY);
-            form_RSQ(work->R, work->S, work->Q, nx, 0, &in->RSQrq[N]);
+            if (H != 0)
+                form_RSQ(work->R, work->S, work->Q, nx, 0, &in->RSQrq[N]);
             form_g(work->g, nx, 0, &in->rqz[N]);  // work->g = q
             if (ng[N] == 0)
             {
                 value =
-                    qpDUNES_updateIntervalData(&(mem->qpData), mem->qpData.intervals[N], work->Q,
+                    qpDUNES_updateIntervalData(&(mem->qpData), mem->qpData.intervals[N], H,
                                                work->g, 0, 0, work->zLow, work->zUpp, 0, 0, 0, 0);
             }
             else
@@ -730,8 +753,8 @@ static int update_memory(ocp_qp_in *in, ocp_qp_qpdunes_opts *opts, ocp_qp_qpdune
                 form_inequalities(work->Ct, work->lc, work->uc, nx, 0, nb[N], ng[N], &in->DCt[N],
                                   &in->d[N]);
                 value = qpDUNES_updateIntervalData(&(mem->qpData), mem->qpData.intervals[N],
-                                                   work->Q, work->g, 0, 0, work->zLow, work->zUpp,
-                                                   work->Ct, work->lc, work->uc, 0);
+                                                   H, work->g, 0, 0, work->zLow, work->zUpp,
+                                                   Ct, work->lc, work->uc, 0);
             }
             if (value != QPDUNES_OK)
             {
@@ -851,6 +874,16 @@ int ocp_qp_qpdunes(void *config_, ocp_qp_in *in, ocp_qp_out *out, void *opts_, v
     ocp_qp_qpdunes_cast_workspace(work, mem);
     return_t qpdunes_status = update_memory(in, opts, mem, work);
     if (qpdunes_status != QPDUNES_OK) return qpdunes_status;
+    if (opts->guess_active_set)
+    {
+        // the dual Newton iterations start from the multipliers of the dynamics, the active sets
+        // of the stage qps follow from them
+        for (int kk = 0; kk < N; kk++)
+            blasfeo_unpack_dvec(in->dim->nx[kk + 1], &out->pi[kk], 0,
+                                &mem->qpData.lambda.data[kk * in->dim->nx[kk + 1]], 1);
+    }
+    mem->last_qp_in = in;
+    mem->last_generation = ocp_qp_in_generation(in);
     info->interface_time = acados_toc(&interface_timer);
 
     acados_tic(&qp_timer);
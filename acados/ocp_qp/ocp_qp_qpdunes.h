@@ -58,6 +58,7 @@ typedef struct ocp_qp_qpdunes_opts_
     qpOptions_t options;
     qpdunes_stage_qp_solver_t stageQpSolver;
     int warmstart;  // warmstart = 0: all multipliers set to zero, warmstart = 1: use previous mult.
+    int guess_active_set;  // start from the multipliers of the dynamics in qp_out
     bool isLinearMPC;
 } ocp_qp_qpdunes_opts;
 
@@ -71,6 +72,8 @@ typedef struct ocp_qp_qpdunes_memory_
     qpData_t qpData;
     double time_qp_solver_call;
     int iter;
+    const ocp_qp_in *last_qp_in;  // qp_in and generation read by the last call
+    long long last_generation;
 
 } ocp_qp_qpdunes_memory;
 
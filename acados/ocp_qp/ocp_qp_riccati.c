@@ -0,0 +1,598 @@
+/*
+ * Copyright 2019 Gianluca Frison, Dimitris Kouzoupis, Robin Verschueren,
+ * Andrea Zanelli, Niels van Duijkeren, Jonathan Frey, Tommaso Sartor,
+ * Branimir Novoselnik, Rien Quirynen, Rezart Qelibari, Dang Doan,
+ * Jonas Koenemann, Yutao Chen, Tobias Schöls, Jonas Schlagenhauf, Moritz Diehl
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+
+// external
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+// blasfeo
+#include "blasfeo/include/blasfeo_d_aux.h"
+#include "blasfeo/include/blasfeo_d_blas.h"
+// hpipm
+#include "hpipm/include/hpipm_d_ocp_qp.h"
+#include "hpipm/include/hpipm_d_ocp_qp_sol.h"
+// acados
+#include "acados/ocp_qp/ocp_qp_common.h"
+#include "acados/ocp_qp/ocp_qp_hpipm.h"
+#include "acados/ocp_qp/ocp_qp_riccati.h"
+#include "acados/utils/mem.h"
+#include "acados/utils/timing.h"
+#include "acados/utils/types.h"
+
+
+
+/************************************************
+ * opts
+ ************************************************/
+
+int ocp_qp_riccati_opts_calculate_size(void *config_, void *dims_)
+{
+    int size = 0;
+    size += sizeof(ocp_qp_riccati_opts);
+    size += ocp_qp_hpipm_opts_calculate_size(config_, dims_);
+
+    size += 1 * 8;
+    make_int_multiple_of(8, &size);
+
+    return size;
+}
+
+
+
+void *ocp_qp_riccati_opts_assign(void *config_, void *dims_, void *raw_memory)
+{
+    ocp_qp_riccati_opts *opts;
+
+    char *c_ptr = (char *) raw_memory;
+
+    opts = (ocp_qp_riccati_opts *) c_ptr;
+    c_ptr += sizeof(ocp_qp_riccati_opts);
+
+    align_char_to(8, &c_ptr);
+
+    opts->hpipm_opts = ocp_qp_hpipm_opts_assign(config_, dims_, c_ptr);
+    c_ptr += ocp_qp_hpipm_opts_calculate_size(config_, dims_);
+
+    assert((char *) raw_memory + ocp_qp_riccati_opts_calculate_size(config_, dims_) >= c_ptr);
+
+    return (void *) opts;
+}
+
+
+
+void ocp_qp_riccati_opts_initialize_default(void *config_, void *dims_, void *opts_)
+{
+    ocp_qp_riccati_opts *opts = opts_;
+
+    ocp_qp_hpipm_opts_initialize_default(config_, dims_, opts->hpipm_opts);
+
+    opts->fallback = 1;
+
+    return;
+}
+
+
+
+void ocp_qp_riccati_opts_update(void *config_, void *dims_, void *opts_)
+{
+    ocp_qp_riccati_opts *opts = opts_;
+
+    ocp_qp_hpipm_opts_update(config_, dims_, opts->hpipm_opts);
+
+    return;
+}
+
+
+
+void ocp_qp_riccati_opts_set(void *config_, void *opts_, const char *field, void *value)
+{
+    ocp_qp_riccati_opts *opts = opts_;
+
+    if (!strcmp(field, "fallback"))
+    {
+        int *tmp_ptr = value;
+        opts->fallback = *tmp_ptr;
+    }
+    else // pass options to the fallback solver
+    {
+        ocp_qp_hpipm_opts_set(config_, opts->hpipm_opts, field, value);
+    }
+
+    return;
+}
+
+
+
+/************************************************
+ * memory
+ ************************************************/
+
+int ocp_qp_riccati_memory_calculate_size(void *config_, void *dims_, void *opts_)
+{
+    ocp_qp_dims *dims = dims_;
+    ocp_qp_riccati_opts *opts = opts_;
+
+    int N = dims->N;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
+
+    int ii;
+
+    int nuxM = 0;
+    int nxM = 0;
+    for (ii = 0; ii <= N; ii++)
+    {
+        nuxM = nu[ii]+nx[ii] > nuxM ? nu[ii]+nx[ii] : nuxM;
+        nxM = nx[ii] > nxM ? nx[ii] : nxM;
+    }
+
+    int size = 0;
+    size += sizeof(ocp_qp_riccati_memory);
+
+    size += ocp_qp_hpipm_memory_calculate_size(config_, dims, opts->hpipm_opts);
+
+    size += (N+1)*sizeof(struct blasfeo_dmat); // L
+
+    for (ii = 0; ii <= N; ii++)
+        size += blasfeo_memsize_dmat(nu[ii]+nx[ii]+1, nu[ii]+nx[ii]); // L
+    size += blasfeo_memsize_dmat(nuxM+1, nxM); // AL
+    size += blasfeo_memsize_dvec(nuxM); // tmp_nux
+    size += 2*blasfeo_memsize_dvec(nxM); // tmp_nx0 tmp_nx1
+
+    size += 1 * 8;
+    size += 1 * 64;
+    make_int_multiple_of(8, &size);
+
+    return size;
+}
+
+
+
+void *ocp_qp_riccati_memory_assign(void *config_, void *dims_, void *opts_, void *raw_memory)
+{
+    ocp_qp_dims *dims = dims_;
+    ocp_qp_riccati_opts *opts = opts_;
+    ocp_qp_riccati_memory *mem;
+
+    int N = dims->N;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
+
+    int ii;
+
+    int nuxM = 0;
+    int nxM = 0;
+    for (ii = 0; ii <= N; ii++)
+    {
+        nuxM = nu[ii]+nx[ii] > nuxM ? nu[ii]+nx[ii] : nuxM;
+        nxM = nx[ii] > nxM ? nx[ii] : nxM;
+    }
+
+    // char pointer
+    char *c_ptr = (char *) raw_memory;
+
+    mem = (ocp_qp_riccati_memory *) c_ptr;
+    c_ptr += sizeof(ocp_qp_riccati_memory);
+
+    align_char_to(8, &c_ptr);
+
+    // hpipm memory
+    mem->hpipm_mem = ocp_qp_hpipm_memory_assign(config_, dims, opts->hpipm_opts, c_ptr);
+    c_ptr += ocp_qp_hpipm_memory_calculate_size(config_, dims, opts->hpipm_opts);
+
+    // blasfeo structs
+    assign_and_advance_blasfeo_dmat_structs(N+1, &mem->L, &c_ptr);
+
+    // blasfeo mem
+    align_char_to(64, &c_ptr);
+
+    for (ii = 0; ii <= N; ii++)
+        assign_and_advance_blasfeo_dmat_mem(nu[ii]+nx[ii]+1, nu[ii]+nx[ii], mem->L+ii, &c_ptr);
+    assign_and_advance_blasfeo_dmat_mem(nuxM+1, nxM, &mem->AL, &c_ptr);
+    assign_and_advance_blasfeo_dvec_mem(nuxM, &mem->tmp_nux, &c_ptr);
+    assign_and_advance_blasfeo_dvec_mem(nxM, &mem->tmp_nx0, &c_ptr);
+    assign_and_advance_blasfeo_dvec_mem(nxM, &mem->tmp_nx1, &c_ptr);
+
+    mem->time_qp_solver_call = 0.0;
+    mem->iter = 0;
+    mem->riccati = 0;
+
+    assert((char *) raw_memory + ocp_qp_riccati_memory_calculate_size(config_, dims, opts_) >= c_ptr);
+
+    return mem;
+}
+
+
+
+void ocp_qp_riccati_memory_get(void *config_, void *mem_, const char *field, void* value)
+{
+    ocp_qp_riccati_memory *mem = mem_;
+
+    if (!strcmp(field, "time_qp_solver_call"))
+    {
+        double *tmp_ptr = value;
+        *tmp_ptr = mem->time_qp_solver_call;
+    }
+    else if (!strcmp(field, "iter"))
+    {
+        int *tmp_ptr = value;
+        *tmp_ptr = mem->iter;
+    }
+    else if (!strcmp(field, "riccati"))
+    {
+        int *tmp_ptr = value;
+        *tmp_ptr = mem->riccati;
+    }
+    else
+    {
+        printf("\nerror: ocp_qp_riccati_memory_get: field %s not available\n", field);
+        exit(1);
+    }
+
+    return;
+
+}
+
+
+
+/************************************************
+ * workspace
+ ************************************************/
+
+int ocp_qp_riccati_workspace_calculate_size(void *config_, void *dims_, void *opts_)
+{
+    return 0;
+}
+
+
+
+/************************************************
+ * functions
+ ************************************************/
+
+int ocp_qp_riccati_check_structure(ocp_qp_in *qp_in)
+{
+    ocp_qp_dims *dims = qp_in->dim;
+
+    int N = dims->N;
+    int *nx = dims->nx;
+    int *nb = dims->nb;
+    int *nbu = dims->nbu;
+    int *nbx = dims->nbx;
+    int *ng = dims->ng;
+    int *ns = dims->ns;
+
+    int ii, jj;
+
+    for (ii = 0; ii <= N; ii++)
+    {
+        if (ng[ii] > 0 || ns[ii] > 0)
+            return 0;
+        if (ii > 0 && nb[ii] > 0)
+            return 0;
+    }
+
+    if (nb[0] == 0)
+        return 1;
+
+    // bounds at the first stage have to fix all states
+    if (nbu[0] > 0 || nbx[0] != nx[0])
+        return 0;
+
+    for (jj = 0; jj < nb[0]; jj++)
+    {
+        // upper bounds are stored with flipped sign in hpipm
+        if (blasfeo_dvecex1(qp_in->d+0, jj) != -blasfeo_dvecex1(qp_in->d+0, nb[0]+jj))
+            return 0;
+    }
+
+    return 2;
+}
+
+
+
+void ocp_qp_riccati_x0_multipliers(ocp_qp_in *qp_in, ocp_qp_out *qp_out, struct blasfeo_dvec *tmp_nux)
+{
+    int N = qp_in->dim->N;
+    int *nx = qp_in->dim->nx;
+    int *nu = qp_in->dim->nu;
+    int *nb = qp_in->dim->nb;
+
+    int nu0 = nu[0];
+    int nx0 = nx[0];
+
+    int jj;
+    double tmp;
+
+    // lam_lb - lam_ub = RSQ ux + rq + BAbt pi at the bounded states
+    blasfeo_dsymv_l(nu0+nx0, nu0+nx0, 1.0, qp_in->RSQrq+0, 0, 0, qp_out->ux+0, 0, 1.0,
+                    qp_in->rqz+0, 0, tmp_nux, 0);
+    if (N > 0)
+        blasfeo_dgemv_n(nu0+nx0, nx[1], 1.0, qp_in->BAbt+0, 0, 0, qp_out->pi+0, 0, 1.0,
+                        tmp_nux, 0, tmp_nux, 0);
+
+    for (jj = 0; jj < nb[0]; jj++)
+    {
+        tmp = blasfeo_dvecex1(tmp_nux, qp_in->idxb[0][jj]);
+        blasfeo_dvecin1(tmp > 0.0 ? tmp : 0.0, qp_out->lam+0, jj);
+        blasfeo_dvecin1(tmp < 0.0 ? -tmp : 0.0, qp_out->lam+0, nb[0]+jj);
+    }
+
+    return;
+}
+
+
+
+// positive diagonal of a cholesky factor, i.e. the factorized matrix is positive definite
+static int ocp_qp_riccati_check_factor(int n, struct blasfeo_dmat *L)
+{
+    int jj;
+
+    // blasfeo sets non positive pivots to zero
+    for (jj = 0; jj < n; jj++)
+    {
+        if (!(blasfeo_dgeex1(L, jj, jj) > 0.0))
+            return 0;
+    }
+
+    return 1;
+}
+
+
+
+// backward recursion: L[ii] is the lower cholesky factor of
+// [RSQ + [B'; A'] P [B A], .; (rq + [B'; A'] (P b + p))', .], with P = Lp Lp' and p = Lp l
+// the cost-to-go of the next stage, stored in the last nx rows and columns of L[ii+1];
+// returns 0 if a reduced Hessian is not positive definite
+static int ocp_qp_riccati_factorize(ocp_qp_in *qp_in, int x0_fixed, ocp_qp_riccati_memory *mem)
+{
+    int N = qp_in->dim->N;
+    int *nx = qp_in->dim->nx;
+    int *nu = qp_in->dim->nu;
+
+    struct blasfeo_dmat *L = mem->L;
+
+    int ii, nu0, nx0, nu1, nx1;
+
+    // last stage
+    nu0 = nu[N];
+    nx0 = nx[N];
+    blasfeo_dtrcp_l(nu0+nx0, qp_in->RSQrq+N, 0, 0, L+N, 0, 0);
+    blasfeo_drowin(nu0+nx0, 1.0, qp_in->rqz+N, 0, L+N, nu0+nx0, 0);
+    blasfeo_dpotrf_l_mn(nu0+nx0+1, nu0+nx0, L+N, 0, 0, L+N, 0, 0);
+    if (!ocp_qp_riccati_check_factor(nu0+nx0, L+N))
+        return 0;
+
+    for (ii = N-1; ii >= 0; ii--)
+    {
+        nu0 = nu[ii];
+        nx0 = nx[ii];
+        nu1 = nu[ii+1];
+        nx1 = nx[ii+1];
+
+        // AL = [B'; A'; b' + l' Lp^-1] Lp
+        blasfeo_dtrmm_rlnn(nu0+nx0, nx1, 1.0, L+ii+1, nu1, nu1, qp_in->BAbt+ii, 0, 0, &mem->AL, 0, 0);
+        blasfeo_dtrmv_ltn(nx1, nx1, L+ii+1, nu1, nu1, qp_in->b+ii, 0, &mem->tmp_nx1, 0);
+        blasfeo_drowex(nx1, 1.0, L+ii+1, nu1+nx1, nu1, &mem->tmp_nx0, 0);
+        blasfeo_daxpy(nx1, 1.0, &mem->tmp_nx0, 0, &mem->tmp_nx1, 0, &mem->tmp_nx1, 0);
+        blasfeo_drowin(nx1, 1.0, &mem->tmp_nx1, 0, &mem->AL, nu0+nx0, 0);
+
+        blasfeo_dtrcp_l(nu0+nx0, qp_in->RSQrq+ii, 0, 0, L+ii, 0, 0);
+        blasfeo_drowin(nu0+nx0, 1.0, qp_in->rqz+ii, 0, L+ii, nu0+nx0, 0);
+        blasfeo_dsyrk_ln_mn(nu0+nx0+1, nu0+nx0, nx1, 1.0, &mem->AL, 0, 0, &mem->AL, 0, 0,
+                            1.0, L+ii, 0, 0, L+ii, 0, 0);
+
+        // with x0 fixed only the input part of the first stage is needed
+        if (ii == 0 && x0_fixed)
+        {
+            blasfeo_dpotrf_l_mn(nu0+nx0+1, nu0, L+ii, 0, 0, L+ii, 0, 0);
+            if (!ocp_qp_riccati_check_factor(nu0, L+ii))
+                return 0;
+        }
+        else
+        {
+            blasfeo_dpotrf_l_mn(nu0+nx0+1, nu0+nx0, L+ii, 0, 0, L+ii, 0, 0);
+            if (!ocp_qp_riccati_check_factor(nu0+nx0, L+ii))
+                return 0;
+        }
+    }
+
+    return 1;
+}
+
+
+
+// forward recursion: primal solution, equality multipliers pi and multipliers of the bounds on x0
+static void ocp_qp_riccati_solve(ocp_qp_in *qp_in, ocp_qp_out *qp_out, int x0_fixed,
+                                 ocp_qp_riccati_memory *mem)
+{
+    int N = qp_in->dim->N;
+    int *nx = qp_in->dim->nx;
+    int *nu = qp_in->dim->nu;
+    int *nb = qp_in->dim->nb;
+
+    struct blasfeo_dmat *L = mem->L;
+
+    int ii, nu0, nx0, nu1, nx1;
+
+    // initial state
+    nu0 = nu[0];
+    nx0 = nx[0];
+    if (x0_fixed)
+    {
+        blasfeo_dvecse(nx0, 0.0, qp_out->ux+0, nu0);
+        blasfeo_dvecad_sp(nb[0], 1.0, qp_in->d+0, 0, qp_in->idxb[0], qp_out->ux+0, 0);
+    }
+    else
+    {
+        // minimizer of the cost-to-go of the first stage
+        blasfeo_drowex(nx0, 1.0, L+0, nu0+nx0, nu0, qp_out->ux+0, nu0);
+        blasfeo_dtrsv_ltn(nx0, L+0, nu0, nu0, qp_out->ux+0, nu0, qp_out->ux+0, nu0);
+        blasfeo_dvecsc(nx0, -1.0, qp_out->ux+0, nu0);
+    }
+
+    for (ii = 0; ii <= N; ii++)
+    {
+        nu0 = nu[ii];
+        nx0 = nx[ii];
+
+        // u = - Lu^-T (Lxu' x + lu')
+        blasfeo_drowex(nu0, 1.0, L+ii, nu0+nx0, 0, qp_out->ux+ii, 0);
+        blasfeo_dgemv_t(nx0, nu0, 1.0, L+ii, nu0, 0, qp_out->ux+ii, nu0, 1.0, qp_out->ux+ii, 0,
+                        qp_out->ux+ii, 0);
+        blasfeo_dtrsv_ltn(nu0, L+ii, 0, 0, qp_out->ux+ii, 0, qp_out->ux+ii, 0);
+        blasfeo_dvecsc(nu0, -1.0, qp_out->ux+ii, 0);
+
+        if (ii < N)
+        {
+            nu1 = nu[ii+1];
+            nx1 = nx[ii+1];
+
+            // x_next = B u + A x + b
+            blasfeo_dgemv_t(nu0+nx0, nx1, 1.0, qp_in->BAbt+ii, 0, 0, qp_out->ux+ii, 0, 1.0,
+                            qp_in->b+ii, 0, qp_out->ux+ii+1, nu1);
+
+            // pi = P x_next + p = Lp (Lp' x_next + l)
+            blasfeo_drowex(nx1, 1.0, L+ii+1, nu1+nx1, nu1, &mem->tmp_nx0, 0);
+            blasfeo_dtrmv_ltn(nx1, nx1, L+ii+1, nu1, nu1, qp_out->ux+ii+1, nu1, &mem->tmp_nx1, 0);
+            blasfeo_daxpy(nx1, 1.0, &mem->tmp_nx0, 0, &mem->tmp_nx1, 0, &mem->tmp_nx1, 0);
+            blasfeo_dtrmv_lnn(nx1, nx1, L+ii+1, nu1, nu1, &mem->tmp_nx1, 0, qp_out->pi+ii, 0);
+        }
+
+        blasfeo_dvecse(2*nb[ii], 0.0, qp_out->lam+ii, 0);
+        blasfeo_dvecse(2*nb[ii], 0.0, qp_out->t+ii, 0);
+    }
+
+    if (x0_fixed)
+        ocp_qp_riccati_x0_multipliers(qp_in, qp_out, &mem->tmp_nux);
+
+    return;
+}
+
+
+
+int ocp_qp_riccati(void *config_, void *qp_in_, void *qp_out_, void *opts_, void *mem_, void *work_)
+{
+    ocp_qp_in *qp_in = qp_in_;
+    ocp_qp_out *qp_out = qp_out_;
+
+    ocp_qp_riccati_opts *opts = opts_;
+    ocp_qp_riccati_memory *mem = mem_;
+
+    qp_info *info = qp_out->misc;
+    acados_timer tot_timer, qp_timer;
+
+    acados_tic(&tot_timer);
+
+    int structure = ocp_qp_riccati_check_structure(qp_in);
+
+    // factorize and solve
+    acados_tic(&qp_timer);
+    if (structure != 0 && ocp_qp_riccati_factorize(qp_in, structure == 2, mem))
+        ocp_qp_riccati_solve(qp_in, qp_out, structure == 2, mem);
+    else
+        structure = 0;
+
+    if (structure == 0)
+    {
+        mem->riccati = 0;
+        if (!opts->fallback)
+            return ACADOS_QP_FAILURE;
+
+        int status = ocp_qp_hpipm(config_, qp_in, qp_out, opts->hpipm_opts, mem->hpipm_mem, work_);
+
+        mem->time_qp_solver_call = mem->hpipm_mem->time_qp_solver_call;
+        mem->iter = mem->hpipm_mem->iter;
+
+        return status;
+    }
+
+    info->solve_QP_time = acados_toc(&qp_timer);
+    info->interface_time = 0;
+    info->total_time = acados_toc(&tot_timer);
+    info->num_iter = 1;
+    info->t_computed = 1;
+
+    mem->time_qp_solver_call = info->solve_QP_time;
+    mem->iter = 1;
+    mem->riccati = structure;
+
+    return ACADOS_SUCCESS;
+}
+
+
+
+void ocp_qp_riccati_eval_sens(void *config_, void *param_qp_in_, void *sens_qp_out_, void *opts_, void *mem_, void *work_)
+{
+    ocp_qp_in *param_qp_in = param_qp_in_;
+    ocp_qp_out *sens_qp_out = sens_qp_out_;
+
+    ocp_qp_riccati_opts *opts = opts_;
+    ocp_qp_riccati_memory *mem = mem_;
+
+    if (mem->riccati == 0)
+    {
+        ocp_qp_hpipm_eval_sens(config_, param_qp_in, sens_qp_out, opts->hpipm_opts, mem->hpipm_mem, work_);
+        return;
+    }
+
+    // the qp is linear, the sensitivities solve the same kkt system with the parametric vectors
+    ocp_qp_riccati_factorize(param_qp_in, mem->riccati == 2, mem);
+    ocp_qp_riccati_solve(param_qp_in, sens_qp_out, mem->riccati == 2, mem);
+
+    return;
+}
+
+
+
+void ocp_qp_riccati_config_initialize_default(void *config_)
+{
+    qp_solver_config *config = config_;
+
+    config->dims_set = &ocp_qp_dims_set;
+    config->opts_calculate_size = &ocp_qp_riccati_opts_calculate_size;
+    config->opts_assign = &ocp_qp_riccati_opts_assign;
+    config->opts_initialize_default = &ocp_qp_riccati_opts_initialize_default;
+    config->opts_update = &ocp_qp_riccati_opts_update;
+    config->opts_set = &ocp_qp_riccati_opts_set;
+    config->memory_calculate_size = &ocp_qp_riccati_memory_calculate_size;
+    config->memory_assign = &ocp_qp_riccati_memory_assign;
+    config->memory_get = &ocp_qp_riccati_memory_get;
+    config->workspace_calculate_size = &ocp_qp_riccati_workspace_calculate_size;
+    config->evaluate = &ocp_qp_riccati;
+    config->eval_sens = &ocp_qp_riccati_eval_sens;
+
+    return;
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright 2019 Gianluca Frison, Dimitris Kouzoupis, Robin Verschueren,
+ * Andrea Zanelli, Niels van Duijkeren, Jonathan Frey, Tommaso Sartor,
+ * Branimir Novoselnik, Rien Quirynen, Rezart Qelibari, Dang Doan,
+ * Jonas Koenemann, Yutao Chen, Tobias Schöls, Jonas Schlagenhauf, Moritz Diehl
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+
+#ifndef ACADOS_OCP_QP_OCP_QP_RICCATI_H_
+#define ACADOS_OCP_QP_OCP_QP_RICCATI_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// blasfeo
+#include "blasfeo/include/blasfeo_common.h"
+// acados
+#include "acados/ocp_qp/ocp_qp_common.h"
+#include "acados/ocp_qp/ocp_qp_hpipm.h"
+#include "acados/utils/types.h"
+
+
+
+// Riccati recursion for ocp qps without inequalities:
+// solves qps with nb=ng=ns=0 at all stages, except for bounds fixing all of x0,
+// with one backward factorization and one forward substitution;
+// all other qps are passed to hpipm
+typedef struct ocp_qp_riccati_opts_
+{
+    ocp_qp_hpipm_opts *hpipm_opts; // opts of the fallback solver
+    int fallback; // use hpipm if the qp has inequalities, otherwise return ACADOS_QP_FAILURE
+} ocp_qp_riccati_opts;
+
+
+
+typedef struct ocp_qp_riccati_memory_
+{
+    struct blasfeo_dmat *L; // factorization of the (nu+nx+1)x(nu+nx) cost-to-go, one per stage
+    struct blasfeo_dmat AL; // BAbt times the factor of the next stage
+    struct blasfeo_dvec tmp_nux;
+    struct blasfeo_dvec tmp_nx0;
+    struct blasfeo_dvec tmp_nx1;
+    ocp_qp_hpipm_memory *hpipm_mem;
+    double time_qp_solver_call;
+    int iter;
+    int riccati; // structure of the last qp solved by the riccati recursion, 0 if solved by hpipm
+} ocp_qp_riccati_memory;
+
+
+
+//
+int ocp_qp_riccati_opts_calculate_size(void *config, void *dims);
+//
+void *ocp_qp_riccati_opts_assign(void *config, void *dims, void *raw_memory);
+//
+void ocp_qp_riccati_opts_initialize_default(void *config, void *dims, void *opts_);
+//
+void ocp_qp_riccati_opts_update(void *config, void *dims, void *opts_);
+//
+void ocp_qp_riccati_opts_set(void *config_, void *opts_, const char *field, void *value);
+//
+int ocp_qp_riccati_memory_calculate_size(void *config, void *dims, void *opts_);
+//
+void *ocp_qp_riccati_memory_assign(void *config, void *dims, void *opts_, void *raw_memory);
+//
+void ocp_qp_riccati_memory_get(void *config_, void *mem_, const char *field, void* value);
+//
+int ocp_qp_riccati_workspace_calculate_size(void *config, void *dims, void *opts_);
+// returns 1 if qp_in can be solved by the riccati recursion, 2 if in addition x0 is fixed
+int ocp_qp_riccati_check_structure(ocp_qp_in *qp_in);
+// multipliers of the bounds fixing x0, given the primal solution and pi
+void ocp_qp_riccati_x0_multipliers(ocp_qp_in *qp_in, ocp_qp_out *qp_out, struct blasfeo_dvec *tmp_nux);
+//
+int ocp_qp_riccati(void *config, void *qp_in, void *qp_out, void *opts_, void *mem_, void *work_);
+//
+void ocp_qp_riccati_eval_sens(void *config, void *qp_in, void *qp_out, void *opts_, void *mem_, void *work_);
+//
+void ocp_qp_riccati_config_initialize_default(void *config);
+
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif  // ACADOS_OCP_QP_OCP_QP_RICCATI_H_
@@ -0,0 +1,664 @@
+/*
+ * Copyright 2019 Gianluca Frison, Dimitris Kouzoupis, Robin Verschueren,
+ * Andrea Zanelli, Niels van Duijkeren, Jonathan Frey, Tommaso Sartor,
+ * Branimir Novoselnik, Rien Quirynen, Rezart Qelibari, Dang Doan,
+ * Jonas Koenemann, Yutao Chen, Tobias Schöls, Jonas Schlagenhauf, Moritz Diehl
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+
+
+// mmap, open, fstat
+#if !(defined _WIN32 || defined _WIN64)
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+// external
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !(defined _WIN32 || defined _WIN64)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// blasfeo
+#include "blasfeo/include/blasfeo_common.h"
+#include "blasfeo/include/blasfeo_d_aux.h"
+// acados
+#include "acados/ocp_qp/ocp_qp_common.h"
+#include "acados/ocp_qp/ocp_qp_snapshot.h"
+#include "acados/utils/mem.h"
+
+
+
+#define SNAPSHOT_ALIGN 64
+#define SNAPSHOT_MAGIC "ACQPSNAP"
+#define SNAPSHOT_BYTE_ORDER 0x01020304u
+#define SNAPSHOT_NUM_DIMS 11
+
+
+
+typedef struct
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t sizeof_int;
+    uint32_t sizeof_double;
+    // memsize and element positions of a probe matrix, identify the blasfeo matrix layout
+    uint32_t dmat_layout[4];
+} snapshot_file_header;
+
+
+
+typedef struct
+{
+    uint32_t kind;
+    int32_t N;
+    uint64_t size;  // bytes of the record, this header included
+} snapshot_record_header;
+
+
+
+/************************************************
+ * helpers
+ ************************************************/
+
+static size_t snapshot_padded(size_t size)
+{
+    return (size + SNAPSHOT_ALIGN - 1) / SNAPSHOT_ALIGN * SNAPSHOT_ALIGN;
+}
+
+
+
+// dims stored in a record, nb and ns follow from them
+static const char *snapshot_dims_name[SNAPSHOT_NUM_DIMS] =
+    {"nx", "nu", "nbx", "nbu", "ng", "nsbx", "nsbu", "nsg", "nbxe", "nbue", "nge"};
+
+
+
+static int *snapshot_dims_field(ocp_qp_dims *dims, int ii)
+{
+    switch (ii)
+    {
+        case 0: return dims->nx;
+        case 1: return dims->nu;
+        case 2: return dims->nbx;
+        case 3: return dims->nbu;
+        case 4: return dims->ng;
+        case 5: return dims->nsbx;
+        case 6: return dims->nsbu;
+        case 7: return dims->nsg;
+        case 8: return dims->nbxe;
+        case 9: return dims->nbue;
+        default: return dims->nge;
+    }
+}
+
+
+
+static size_t snapshot_dims_size(int N)
+{
+    return snapshot_padded(SNAPSHOT_NUM_DIMS * (N + 1) * sizeof(int));
+}
+
+
+
+static void snapshot_dmat_layout(uint32_t layout[4])
+{
+    struct blasfeo_dmat A;
+    int memsize = blasfeo_memsize_dmat(9, 3);
+
+    void *raw = acados_malloc(memsize + SNAPSHOT_ALIGN, 1);
+    char *c_ptr = raw;
+    align_char_to(SNAPSHOT_ALIGN, &c_ptr);
+    blasfeo_create_dmat(9, 3, &A, c_ptr);
+
+    layout[0] = (uint32_t) memsize;
+    layout[1] = (uint32_t) (&BLASFEO_DMATEL(&A, 1, 0) - A.pA);
+    layout[2] = (uint32_t) (&BLASFEO_DMATEL(&A, 0, 1) - A.pA);
+    layout[3] = (uint32_t) (&BLASFEO_DMATEL(&A, 8, 2) - A.pA);
+
+    free(raw);
+}
+
+
+
+static size_t snapshot_in_size(ocp_qp_in *qp_in)
+{
+    ocp_qp_dims *dims = qp_in->dim;
+    int N = dims->N;
+
+    size_t size = snapshot_padded(sizeof(snapshot_record_header));
+    size += snapshot_dims_size(N);
+
+    for (int kk = 0; kk <= N; kk++)
+    {
+        if (kk < N)
+        {
+            size += snapshot_padded(qp_in->BAbt[kk].memsize);
+            size += snapshot_padded(qp_in->b[kk].memsize);
+        }
+        size += snapshot_padded(qp_in->RSQrq[kk].memsize);
+        size += snapshot_padded(qp_in->rqz[kk].memsize);
+        size += snapshot_padded(qp_in->DCt[kk].memsize);
+        size += snapshot_padded(qp_in->d[kk].memsize);
+        size += snapshot_padded(qp_in->d_mask[kk].memsize);
+        size += snapshot_padded(qp_in->m[kk].memsize);
+        size += snapshot_padded(qp_in->Z[kk].memsize);
+        size += snapshot_padded(dims->nb[kk] * sizeof(int));
+        size += snapshot_padded((dims->nb[kk] + dims->ng[kk]) * sizeof(int));
+        size += snapshot_padded((dims->nbxe[kk] + dims->nbue[kk] + dims->nge[kk]) * sizeof(int));
+    }
+
+    return size;
+}
+
+
+
+static size_t snapshot_out_size(ocp_qp_out *qp_out)
+{
+    int N = qp_out->dim->N;
+
+    size_t size = snapshot_padded(sizeof(snapshot_record_header));
+    size += snapshot_dims_size(N);
+
+    for (int kk = 0; kk <= N; kk++)
+    {
+        size += snapshot_padded(qp_out->ux[kk].memsize);
+        if (kk < N)
+            size += snapshot_padded(qp_out->pi[kk].memsize);
+        size += snapshot_padded(qp_out->lam[kk].memsize);
+        size += snapshot_padded(qp_out->t[kk].memsize);
+    }
+    size += snapshot_padded(sizeof(qp_info));
+
+    return size;
+}
+
+
+
+/************************************************
+ * writer
+ ************************************************/
+
+static void snapshot_write(FILE *file, const void *data, size_t size)
+{
+    if (size > 0 && fwrite(data, 1, size, file) != size)
+    {
+        printf("\nerror: ocp_qp_snapshot: failed to write to file\n");
+        exit(1);
+    }
+}
+
+
+
+// writes size bytes and pads them to the block alignment
+static void snapshot_write_block(FILE *file, const void *data, size_t size)
+{
+    static const char zeros[SNAPSHOT_ALIGN] = {0};
+
+    snapshot_write(file, data, size);
+    snapshot_write(file, zeros, snapshot_padded(size) - size);
+}
+
+
+
+static void snapshot_write_header(FILE *file, ocp_qp_snapshot_kind kind, int N, size_t size)
+{
+    snapshot_record_header header;
+    memset(&header, 0, sizeof(header));
+    header.kind = kind;
+    header.N = N;
+    header.size = size;
+
+    snapshot_write_block(file, &header, sizeof(header));
+}
+
+
+
+static void snapshot_write_dims(FILE *file, ocp_qp_dims *dims)
+{
+    static const char zeros[SNAPSHOT_ALIGN] = {0};
+    size_t size = SNAPSHOT_NUM_DIMS * (dims->N + 1) * sizeof(int);
+
+    for (int ii = 0; ii < SNAPSHOT_NUM_DIMS; ii++)
+        snapshot_write(file, snapshot_dims_field(dims, ii), (dims->N + 1) * sizeof(int));
+    snapshot_write(file, zeros, snapshot_padded(size) - size);
+}
+
+
+
+ocp_qp_snapshot_writer *ocp_qp_snapshot_writer_open(const char *filename)
+{
+    FILE *file = fopen(filename, "wb");
+    if (file == NULL)
+    {
+        printf("\nerror: ocp_qp_snapshot_writer_open: can not open %s\n", filename);
+        exit(1);
+    }
+
+    snapshot_file_header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, 8);
+    header.version = OCP_QP_SNAPSHOT_VERSION;
+    header.byte_order = SNAPSHOT_BYTE_ORDER;
+    header.sizeof_int = sizeof(int);
+    header.sizeof_double = sizeof(double);
+    snapshot_dmat_layout(header.dmat_layout);
+
+    snapshot_write_block(file, &header, sizeof(header));
+
+    ocp_qp_snapshot_writer *writer = acados_malloc(1, sizeof(ocp_qp_snapshot_writer));
+    writer->file = file;
+    writer->num_records = 0;
+
+    return writer;
+}
+
+
+
+void ocp_qp_snapshot_write_in(ocp_qp_snapshot_writer *writer, ocp_qp_in *qp_in)
+{
+    FILE *file = writer->file;
+    ocp_qp_dims *dims = qp_in->dim;
+    int N = dims->N;
+
+    snapshot_write_header(file, OCP_QP_SNAPSHOT_IN, N, snapshot_in_size(qp_in));
+    snapshot_write_dims(file, dims);
+
+    for (int kk = 0; kk <= N; kk++)
+    {
+        if (kk < N)
+        {
+            snapshot_write_block(file, qp_in->BAbt[kk].pA, qp_in->BAbt[kk].memsize);
+            snapshot_write_block(file, qp_in->b[kk].pa, qp_in->b[kk].memsize);
+        }
+        snapshot_write_block(file, qp_in->RSQrq[kk].pA, qp_in->RSQrq[kk].memsize);
+        snapshot_write_block(file, qp_in->rqz[kk].pa, qp_in->rqz[kk].memsize);
+        snapshot_write_block(file, qp_in->DCt[kk].pA, qp_in->DCt[kk].memsize);
+        snapshot_write_block(file, qp_in->d[kk].pa, qp_in->d[kk].memsize);
+        snapshot_write_block(file, qp_in->d_mask[kk].pa, qp_in->d_mask[kk].memsize);
+        snapshot_write_block(file, qp_in->m[kk].pa, qp_in->m[kk].memsize);
+        snapshot_write_block(file, qp_in->Z[kk].pa, qp_in->Z[kk].memsize);
+        snapshot_write_block(file, qp_in->idxb[kk], dims->nb[kk] * sizeof(int));
+        snapshot_write_block(file, qp_in->idxs_rev[kk], (dims->nb[kk] + dims->ng[kk]) * sizeof(int));
+        snapshot_write_block(file, qp_in->idxe[kk],
+                             (dims->nbxe[kk] + dims->nbue[kk] + dims->nge[kk]) * sizeof(int));
+    }
+
+    writer->num_records++;
+}
+
+
+
+void ocp_qp_snapshot_write_out(ocp_qp_snapshot_writer *writer, ocp_qp_out *qp_out)
+{
+    FILE *file = writer->file;
+    int N = qp_out->dim->N;
+
+    snapshot_write_header(file, OCP_QP_SNAPSHOT_OUT, N, snapshot_out_size(qp_out));
+    snapshot_write_dims(file, qp_out->dim);
+
+    for (int kk = 0; kk <= N; kk++)
+    {
+        snapshot_write_block(file, qp_out->ux[kk].pa, qp_out->ux[kk].memsize);
+        if (kk < N)
+            snapshot_write_block(file, qp_out->pi[kk].pa, qp_out->pi[kk].memsize);
+        snapshot_write_block(file, qp_out->lam[kk].pa, qp_out->lam[kk].memsize);
+        snapshot_write_block(file, qp_out->t[kk].pa, qp_out->t[kk].memsize);
+    }
+    snapshot_write_block(file, qp_out->misc, sizeof(qp_info));
+
+    writer->num_records++;
+}
+
+
+
+void ocp_qp_snapshot_writer_close(ocp_qp_snapshot_writer *writer)
+{
+    if (fclose(writer->file) != 0)
+    {
+        printf("\nerror: ocp_qp_snapshot_writer_close: failed to write to file\n");
+        exit(1);
+    }
+    free(writer);
+}
+
+
+
+/************************************************
+ * reader
+ ************************************************/
+
+static snapshot_record_header *snapshot_record(ocp_qp_snapshot *snap, int record)
+{
+    if (record < 0 || record >= snap->num_records)
+    {
+        printf("\nerror: ocp_qp_snapshot: record %d out of range, file has %d records\n", record,
+               snap->num_records);
+        exit(1);
+    }
+
+    return (snapshot_record_header *) (snap->data + snap->offsets[record]);
+}
+
+
+
+static int *snapshot_record_dims(snapshot_record_header *header)
+{
+    return (int *) ((char *) header + snapshot_padded(sizeof(snapshot_record_header)));
+}
+
+
+
+// checks that the record has kind and the dims of dims
+static void snapshot_check_record(snapshot_record_header *header, ocp_qp_snapshot_kind kind,
+                                  ocp_qp_dims *dims)
+{
+    int N = dims->N;
+
+    if (header->kind != (uint32_t) kind || header->N != N)
+    {
+        printf("\nerror: ocp_qp_snapshot: record has kind %u and N = %d, expected kind %u and N = %d\n",
+               header->kind, header->N, (uint32_t) kind, N);
+        exit(1);
+    }
+
+    int *rec_dims = snapshot_record_dims(header);
+
+    for (int ii = 0; ii < SNAPSHOT_NUM_DIMS; ii++)
+    {
+        int *field = snapshot_dims_field(dims, ii);
+        for (int kk = 0; kk <= N; kk++)
+        {
+            if (rec_dims[ii * (N + 1) + kk] != field[kk])
+            {
+                printf("\nerror: ocp_qp_snapshot: %s[%d] = %d in record, %d in dims\n",
+                       snapshot_dims_name[ii], kk, rec_dims[ii * (N + 1) + kk], field[kk]);
+                exit(1);
+            }
+        }
+    }
+}
+
+
+
+// returns the current block and advances to the next one
+static char *snapshot_next_block(char **c_ptr, size_t size)
+{
+    char *block = *c_ptr;
+    *c_ptr += snapshot_padded(size);
+    return block;
+}
+
+
+
+ocp_qp_snapshot *ocp_qp_snapshot_open(const char *filename)
+{
+    ocp_qp_snapshot *snap = acados_calloc(1, sizeof(ocp_qp_snapshot));
+
+#if (defined _WIN32 || defined _WIN64)
+
+    // no mmap: read the whole file into one aligned buffer
+    FILE *file = fopen(filename, "rb");
+    if (file == NULL)
+    {
+        printf("\nerror: ocp_qp_snapshot_open: can not open %s\n", filename);
+        exit(1);
+    }
+    fseek(file, 0, SEEK_END);
+    snap->size = (size_t) ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    snap->raw = acados_malloc(snap->size + SNAPSHOT_ALIGN, 1);
+    snap->data = snap->raw;
+    align_char_to(SNAPSHOT_ALIGN, &snap->data);
+    if (fread(snap->data, 1, snap->size, file) != snap->size)
+    {
+        printf("\nerror: ocp_qp_snapshot_open: failed to read %s\n", filename);
+        exit(1);
+    }
+    fclose(file);
+
+#else
+
+    int fd = open(filename, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0)
+    {
+        printf("\nerror: ocp_qp_snapshot_open: can not open %s\n", filename);
+        exit(1);
+    }
+    snap->size = (size_t) st.st_size;
+
+    // private mapping: pages are copied only if a mapped qp_in is written to
+    void *data = mmap(NULL, snap->size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        printf("\nerror: ocp_qp_snapshot_open: can not map %s\n", filename);
+        exit(1);
+    }
+    snap->data = data;
+    snap->raw = NULL;
+
+#endif
+
+    // file header
+    snapshot_file_header *header = (snapshot_file_header *) snap->data;
+    if (snap->size < snapshot_padded(sizeof(snapshot_file_header)) ||
+        memcmp(header->magic, SNAPSHOT_MAGIC, 8))
+    {
+        printf("\nerror: ocp_qp_snapshot_open: %s is not an acados qp snapshot\n", filename);
+        exit(1);
+    }
+    if (header->version != OCP_QP_SNAPSHOT_VERSION)
+    {
+        printf("\nerror: ocp_qp_snapshot_open: %s has version %u, expected %d\n", filename,
+               header->version, OCP_QP_SNAPSHOT_VERSION);
+        exit(1);
+    }
+
+    uint32_t dmat_layout[4];
+    snapshot_dmat_layout(dmat_layout);
+    if (header->byte_order != SNAPSHOT_BYTE_ORDER || header->sizeof_int != sizeof(int) ||
+        header->sizeof_double != sizeof(double) ||
+        memcmp(header->dmat_layout, dmat_layout, sizeof(dmat_layout)))
+    {
+        printf("\nerror: ocp_qp_snapshot_open: %s was written on a different platform or with a "
+               "different blasfeo matrix layout\n", filename);
+        exit(1);
+    }
+
+    // index the records
+    size_t offset;
+    size_t begin = snapshot_padded(sizeof(snapshot_file_header));
+    int num_records = 0;
+
+    for (offset = begin; offset < snap->size; num_records++)
+    {
+        snapshot_record_header *rec = (snapshot_record_header *) (snap->data + offset);
+        if (offset + sizeof(snapshot_record_header) > snap->size || rec->size == 0 ||
+            offset + rec->size > snap->size)
+        {
+            printf("\nerror: ocp_qp_snapshot_open: %s is truncated after %d records\n", filename,
+                   num_records);
+            exit(1);
+        }
+        offset += rec->size;
+    }
+
+    snap->num_records = num_records;
+    snap->offsets = acados_malloc(num_records > 0 ? num_records : 1, sizeof(size_t));
+
+    offset = begin;
+    for (int ii = 0; ii < num_records; ii++)
+    {
+        snap->offsets[ii] = offset;
+        offset += ((snapshot_record_header *) (snap->data + offset))->size;
+    }
+
+    return snap;
+}
+
+
+
+void ocp_qp_snapshot_close(ocp_qp_snapshot *snap)
+{
+#if (defined _WIN32 || defined _WIN64)
+    free(snap->raw);
+#else
+    munmap(snap->data, snap->size);
+#endif
+    free(snap->offsets);
+    free(snap);
+}
+
+
+
+ocp_qp_snapshot_kind ocp_qp_snapshot_record_kind(ocp_qp_snapshot *snap, int record)
+{
+    return (ocp_qp_snapshot_kind) snapshot_record(snap, record)->kind;
+}
+
+
+
+int ocp_qp_snapshot_record_N(ocp_qp_snapshot *snap, int record)
+{
+    return snapshot_record(snap, record)->N;
+}
+
+
+
+void ocp_qp_snapshot_get_dims(ocp_qp_snapshot *snap, int record, ocp_qp_dims *dims)
+{
+    snapshot_record_header *header = snapshot_record(snap, record);
+    int N = header->N;
+    int *rec_dims = snapshot_record_dims(header);
+
+    if (dims->N != N)
+    {
+        printf("\nerror: ocp_qp_snapshot_get_dims: dims for N = %d, record has N = %d\n", dims->N, N);
+        exit(1);
+    }
+
+    for (int ii = 0; ii < SNAPSHOT_NUM_DIMS; ii++)
+    {
+        for (int kk = 0; kk <= N; kk++)
+            ocp_qp_dims_set(NULL, dims, kk, snapshot_dims_name[ii], &rec_dims[ii * (N + 1) + kk]);
+    }
+}
+
+
+
+void ocp_qp_snapshot_map_in(ocp_qp_snapshot *snap, int record, ocp_qp_in *qp_in)
+{
+    snapshot_record_header *header = snapshot_record(snap, record);
+    ocp_qp_dims *dims = qp_in->dim;
+    int N = dims->N;
+
+    snapshot_check_record(header, OCP_QP_SNAPSHOT_IN, dims);
+    assert(header->size == snapshot_in_size(qp_in));
+
+    char *c_ptr = (char *) snapshot_record_dims(header) + snapshot_dims_size(N);
+
+    for (int kk = 0; kk <= N; kk++)
+    {
+        int nu = dims->nu[kk];
+        int nx = dims->nx[kk];
+        int nb = dims->nb[kk];
+        int ng = dims->ng[kk];
+        int ns = dims->ns[kk];
+
+        // recreate the blasfeo structs on the memory in the file
+        if (kk < N)
+        {
+            int nx1 = dims->nx[kk + 1];
+            blasfeo_create_dmat(nu + nx + 1, nx1, qp_in->BAbt + kk,
+                                snapshot_next_block(&c_ptr, qp_in->BAbt[kk].memsize));
+            blasfeo_create_dvec(nx1, qp_in->b + kk, snapshot_next_block(&c_ptr, qp_in->b[kk].memsize));
+        }
+        blasfeo_create_dmat(nu + nx + 1, nu + nx, qp_in->RSQrq + kk,
+                            snapshot_next_block(&c_ptr, qp_in->RSQrq[kk].memsize));
+        blasfeo_create_dvec(nu + nx + 2 * ns, qp_in->rqz + kk,
+                            snapshot_next_block(&c_ptr, qp_in->rqz[kk].memsize));
+        blasfeo_create_dmat(nu + nx, ng, qp_in->DCt + kk,
+                            snapshot_next_block(&c_ptr, qp_in->DCt[kk].memsize));
+        blasfeo_create_dvec(2 * nb + 2 * ng + 2 * ns, qp_in->d + kk,
+                            snapshot_next_block(&c_ptr, qp_in->d[kk].memsize));
+        blasfeo_create_dvec(2 * nb + 2 * ng + 2 * ns, qp_in->d_mask + kk,
+                            snapshot_next_block(&c_ptr, qp_in->d_mask[kk].memsize));
+        blasfeo_create_dvec(2 * nb + 2 * ng + 2 * ns, qp_in->m + kk,
+                            snapshot_next_block(&c_ptr, qp_in->m[kk].memsize));
+        blasfeo_create_dvec(2 * ns, qp_in->Z + kk, snapshot_next_block(&c_ptr, qp_in->Z[kk].memsize));
+
+        qp_in->idxb[kk] = (int *) snapshot_next_block(&c_ptr, nb * sizeof(int));
+        qp_in->idxs_rev[kk] = (int *) snapshot_next_block(&c_ptr, (nb + ng) * sizeof(int));
+        qp_in->idxe[kk] = (int *) snapshot_next_block(&c_ptr,
+                              (dims->nbxe[kk] + dims->nbue[kk] + dims->nge[kk]) * sizeof(int));
+    }
+
+    assert(c_ptr == (char *) header + header->size);
+
+    ocp_qp_in_mark_changed_all(qp_in, OCP_QP_IN_ALL);
+}
+
+
+
+void ocp_qp_snapshot_get_out(ocp_qp_snapshot *snap, int record, ocp_qp_out *qp_out)
+{
+    snapshot_record_header *header = snapshot_record(snap, record);
+    int N = qp_out->dim->N;
+
+    snapshot_check_record(header, OCP_QP_SNAPSHOT_OUT, qp_out->dim);
+    assert(header->size == snapshot_out_size(qp_out));
+
+    char *c_ptr = (char *) snapshot_record_dims(header) + snapshot_dims_size(N);
+
+    for (int kk = 0; kk <= N; kk++)
+    {
+        memcpy(qp_out->ux[kk].pa, snapshot_next_block(&c_ptr, qp_out->ux[kk].memsize),
+               qp_out->ux[kk].memsize);
+        if (kk < N)
+            memcpy(qp_out->pi[kk].pa, snapshot_next_block(&c_ptr, qp_out->pi[kk].memsize),
+                   qp_out->pi[kk].memsize);
+        memcpy(qp_out->lam[kk].pa, snapshot_next_block(&c_ptr, qp_out->lam[kk].memsize),
+               qp_out->lam[kk].memsize);
+        memcpy(qp_out->t[kk].pa, snapshot_next_block(&c_ptr, qp_out->t[kk].memsize),
+               qp_out->t[kk].memsize);
+    }
+    memcpy(qp_out->misc, snapshot_next_block(&c_ptr, sizeof(qp_info)), sizeof(qp_info));
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright 2019 Gianluca Frison, Dimitris Kouzoupis, Robin Verschueren,
+ * Andrea Zanelli, Niels van Duijkeren, Jonathan Frey, Tommaso Sartor,
+ * Branimir Novoselnik, Rien Quirynen, Rezart Qelibari, Dang Doan,
+ * Jonas Koenemann, Yutao Chen, Tobias Schöls, Jonas Schlagenhauf, Moritz Diehl
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+
+
+#ifndef ACADOS_OCP_QP_OCP_QP_SNAPSHOT_H_
+#define ACADOS_OCP_QP_OCP_QP_SNAPSHOT_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdio.h>
+
+// acados
+#include "acados/ocp_qp/ocp_qp_common.h"
+
+
+
+// Binary snapshots of ocp qps, for logging and replay.
+//
+// A snapshot file is a file header followed by a sequence of records, each holding one
+// ocp_qp_in or one ocp_qp_out together with its dims. Matrices and vectors are stored as the
+// memory of their blasfeo structs (panel-major for the high-performance blasfeo targets), so that
+// a record can be mapped into an ocp_qp_in without copying. All blocks are 64 byte aligned
+// within the file. The file header records the blasfeo matrix layout; a file can only be read
+// with a blasfeo library of the same layout.
+
+#define OCP_QP_SNAPSHOT_VERSION 1
+
+typedef enum
+{
+    OCP_QP_SNAPSHOT_IN = 1,
+    OCP_QP_SNAPSHOT_OUT = 2,
+} ocp_qp_snapshot_kind;
+
+
+
+// streaming writer, appends one record per call
+typedef struct
+{
+    FILE *file;
+    int num_records;
+} ocp_qp_snapshot_writer;
+
+//
+ocp_qp_snapshot_writer *ocp_qp_snapshot_writer_open(const char *filename);
+//
+void ocp_qp_snapshot_write_in(ocp_qp_snapshot_writer *writer, ocp_qp_in *qp_in);
+//
+void ocp_qp_snapshot_write_out(ocp_qp_snapshot_writer *writer, ocp_qp_out *qp_out);
+//
+void ocp_qp_snapshot_writer_close(ocp_qp_snapshot_writer *writer);
+
+
+
+// read-only view of a snapshot file, memory mapped where available
+typedef struct
+{
+    char *data;
+    size_t size;
+    void *raw;           // allocation if the file is read instead of mapped
+    size_t *offsets;     // file offset of each record
+    int num_records;
+} ocp_qp_snapshot;
+
+//
+ocp_qp_snapshot *ocp_qp_snapshot_open(const char *filename);
+//
+void ocp_qp_snapshot_close(ocp_qp_snapshot *snap);
+//
+ocp_qp_snapshot_kind ocp_qp_snapshot_record_kind(ocp_qp_snapshot *snap, int record);
+//
+int ocp_qp_snapshot_record_N(ocp_qp_snapshot *snap, int record);
+// sets dims, allocated for the horizon of the record
+void ocp_qp_snapshot_get_dims(ocp_qp_snapshot *snap, int record, ocp_qp_dims *dims);
+// points the data of qp_in, allocated for the dims of the record, into the snapshot (no copy);
+// valid until the snapshot is closed, writes to qp_in do not reach the file
+void ocp_qp_snapshot_map_in(ocp_qp_snapshot *snap, int record, ocp_qp_in *qp_in);
+// copies the solution and qp_info of the record to qp_out
+void ocp_qp_snapshot_get_out(ocp_qp_snapshot *snap, int record, ocp_qp_out *qp_out);
+
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif  // ACADOS_OCP_QP_OCP_QP_SNAPSHOT_H_
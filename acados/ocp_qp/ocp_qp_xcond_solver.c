@@ -39,11 +39,19 @@
 
 // acados
 #include "acados/ocp_qp/ocp_qp_common.h"
+#include "acados/ocp_qp/ocp_qp_partial_condensing.h"
 #include "acados/ocp_qp/ocp_qp_xcond_solver.h"
 #include "acados/utils/mem.h"
 #include "acados/utils/timing.h"
 #include "acados/utils/types.h"
 
+#if defined(ACADOS_WITH_QPOASES)
+#include "acados/dense_qp/dense_qp_qpoases.h"
+#endif
+#if defined(ACADOS_WITH_QPDUNES)
+#include "acados/ocp_qp/ocp_qp_qpdunes.h"
+#endif
+
 
 
 /************************************************
@@ -147,6 +155,21 @@ void ocp_qp_xcond_solver_dims_set_(void *config_, ocp_qp_xcond_solver_dims *dims
  * opts
  ************************************************/
 
+// qp solvers that start from an active set guess in their qp_out
+static int ocp_qp_xcond_solver_guess_supported(qp_solver_config *qp_solver)
+{
+#if defined(ACADOS_WITH_QPOASES)
+    if (qp_solver->evaluate == (int (*)(void *, void *, void *, void *, void *, void *)) &dense_qp_qpoases)
+        return 1;
+#endif
+#if defined(ACADOS_WITH_QPDUNES)
+    if (qp_solver->evaluate == (int (*)(void *, void *, void *, void *, void *, void *)) &ocp_qp_qpdunes)
+        return 1;
+#endif
+    return 0;
+}
+
+
 int ocp_qp_xcond_solver_opts_calculate_size(void *config_, ocp_qp_xcond_solver_dims *dims)
 {
     ocp_qp_xcond_solver_config *config = config_;
@@ -211,6 +234,10 @@ void ocp_qp_xcond_solver_opts_initialize_default(void *config_, ocp_qp_xcond_sol
 
     // xcond solver opts
     ocp_qp_xcond_solver_opts *opts = (ocp_qp_xcond_solver_opts *) opts_;
+    opts->cond_N = dims->orig_dims->N;
+    opts->cond_N_auto = 0;
+    opts->N2_auto_sizes_valid = 0;
+    opts->guess_active_set = 0;
     // xcond opts
     xcond->opts_initialize_default(dims->xcond_dims, opts->xcond_opts);
     // qp solver opts
@@ -230,6 +257,7 @@ void ocp_qp_xcond_solver_opts_update(void *config_, ocp_qp_xcond_solver_dims *di
 
     // xcond solver opts
     ocp_qp_xcond_solver_opts *opts = (ocp_qp_xcond_solver_opts *) opts_;
+    opts->N2_auto_sizes_valid = 0;
     // xcond opts
     xcond->opts_update(dims->xcond_dims, opts->xcond_opts);
     // qp solver opts
@@ -247,6 +275,9 @@ void ocp_qp_xcond_solver_opts_set_(void *config_, void *opts_, const char *field
 
     int ii;
 
+    // the sizes of cond_N_auto may depend on any option
+    opts->N2_auto_sizes_valid = 0;
+
     char module[MAX_STR_LEN];
     char *ptr_module = NULL;
     int module_length = 0;
@@ -262,8 +293,39 @@ void ocp_qp_xcond_solver_opts_set_(void *config_, void *opts_, const char *field
         ptr_module = module;
     }
 
-    if( ptr_module!=NULL && (!strcmp(ptr_module, "cond")) ) // pass options to condensing module // TODO rename xcond ???
+    if (!strcmp(field, "cond_N_auto"))
+    {
+        int *tmp_ptr = value;
+        if (*tmp_ptr && xcond->condensing != &ocp_qp_partial_condensing)
+        {
+            printf("\nerror: ocp_qp_xcond_solver_opts_set: cond_N_auto requires partial condensing\n");
+            exit(1);
+        }
+        opts->cond_N_auto = *tmp_ptr;
+    }
+    else if (!strcmp(field, "guess_active_set"))
     {
+        // the qp solver reads the guess from its qp_out, the xcond module puts it there;
+        // ignored by the other qp solvers
+        int *tmp_ptr = value;
+        if (ocp_qp_xcond_solver_guess_supported(qp_solver))
+        {
+            opts->guess_active_set = *tmp_ptr;
+            qp_solver->opts_set(qp_solver, opts->qp_solver_opts, field, value);
+        }
+        else if (*tmp_ptr)
+        {
+            printf("\nwarning: ocp_qp_xcond_solver_opts_set: guess_active_set not supported by "
+                   "the qp solver, ignored\n");
+        }
+    }
+    else if( ptr_module!=NULL && (!strcmp(ptr_module, "cond")) ) // pass options to condensing module // TODO rename xcond ???
+    {
+        if (!strcmp(field, "cond_N"))
+        {
+            int *tmp_ptr = value;
+            opts->cond_N = *tmp_ptr;
+        }
         xcond->opts_set(opts->xcond_opts, field+module_length+1, value);
     }
     else // pass options to QP module
@@ -277,6 +339,264 @@ void ocp_qp_xcond_solver_opts_set_(void *config_, void *opts_, const char *field
 
 
 
+/************************************************
+ * automatic partial condensing horizon
+ ************************************************/
+
+// flop model of the condensing plus OCP_QP_XCOND_N2_AUTO_ITER Riccati recursions
+// of the partially condensed qp with horizon N2
+static double ocp_qp_xcond_solver_pcond_flops(ocp_qp_dims *dims, int N2)
+{
+    int N = dims->N;
+    int ii, jj;
+
+    double cond = 0.0;
+    double ric = 0.0;
+    double nx0, nx1, nu_c, ng_c, nv;
+
+    int k0 = 0;
+    for (ii = 0; ii < N2; ii++)
+    {
+        int bs = N / N2 + (ii < N % N2);
+
+        nx0 = dims->nx[k0];
+        nu_c = 0.0;
+        ng_c = 0.0;
+        for (jj = k0; jj < k0 + bs; jj++)
+        {
+            // state sensitivities and condensed Hessian
+            nv = nx0 + nu_c + dims->nu[jj];
+            cond += nv * (dims->nx[jj] + dims->nu[jj]) * dims->nx[jj+1] + nv * nv * dims->nx[jj];
+            nu_c += dims->nu[jj];
+            // state bounds within the block become general constraints
+            ng_c += dims->ng[jj] + (jj > k0 ? dims->nbx[jj] : 0);
+        }
+
+        nv = nx0 + nu_c;
+        nx1 = dims->nx[k0+bs];
+        ric += nv * nv * nv / 3.0 + nv * nv * nx1 + nv * nx1 * nx1 + nv * nv * ng_c;
+
+        k0 += bs;
+    }
+
+    // last stage
+    nv = dims->nx[N] + dims->nu[N];
+    ric += nv * nv * nv / 3.0 + nv * nv * dims->ng[N];
+
+    return cond + OCP_QP_XCOND_N2_AUTO_ITER * ric;
+}
+
+
+
+// preselect the horizons with the lowest modelled cost, returns their number
+static int ocp_qp_xcond_solver_N2_candidates(ocp_qp_dims *dims, int *cand)
+{
+    int N = dims->N;
+    int num = N < OCP_QP_XCOND_N2_AUTO_CAND ? N : OCP_QP_XCOND_N2_AUTO_CAND;
+
+    double flops[OCP_QP_XCOND_N2_AUTO_CAND];
+    double tmp_flops;
+    int ii, jj, tmp_N2;
+
+    for (ii = 0; ii < num; ii++)
+        flops[ii] = -1.0;
+
+    // insertion into the sorted list of the num cheapest horizons
+    for (int N2 = 1; N2 <= N; N2++)
+    {
+        tmp_flops = ocp_qp_xcond_solver_pcond_flops(dims, N2);
+        tmp_N2 = N2;
+        for (ii = 0; ii < num; ii++)
+        {
+            if (flops[ii] < 0.0 || tmp_flops < flops[ii])
+            {
+                for (jj = num-1; jj > ii; jj--)
+                {
+                    flops[jj] = flops[jj-1];
+                    cand[jj] = cand[jj-1];
+                }
+                flops[ii] = tmp_flops;
+                cand[ii] = tmp_N2;
+                break;
+            }
+        }
+    }
+
+    return num;
+}
+
+
+
+// set the partial condensing horizon in the xcond opts, and the condensed xcond dims;
+// the qp solver opts do not depend on the horizon
+static void ocp_qp_xcond_solver_set_N2(ocp_qp_xcond_config *xcond, void *xcond_dims,
+                                       void *xcond_opts, int N2)
+{
+    xcond->opts_set(xcond_opts, "N", &N2);
+    xcond->opts_update(xcond_dims, xcond_opts);
+
+    // populates the dims of the condensed qp
+    xcond->memory_calculate_size(xcond_dims, xcond_opts);
+
+    return;
+}
+
+
+
+// memory and workspace sizes of the condensing module and of the qp solver,
+// maximized over the candidate horizons if cond_N_auto
+static void ocp_qp_xcond_solver_calculate_sizes(ocp_qp_xcond_solver_config *config,
+        ocp_qp_xcond_solver_dims *dims, ocp_qp_xcond_solver_opts *opts,
+        int *xcond_mem_size, int *solver_mem_size, int *work_size)
+{
+    qp_solver_config *qp_solver = config->qp_solver;
+    ocp_qp_xcond_config *xcond = config->xcond;
+
+    int cand[OCP_QP_XCOND_N2_AUTO_CAND];
+    int num = 1;
+    int tmp_size;
+
+    // the candidate loop changes the shared dims and opts, it only runs after an opts change
+    // (i.e. at creation), and later calls (e.g. from a solver casting its workspace) reuse it
+    if (opts->cond_N_auto && opts->N2_auto_sizes_valid)
+    {
+        *xcond_mem_size = opts->N2_auto_xcond_mem_size;
+        *solver_mem_size = opts->N2_auto_solver_mem_size;
+        *work_size = opts->N2_auto_work_size;
+        return;
+    }
+
+    if (opts->cond_N_auto)
+    {
+        num = ocp_qp_xcond_solver_N2_candidates(dims->orig_dims, cand);
+        // size of the xcond opts copy in the memory, does not depend on the horizon
+        opts->N2_auto_xcond_opts_size = xcond->opts_calculate_size(dims->xcond_dims);
+        make_int_multiple_of(8, &opts->N2_auto_xcond_opts_size);
+    }
+
+    *xcond_mem_size = 0;
+    *solver_mem_size = 0;
+    *work_size = 0;
+
+    for (int ii = 0; ii < num; ii++)
+    {
+        if (opts->cond_N_auto)
+            ocp_qp_xcond_solver_set_N2(xcond, dims->xcond_dims, opts->xcond_opts, cand[ii]);
+
+        // set up dimesions of condensed qp
+        tmp_size = xcond->memory_calculate_size(dims->xcond_dims, opts->xcond_opts);
+        if (tmp_size > *xcond_mem_size)
+            *xcond_mem_size = tmp_size;
+
+        void *xcond_qp_dims;
+        xcond->dims_get(xcond, dims->xcond_dims, "xcond_dims", &xcond_qp_dims);
+
+        tmp_size = qp_solver->memory_calculate_size(qp_solver, xcond_qp_dims, opts->qp_solver_opts);
+        if (tmp_size > *solver_mem_size)
+            *solver_mem_size = tmp_size;
+
+        tmp_size = xcond->workspace_calculate_size(dims->xcond_dims, opts->xcond_opts);
+        tmp_size += qp_solver->workspace_calculate_size(qp_solver, xcond_qp_dims, opts->qp_solver_opts);
+        if (tmp_size > *work_size)
+            *work_size = tmp_size;
+    }
+
+    make_int_multiple_of(8, xcond_mem_size);
+    make_int_multiple_of(8, solver_mem_size);
+
+    if (opts->cond_N_auto)
+    {
+        ocp_qp_xcond_solver_set_N2(xcond, dims->xcond_dims, opts->xcond_opts, opts->cond_N);
+
+        opts->N2_auto_xcond_mem_size = *xcond_mem_size;
+        opts->N2_auto_solver_mem_size = *solver_mem_size;
+        opts->N2_auto_work_size = *work_size;
+        opts->N2_auto_sizes_valid = 1;
+    }
+
+    return;
+}
+
+
+
+// switch to another horizon, the memory of both modules is re-assigned in place
+static void ocp_qp_xcond_solver_switch_N2(ocp_qp_xcond_solver_config *config,
+        ocp_qp_xcond_solver_opts *opts, ocp_qp_xcond_solver_memory *mem, int N2)
+{
+    qp_solver_config *qp_solver = config->qp_solver;
+    ocp_qp_xcond_config *xcond = config->xcond;
+
+    ocp_qp_xcond_solver_set_N2(xcond, mem->xcond_dims, mem->xcond_opts, N2);
+
+    void *xcond_qp_dims;
+    xcond->dims_get(xcond, mem->xcond_dims, "xcond_dims", &xcond_qp_dims);
+
+    mem->xcond_memory = xcond->memory_assign(mem->xcond_dims, mem->xcond_opts, mem->xcond_memory);
+    mem->solver_memory = qp_solver->memory_assign(qp_solver, xcond_qp_dims, opts->qp_solver_opts,
+                                                  mem->solver_memory);
+
+    xcond->memory_get(xcond, mem->xcond_memory, "xcond_qp_in", &mem->xcond_qp_in);
+    xcond->memory_get(xcond, mem->xcond_memory, "xcond_qp_out", &mem->xcond_qp_out);
+
+    mem->cond_N = N2;
+    mem->lhs_qp_in = NULL;
+    mem->lhs_generation = 0;
+
+    return;
+}
+
+
+
+// set the horizon of the next solve: the candidate of the next timed solve, or the fastest
+// one after all timed solves; switching only before a solve keeps the memory of the last
+// solve valid (e.g. for eval_sens)
+static void ocp_qp_xcond_solver_N2_auto_prepare(ocp_qp_xcond_solver_config *config,
+        ocp_qp_xcond_solver_opts *opts, ocp_qp_xcond_solver_memory *mem)
+{
+    if (mem->N2_auto_num == 0)
+        return;
+
+    int N2;
+    if (mem->N2_auto_iter < mem->N2_auto_num * OCP_QP_XCOND_N2_AUTO_REPS)
+    {
+        N2 = mem->N2_auto_cand[mem->N2_auto_iter / OCP_QP_XCOND_N2_AUTO_REPS];
+    }
+    else
+    {
+        int best = 0;
+        for (int ii = 1; ii < mem->N2_auto_num; ii++)
+        {
+            if (mem->N2_auto_time[ii] < mem->N2_auto_time[best])
+                best = ii;
+        }
+        N2 = mem->N2_auto_cand[best];
+    }
+
+    if (N2 != mem->cond_N)
+        ocp_qp_xcond_solver_switch_N2(config, opts, mem, N2);
+
+    return;
+}
+
+
+
+// record the time of a solve
+static void ocp_qp_xcond_solver_N2_auto_record(ocp_qp_xcond_solver_memory *mem, double time)
+{
+    if (mem->N2_auto_iter >= mem->N2_auto_num * OCP_QP_XCOND_N2_AUTO_REPS)
+        return;
+
+    int ic = mem->N2_auto_iter / OCP_QP_XCOND_N2_AUTO_REPS;
+    if (mem->N2_auto_iter % OCP_QP_XCOND_N2_AUTO_REPS == 0 || time < mem->N2_auto_time[ic])
+        mem->N2_auto_time[ic] = time;
+
+    mem->N2_auto_iter++;
+
+    return;
+}
+
+
+
 /************************************************
  * memory
  ************************************************/
@@ -284,21 +604,26 @@ void ocp_qp_xcond_solver_opts_set_(void *config_, void *opts_, const char *field
 int ocp_qp_xcond_solver_memory_calculate_size(void *config_, ocp_qp_xcond_solver_dims *dims, void *opts_)
 {
     ocp_qp_xcond_solver_config *config = config_;
-    qp_solver_config *qp_solver = config->qp_solver;
-    ocp_qp_xcond_config *xcond = config->xcond;
 
     ocp_qp_xcond_solver_opts *opts = (ocp_qp_xcond_solver_opts *) opts_;
 
+    int xcond_mem_size, solver_mem_size, work_size;
+    ocp_qp_xcond_solver_calculate_sizes(config, dims, opts, &xcond_mem_size, &solver_mem_size,
+                                        &work_size);
+
     int size = 0;
     size += sizeof(ocp_qp_xcond_solver_memory);
 
-    // set up dimesions of partially condensed qp
-    void *xcond_qp_dims;
-    xcond->dims_get(xcond, dims->xcond_dims, "xcond_dims", &xcond_qp_dims);
+    size += xcond_mem_size;
 
-    size += xcond->memory_calculate_size(dims->xcond_dims, opts->xcond_opts);
+    size += solver_mem_size;
 
-    size += qp_solver->memory_calculate_size(qp_solver, xcond_qp_dims, opts->qp_solver_opts);
+    // own copies of the xcond dims and opts
+    if (opts->cond_N_auto)
+    {
+        size += config->xcond->dims_calculate_size(config->xcond, dims->orig_dims->N);
+        size += opts->N2_auto_xcond_opts_size;
+    }
 
     return size;
 }
@@ -316,26 +641,86 @@ void *ocp_qp_xcond_solver_memory_assign(void *config_, ocp_qp_xcond_solver_dims
 
     char *c_ptr = (char *) raw_memory;
 
-    // set up dimesions of partially condensed qp
-    void *xcond_qp_dims;
-    xcond->dims_get(xcond, dims->xcond_dims, "xcond_dims", &xcond_qp_dims);
+    int xcond_mem_size, solver_mem_size, work_size;
+    ocp_qp_xcond_solver_calculate_sizes(config, dims, opts, &xcond_mem_size, &solver_mem_size,
+                                        &work_size);
 
     ocp_qp_xcond_solver_memory *mem = (ocp_qp_xcond_solver_memory *) c_ptr;
     c_ptr += sizeof(ocp_qp_xcond_solver_memory);
 
     assert((size_t) c_ptr % 8 == 0 && "double not 8-byte aligned!");
 
-    mem->xcond_memory = xcond->memory_assign(dims->xcond_dims, opts->xcond_opts, c_ptr);
-    c_ptr += xcond->memory_calculate_size(dims->xcond_dims, opts->xcond_opts);
+    char *xcond_mem_ptr = c_ptr;
+    c_ptr += xcond_mem_size;
 
     assert((size_t) c_ptr % 8 == 0 && "double not 8-byte aligned!");
 
-    mem->solver_memory = qp_solver->memory_assign(qp_solver, xcond_qp_dims, opts->qp_solver_opts, c_ptr);
-    c_ptr += qp_solver->memory_calculate_size(qp_solver, xcond_qp_dims, opts->qp_solver_opts);
+    char *solver_mem_ptr = c_ptr;
+    c_ptr += solver_mem_size;
+
+    // the first solves are timed for the candidate horizons
+    mem->N2_auto_num = 0;
+    mem->N2_auto_iter = 0;
+    if (opts->cond_N_auto)
+    {
+        int N = dims->orig_dims->N;
+        ocp_qp_dims *orig_dims = dims->orig_dims;
+
+        // own copy of the xcond dims, the horizon is switched on it
+        mem->xcond_dims = xcond->dims_assign(xcond, N, c_ptr);
+        c_ptr += xcond->dims_calculate_size(xcond, N);
+
+        for (int ii = 0; ii <= N; ii++)
+        {
+            xcond->dims_set(xcond, mem->xcond_dims, ii, "nx", &orig_dims->nx[ii]);
+            xcond->dims_set(xcond, mem->xcond_dims, ii, "nu", &orig_dims->nu[ii]);
+            xcond->dims_set(xcond, mem->xcond_dims, ii, "nbx", &orig_dims->nbx[ii]);
+            xcond->dims_set(xcond, mem->xcond_dims, ii, "nbu", &orig_dims->nbu[ii]);
+            xcond->dims_set(xcond, mem->xcond_dims, ii, "ng", &orig_dims->ng[ii]);
+            xcond->dims_set(xcond, mem->xcond_dims, ii, "nsbx", &orig_dims->nsbx[ii]);
+            xcond->dims_set(xcond, mem->xcond_dims, ii, "nsbu", &orig_dims->nsbu[ii]);
+            xcond->dims_set(xcond, mem->xcond_dims, ii, "nsg", &orig_dims->nsg[ii]);
+            xcond->dims_set(xcond, mem->xcond_dims, ii, "nbxe", &orig_dims->nbxe[ii]);
+            xcond->dims_set(xcond, mem->xcond_dims, ii, "nbue", &orig_dims->nbue[ii]);
+            xcond->dims_set(xcond, mem->xcond_dims, ii, "nge", &orig_dims->nge[ii]);
+        }
+
+        // own copy of the xcond opts (cond_N_auto implies partial condensing)
+        ocp_qp_partial_condensing_opts *pcond_opts = opts->xcond_opts;
+
+        mem->xcond_opts = xcond->opts_assign(mem->xcond_dims, c_ptr);
+        c_ptr += opts->N2_auto_xcond_opts_size;
+
+        xcond->opts_initialize_default(mem->xcond_dims, mem->xcond_opts);
+        xcond->opts_set(mem->xcond_opts, "ric_alg", &pcond_opts->ric_alg);
+        xcond->opts_set(mem->xcond_opts, "num_threads", &pcond_opts->num_threads);
+
+        mem->N2_auto_num = ocp_qp_xcond_solver_N2_candidates(orig_dims, mem->N2_auto_cand);
+        ocp_qp_xcond_solver_set_N2(xcond, mem->xcond_dims, mem->xcond_opts, mem->N2_auto_cand[0]);
+        mem->cond_N = mem->N2_auto_cand[0];
+    }
+    else
+    {
+        mem->xcond_dims = dims->xcond_dims;
+        mem->xcond_opts = opts->xcond_opts;
+        mem->cond_N = opts->cond_N;
+    }
+
+    // set up dimesions of partially condensed qp
+    void *xcond_qp_dims;
+    xcond->dims_get(xcond, mem->xcond_dims, "xcond_dims", &xcond_qp_dims);
+
+    mem->xcond_memory = xcond->memory_assign(mem->xcond_dims, mem->xcond_opts, xcond_mem_ptr);
+
+    mem->solver_memory = qp_solver->memory_assign(qp_solver, xcond_qp_dims, opts->qp_solver_opts,
+                                                  solver_mem_ptr);
 
     xcond->memory_get(xcond, mem->xcond_memory, "xcond_qp_in", &mem->xcond_qp_in);
     xcond->memory_get(xcond, mem->xcond_memory, "xcond_qp_out", &mem->xcond_qp_out);
 
+    mem->lhs_qp_in = NULL;
+    mem->lhs_generation = 0;
+
     assert((char *) raw_memory + ocp_qp_xcond_solver_memory_calculate_size(config_, dims, opts_) >= c_ptr);
 
     return mem;
@@ -365,6 +750,35 @@ void ocp_qp_xcond_solver_memory_get(void *config_, void *mem_, const char *field
     {
         xcond->memory_get(xcond, mem->xcond_memory, field, value);
     }
+    else if (!strcmp(field, "cond_N"))
+    {
+        int *ptr = value;
+        *ptr = mem->cond_N;
+    }
+    else if (!strcmp(field, "cond_N_auto_num"))
+    {
+        int *ptr = value;
+        *ptr = mem->N2_auto_num;
+    }
+    else if (!strcmp(field, "cond_N_auto_done"))
+    {
+        int *ptr = value;
+        *ptr = mem->N2_auto_iter >= mem->N2_auto_num * OCP_QP_XCOND_N2_AUTO_REPS;
+    }
+    else if (!strcmp(field, "cond_N_auto_candidates"))
+    {
+        // array of length cond_N_auto_num
+        int *ptr = value;
+        for (int ii = 0; ii < mem->N2_auto_num; ii++)
+            ptr[ii] = mem->N2_auto_cand[ii];
+    }
+    else if (!strcmp(field, "cond_N_auto_timings"))
+    {
+        // array of length cond_N_auto_num, fastest solve time of each candidate
+        double *ptr = value;
+        for (int ii = 0; ii < mem->N2_auto_num; ii++)
+            ptr[ii] = mem->N2_auto_time[ii];
+    }
     else
     {
         printf("\nerror: ocp_qp_xcond_solver_memory_get: field %s not available\n", field);
@@ -384,21 +798,16 @@ void ocp_qp_xcond_solver_memory_get(void *config_, void *mem_, const char *field
 int ocp_qp_xcond_solver_workspace_calculate_size(void *config_, ocp_qp_xcond_solver_dims *dims, void *opts_)
 {
     ocp_qp_xcond_solver_config *config = config_;
-    qp_solver_config *qp_solver = config->qp_solver;
-    ocp_qp_xcond_config *xcond = config->xcond;
 
     ocp_qp_xcond_solver_opts *opts = (ocp_qp_xcond_solver_opts *) opts_;
 
-    int size = sizeof(ocp_qp_xcond_solver_workspace);
-
-//    size += xcond->workspace_calculate_size(dims->orig_dims, opts->xcond_opts);
-    size += xcond->workspace_calculate_size(dims->xcond_dims, opts->xcond_opts);
+    int xcond_mem_size, solver_mem_size, work_size;
+    ocp_qp_xcond_solver_calculate_sizes(config, dims, opts, &xcond_mem_size, &solver_mem_size,
+                                        &work_size);
 
-    // set up dimesions of condensed qp
-    void *xcond_qp_dims;
-    xcond->dims_get(xcond, dims->xcond_dims, "xcond_dims", &xcond_qp_dims);
+    int size = sizeof(ocp_qp_xcond_solver_workspace);
 
-    size += qp_solver->workspace_calculate_size(qp_solver, xcond_qp_dims, opts->qp_solver_opts);
+    size += work_size;
 
     return size;
 }
@@ -416,14 +825,14 @@ static void cast_workspace(void *config_, ocp_qp_xcond_solver_dims *dims,
 
     // set up dimesions of  condensed qp
     void *xcond_qp_dims;
-    xcond->dims_get(xcond, dims->xcond_dims, "xcond_dims", &xcond_qp_dims);
+    xcond->dims_get(xcond, mem->xcond_dims, "xcond_dims", &xcond_qp_dims);
 
     char *c_ptr = (char *) work;
 
     c_ptr += sizeof(ocp_qp_xcond_solver_workspace);
 
     work->xcond_work = c_ptr;
-    c_ptr += xcond->workspace_calculate_size(dims->xcond_dims, opts->xcond_opts);
+    c_ptr += xcond->workspace_calculate_size(mem->xcond_dims, mem->xcond_opts);
 
     work->qp_solver_work = c_ptr;
     c_ptr += qp_solver->workspace_calculate_size(qp_solver, xcond_qp_dims, opts->qp_solver_opts);
@@ -437,11 +846,65 @@ static void cast_workspace(void *config_, ocp_qp_xcond_solver_dims *dims,
  * functions
  ************************************************/
 
+static int ocp_qp_xcond_solver_solve_and_expand(ocp_qp_xcond_solver_config *config, ocp_qp_out *qp_out,
+                                                ocp_qp_xcond_solver_opts *opts,
+                                                ocp_qp_xcond_solver_memory *memory,
+                                                ocp_qp_xcond_solver_workspace *work)
+{
+    qp_solver_config *qp_solver = config->qp_solver;
+    ocp_qp_xcond_config *xcond = config->xcond;
+
+    qp_info *info = (qp_info *) qp_out->misc;
+    acados_timer cond_timer;
+
+    int solver_status = ACADOS_SUCCESS;
+
+    // active set guess from the solution in qp_out
+    if (opts->guess_active_set)
+    {
+        acados_tic(&cond_timer);
+        xcond->condensing_sol(qp_out, memory->xcond_qp_out, memory->xcond_opts, memory->xcond_memory,
+                              work->xcond_work);
+        info->condensing_time += acados_toc(&cond_timer);
+    }
+
+    // solve qp
+    solver_status = qp_solver->evaluate(qp_solver, memory->xcond_qp_in, memory->xcond_qp_out,
+                                opts->qp_solver_opts, memory->solver_memory, work->qp_solver_work);
+
+    // expansion
+    acados_tic(&cond_timer);
+    xcond->expansion(memory->xcond_qp_out, qp_out, memory->xcond_opts, memory->xcond_memory, work->xcond_work);
+    info->condensing_time += acados_toc(&cond_timer);
+
+    // output qp info
+    qp_info *info_mem;
+    xcond->memory_get(xcond, memory->xcond_memory, "qp_out_info", &info_mem);
+
+    info->solve_QP_time = info_mem->solve_QP_time;
+    info->interface_time = info_mem->interface_time;
+    info->num_iter = info_mem->num_iter;
+    info->t_computed = info_mem->t_computed;
+
+    return solver_status;
+}
+
+
+
+// true if the matrices of qp_in have to be condensed, i.e. the last condensing of the matrices
+// was of another qp_in or they were written since
+static bool ocp_qp_xcond_solver_lhs_changed(ocp_qp_xcond_solver_memory *mem, ocp_qp_in *qp_in)
+{
+    return qp_in != mem->lhs_qp_in ||
+           ocp_qp_in_changed(qp_in, OCP_QP_IN_MAT, mem->lhs_generation);
+}
+
+
+
 int ocp_qp_xcond_solver(void *config_, ocp_qp_xcond_solver_dims *dims, ocp_qp_in *qp_in, ocp_qp_out *qp_out,
                                      void *opts_, void *mem_, void *work_)
 {
     ocp_qp_xcond_solver_config *config = config_;
-    qp_solver_config *qp_solver = config->qp_solver;
     ocp_qp_xcond_config *xcond = config->xcond;
 
     qp_info *info = (qp_info *) qp_out->misc;
@@ -453,34 +916,117 @@ int ocp_qp_xcond_solver(void *config_, ocp_qp_xcond_solver_dims *dims, ocp_qp_in
     ocp_qp_xcond_solver_memory *memory = mem_;
     ocp_qp_xcond_solver_workspace *work = work_;
 
+    // candidate horizon of cond_N_auto
+    ocp_qp_xcond_solver_N2_auto_prepare(config, opts, memory);
+
     // cast workspace
     cast_workspace(config_, dims, opts, memory, work);
 
     int solver_status = ACADOS_SUCCESS;
 
-    // condensing
+    // condensing, of the rhs only if the matrices did not change since the last call
     acados_tic(&cond_timer);
-    xcond->condensing(qp_in, memory->xcond_qp_in, opts->xcond_opts, memory->xcond_memory, work->xcond_work);
+    if (!ocp_qp_xcond_solver_lhs_changed(memory, qp_in))
+    {
+        xcond->condensing_rhs(qp_in, memory->xcond_qp_in, memory->xcond_opts, memory->xcond_memory,
+                              work->xcond_work);
+    }
+    else
+    {
+        xcond->condensing(qp_in, memory->xcond_qp_in, memory->xcond_opts, memory->xcond_memory,
+                          work->xcond_work);
+        memory->lhs_qp_in = qp_in;
+    }
+    memory->lhs_generation = ocp_qp_in_generation(qp_in);
     info->condensing_time = acados_toc(&cond_timer);
 
-    // solve qp
-    solver_status = qp_solver->evaluate(qp_solver, memory->xcond_qp_in, memory->xcond_qp_out,
-                                opts->qp_solver_opts, memory->solver_memory, work->qp_solver_work);
+    // solve qp and expand solution
+    solver_status = ocp_qp_xcond_solver_solve_and_expand(config, qp_out, opts, memory, work);
 
-    // expansion
+    info->total_time = acados_toc(&tot_timer);
+
+    ocp_qp_xcond_solver_N2_auto_record(memory, info->total_time);
+
+    return solver_status;
+}
+
+
+
+int ocp_qp_xcond_solver_condense_lhs(void *config_, ocp_qp_xcond_solver_dims *dims, ocp_qp_in *qp_in,
+                                     void *opts_, void *mem_, void *work_)
+{
+    ocp_qp_xcond_solver_config *config = config_;
+    ocp_qp_xcond_config *xcond = config->xcond;
+
+    // cast data structures
+    ocp_qp_xcond_solver_opts *opts = opts_;
+    ocp_qp_xcond_solver_memory *memory = mem_;
+    ocp_qp_xcond_solver_workspace *work = work_;
+
+    // candidate horizon of cond_N_auto, timed in condense_rhs_and_solve
+    ocp_qp_xcond_solver_N2_auto_prepare(config, opts, memory);
+
+    // cast workspace
+    cast_workspace(config_, dims, opts, memory, work);
+
+    // condensing of matrices (the rhs is condensed as well, and overwritten later)
+    int status = xcond->condensing(qp_in, memory->xcond_qp_in, memory->xcond_opts,
+                                   memory->xcond_memory, work->xcond_work);
+    memory->lhs_qp_in = qp_in;
+    memory->lhs_generation = ocp_qp_in_generation(qp_in);
+
+    return status;
+}
+
+
+
+int ocp_qp_xcond_solver_condense_rhs_and_solve(void *config_, ocp_qp_xcond_solver_dims *dims,
+                                               ocp_qp_in *qp_in, ocp_qp_out *qp_out, void *opts_,
+                                               void *mem_, void *work_)
+{
+    ocp_qp_xcond_solver_config *config = config_;
+    ocp_qp_xcond_config *xcond = config->xcond;
+
+    qp_info *info = (qp_info *) qp_out->misc;
+    acados_timer tot_timer, cond_timer;
+    acados_tic(&tot_timer);
+
+    // cast data structures
+    ocp_qp_xcond_solver_opts *opts = opts_;
+    ocp_qp_xcond_solver_memory *memory = mem_;
+    ocp_qp_xcond_solver_workspace *work = work_;
+
+    // horizon of cond_N_auto, already set if condense_lhs was called before
+    ocp_qp_xcond_solver_N2_auto_prepare(config, opts, memory);
+
+    // cast workspace
+    cast_workspace(config_, dims, opts, memory, work);
+
+    int solver_status = ACADOS_SUCCESS;
+
+    // condensing of rhs only, matrices are the ones of the last condense_lhs call;
+    // matrices changed in between fall back to a full condensing
     acados_tic(&cond_timer);
-    xcond->expansion(memory->xcond_qp_out, qp_out, opts->xcond_opts, memory->xcond_memory, work->xcond_work);
-    info->condensing_time += acados_toc(&cond_timer);
+    if (!ocp_qp_xcond_solver_lhs_changed(memory, qp_in))
+    {
+        xcond->condensing_rhs(qp_in, memory->xcond_qp_in, memory->xcond_opts, memory->xcond_memory,
+                              work->xcond_work);
+    }
+    else
+    {
+        xcond->condensing(qp_in, memory->xcond_qp_in, memory->xcond_opts, memory->xcond_memory,
+                          work->xcond_work);
+        memory->lhs_qp_in = qp_in;
+    }
+    memory->lhs_generation = ocp_qp_in_generation(qp_in);
+    info->condensing_time = acados_toc(&cond_timer);
 
-    // output qp info
-    qp_info *info_mem;
-    xcond->memory_get(xcond, memory->xcond_memory, "qp_out_info", &info_mem);
+    // solve qp and expand solution
+    solver_status = ocp_qp_xcond_solver_solve_and_expand(config, qp_out, opts, memory, work);
 
     info->total_time = acados_toc(&tot_timer);
-    info->solve_QP_time = info_mem->solve_QP_time;
-    info->interface_time = info_mem->interface_time;
-    info->num_iter = info_mem->num_iter;
-    info->t_computed = info_mem->t_computed;
+
+    ocp_qp_xcond_solver_N2_auto_record(memory, info->total_time);
 
     return solver_status;
 }
@@ -509,7 +1055,7 @@ void ocp_qp_xcond_solver_eval_sens(void *config_, ocp_qp_xcond_solver_dims *dims
 
     // condensing
 //    acados_tic(&cond_timer);
-    xcond->condensing_rhs(param_qp_in, memory->xcond_qp_in, opts->xcond_opts, memory->xcond_memory, work->xcond_work);
+    xcond->condensing_rhs(param_qp_in, memory->xcond_qp_in, memory->xcond_opts, memory->xcond_memory, work->xcond_work);
 //    info->condensing_time = acados_toc(&cond_timer);
 
     // qp evaluate sensitivity
@@ -517,7 +1063,7 @@ void ocp_qp_xcond_solver_eval_sens(void *config_, ocp_qp_xcond_solver_dims *dims
 
     // expansion
 //    acados_tic(&cond_timer);
-    xcond->expansion(memory->xcond_qp_out, sens_qp_out, opts->xcond_opts, memory->xcond_memory, work->xcond_work);
+    xcond->expansion(memory->xcond_qp_out, sens_qp_out, memory->xcond_opts, memory->xcond_memory, work->xcond_work);
 //    info->condensing_time += acados_toc(&cond_timer);
 
     // output qp info
@@ -553,6 +1099,8 @@ void ocp_qp_xcond_solver_config_initialize_default(void *config_)
     config->memory_get = &ocp_qp_xcond_solver_memory_get;
     config->workspace_calculate_size = &ocp_qp_xcond_solver_workspace_calculate_size;
     config->evaluate = &ocp_qp_xcond_solver;
+    config->condense_lhs = &ocp_qp_xcond_solver_condense_lhs;
+    config->condense_rhs_and_solve = &ocp_qp_xcond_solver_condense_rhs_and_solve;
     config->eval_sens = &ocp_qp_xcond_solver_eval_sens;
 
     return;
@@ -45,6 +45,15 @@ extern "C" {
 
 
 
+// automatic selection of the partial condensing horizon (cond_N_auto):
+// number of candidates preselected by a flop model, timed solves per candidate
+#define OCP_QP_XCOND_N2_AUTO_CAND 4
+#define OCP_QP_XCOND_N2_AUTO_REPS 2
+// ipm iterations assumed by the flop model
+#define OCP_QP_XCOND_N2_AUTO_ITER 10
+
+
+
 typedef struct
 {
     ocp_qp_dims *orig_dims;
@@ -57,6 +66,20 @@ typedef struct ocp_qp_xcond_solver_opts_
 {
     void *xcond_opts;
     void *qp_solver_opts;
+    int cond_N;  // partial condensing horizon, mirrors the one of the condensing module
+    // select cond_N on-line; each memory switches the horizon on its own copy of the
+    // xcond dims and opts, so the dims and opts can be shared by several memories
+    int cond_N_auto;
+    // sizes maximized over the cond_N_auto candidates, computed once after any opts change
+    int N2_auto_sizes_valid;
+    int N2_auto_xcond_mem_size;
+    int N2_auto_solver_mem_size;
+    int N2_auto_work_size;
+    int N2_auto_xcond_opts_size;
+    // start the qp solver from the active set of the qp_out passed to the solver (e.g. the
+    // solution of a previous iteration, or of another qp solver), mapped to the xcond qp;
+    // only qpOASES and qpDUNES use it, it is ignored for the other qp solvers
+    int guess_active_set;
 } ocp_qp_xcond_solver_opts;
 
 
@@ -65,8 +88,18 @@ typedef struct ocp_qp_xcond_solver_memory_
 {
     void *xcond_memory;
     void *solver_memory;
+    void *xcond_dims;  // dims and opts of the condensing module used by this memory,
+    void *xcond_opts;  // own copies if cond_N_auto, the ones of dims and opts otherwise
     void *xcond_qp_in;
     void *xcond_qp_out;
+    ocp_qp_in *lhs_qp_in;  // qp_in of the last condensing of the matrices
+    long long lhs_generation;  // generation of lhs_qp_in read by the last condensing
+    int cond_N;  // current partial condensing horizon
+    // cond_N_auto
+    int N2_auto_num;   // number of candidates, 0 if cond_N is fixed
+    int N2_auto_iter;  // number of timed solves, the horizon is locked after all of them
+    int N2_auto_cand[OCP_QP_XCOND_N2_AUTO_CAND];
+    double N2_auto_time[OCP_QP_XCOND_N2_AUTO_CAND];  // fastest solve per candidate
 } ocp_qp_xcond_solver_memory;
 
 
@@ -94,6 +127,8 @@ typedef struct
     void (*memory_get)(void *config_, void *mem_, const char *field, void* value);
     int (*workspace_calculate_size)(void *config, ocp_qp_xcond_solver_dims *dims, void *opts);
     int (*evaluate)(void *config, ocp_qp_xcond_solver_dims *dims, ocp_qp_in *qp_in, ocp_qp_out *qp_out, void *opts, void *mem, void *work);
+    int (*condense_lhs)(void *config, ocp_qp_xcond_solver_dims *dims, ocp_qp_in *qp_in, void *opts, void *mem, void *work);
+    int (*condense_rhs_and_solve)(void *config, ocp_qp_xcond_solver_dims *dims, ocp_qp_in *qp_in, ocp_qp_out *qp_out, void *opts, void *mem, void *work);
     void (*eval_sens)(void *config, ocp_qp_xcond_solver_dims *dims, ocp_qp_in *param_qp_in, ocp_qp_out *sens_qp_out, void *opts, void *mem, void *work);
     qp_solver_config *qp_solver;  // either ocp_qp_solver or dense_solver
     ocp_qp_xcond_config *xcond;
@@ -140,6 +175,10 @@ int ocp_qp_xcond_solver_workspace_calculate_size(void *config, ocp_qp_xcond_solv
 /* config */
 //
 int ocp_qp_xcond_solver(void *config, ocp_qp_xcond_solver_dims *dims, ocp_qp_in *qp_in, ocp_qp_out *qp_out, void *opts_, void *mem_, void *work_);
+// condense Hessian, dynamics and constraint matrices (and rhs) only, no solve
+int ocp_qp_xcond_solver_condense_lhs(void *config, ocp_qp_xcond_solver_dims *dims, ocp_qp_in *qp_in, void *opts_, void *mem_, void *work_);
+// condense rhs on top of the matrices from condense_lhs, solve and expand
+int ocp_qp_xcond_solver_condense_rhs_and_solve(void *config, ocp_qp_xcond_solver_dims *dims, ocp_qp_in *qp_in, ocp_qp_out *qp_out, void *opts_, void *mem_, void *work_);
 
 //
 void ocp_qp_xcond_solver_config_initialize_default(void *config_);
@@ -44,6 +44,7 @@
 #include "blasfeo/include/blasfeo_d_kernel.h"
 #include "blasfeo/include/blasfeo_i_aux_ext_dep.h"
 
+#include "acados/utils/mem.h"
 #include "acados/utils/print.h"
 
 #ifndef M_PI
@@ -248,11 +249,419 @@ void gauss_nodes(int ns, double *nodes, void *work)
 
 
 
+// Real block diagonalization of the inverse Gauss-Legendre Butcher matrix (nodes ordered as in
+// gauss_nodes), T^{-1} * A^{-1} * T = D, for ns = 2, ..., GAUSS_SIMPLIFIED_NS_MAX.
+// D (ns x 2, column-major): row pairs (i, i+1) hold the 2x2 block of a complex conjugate
+// eigenvalue pair, for odd ns the last row holds the real eigenvalue in its first column.
+// T (ns x ns, column-major): real and imaginary parts of the corresponding eigenvectors.
+static const double gauss_simplified_D_2[] = {
+    2.9999999999999996e+00, -1.7320508075688772e+00, 1.7320508075688772e+00,
+    2.9999999999999996e+00
+};
+
+static const double gauss_simplified_T_2[] = {
+    9.6592582628906842e-01, -6.6359915501009627e-17, 0.0000000000000000e+00,
+    -2.5881904510252079e-01
+};
+
+static const double gauss_simplified_D_3[] = {
+    3.6778146453739247e+00, -3.5087619195674487e+00, 4.6443707092521676e+00,
+    3.5087619195674487e+00, 3.6778146453739247e+00, 0.0000000000000000e+00
+};
+
+static const double gauss_simplified_T_3[] = {
+    -9.4780144954483625e-01, -5.0295169925554134e-02, 7.7948357550038094e-02,
+    0.0000000000000000e+00, 2.9969960581658434e-01, -5.6982523211086947e-02,
+    9.9047432157564597e-01, 1.1770061780985283e-01, 7.1464556714800287e-02
+};
+
+static const double gauss_simplified_D_4[] = {
+    4.2075787943592218e+00, -5.3148360837135682e+00, 5.7924212056407534e+00,
+    -1.7344682578688573e+00, 5.3148360837135682e+00, 4.2075787943592218e+00,
+    1.7344682578688573e+00, 5.7924212056407534e+00
+};
+
+static const double gauss_simplified_T_4[] = {
+    9.2755121578442024e-01, 8.9973980766129363e-02, -1.1347923253170784e-01,
+    4.5676938944744824e-02, 0.0000000000000000e+00, -3.3944980848817574e-01,
+    3.6496686603583427e-02, 5.5969008293203868e-03, 9.7688646208845364e-01,
+    1.7926761499828683e-01, 2.7865866968752602e-02, -1.2056498009687994e-02,
+    0.0000000000000000e+00, -1.0940228267310095e-01, -1.1762625061477404e-02,
+    -2.2953821305620972e-02
+};
+
+static const double gauss_simplified_D_5[] = {
+    4.6493486063632918e+00, -7.1420458406761096e+00, 6.7039127983069431e+00,
+    -3.4853228323661725e+00, 7.2934771906594484e+00, 7.1420458406761096e+00,
+    4.6493486063632918e+00, 3.4853228323661725e+00, 6.7039127983069431e+00,
+    0.0000000000000000e+00
+};
+
+static const double gauss_simplified_T_5[] = {
+    9.0411743519846155e-01, 1.3001130604337371e-01, -1.4426917672856002e-01,
+    4.9645019802481961e-02, -1.7761143010428849e-02, 0.0000000000000000e+00,
+    -3.7516554615897674e-01, 1.1719339710664150e-02, 2.9204111659184805e-02,
+    -1.8320263073173172e-02, 9.5735008970684399e-01, 2.2355134850458269e-01,
+    -7.6582332554709395e-04, -5.7681622599773828e-03, -4.6086692807295335e-03,
+    0.0000000000000000e+00, -1.7841467946953624e-01, -3.5728186480685452e-02,
+    -1.5214920129763956e-02, 1.0521756143668244e-02, 9.6857461611736728e-01,
+    2.4484872919812409e-01, 4.2697767969383175e-02, -2.7678875562257808e-03,
+    9.0306274459175748e-03
+};
+
+static const double gauss_simplified_D_6[] = {
+    5.0318644956231697e+00, -8.9853459073092949e+00, 7.4714167126486739e+00,
+    -5.2525446228892765e+00, 8.4967187917271758e+00, -1.7350193464772943e+00,
+    8.9853459073092949e+00, 5.0318644956231697e+00, 5.2525446228892765e+00,
+    7.4714167126486739e+00, 1.7350193464772943e+00, 8.4967187917271758e+00
+};
+
+static const double gauss_simplified_T_6[] = {
+    8.7808321708605108e-01, 1.7174076768258004e-01, -1.7285671470878081e-01,
+    4.5557282850813216e-02, -9.6857867134837114e-03, 1.9576377675118153e-03,
+    0.0000000000000000e+00, -4.0377104892106513e-01, -1.9069352853084826e-02,
+    5.3353030317658423e-02, -3.0662337246238010e-02, 1.5523884904491846e-02,
+    9.3555909275336069e-01, 2.6160744979570577e-01, -2.1776505510137125e-02,
+    -7.6298439875653557e-03, -6.0493347690819075e-03, 5.4656523812362558e-03,
+    0.0000000000000000e+00, -2.2709825698006320e-01, -6.3546793662303272e-02,
+    -5.5741760896124990e-03, 6.6963839946151136e-03, -2.0251798596873515e-03,
+    -9.5290824432258980e-01, -2.8978071413392414e-01, -4.3552536808886155e-02,
+    -8.8079797671061257e-04, -2.8029695104241927e-03, 2.2458329838366277e-03,
+    0.0000000000000000e+00, 7.3038588927541351e-02, 2.5902104391501039e-02,
+    8.0762161273007990e-03, -1.6020585539541729e-03, 3.0281353437578078e-03
+};
+
+static const double gauss_simplified_D_7[] = {
+    5.3713537578876096e+00, -1.0841388261432224e+01, 8.1402783272844630e+00,
+    -7.0343480954312403e+00, 9.5165810562800210e+00, -3.4785721222551111e+00,
+    9.9435737170944289e+00, 1.0841388261432224e+01, 5.3713537578876096e+00,
+    7.0343480954312403e+00, 8.1402783272844630e+00, 3.4785721222551111e+00,
+    9.5165810562800210e+00, 0.0000000000000000e+00
+};
+
+static const double gauss_simplified_T_7[] = {
+    -8.5035232043588049e-01, -2.1450814053661496e-01, 1.9735124680638266e-01,
+    -3.4525786839946324e-02, -3.7480270774970146e-03, 7.2456359325201647e-03,
+    -4.9583105855061016e-03, 0.0000000000000000e+00, 4.2359825665884765e-01,
+    5.6667545179045979e-02, -7.8082400186207129e-02, 3.8607888395597902e-02,
+    -1.8461670570721598e-02, 9.0307885858180396e-03, 9.1265021040563343e-01,
+    2.9646814693794837e-01, -3.7257049634525086e-02, -1.4836403119515500e-02,
+    -4.0010474121755834e-03, 5.1932873031154004e-03, -3.0042076223673322e-03,
+    0.0000000000000000e+00, -2.6195033155582120e-01, -9.4173302982180893e-02,
+    3.0532524084083915e-03, 4.2899287529169485e-03, 3.5806307043106028e-04,
+    -1.2568098411682735e-03, 9.3458122311122016e-01, 3.2554787900384219e-01,
+    4.1269009800451721e-02, -9.5750612141811580e-04, -9.4442722610532355e-04,
+    -2.6136489066373248e-04, -3.7222800640570127e-04, 0.0000000000000000e+00,
+    -1.2513074581231315e-01, -5.5313477792228664e-02, -1.2080269976410070e-02,
+    9.1133366716706233e-04, -2.0653078214020217e-03, 1.7480751994739369e-03,
+    9.4055978178044097e-01, 3.3334883004868687e-01, 6.4554598012522474e-02,
+    6.8848385937857201e-03, 2.6598298604616926e-03, -1.3756710316336618e-03,
+    1.4799018907661063e-03
+};
+
+static const double gauss_simplified_D_8[] = {
+    5.6779678978367674e+00, -1.2707822597247784e+01, 8.7365784339057306e+00,
+    -8.8288850008925976e+00, 1.0409681582375107e+01, -5.2323503048572375e+00,
+    1.1175772085918894e+01, -1.7352288916565461e+00, 1.2707822597247784e+01,
+    5.6779678978367674e+00, 8.8288850008925976e+00, 8.7365784339057306e+00,
+    5.2323503048572375e+00, 1.0409681582375107e+01, 1.7352288916565461e+00,
+    1.1175772085918894e+01
+};
+
+static const double gauss_simplified_T_8[] = {
+    8.2193585582411233e-01, 2.5695191289628649e-01, -2.1531057258483430e-01,
+    1.5720097174868292e-02, 2.0911795842842178e-02, -1.7389482320966636e-02,
+    1.1236032025475818e-02, -6.4405756745805273e-03, 0.0000000000000000e+00,
+    -4.3397322144122358e-01, -1.0045115052637008e-01, 1.0192116246093680e-01,
+    -4.1952919437378396e-02, 1.6030277877054053e-02, -6.7973400339616007e-03,
+    3.1044321477736946e-03, -8.8931582451607150e-01, -3.2882588278748548e-01,
+    4.7412923022494252e-02, 2.6310018504678262e-02, 5.2667515379907872e-04,
+    -3.7687869141313324e-03, 2.0093487142945608e-03, -8.5879141228368974e-04,
+    0.0000000000000000e+00, 2.8603256021290585e-01, 1.2685013315140561e-01,
+    -9.8324966248575178e-03, -4.3205079373658485e-03, -1.2389189547245235e-03,
+    2.4296418392114397e-03, -1.7549768582465566e-03, -9.1512355767925158e-01,
+    -3.5608185529462405e-01, -3.9264932617492761e-02, 6.4813850227712173e-03,
+    3.0337745103532049e-03, -4.4445395875414512e-04, 8.3666729513345644e-04,
+    -7.8577242811880854e-04, 0.0000000000000000e+00, 1.6304756704893719e-01,
+    8.5681802522811726e-02, 1.5247456534805637e-02, -5.4819094479204033e-04,
+    6.2355066960449333e-04, -9.0665413105449160e-04, 4.9775715568057925e-04,
+    9.2522599677736594e-01, 3.6647984402997824e-01, 7.6251584480502163e-02,
+    8.8743434172925319e-03, 1.3922869826198865e-03, -4.8940907885001062e-04,
+    5.3987606222104245e-04, -4.2882093245944554e-04, 0.0000000000000000e+00,
+    -5.3056290502956398e-02, -2.9542231221371132e-02, -8.0170353162528803e-03,
+    -7.9721274818788843e-04, -7.4326683631171760e-04, 4.9296710287674225e-04,
+    -5.0010930894975661e-04
+};
+
+static const double gauss_simplified_D_9[] = {
+    5.9585215966711083e+00, -1.4582927377244966e+01, 9.2768797702648644e+00,
+    -1.0634543347748068e+01, 1.1208843659694733e+01, -6.9963138450570330e+00,
+    1.2258735757003109e+01, -3.4756967561812870e+00, 1.2594038432460025e+01,
+    1.4582927377244966e+01, 5.9585215966711083e+00, 1.0634543347748068e+01,
+    9.2768797702648644e+00, 6.9963138450570330e+00, 1.1208843659694733e+01,
+    3.4756967561812870e+00, 1.2258735757003109e+01, 0.0000000000000000e+00
+};
+
+static const double gauss_simplified_T_9[] = {
+    -7.9384250663601219e-01, -2.9742497850721861e-01, 2.2460684386815194e-01,
+    1.1161682429223682e-02, -4.0671877871012348e-02, 2.6737473182080997e-02,
+    -1.5477002921820037e-02, 9.1220807918937514e-03, -5.0931271451387797e-03,
+    0.0000000000000000e+00, 4.3510819292042968e-01, 1.4868443687827645e-01,
+    -1.2247643742023198e-01, 3.9401916831758248e-02, -8.9676937550279452e-03,
+    8.7349562388396105e-04, 8.6322018398742994e-04, -8.5880328675818902e-04,
+    8.6610261525994126e-01, 3.5859837446935416e-01, -5.2066663574374783e-02,
+    -4.1340124048056759e-02, 3.2916099269817609e-03, 2.5812306611151890e-03,
+    -8.5151233234706189e-04, -1.3357708895478496e-04, 2.9911796416404499e-04,
+    0.0000000000000000e+00, -3.0131979735734976e-01, -1.6058246472476828e-01,
+    1.3932057977604734e-02, 6.9646400088144919e-03, 7.2151287212455779e-04,
+    -2.5088178386964534e-03, 1.9943371519718844e-03, -1.2015346514997927e-03,
+    -8.9529062622024524e-01, -3.8289128779215392e-01, -3.9057525194806250e-02,
+    1.4616104678174636e-02, 4.5033935639012309e-03, -5.7484040554017866e-04,
+    6.2584520647701819e-04, -7.3523837601871501e-04, 5.0968043309344120e-04,
+    0.0000000000000000e+00, 1.9047468187400898e-01, 1.1595785351155380e-01,
+    1.8965580260949778e-02, -1.1115224521292206e-03, -4.7966889823557293e-04,
+    -1.8716206869855815e-04, 4.9557988506226792e-06, 1.0216917939076941e-04,
+    9.0860718434217347e-01, 3.9362136386700247e-01, 8.4251374326292219e-02,
+    7.6262373680541376e-03, -2.2933663796857292e-04, -2.4370348999050843e-04,
+    -2.7042771856001551e-05, -1.3614229048934513e-05, -3.4452339279522420e-05,
+    0.0000000000000000e+00, -9.2459474364991828e-02, -5.9356852445781871e-02,
+    -1.6180507738921521e-02, -1.9991220241953409e-03, -6.5613727299974520e-04,
+    3.8701551541923013e-04, -4.0045363899854532e-04, 3.2014804927610758e-04,
+    -9.1255025964651593e-01, -3.9673481968343782e-01, -9.8017218221753841e-02,
+    -1.5496079709197074e-02, -2.3810107162980602e-03, 6.7074588841508433e-05,
+    -3.8420526509612695e-04, 3.2460930147416666e-04, -2.7607902116190430e-04
+};
+
+
+
+static void gauss_simplified_tables(int ns, const double **D, const double **T)
+{
+    switch (ns)
+    {
+        case 2: *D = gauss_simplified_D_2; *T = gauss_simplified_T_2; break;
+        case 3: *D = gauss_simplified_D_3; *T = gauss_simplified_T_3; break;
+        case 4: *D = gauss_simplified_D_4; *T = gauss_simplified_T_4; break;
+        case 5: *D = gauss_simplified_D_5; *T = gauss_simplified_T_5; break;
+        case 6: *D = gauss_simplified_D_6; *T = gauss_simplified_T_6; break;
+        case 7: *D = gauss_simplified_D_7; *T = gauss_simplified_T_7; break;
+        case 8: *D = gauss_simplified_D_8; *T = gauss_simplified_T_8; break;
+        case 9: *D = gauss_simplified_D_9; *T = gauss_simplified_T_9; break;
+        default:
+            printf("\nerror: gauss_simplified: no transformation available for ns = %d, "
+                   "simplified Newton supports 1 <= ns <= %d\n", ns, GAUSS_SIMPLIFIED_NS_MAX);
+            exit(1);
+    }
+}
+
+
+
+// Same transformation for the inverse Radau IIA Butcher matrix (nodes ordered as in
+// gauss_radau_iia_nodes), for ns = 2, ..., GAUSS_SIMPLIFIED_NS_MAX.
+static const double radau_simplified_D_2[] = {
+    2.0000000000000000e+00, -1.4142135623730954e+00, 1.4142135623730954e+00,
+    2.0000000000000000e+00
+};
+
+static const double radau_simplified_T_2[] = {
+    1.0540925533894602e-01, 9.4868329805051377e-01, -2.9814239699997197e-01,
+    0.0000000000000000e+00
+};
+
+static const double radau_simplified_D_3[] = {
+    2.6810828736277488e+00, -3.0504301992474088e+00, 3.6378342527444985e+00,
+    3.0504301992474088e+00, 2.6810828736277488e+00, 0.0000000000000000e+00
+};
+
+static const double radau_simplified_T_3[] = {
+    -1.2845806217830075e-01, 1.8563595103095720e-01, 9.0940351764686189e-01,
+    2.7308654751321371e-02, -3.4824890439657508e-01, 0.0000000000000000e+00,
+    9.1232394870892991e-02, 2.4171793270710656e-01, 9.6604818261509307e-01
+};
+
+static const double radau_simplified_D_4[] = {
+    4.7871931031284767e+00, -1.5674764168952156e+00, 3.2128068968715398e+00,
+    -4.7730874332766424e+00, 1.5674764168952156e+00, 4.7871931031284767e+00,
+    4.7730874332766424e+00, 3.2128068968715398e+00
+};
+
+static const double radau_simplified_T_4[] = {
+    -1.1063268554736914e-02, 4.3521415936429907e-02, 3.1632861438586690e-01,
+    9.3908523433465763e-01, -3.3290881388152990e-02, -3.0245407010078527e-02,
+    -1.1838730248767132e-01, 0.0000000000000000e+00, 5.6065097932870636e-02,
+    -1.6981361104118331e-01, 2.5436928992926638e-01, 8.7083001076563060e-01,
+    3.9375655283654123e-02, -2.5736324388210035e-02, -3.7783408841409655e-01,
+    0.0000000000000000e+00
+};
+
+static const double radau_simplified_D_5[] = {
+    5.7009532986717311e+00, -3.2102656003085657e+00, 3.6556943254635823e+00,
+    -6.5437368993601099e+00, 6.2867047517291414e+00, 3.2102656003085657e+00,
+    5.7009532986717311e+00, 6.5437368993601099e+00, 3.6556943254635823e+00,
+    0.0000000000000000e+00
+};
+
+static const double radau_simplified_T_5[] = {
+    -1.0417478092524787e-02, -6.9599486125605289e-03, 1.7605332156909442e-02,
+    3.6992382532788659e-01, 9.0756320489960884e-01, 1.2723908069060035e-02,
+    -2.2424596625285981e-02, -7.4238991169297816e-02, -1.8122442421508528e-01,
+    0.0000000000000000e+00, -8.5405461731292622e-03, 4.1837694342677381e-02,
+    -1.9224022092404525e-01, 3.1511474834719289e-01, 8.3387095285723112e-01,
+    -3.9753861482457291e-02, 7.8660563945725598e-02, -8.5641086312462866e-02,
+    -3.8920437270087505e-01, 0.0000000000000000e+00, 1.2517586220502381e-02,
+    1.4916701518943416e-03, 7.2981876388094363e-02, 3.8009144000356676e-01,
+    9.2197897368121051e-01
+};
+
+static const double radau_simplified_D_6[] = {
+    7.4906375288092830e+00, -1.6215023887786240e+00, 6.4705149367010932e+00,
+    -4.9001211474215651e+00, 4.0388475344886015e+00, -8.3456004148725640e+00,
+    1.6215023887786240e+00, 7.4906375288092830e+00, 4.9001211474215651e+00,
+    6.4705149367010932e+00, 8.3456004148725640e+00, 4.0388475344886015e+00
+};
+
+static const double radau_simplified_T_6[] = {
+    -2.6822618239802300e-03, 3.3838850017796087e-03, 5.9335348406102974e-03,
+    8.2336270666179920e-02, 4.2332247591619149e-01, 8.9846302357206576e-01,
+    -4.6871932154262871e-03, 1.3836337671124964e-03, -1.3215784092156634e-02,
+    -4.1649350484387587e-02, -6.9252823633610350e-02, 0.0000000000000000e+00,
+    8.7551581138290199e-03, -1.1045427077698513e-02, -1.5781441378558643e-02,
+    5.7346894993975731e-03, 4.1225611545097568e-01, 8.7659829231933917e-01,
+    4.7348750333259963e-05, 7.2171522645990190e-03, -1.2084186528362790e-02,
+    -1.1975174130013322e-01, -2.1587296665016423e-01, 0.0000000000000000e+00,
+    -1.2506270011345686e-02, 1.6279849345437587e-02, 1.1355695409536756e-02,
+    -1.9914375602472331e-01, 3.6664107772971222e-01, 7.9954072707860224e-01,
+    2.3026784169826297e-02, -4.9841756182231599e-02, 1.0842532751317729e-01,
+    -1.4853938656776750e-01, -3.8634943217356793e-01, 0.0000000000000000e+00
+};
+
+static const double radau_simplified_D_7[] = {
+    8.5118348251027403e+00, -3.2810136243246308e+00, 7.1410552191883498e+00,
+    -6.6230459226382745e+00, 4.3786935615084168e+00, -1.0169693283794281e+01,
+    8.9368327884047094e+00, 3.2810136243246308e+00, 8.5118348251027403e+00,
+    6.6230459226382745e+00, 7.1410552191883498e+00, 1.0169693283794281e+01,
+    4.3786935615084168e+00, 0.0000000000000000e+00
+};
+
+static const double radau_simplified_T_7[] = {
+    -1.0827586894974150e-03, -5.8276184222636605e-05, -2.0561516463077334e-03,
+    2.7230297008279700e-03, 8.8916237576077348e-02, 4.5608783040991685e-01,
+    8.7414687101864208e-01, 2.4131851326969454e-03, -2.7845728511278573e-03,
+    -3.6443862485872598e-04, -2.1955601595690120e-02, -8.3083307150142741e-02,
+    -1.1195368966843802e-01, 0.0000000000000000e+00, -3.4367406766326663e-03,
+    7.1321761545195530e-03, -7.2549470556904977e-03, -3.1672048096424099e-02,
+    4.5483188155930471e-03, 4.4627053314933779e-01, 8.4749786587673959e-01,
+    -3.7520703101368118e-03, 3.4170686560928915e-03, 5.8674079586128374e-03,
+    -6.9825411024111127e-03, -1.6374600855947852e-01, -2.3351481172931218e-01,
+    0.0000000000000000e+00, 1.6570026657609472e-02, -2.9295974113778149e-02,
+    4.4096878115069779e-02, -2.9359776698830650e-02, -1.9143681522663936e-01,
+    4.0840852364776326e-01, 7.6828502168312562e-01, -6.7482836738111396e-03,
+    1.6537765787686814e-02, -4.5213980108934571e-02, 1.2733310964253985e-01,
+    -2.1017459032734567e-01, -3.7363455107564281e-01, 0.0000000000000000e+00,
+    2.1537546273132043e-03, -1.6000250778836205e-03, 4.0591073019518274e-03,
+    1.5750488079382029e-02, 1.1297766102430382e-01, 4.5838104318399236e-01,
+    8.8139157835377591e-01
+};
+
+static const double radau_simplified_D_8[] = {
+    1.0169446006640758e+01, -1.6492017968478081e+00, 9.4063712136683204e+00,
+    -4.9692172876436906e+00, 7.7386881468207864e+00, -8.3708793062423652e+00,
+    4.6854946328165390e+00, -1.2010578599816188e+01, 1.6492017968478081e+00,
+    1.0169446006640758e+01, 4.9692172876436906e+00, 9.4063712136683204e+00,
+    8.3708793062423652e+00, 7.7386881468207864e+00, 1.2010578599816188e+01,
+    4.6854946328165390e+00
+};
+
+static const double radau_simplified_T_8[] = {
+    -5.6334749645858503e-04, 6.7386189955450921e-04, -4.3636361501710137e-04,
+    2.5581578722405555e-03, 1.9575712428293635e-02, 1.3213286723986176e-01,
+    4.8441977127270269e-01, 8.6234772539990656e-01, -8.0018703815166743e-04,
+    6.8987810474415118e-04, -1.1472008954415043e-03, -2.0333797765416843e-03,
+    -1.3561694626041244e-02, -4.0099737174366136e-02, -4.5228322139489047e-02,
+    2.9835902447653650e-18, 1.3645097294177643e-03, -1.4685211242186054e-03,
+    4.2757831854743422e-04, -5.4539364541888432e-03, -4.8340557191963495e-03,
+    9.7059262314628844e-02, 4.8182594168487175e-01, 8.5058024159345114e-01,
+    -3.8538262152746408e-04, 9.9303901478839472e-04, -4.2409065652175706e-04,
+    -1.3074701435538013e-03, -3.0876361159459364e-02, -1.2153210684052999e-01,
+    -1.3839354283542127e-01, 0.0000000000000000e+00, -1.2646582531595737e-04,
+    -1.1213451376270000e-03, 4.8070811851101810e-03, -3.3923159313573341e-03,
+    -5.1344212877391021e-02, 1.1945867668702179e-02, 4.7335402816690120e-01,
+    8.2061602198122885e-01, 3.1499330961881847e-03, -4.8349424631706859e-03,
+    3.6975104335843496e-03, 9.1939963662603357e-03, -8.1113984705304867e-03,
+    -2.0436914042513393e-01, -2.4030490433429816e-01, 0.0000000000000000e+00,
+    -1.2242419939005813e-02, 2.2532835572287701e-02, -3.9885172033932222e-02,
+    6.9506845934734968e-02, -7.6176384855144191e-02, -1.7103847517799611e-01,
+    4.4077088204597764e-01, 7.4012968160397730e-01, -3.5807480831500302e-03,
+    4.3636812065950600e-03, 4.3628137782591558e-04, -2.8542341157799904e-02,
+    1.3356612349182795e-01, -2.6676199041111298e-01, -3.5488570036010392e-01,
+    0.0000000000000000e+00
+};
+
+static const double radau_simplified_D_9[] = {
+    1.1253269857426924e+01, -3.3213405313329951e+00, 1.0206883220764995e+01,
+    -6.6801407237435040e+00, 8.2800422005100458e+00, -1.0138359661117891e+01,
+    4.9661292606946663e+00, -1.3864685978964248e+01, 1.1587350921310566e+01,
+    3.3213405313329951e+00, 1.1253269857426924e+01, 6.6801407237435040e+00,
+    1.0206883220764995e+01, 1.0138359661117891e+01, 8.2800422005100458e+00,
+    1.3864685978964248e+01, 4.9661292606946663e+00, 0.0000000000000000e+00
+};
+
+static const double radau_simplified_T_9[] = {
+    -1.3600273849438622e-04, 6.1478587345462288e-05, -1.5750936010824442e-04,
+    -3.2280376751324977e-04, 2.7890306791161638e-04, 1.9398771933305206e-02,
+    1.4734156504396265e-01, 5.0465647737075192e-01, 8.4316034238721660e-01,
+    4.6918538346777468e-04, -5.6317514430126849e-04, 4.6360069136323450e-04,
+    -1.0794627784212623e-03, -4.6651538772656490e-03, -2.7529673491263937e-02,
+    -7.6436581375254081e-02, -7.5447224164368845e-02, 0.0000000000000000e+00,
+    -6.9211899838168270e-04, 1.0517793126791943e-03, -8.1409337225736892e-04,
+    1.5757684546673255e-04, -8.6181947512484255e-03, -1.4492565367139955e-02,
+    1.0783026270311070e-01, 5.0216632141835482e-01, 8.2828056215703072e-01,
+    -4.2718835330121609e-04, 3.4007783594476246e-04, 5.6503486647630130e-05,
+    1.2828367281168976e-03, -9.0201070245956910e-04, -4.1635526049626011e-02,
+    -1.5601429295627656e-01, -1.5423881673510112e-01, 0.0000000000000000e+00,
+    1.4612454395651717e-03, -1.8192758324276305e-03, 5.5067459152840917e-04,
+    4.0676588610048907e-03, -1.6227208812107056e-03, -7.2325591634722741e-02,
+    2.6053450814116641e-02, 4.9450655354237932e-01, 7.9595827445352263e-01,
+    -1.4396394296127802e-03, 2.6836832791701597e-03, -4.1056679075033792e-03,
+    2.1928467695546449e-03, 1.6267875715700934e-02, -1.5648392927594759e-02,
+    -2.4036629017565472e-01, -2.4013034746389961e-01, 0.0000000000000000e+00,
+    5.5104053956150558e-03, -1.0518736713069939e-02, 2.0134375533653499e-02,
+    -4.2127826933011640e-02, 8.8629609225246195e-02, -1.2480727108459620e-01,
+    -1.4070908965734749e-01, 4.6469430139150808e-01, 7.1486760316133413e-01,
+    7.6224388115147127e-03, -1.2567751090531234e-02, 1.7797097010745486e-02,
+    -2.0365237476799310e-02, -1.8019984705226633e-03, 1.2635603660562170e-01,
+    -3.1557692327415299e-01, -3.3311534231670908e-01, 0.0000000000000000e+00,
+    4.1474742959639424e-04, -4.4633936218189756e-04, 5.2948444800800004e-04,
+    2.1029455574891583e-04, 4.6685838369412373e-03, 3.0296458425868467e-02,
+    1.5926449224612726e-01, 5.0525703619864304e-01, 8.4759057451184305e-01
+};
+
+
+
+static void radau_simplified_tables(int ns, const double **D, const double **T)
+{
+    switch (ns)
+    {
+        case 2: *D = radau_simplified_D_2; *T = radau_simplified_T_2; break;
+        case 3: *D = radau_simplified_D_3; *T = radau_simplified_T_3; break;
+        case 4: *D = radau_simplified_D_4; *T = radau_simplified_T_4; break;
+        case 5: *D = radau_simplified_D_5; *T = radau_simplified_T_5; break;
+        case 6: *D = radau_simplified_D_6; *T = radau_simplified_T_6; break;
+        case 7: *D = radau_simplified_D_7; *T = radau_simplified_T_7; break;
+        case 8: *D = radau_simplified_D_8; *T = radau_simplified_T_8; break;
+        case 9: *D = radau_simplified_D_9; *T = radau_simplified_T_9; break;
+        default:
+            printf("\nerror: gauss_simplified: no transformation available for ns = %d, "
+                   "simplified Newton supports 1 <= ns <= %d\n", ns, GAUSS_SIMPLIFIED_NS_MAX);
+            exit(1);
+    }
+}
+
+
+
 int gauss_simplified_work_calculate_size(int ns)
 {
     int size = 0;
 
-    size += 1 * 2 * ns * sizeof(double);   // D
     size += 3 * ns * ns * sizeof(double);  // T, T_inv, lu_work
 
     size += 1 * ns * sizeof(int);  // perm
@@ -261,14 +670,19 @@ int gauss_simplified_work_calculate_size(int ns)
 }
 
 
-// TODO(all): understand how this works and leave a comment!
-void gauss_simplified(int ns, Newton_scheme *scheme, void *work)
+
+// Transformation for simplified Newton on the collocation equations:
+// with the Jacobians frozen over all stages, the Newton matrix (I kron df_dxdot + h A kron df_dx)
+// is transformed with T into ns/2 real blocks (I kron h df_dx + D_i kron df_dxdot) of size
+// 2 (nx+nz) and, for odd ns, one block of size (nx+nz).
+// On output: eig = D, transf1 = D * T^{-1} (applied to the residuals), transf2 = T (applied to
+// the solution), transf1_T and transf2_T their transposed counterparts.
+// The tables for Gauss-Legendre or Radau IIA nodes are selected by collocation_type.
+void gauss_simplified(int ns, sim_collocation_type collocation_type, Newton_scheme *scheme,
+                      void *work)
 {
     char *c_ptr = work;
 
-    // D
-    double *D = (double *) c_ptr;
-    c_ptr += 2 * ns * sizeof(double);
     // T
     double *T = (double *) c_ptr;
     c_ptr += ns * ns * sizeof(double);
@@ -284,17 +698,29 @@ void gauss_simplified(int ns, Newton_scheme *scheme, void *work)
 
     assert((char *) work + gauss_simplified_work_calculate_size(ns) >= c_ptr);
 
-    char simplified[MAX_STR_LEN];
-
-    snprintf(simplified, sizeof(simplified), "simplified/GL%d_simpl_%s.txt", 2 * ns, "D");
-    read_matrix(simplified, D, ns, 2);
+    // D: for ns = 1, A^{-1} = 1/a_11 is already diagonal (2 for implicit midpoint, 1 for
+    // implicit Euler)
+    double D_1[2] = {collocation_type == GAUSS_RADAU_IIA ? 1.0 : 2.0, 0.0};
+    double T_1[1] = {1.0};
+    const double *D = D_1;
+    const double *T_tab = T_1;
+    if (ns > 1)
+    {
+        if (collocation_type == GAUSS_RADAU_IIA)
+            radau_simplified_tables(ns, &D, &T_tab);
+        else
+            gauss_simplified_tables(ns, &D, &T_tab);
+    }
 
-    snprintf(simplified, sizeof(simplified), "simplified/GL%d_simpl_%s.txt", 2 * ns, "T");
-    read_matrix(simplified, T, ns, ns);
+    for (int i = 0; i < ns * ns; i++)
+    {
+        T[i] = T_tab[i];
+        T_inv[i] = 0.0;
+    }
 
     scheme->single = false;
     scheme->low_tria = 0;
-    for (int i = 0; i < ns; i++)
+    for (int i = 0; i < 2 * ns; i++)
     {
         scheme->eig[i] = D[i];
     }
@@ -377,6 +803,188 @@ void gauss_simplified(int ns, Newton_scheme *scheme, void *work)
 
 
 
+int newton_scheme_calculate_size(int ns)
+{
+    int size = sizeof(Newton_scheme);
+
+    size += 2 * ns * sizeof(double);       // eig
+    size += 4 * ns * ns * sizeof(double);  // transf1, transf2, transf1_T, transf2_T
+
+    size += 8;  // align
+
+    return size;
+}
+
+
+
+Newton_scheme *newton_scheme_assign(int ns, void *raw_memory)
+{
+    char *c_ptr = (char *) raw_memory;
+
+    Newton_scheme *scheme = (Newton_scheme *) c_ptr;
+    c_ptr += sizeof(Newton_scheme);
+
+    align_char_to(8, &c_ptr);
+
+    assign_and_advance_double(2 * ns, &scheme->eig, &c_ptr);
+    assign_and_advance_double(ns * ns, &scheme->transf1, &c_ptr);
+    assign_and_advance_double(ns * ns, &scheme->transf2, &c_ptr);
+    assign_and_advance_double(ns * ns, &scheme->transf1_T, &c_ptr);
+    assign_and_advance_double(ns * ns, &scheme->transf2_T, &c_ptr);
+
+    scheme->type = exact;
+    scheme->low_tria = NULL;
+    scheme->single = false;
+    scheme->freeze = false;
+
+    assert((char *) raw_memory + newton_scheme_calculate_size(ns) >= c_ptr);
+
+    return scheme;
+}
+
+
+
+// blocks: ((nx+nz)*ns, 2*(nx+nz)), the block of stage pair (i, i+1) is stored from row i*(nx+nz);
+// ipiv: (nx+nz)*ns, pivots of each block at the same offset
+void simplified_newton_factorize(int ns, int nx, int nz, double step, Newton_scheme *scheme,
+    struct blasfeo_dmat *df_dx, struct blasfeo_dmat *df_dxdot, struct blasfeo_dmat *df_dz,
+    struct blasfeo_dmat *blocks, int *ipiv)
+{
+    int n = nx + nz;
+    double d;
+
+    for (int i = 0; i < ns; i += 2)
+    {
+        // complex conjugate pair of eigenvalues -> 2x2 real block, last real eigenvalue -> 1x1
+        int nb = (i + 1 < ns) ? 2 : 1;
+        int m = nb * n;
+
+        blasfeo_dgese(m, m, 0.0, blocks, i * n, 0);
+        for (int ia = 0; ia < nb; ia++)
+        {
+            for (int ib = 0; ib < nb; ib++)
+            {
+                d = scheme->eig[(i + ia) + ns * ib];
+                blasfeo_dgead(n, nx, d, df_dxdot, 0, 0, blocks, (i + ia) * n, ib * n);
+                if (nz > 0)
+                    blasfeo_dgead(n, nz, d, df_dz, 0, 0, blocks, (i + ia) * n, ib * n + nx);
+                if (ia == ib)
+                    blasfeo_dgead(n, nx, step, df_dx, 0, 0, blocks, (i + ia) * n, ib * n);
+            }
+        }
+        blasfeo_dgetrf_rp(m, m, blocks, i * n, 0, blocks, i * n, 0, ipiv + i * n);
+    }
+
+    return;
+}
+
+
+
+// rG: residuals ordered by stage (g_1, ..., g_ns), each of size (nx+nz);
+// out: Newton step in K layout (k_1, ..., k_ns, z_1, ..., z_ns), may be the same vector as rG
+void simplified_newton_solve(int ns, int nx, int nz, Newton_scheme *scheme,
+    struct blasfeo_dmat *blocks, int *ipiv, struct blasfeo_dvec *rG, struct blasfeo_dvec *tmp,
+    struct blasfeo_dvec *out)
+{
+    int n = nx + nz;
+    double a;
+
+    // tmp = (D T^{-1} kron I) rG
+    blasfeo_dvecse(ns * n, 0.0, tmp, 0);
+    for (int i = 0; i < ns; i++)
+    {
+        for (int j = 0; j < ns; j++)
+        {
+            a = scheme->transf1[i + ns * j];
+            if (a != 0.0)
+                blasfeo_daxpy(n, a, rG, j * n, tmp, i * n, tmp, i * n);
+        }
+    }
+
+    // solve with the factorized blocks
+    for (int i = 0; i < ns; i += 2)
+    {
+        int m = (i + 1 < ns) ? 2 * n : n;
+        blasfeo_dvecpe(m, ipiv + i * n, tmp, i * n);
+        blasfeo_dtrsv_lnu(m, blocks, i * n, 0, tmp, i * n, tmp, i * n);
+        blasfeo_dtrsv_unn(m, blocks, i * n, 0, tmp, i * n, tmp, i * n);
+    }
+
+    // out = (T kron I) tmp
+    blasfeo_dvecse(ns * n, 0.0, out, 0);
+    for (int j = 0; j < ns; j++)
+    {
+        for (int i = 0; i < ns; i++)
+        {
+            a = scheme->transf2[j + ns * i];
+            if (a != 0.0)
+            {
+                blasfeo_daxpy(nx, a, tmp, i * n, out, j * nx, out, j * nx);
+                blasfeo_daxpy(nz, a, tmp, i * n + nx, out, ns * nx + j * nz,
+                              out, ns * nx + j * nz);
+            }
+        }
+    }
+
+    return;
+}
+
+
+
+// same as simplified_newton_solve, for ncol right hand sides
+void simplified_newton_solve_mat(int ns, int nx, int nz, int ncol, Newton_scheme *scheme,
+    struct blasfeo_dmat *blocks, int *ipiv, struct blasfeo_dmat *rG, struct blasfeo_dmat *tmp,
+    struct blasfeo_dmat *out)
+{
+    int n = nx + nz;
+    double a;
+
+    // tmp = (D T^{-1} kron I) rG
+    blasfeo_dgese(ns * n, ncol, 0.0, tmp, 0, 0);
+    for (int i = 0; i < ns; i++)
+    {
+        for (int j = 0; j < ns; j++)
+        {
+            a = scheme->transf1[i + ns * j];
+            if (a != 0.0)
+                blasfeo_dgead(n, ncol, a, rG, j * n, 0, tmp, i * n, 0);
+        }
+    }
+
+    // solve with the factorized blocks
+    for (int i = 0; i < ns; i += 2)
+    {
+        int m = (i + 1 < ns) ? 2 * n : n;
+        for (int k = 0; k < m; k++)
+        {
+            if (ipiv[i * n + k] != k)
+                blasfeo_drowsw(ncol, tmp, i * n + k, 0, tmp, i * n + ipiv[i * n + k], 0);
+        }
+        blasfeo_dtrsm_llnu(m, ncol, 1.0, blocks, i * n, 0, tmp, i * n, 0, tmp, i * n, 0);
+        blasfeo_dtrsm_lunn(m, ncol, 1.0, blocks, i * n, 0, tmp, i * n, 0, tmp, i * n, 0);
+    }
+
+    // out = (T kron I) tmp
+    blasfeo_dgese(ns * n, ncol, 0.0, out, 0, 0);
+    for (int j = 0; j < ns; j++)
+    {
+        for (int i = 0; i < ns; i++)
+        {
+            a = scheme->transf2[j + ns * i];
+            if (a != 0.0)
+            {
+                blasfeo_dgead(nx, ncol, a, tmp, i * n, 0, out, j * nx, 0);
+                if (nz > 0)
+                    blasfeo_dgead(nz, ncol, a, tmp, i * n + nx, 0, out, ns * nx + j * nz, 0);
+            }
+        }
+    }
+
+    return;
+}
+
+
+
 int butcher_table_work_calculate_size(int ns)
 {
     int size = 0;
@@ -444,3 +1052,87 @@ void butcher_table(int ns, double *nodes, double *b, double *A, void *work)
 
     return;
 }
+
+
+
+// Radau IIA nodes on [0, 1] in ascending order, c_ns = 1: roots of P_ns(x) - P_{ns-1}(x),
+// x = 2c - 1, with the Legendre polynomials P_k, computed by Newton's method on each root.
+void gauss_radau_iia_nodes(int ns, double *nodes)
+{
+    double x, dx, p, p_prev, p_prev2, dp, dp_prev, dp_prev2;
+    double eps = 2e-16;
+
+    nodes[ns - 1] = 1.0;
+
+    for (int i = 1; i < ns; i++)
+    {
+        // initial guess, close to the i-th largest root
+        x = cos(2 * i * M_PI / (2 * ns - 1));
+        for (int iter = 0; iter < 100; iter++)
+        {
+            // three-term recursion for P_k and P_k' up to k = ns
+            p_prev2 = 0.0;
+            p_prev = 1.0;
+            p = x;
+            dp_prev2 = 0.0;
+            dp_prev = 0.0;
+            dp = 1.0;
+            for (int k = 2; k <= ns; k++)
+            {
+                p_prev2 = p_prev;
+                p_prev = p;
+                dp_prev2 = dp_prev;
+                dp_prev = dp;
+                p = ((2 * k - 1) * x * p_prev - (k - 1) * p_prev2) / k;
+                dp = dp_prev2 + (2 * k - 1) * p_prev;
+            }
+
+            dx = (p - p_prev) / (dp - dp_prev);
+            x -= dx;
+            if (fabs(dx) < eps)
+                break;
+        }
+        nodes[ns - 1 - i] = 0.5 * (1 + x);
+    }
+
+    return;
+}
+
+
+
+int calculate_butcher_tableau_work_size(int ns)
+{
+    int tmp0 = gauss_nodes_work_calculate_size(ns);
+    int tmp1 = butcher_table_work_calculate_size(ns);
+
+    return tmp0 > tmp1 ? tmp0 : tmp1;
+}
+
+
+
+void calculate_butcher_tableau(int ns, sim_collocation_type collocation_type, double *c_vec,
+                               double *b_vec, double *A_mat, void *work)
+{
+    if (collocation_type == GAUSS_RADAU_IIA)
+    {
+        gauss_radau_iia_nodes(ns, c_vec);
+        butcher_table(ns, c_vec, b_vec, A_mat, work);
+        // stiffly accurate: b equals the last row of A, such that the state at the end of the
+        // interval coincides with the last stage value
+        for (int j = 0; j < ns; j++)
+            b_vec[j] = A_mat[(ns - 1) + ns * j];
+    }
+    else if (collocation_type == GAUSS_LEGENDRE)
+    {
+        gauss_nodes(ns, c_vec, work);
+        butcher_table(ns, c_vec, b_vec, A_mat, work);
+    }
+    else
+    {
+        printf("\nerror: calculate_butcher_tableau: unknown collocation_type %d\n",
+               collocation_type);
+        exit(1);
+    }
+
+    return;
+}
@@ -39,8 +39,21 @@
 extern "C" {
 #endif
 
+#include "blasfeo/include/blasfeo_common.h"
+
 #include "acados/utils/types.h"
 
+// largest number of stages with a compiled-in simplified Newton transformation
+#define GAUSS_SIMPLIFIED_NS_MAX 9
+
+
+
+typedef enum
+{
+    GAUSS_LEGENDRE = 0,
+    GAUSS_RADAU_IIA,
+} sim_collocation_type;
+
 
 
 enum Newton_type_collocation
@@ -76,11 +89,35 @@ void gauss_nodes(int ns, double *nodes, void *raw_memory);
 //
 int gauss_simplified_work_calculate_size(int ns);
 //
-void gauss_simplified(int ns, Newton_scheme *scheme, void *work);
+void gauss_simplified(int ns, sim_collocation_type collocation_type, Newton_scheme *scheme,
+                      void *work);
+//
+int newton_scheme_calculate_size(int ns);
+//
+Newton_scheme *newton_scheme_assign(int ns, void *raw_memory);
+//
+void simplified_newton_factorize(int ns, int nx, int nz, double step, Newton_scheme *scheme,
+    struct blasfeo_dmat *df_dx, struct blasfeo_dmat *df_dxdot, struct blasfeo_dmat *df_dz,
+    struct blasfeo_dmat *blocks, int *ipiv);
+//
+void simplified_newton_solve(int ns, int nx, int nz, Newton_scheme *scheme,
+    struct blasfeo_dmat *blocks, int *ipiv, struct blasfeo_dvec *rG, struct blasfeo_dvec *tmp,
+    struct blasfeo_dvec *out);
+//
+void simplified_newton_solve_mat(int ns, int nx, int nz, int ncol, Newton_scheme *scheme,
+    struct blasfeo_dmat *blocks, int *ipiv, struct blasfeo_dmat *rG, struct blasfeo_dmat *tmp,
+    struct blasfeo_dmat *out);
 //
 int butcher_table_work_calculate_size(int ns);
 //
 void butcher_table(int ns, double *nodes, double *b, double *A, void *work);
+//
+void gauss_radau_iia_nodes(int ns, double *nodes);
+//
+int calculate_butcher_tableau_work_size(int ns);
+//
+void calculate_butcher_tableau(int ns, sim_collocation_type collocation_type, double *c_vec,
+                               double *b_vec, double *A_mat, void *work);
 
 
 
@@ -297,6 +297,9 @@ sim_out *sim_out_assign(void *config_, void *dims, void *raw_memory)
     assign_and_advance_double(nz, &out->zn, &c_ptr);
     assign_and_advance_double(nz * NF, &out->S_algebraic, &c_ptr);
 
+    out->info->num_steps_accepted = 0;
+    out->info->num_steps_rejected = 0;
+
     assert((char *) raw_memory + sim_out_calculate_size(config_, dims) >= c_ptr);
 
     return out;
@@ -406,6 +409,16 @@ int sim_out_get_(void *config_, void *dims_, sim_out *out, const char *field, vo
         double *time = value;
         *time = out->info->LAtime;
     }
+    else if (!strcmp(field, "num_steps_accepted"))
+    {
+        int *num_steps = value;
+        *num_steps = out->info->num_steps_accepted;
+    }
+    else if (!strcmp(field, "num_steps_rejected"))
+    {
+        int *num_steps = value;
+        *num_steps = out->info->num_steps_rejected;
+    }
     else
     {
         printf("sim_out_get_: field %s not supported \n", field);
@@ -474,6 +487,54 @@ void sim_opts_set_(sim_opts *opts, const char *field, void *value)
         bool *sens_algebraic = (bool *) value;
         opts->sens_algebraic = *sens_algebraic;
     }
+    else if (!strcmp(field, "collocation_type"))
+    {
+        sim_collocation_type *collocation_type = (sim_collocation_type *) value;
+        opts->collocation_type = *collocation_type;
+    }
+    else if (!strcmp(field, "adaptive_step"))
+    {
+        bool *adaptive_step = (bool *) value;
+        opts->adaptive_step = *adaptive_step;
+    }
+    else if (!strcmp(field, "freeze_steps"))
+    {
+        bool *freeze_steps = (bool *) value;
+        opts->freeze_steps = *freeze_steps;
+    }
+    else if (!strcmp(field, "max_num_steps"))
+    {
+        int *max_num_steps = (int *) value;
+        opts->max_num_steps = *max_num_steps;
+    }
+    else if (!strcmp(field, "abs_tol"))
+    {
+        double *abs_tol = (double *) value;
+        opts->abs_tol = *abs_tol;
+    }
+    else if (!strcmp(field, "rel_tol"))
+    {
+        double *rel_tol = (double *) value;
+        opts->rel_tol = *rel_tol;
+    }
+    else if (!strcmp(field, "simplified_newton"))
+    {
+        bool *simplified_newton = (bool *) value;
+        if (opts->scheme == NULL)
+        {
+            printf("\nerror: simplified_newton is not supported by this integrator\n");
+            exit(1);
+        }
+        if (*simplified_newton)
+        {
+            opts->scheme->type = simplified_in;
+            gauss_simplified(opts->ns, opts->collocation_type, opts->scheme, opts->work);
+        }
+        else
+        {
+            opts->scheme->type = exact;
+        }
+    }
     else
     {
         printf("\nerror: field %s not available in sim_opts_set\n", field);
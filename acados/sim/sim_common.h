@@ -97,6 +97,9 @@ typedef struct
     double LAtime;   // in seconds
     double ADtime;   // in seconds
 
+    int num_steps_accepted;  // integration steps taken (adaptive ERK: accepted steps)
+    int num_steps_rejected;  // adaptive ERK: steps rejected by the error control
+
 } sim_info;
 
 
@@ -108,7 +111,8 @@ typedef struct
     double *S_adj;   //
     double *S_hess;  //
 
-    double *zn;           // z - algebraic variables - reported at start of simulation interval
+    double *zn;           // z - algebraic variables - reported at start of simulation interval,
+                          // at its end for stiffly accurate tableaus (Radau IIA) in the IRK
     double *S_algebraic;  // sensitivities of reported value of algebraic variables w.r.t.
                           // initial stat & control (x_n,u)
 
@@ -133,6 +137,8 @@ typedef struct
     double *A_mat;
     double *c_vec;
     double *b_vec;
+    // collocation integrators: nodes of the Butcher tableau, Gauss-Legendre or Radau IIA
+    sim_collocation_type collocation_type;
 
     bool sens_forw;
     bool sens_adj;
@@ -146,8 +152,19 @@ typedef struct
     // && jac_reuse=false
     int newton_iter;
     bool jac_reuse;
+    // collocation Newton scheme, NULL if the integrator has none;
+    // scheme->type != exact -> simplified Newton with the block diagonalized Jacobian
     Newton_scheme *scheme;
 
+    // explicit integrators: adaptive step size with an embedded pair, the error estimate
+    // is h * sum_i b_err[i] * k_i; the accepted step sequence is reused for the sensitivities
+    bool adaptive_step;
+    bool freeze_steps;  // reuse the step sequence of the last adaptive call
+    int max_num_steps;
+    double abs_tol;
+    double rel_tol;
+    double *b_err;
+
     // workspace
     void *work;
 
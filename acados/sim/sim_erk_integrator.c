@@ -34,6 +34,7 @@
 
 // standard
 #include <assert.h>
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -199,6 +200,7 @@ int sim_erk_opts_calculate_size(void *config_, void *dims)
     size += ns_max * ns_max * sizeof(double);  // A_mat
     size += ns_max * sizeof(double);           // b_vec
     size += ns_max * sizeof(double);           // c_vec
+    size += ns_max * sizeof(double);           // b_err
 
     make_int_multiple_of(8, &size);
     size += 1 * 8;
@@ -222,6 +224,7 @@ void *sim_erk_opts_assign(void *config_, void *dims, void *raw_memory)
     assign_and_advance_double(ns_max * ns_max, &opts->A_mat, &c_ptr);
     assign_and_advance_double(ns_max, &opts->b_vec, &c_ptr);
     assign_and_advance_double(ns_max, &opts->c_vec, &c_ptr);
+    assign_and_advance_double(ns_max, &opts->b_err, &c_ptr);
 
     assert((char *) raw_memory + sim_erk_opts_calculate_size(config_, dims) >= c_ptr);
 
@@ -341,6 +344,116 @@ void sim_erk_opts_initialize_default(void *config_, void *dims_, void *opts_)
 
     opts->output_z = false;
     opts->sens_algebraic = false;
+
+    // adaptive step size
+    opts->adaptive_step = false;
+    opts->freeze_steps = false;
+    opts->max_num_steps = 1000;
+    opts->abs_tol = 1e-8;
+    opts->rel_tol = 1e-6;
+}
+
+
+
+// embedded pairs for the adaptive step size: Bogacki-Shampine 3(2) for ns = 4,
+// Dormand-Prince 5(4) for ns = 7; b is the higher order solution, b_err = b - b_hat
+static void sim_erk_embedded_tableau(sim_opts *opts)
+{
+    int ns = opts->ns;
+
+    double *A = opts->A_mat;
+    double *b = opts->b_vec;
+    double *c = opts->c_vec;
+    double *b_err = opts->b_err;
+
+    for (int ii = 0; ii < ns * ns; ii++)
+        A[ii] = 0.0;
+
+    switch (ns)
+    {
+        case 4:
+        {
+            // A
+            A[1 + ns * 0] = 1.0 / 2.0;
+            A[2 + ns * 1] = 3.0 / 4.0;
+            A[3 + ns * 0] = 2.0 / 9.0;
+            A[3 + ns * 1] = 1.0 / 3.0;
+            A[3 + ns * 2] = 4.0 / 9.0;
+            // b
+            b[0] = 2.0 / 9.0;
+            b[1] = 1.0 / 3.0;
+            b[2] = 4.0 / 9.0;
+            b[3] = 0.0;
+            // b_err
+            b_err[0] = -5.0 / 72.0;
+            b_err[1] = 1.0 / 12.0;
+            b_err[2] = 1.0 / 9.0;
+            b_err[3] = -1.0 / 8.0;
+            // c
+            c[0] = 0.0;
+            c[1] = 1.0 / 2.0;
+            c[2] = 3.0 / 4.0;
+            c[3] = 1.0;
+            break;
+        }
+        case 7:
+        {
+            // A
+            A[1 + ns * 0] = 1.0 / 5.0;
+            A[2 + ns * 0] = 3.0 / 40.0;
+            A[2 + ns * 1] = 9.0 / 40.0;
+            A[3 + ns * 0] = 44.0 / 45.0;
+            A[3 + ns * 1] = -56.0 / 15.0;
+            A[3 + ns * 2] = 32.0 / 9.0;
+            A[4 + ns * 0] = 19372.0 / 6561.0;
+            A[4 + ns * 1] = -25360.0 / 2187.0;
+            A[4 + ns * 2] = 64448.0 / 6561.0;
+            A[4 + ns * 3] = -212.0 / 729.0;
+            A[5 + ns * 0] = 9017.0 / 3168.0;
+            A[5 + ns * 1] = -355.0 / 33.0;
+            A[5 + ns * 2] = 46732.0 / 5247.0;
+            A[5 + ns * 3] = 49.0 / 176.0;
+            A[5 + ns * 4] = -5103.0 / 18656.0;
+            A[6 + ns * 0] = 35.0 / 384.0;
+            A[6 + ns * 2] = 500.0 / 1113.0;
+            A[6 + ns * 3] = 125.0 / 192.0;
+            A[6 + ns * 4] = -2187.0 / 6784.0;
+            A[6 + ns * 5] = 11.0 / 84.0;
+            // b
+            b[0] = 35.0 / 384.0;
+            b[1] = 0.0;
+            b[2] = 500.0 / 1113.0;
+            b[3] = 125.0 / 192.0;
+            b[4] = -2187.0 / 6784.0;
+            b[5] = 11.0 / 84.0;
+            b[6] = 0.0;
+            // b_err
+            b_err[0] = 71.0 / 57600.0;
+            b_err[1] = 0.0;
+            b_err[2] = -71.0 / 16695.0;
+            b_err[3] = 71.0 / 1920.0;
+            b_err[4] = -17253.0 / 339200.0;
+            b_err[5] = 22.0 / 525.0;
+            b_err[6] = -1.0 / 40.0;
+            // c
+            c[0] = 0.0;
+            c[1] = 1.0 / 5.0;
+            c[2] = 3.0 / 10.0;
+            c[3] = 4.0 / 5.0;
+            c[4] = 8.0 / 9.0;
+            c[5] = 1.0;
+            c[6] = 1.0;
+            break;
+        }
+        default:
+        {
+            printf("\nerror: sim_erk: adaptive_step needs ns = 4 (Bogacki-Shampine) or "
+                   "ns = 7 (Dormand-Prince), got ns = %d\n", ns);
+            exit(1);
+        }
+    }
+
+    return;
 }
 
 
@@ -353,6 +466,12 @@ void sim_erk_opts_update(void *config_, void *dims, void *opts_)
 
     opts->tableau_size = opts->ns;
 
+    if (opts->adaptive_step)
+    {
+        sim_erk_embedded_tableau(opts);
+        return;
+    }
+
     assert((ns == 1 || ns == 2 || ns == 4) && "only number of stages = {1,2,4} implemented!");
 
     assert(ns <= NS_MAX && "ns > NS_MAX!");
@@ -441,8 +560,16 @@ void sim_erk_opts_update(void *config_, void *dims, void *opts_)
 
 int sim_erk_memory_calculate_size(void *config, void *dims, void *opts_)
 {
+    sim_opts *opts = opts_;
+
     int size = sizeof(sim_erk_memory);
 
+    if (opts->adaptive_step)
+        size += opts->max_num_steps * sizeof(double);  // step_seq
+
+    make_int_multiple_of(8, &size);
+    size += 1 * 8;
+
     return size;
 }
 
@@ -452,9 +579,25 @@ void *sim_erk_memory_assign(void *config, void *dims, void *opts_, void *raw_mem
 {
     char *c_ptr = (char *) raw_memory;
 
+    sim_opts *opts = opts_;
+
     sim_erk_memory *mem = (sim_erk_memory *) c_ptr;
     c_ptr += sizeof(sim_erk_memory);
 
+    align_char_to(8, &c_ptr);
+
+    mem->step_seq = NULL;
+    mem->max_num_steps = 0;
+    if (opts->adaptive_step)
+    {
+        assign_and_advance_double(opts->max_num_steps, &mem->step_seq, &c_ptr);
+        mem->max_num_steps = opts->max_num_steps;
+    }
+    mem->num_steps_seq = 0;
+    mem->T_seq = 0.0;
+
+    assert((char *) raw_memory + sim_erk_memory_calculate_size(config, dims, opts_) >= c_ptr);
+
     return mem;
 }
 
@@ -474,7 +617,9 @@ int sim_erk_memory_set_to_zero(void *config_, void * dims_, void *opts_, void *m
 
     if (!strcmp(field, "guesses"))
     {
-        // no guesses/initialization in ERK
+        // adaptive step size: forget the step sequence of the previous call
+        sim_erk_memory *mem = mem_;
+        mem->num_steps_seq = 0;
     }
     else
     {
@@ -532,7 +677,8 @@ int sim_erk_workspace_calculate_size(void *config_, void *dims_, void *opts_)
 
     int nX = nx * (1 + nf);  // (nx) for ODE and (nf*nx) for VDE
     int nhess = (nf + 1) * nf / 2;
-    int num_steps = opts->num_steps;  // number of steps
+    // number of steps, bounded by max_num_steps for the adaptive step size
+    int num_steps = opts->adaptive_step ? opts->max_num_steps : opts->num_steps;
 
     int size = sizeof(sim_erk_workspace);
 
@@ -562,6 +708,13 @@ int sim_erk_workspace_calculate_size(void *config_, void *dims_, void *opts_)
         size += ns * (nx + nu) * sizeof(double);  // adj_traj
     }
 
+    if (opts->adaptive_step)
+    {
+        size += (nx + nu) * sizeof(double);  // ode_in
+        size += ns * nx * sizeof(double);    // K_nom
+        size += 2 * nx * sizeof(double);     // x_nom, x_new
+    }
+
     make_int_multiple_of(8, &size);
     size += 1 * 8;
 
@@ -570,7 +723,10 @@ int sim_erk_workspace_calculate_size(void *config_, void *dims_, void *opts_)
 
 
 
-static void *sim_erk_cast_workspace(void *config_, void *dims_, void *opts_, void *raw_memory)
+// num_steps: number of steps the workspace was sized for, the max_num_steps at creation
+// for the adaptive step size
+static void *sim_erk_cast_workspace(void *config_, void *dims_, void *opts_, int num_steps,
+                                    void *raw_memory)
 {
     sim_opts *opts = opts_;
     sim_erk_dims *dims = (sim_erk_dims *) dims_;
@@ -583,7 +739,6 @@ static void *sim_erk_cast_workspace(void *config_, void *dims_, void *opts_, voi
 
     int nX = nx * (1 + nf);  // (nx) for ODE and (nf*nx) for VDE
     int nhess = (nf + 1) * nf / 2;
-    int num_steps = opts->num_steps;  // number of steps
 
     char *c_ptr = (char *) raw_memory;
 
@@ -645,10 +800,22 @@ static void *sim_erk_cast_workspace(void *config_, void *dims_, void *opts_, voi
         d_ptr += ns*(nu+nx);
     }
 
+    if (opts->adaptive_step)
+    {
+        work->ode_in = d_ptr;
+        d_ptr += nx + nu;
+        work->K_nom = d_ptr;
+        d_ptr += ns * nx;
+        work->x_nom = d_ptr;
+        d_ptr += nx;
+        work->x_new = d_ptr;
+        d_ptr += nx;
+    }
+
     // update c_ptr
     c_ptr = (char *) d_ptr;
 
-    assert((char *) raw_memory + sim_erk_workspace_calculate_size(config_, dims, opts_) >= c_ptr);
+    // no size check against the current opts, max_num_steps may have changed since creation
 
     return (void *) work;
 }
@@ -665,6 +832,154 @@ int sim_erk_precompute(void *config_, sim_in *in, sim_out *out, void *opts_, voi
 
 
 
+// Nominal sweep with error control on the states only (expl_ode_fun): the accepted step sizes
+// are stored in mem->step_seq and replayed by the sweeps with sensitivities, such that those
+// differentiate one fixed discretization and no step is ever rejected there.
+static int sim_erk_adaptive_steps(sim_in *in, sim_opts *opts, sim_erk_memory *mem,
+                                  sim_erk_workspace *work, int nx, int nu, int *num_rejected,
+                                  double *timing_ad)
+{
+    int ns = opts->ns;
+    double T = in->T;
+
+    double *A_mat = opts->A_mat;
+    double *b_vec = opts->b_vec;
+    double *b_err = opts->b_err;
+
+    double *ode_in = work->ode_in;
+    double *K = work->K_nom;
+    double *x = work->x_nom;
+    double *x_new = work->x_new;
+
+    // 1 / (order of the embedded solution + 1)
+    double err_exp = ns == 4 ? 1.0 / 3.0 : 1.0 / 5.0;
+
+    ext_fun_arg_t ext_fun_type_in[2];
+    void *ext_fun_in[2];
+    ext_fun_arg_t ext_fun_type_out[1];
+    void *ext_fun_out[1];
+
+    erk_model *model = in->model;
+
+    acados_timer timer_ad;
+
+    if (model->expl_ode_fun == 0)
+    {
+        printf("sim ERK: expl_ode_fun is not provided, needed for adaptive_step. Exiting.\n");
+        exit(1);
+    }
+
+    ext_fun_type_in[0] = COLMAJ;
+    ext_fun_in[0] = ode_in + 0;  // x: nx
+    ext_fun_type_in[1] = COLMAJ;
+    ext_fun_in[1] = ode_in + nx;  // u: nu
+    ext_fun_type_out[0] = COLMAJ;
+
+    for (int i = 0; i < nx; i++) x[i] = in->x[i];
+    for (int i = 0; i < nu; i++) ode_in[nx + i] = in->u[i];
+
+    // max_num_steps of the opts, within the capacity of the memory
+    int max_num_steps = opts->max_num_steps < mem->max_num_steps ? opts->max_num_steps
+                                                                 : mem->max_num_steps;
+
+    // initial step: first step of the previous call, or T / num_steps
+    double h = T / opts->num_steps;
+    if (mem->num_steps_seq > 0)
+        h = mem->step_seq[0] * T / mem->T_seq;
+
+    double t = 0.0;
+    int num_accepted = 0;
+    *num_rejected = 0;
+    bool last = false;
+
+    while (!last)
+    {
+        if (num_accepted >= max_num_steps)
+        {
+            mem->num_steps_seq = 0;
+            return ACADOS_MAXITER;
+        }
+        if (h < 1e2 * ACADOS_EPS * T)
+        {
+            mem->num_steps_seq = 0;
+            return ACADOS_MINSTEP;
+        }
+        if (t + h >= T)
+        {
+            h = T - t;
+            last = true;
+        }
+
+        for (int s = 0; s < ns; s++)
+        {
+            for (int i = 0; i < nx; i++)
+                ode_in[i] = x[i];
+            for (int j = 0; j < s; j++)
+            {
+                double a = A_mat[j * ns + s];
+                if (a != 0)
+                {
+                    a *= h;
+                    for (int i = 0; i < nx; i++)
+                        ode_in[i] += a * K[j * nx + i];
+                }
+            }
+            ext_fun_out[0] = K + s * nx;  // fun: nx
+
+            acados_tic(&timer_ad);
+            model->expl_ode_fun->evaluate(model->expl_ode_fun, ext_fun_type_in, ext_fun_in,
+                                          ext_fun_type_out, ext_fun_out);
+            *timing_ad += acados_toc(&timer_ad);
+        }
+
+        // weighted RMS norm of the local error estimate
+        double err = 0.0;
+        for (int i = 0; i < nx; i++)
+        {
+            double dx = 0.0;
+            double ex = 0.0;
+            for (int s = 0; s < ns; s++)
+            {
+                dx += b_vec[s] * K[s * nx + i];
+                ex += b_err[s] * K[s * nx + i];
+            }
+            x_new[i] = x[i] + h * dx;
+            double scale = opts->abs_tol + opts->rel_tol * fmax(fabs(x[i]), fabs(x_new[i]));
+            err += (h * ex / scale) * (h * ex / scale);
+        }
+        err = sqrt(err / nx);
+
+        double fac = 5.0;
+        if (err > 0.0)
+            fac = 0.9 * pow(err, -err_exp);
+
+        if (err <= 1.0)
+        {  // accept
+            for (int i = 0; i < nx; i++) x[i] = x_new[i];
+            mem->step_seq[num_accepted] = h;
+            num_accepted++;
+            t += h;
+        }
+        else
+        {  // reject
+            (*num_rejected)++;
+            last = false;
+            if (fac > 1.0) fac = 1.0;
+        }
+
+        if (fac < 0.2) fac = 0.2;
+        if (fac > 5.0) fac = 5.0;
+        h *= fac;
+    }
+
+    mem->num_steps_seq = num_accepted;
+    mem->T_seq = T;
+
+    return ACADOS_SUCCESS;
+}
+
+
+
 int sim_erk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, void *work_)
 {
     sim_config *config = config_;
@@ -682,7 +997,15 @@ int sim_erk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
     void *dims_ = in->dims;
     sim_erk_dims *dims = (sim_erk_dims *) dims_;
 
-    sim_erk_workspace *work = sim_erk_cast_workspace(config, dims, opts, work_);
+    // the step sequence and the workspace trajectories hold the max_num_steps at creation
+    if (opts->adaptive_step && mem->max_num_steps == 0)
+    {
+        printf("\nerror: sim_erk: adaptive_step set after the creation of the memory\n");
+        exit(1);
+    }
+    int num_steps_alloc = opts->adaptive_step ? mem->max_num_steps : opts->num_steps;
+
+    sim_erk_workspace *work = sim_erk_cast_workspace(config, dims, opts, num_steps_alloc, work_);
 
     int i, j, s, istep;
     double a = 0, b = 0;  // temp values of A_mat and b_vec
@@ -718,6 +1041,8 @@ int sim_erk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
     double *S_forw_in = in->S_forw;
     int num_steps = opts->num_steps;
     double step = in->T / num_steps;
+    double *step_seq = NULL;
+    int num_rejected = 0;
 
     double *S_adj_in = in->S_adj;
 
@@ -751,6 +1076,47 @@ int sim_erk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
     // start timer
     acados_tic(&timer);
 
+    /************************************************
+     * step size selection
+     ************************************************/
+
+    // number of steps of the forward sweep below
+    int num_steps_forw = num_steps;
+    bool nominal_sweep = false;
+
+    if (opts->adaptive_step)
+    {
+        if (opts->freeze_steps && mem->num_steps_seq > 0)
+        {
+            // frozen step sequence, rescaled to the simulation time
+            for (istep = 0; istep < mem->num_steps_seq; istep++)
+                mem->step_seq[istep] *= in->T / mem->T_seq;
+            mem->T_seq = in->T;
+        }
+        else
+        {
+            int status = sim_erk_adaptive_steps(in, opts, mem, work, nx, nu, &num_rejected,
+                                                &timing_ad);
+            if (status != ACADOS_SUCCESS)
+            {
+                out->info->num_steps_accepted = 0;
+                out->info->num_steps_rejected = num_rejected;
+                out->info->CPUtime = acados_toc(&timer);
+                out->info->LAtime = 0.0;
+                out->info->ADtime = timing_ad;
+                return status;
+            }
+            nominal_sweep = true;
+        }
+        num_steps = mem->num_steps_seq;
+        step_seq = mem->step_seq;
+        num_steps_forw = num_steps;
+
+        // the nominal sweep already delivers xn, rerun it only for the sensitivities
+        if (nominal_sweep && !opts->sens_forw && !opts->sens_adj && !opts->sens_hess)
+            num_steps_forw = 0;
+    }
+
     /************************************************
      * forward sweep
      ************************************************/
@@ -762,9 +1128,16 @@ int sim_erk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
         for (i = 0; i < nx * nf; i++) forw_traj[nx + i] = S_forw_in[i];  // sensitivities
     }
     for (i = 0; i < nu; i++) rhs_forw_in[nX + i] = u[i];  // controls
+    if (nominal_sweep && num_steps_forw == 0)
+    {
+        for (i = 0; i < nx; i++) forw_traj[i] = work->x_nom[i];
+    }
 
-    for (istep = 0; istep < num_steps; istep++)
+    for (istep = 0; istep < num_steps_forw; istep++)
     {
+        if (step_seq)
+            step = step_seq[istep];
+
         if (opts->sens_adj | opts->sens_hess)
         {
             K_traj = work->K_traj + istep * ns * nX;
@@ -878,6 +1251,8 @@ int sim_erk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
 
             K_traj = work->K_traj + istep * ns * nX;
             forw_traj = work->out_forw_traj + istep*nX;
+            if (step_seq)
+                step = step_seq[istep];
 
             for (s = ns - 1; s >= 0; s--)
             {
@@ -1015,6 +1390,8 @@ int sim_erk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
     out->info->CPUtime = acados_toc(&timer);
     out->info->LAtime = 0.0;
     out->info->ADtime = timing_ad;
+    out->info->num_steps_accepted = num_steps;
+    out->info->num_steps_rejected = num_rejected;
 
     mem->time_sim = out->info->CPUtime;
     mem->time_ad = out->info->ADtime;
@@ -76,6 +76,12 @@ typedef struct
 	double time_ad;
 	double time_la;
 
+	// adaptive step size: accepted step sequence of the last call
+	double *step_seq;
+	int max_num_steps;  // capacity of step_seq, the max_num_steps at creation
+	int num_steps_seq;
+	double T_seq;  // simulation time the step sequence was computed for
+
 	// workspace structs
 } sim_erk_memory;
 
@@ -93,6 +99,12 @@ typedef struct
     double *out_adj_tmp;
     double *adj_traj;
 
+    // adaptive step size, nominal sweep
+    double *ode_in;  // x + u
+    double *K_nom;   // stages*nx
+    double *x_nom;
+    double *x_new;
+
 } sim_erk_workspace;
 
 
@@ -261,9 +261,7 @@ int sim_gnsf_opts_calculate_size(void *config_, void *dims)
     size += ns_max * sizeof(double);           // b_vec
     size += ns_max * sizeof(double);           // c_vec
 
-    int tmp0 = gauss_nodes_work_calculate_size(ns_max);
-    int tmp1 = butcher_table_work_calculate_size(ns_max);
-    int work_size = tmp0 > tmp1 ? tmp0 : tmp1;
+    int work_size = calculate_butcher_tableau_work_size(ns_max);
     size += work_size;  // work
 
     make_int_multiple_of(8, &size);
@@ -288,9 +286,7 @@ void *sim_gnsf_opts_assign(void *config_, void *dims, void *raw_memory)
     assign_and_advance_double(ns_max, &opts->c_vec, &c_ptr);
 
     // work
-    int tmp0 = gauss_nodes_work_calculate_size(ns_max);
-    int tmp1 = butcher_table_work_calculate_size(ns_max);
-    int work_size = tmp0 > tmp1 ? tmp0 : tmp1;
+    int work_size = calculate_butcher_tableau_work_size(ns_max);
     opts->work = c_ptr;
     c_ptr += work_size;
 
@@ -312,11 +308,12 @@ void sim_gnsf_opts_initialize_default(void *config_, void *dims_, void *opts_)
     // set tableau size
     opts->tableau_size = opts->ns;
 
-    // gauss collocation nodes
-    gauss_nodes(ns, opts->c_vec, opts->work);
+    // collocation nodes
+    opts->collocation_type = GAUSS_LEGENDRE;
 
     // butcher tableau
-    butcher_table(ns, opts->c_vec, opts->b_vec, opts->A_mat, opts->work);
+    calculate_butcher_tableau(ns, opts->collocation_type, opts->c_vec, opts->b_vec, opts->A_mat,
+                              opts->work);
 
     // default options
     opts->newton_iter = 3;
@@ -357,11 +354,9 @@ void sim_gnsf_opts_update(void *config_, void *dims, void *opts_)
     // set tableau size
     opts->tableau_size = opts->ns;
 
-    // gauss collocation nodes
-    gauss_nodes(ns, opts->c_vec, opts->work);
-
     // butcher tableau
-    butcher_table(ns, opts->c_vec, opts->b_vec, opts->A_mat, opts->work);
+    calculate_butcher_tableau(ns, opts->collocation_type, opts->c_vec, opts->b_vec, opts->A_mat,
+                              opts->work);
 
     return;
 }
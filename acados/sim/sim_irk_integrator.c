@@ -220,8 +220,10 @@ int sim_irk_opts_calculate_size(void *config_, void *dims)
     size += ns_max * sizeof(double);           // b_vec
     size += ns_max * sizeof(double);           // c_vec
 
-    int tmp0 = gauss_nodes_work_calculate_size(ns_max);
-    int tmp1 = butcher_table_work_calculate_size(ns_max);
+    size += newton_scheme_calculate_size(ns_max);  // scheme
+
+    int tmp0 = calculate_butcher_tableau_work_size(ns_max);
+    int tmp1 = gauss_simplified_work_calculate_size(ns_max);
     int work_size = tmp0 > tmp1 ? tmp0 : tmp1;
     size += work_size;  // work
 
@@ -246,9 +248,13 @@ void *sim_irk_opts_assign(void *config_, void *dims, void *raw_memory)
     assign_and_advance_double(ns_max, &opts->b_vec, &c_ptr);
     assign_and_advance_double(ns_max, &opts->c_vec, &c_ptr);
 
+    // scheme
+    opts->scheme = newton_scheme_assign(ns_max, c_ptr);
+    c_ptr += newton_scheme_calculate_size(ns_max);
+
     // work
-    int tmp0 = gauss_nodes_work_calculate_size(ns_max);
-    int tmp1 = butcher_table_work_calculate_size(ns_max);
+    int tmp0 = calculate_butcher_tableau_work_size(ns_max);
+    int tmp1 = gauss_simplified_work_calculate_size(ns_max);
     int work_size = tmp0 > tmp1 ? tmp0 : tmp1;
     opts->work = c_ptr;
     c_ptr += work_size;
@@ -271,15 +277,16 @@ void sim_irk_opts_initialize_default(void *config_, void *dims_, void *opts_)
     // set tableau size
     opts->tableau_size = opts->ns;
 
-    // gauss collocation nodes
-    gauss_nodes(ns, opts->c_vec, opts->work);
+    // collocation nodes
+    opts->collocation_type = GAUSS_LEGENDRE;
 
     // butcher tableau
-    butcher_table(ns, opts->c_vec, opts->b_vec, opts->A_mat, opts->work);
+    calculate_butcher_tableau(ns, opts->collocation_type, opts->c_vec, opts->b_vec, opts->A_mat,
+                              opts->work);
 
     // default options
     opts->newton_iter = 3;
-    opts->scheme = NULL;
+    opts->scheme->type = exact;
     opts->num_steps = 2;
     opts->num_forw_sens = dims->nx + dims->nu;
     opts->sens_forw = true;
@@ -316,11 +323,13 @@ void sim_irk_opts_update(void *config_, void *dims, void *opts_)
     // set tableau size
     opts->tableau_size = opts->ns;
 
-    // gauss collocation nodes
-    gauss_nodes(ns, opts->c_vec, opts->work);
-
     // butcher tableau
-    butcher_table(ns, opts->c_vec, opts->b_vec, opts->A_mat, opts->work);
+    calculate_butcher_tableau(ns, opts->collocation_type, opts->c_vec, opts->b_vec, opts->A_mat,
+                              opts->work);
+
+    // simplified Newton transformation
+    if (opts->scheme->type != exact)
+        gauss_simplified(ns, opts->collocation_type, opts->scheme, opts->work);
 
     return;
 }
@@ -591,6 +600,13 @@ int sim_irk_workspace_calculate_size(void *config_, void *dims_, void *opts_)
         size += blasfeo_memsize_dmat(nx + nz, nx + nu);  // dk0_dxu
     }
 
+    if (opts->scheme->type != exact)
+    {
+        size += blasfeo_memsize_dmat(nK, 2 * (nx + nz));  // dG_dK_simplified
+        size += blasfeo_memsize_dvec(nK);                 // rG_simplified
+        size += nK * sizeof(int);                         // ipiv_simplified
+    }
+
     size += 1 * 8; // initial alignment
     make_int_multiple_of(64, &size);
     size += 1 * 64;
@@ -685,6 +701,12 @@ static void *sim_irk_workspace_cast(void *config_, void *dims_, void *opts_, voi
         assign_and_advance_blasfeo_dmat_mem(nx + nz, nx + nu, &workspace->dk0_dxu, &c_ptr);
     }
 
+    if (opts->scheme->type != exact)
+    {
+        assign_and_advance_blasfeo_dmat_mem(nK, 2 * (nx + nz), &workspace->dG_dK_simplified,
+                                            &c_ptr);
+    }
+
     assign_and_advance_blasfeo_dvec_mem(nK, workspace->rG, &c_ptr);
     assign_and_advance_blasfeo_dvec_mem(nK, workspace->K, &c_ptr);
     assign_and_advance_blasfeo_dvec_mem(nx, workspace->xt, &c_ptr);
@@ -692,6 +714,8 @@ static void *sim_irk_workspace_cast(void *config_, void *dims_, void *opts_, voi
     assign_and_advance_blasfeo_dvec_mem(nx, &workspace->xtdot, &c_ptr);
     assign_and_advance_blasfeo_dvec_mem(nx + nu, workspace->lambda, &c_ptr);
     assign_and_advance_blasfeo_dvec_mem(nK, workspace->lambdaK, &c_ptr);
+    if (opts->scheme->type != exact)
+        assign_and_advance_blasfeo_dvec_mem(nK, &workspace->rG_simplified, &c_ptr);
 
 
     if ( opts->sens_adj || opts->sens_hess ){
@@ -713,6 +737,9 @@ static void *sim_irk_workspace_cast(void *config_, void *dims_, void *opts_, voi
         assign_and_advance_int(steps * nK, &workspace->ipiv, &c_ptr);
     }
 
+    if (opts->scheme->type != exact)
+        assign_and_advance_int(nK, &workspace->ipiv_simplified, &c_ptr);
+
     // printf("\npointer moved - size calculated = %d bytes\n", c_ptr- (char*)raw_memory -
     // sim_irk_calculate_workspace_size(dims, opts_));
 
@@ -772,6 +799,9 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
     int num_steps = opts->num_steps;
     double step = in->T / num_steps;
 
+    // the last stage lies at the end of the step, e.g. Radau IIA
+    bool stiffly_accurate = opts->c_vec[ns-1] == 1.0;
+
     int *ipiv = workspace->ipiv;
     double *Z_work = workspace->Z_work;
 
@@ -807,6 +837,12 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
     // for hessians only
     struct blasfeo_dmat *Hess = &workspace->Hess;
 
+    // for simplified Newton only
+    bool simplified_newton = opts->scheme->type != exact;
+    struct blasfeo_dmat *dG_dK_simplified = &workspace->dG_dK_simplified;
+    struct blasfeo_dvec *rG_simplified = &workspace->rG_simplified;
+    int *ipiv_simplified = workspace->ipiv_simplified;
+
     double *x_out = out->xn;
     double *S_forw_out = out->S_forw;
     double *S_adj_out = out->S_adj;
@@ -816,6 +852,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
     acados_timer timer, timer_ad, timer_la;
 
     double a;
+    bool update_jac;
     struct blasfeo_dmat *dG_dK_ss;
     struct blasfeo_dmat *dG_dxu_ss;
     struct blasfeo_dmat *dK_dxu_ss;
@@ -959,7 +996,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
             blasfeo_dgecp(nx, nx + nu, &S_forw[ss], 0, 0, S_forw_ss, 0, 0);
 
             // copy last jacobian factorization into dG_dK_ss
-            if (ss > 0 && opts->jac_reuse) {
+            if (ss > 0 && opts->jac_reuse && !simplified_newton) {
                 blasfeo_dgecp(nK, nK, &dG_dK[ss-1], 0, 0, dG_dK_ss, 0, 0);
                 for (int ii = 0; ii < nK; ii++) {
                     ipiv_ss[ii] = ipiv[nK*(ss-1) + ii];
@@ -980,7 +1017,14 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
 
         for (int iter = 0; iter < newton_iter; iter++)
         {
-            if ((opts->jac_reuse && (ss == 0) && (iter == 0)) || (!opts->jac_reuse))
+            // simplified Newton: jacobians evaluated once per integration step (or only in the
+            // first one with jac_reuse), at the first stage
+            if (simplified_newton)
+                update_jac = (iter == 0) && (ss == 0 || !opts->jac_reuse);
+            else
+                update_jac = (opts->jac_reuse && (ss == 0) && (iter == 0)) || (!opts->jac_reuse);
+
+            if (update_jac && !simplified_newton)
             {
                 // if new jacobian gets computed, initialize dG_dK_ss with zeros
                 blasfeo_dgese(nK, nK, 0.0, dG_dK_ss, 0, 0);
@@ -1004,7 +1048,15 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                 impl_ode_res_out.xi = ii * (nx + nz);  // store output in this position of rG
 
                 // compute the residual of implicit ode at time t_ii
-                if ((opts->jac_reuse && (ss == 0) && (iter == 0)) || (!opts->jac_reuse))
+                if (update_jac && simplified_newton && ii == 0)
+                {   // evaluate the ode function & jacobian w.r.t. x, xdot, z
+                    acados_tic(&timer_ad);
+                    model->impl_ode_fun_jac_x_xdot_z->evaluate(
+                        model->impl_ode_fun_jac_x_xdot_z, impl_ode_type_in, impl_ode_in,
+                        impl_ode_fun_jac_x_xdot_z_type_out, impl_ode_fun_jac_x_xdot_z_out);
+                    timing_ad += acados_toc(&timer_ad);
+                }
+                else if (update_jac && !simplified_newton)
                 {   // evaluate the ode function & jacobian w.r.t. x, xdot;
                     // &  compute jacobian dG_dK_ss;
                     acados_tic(&timer_ad);
@@ -1044,25 +1096,40 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
             }  // end ii
 
             acados_tic(&timer_la);
-            // DGETRF computes an LU factorization of a general M-by-N matrix A
-            // using partial pivoting with row interchanges.
-            // printf("dG_dK_ss = (IRK) \n");
-            // blasfeo_print_exp_dmat((nz+nx) *ns, (nz+nx) *ns, dG_dK_ss, 0, 0);
-            if ((opts->jac_reuse && (ss == 0) && (iter == 0)) || (!opts->jac_reuse))
+            if (simplified_newton)
             {
-                blasfeo_dgetrf_rp(nK, nK, dG_dK_ss, 0, 0, dG_dK_ss, 0, 0, ipiv_ss);
+                // factorize only the real blocks of the transformed Newton matrix
+                if (update_jac)
+                {
+                    simplified_newton_factorize(ns, nx, nz, step, opts->scheme, df_dx, df_dxdot,
+                                                df_dz, dG_dK_simplified, ipiv_simplified);
+                }
+                // solve for [DeltaK, DeltaZ], store it in rG
+                simplified_newton_solve(ns, nx, nz, opts->scheme, dG_dK_simplified,
+                                        ipiv_simplified, rG, rG_simplified, rG);
             }
+            else
+            {
+                // DGETRF computes an LU factorization of a general M-by-N matrix A
+                // using partial pivoting with row interchanges.
+                // printf("dG_dK_ss = (IRK) \n");
+                // blasfeo_print_exp_dmat((nz+nx) *ns, (nz+nx) *ns, dG_dK_ss, 0, 0);
+                if (update_jac)
+                {
+                    blasfeo_dgetrf_rp(nK, nK, dG_dK_ss, 0, 0, dG_dK_ss, 0, 0, ipiv_ss);
+                }
 
-            // permute also the r.h.s
-            blasfeo_dvecpe(nK, ipiv_ss, rG, 0);
+                // permute also the r.h.s
+                blasfeo_dvecpe(nK, ipiv_ss, rG, 0);
 
-            // solve dG_dK_ss * y = rG, dG_dK_ss on the (l)eft, (l)ower-trian, (n)o-trans
-            // (u)nit trian
-            blasfeo_dtrsv_lnu(nK, dG_dK_ss, 0, 0, rG, 0, rG, 0);
+                // solve dG_dK_ss * y = rG, dG_dK_ss on the (l)eft, (l)ower-trian, (n)o-trans
+                // (u)nit trian
+                blasfeo_dtrsv_lnu(nK, dG_dK_ss, 0, 0, rG, 0, rG, 0);
 
-            // solve dG_dK_ss * x = rG, dG_dK_ss on the (l)eft, (u)pper-trian, (n)o-trans
-            // (n)o unit trian , and store x in rG
-            blasfeo_dtrsv_unn(nK, dG_dK_ss, 0, 0, rG, 0, rG, 0);
+                // solve dG_dK_ss * x = rG, dG_dK_ss on the (l)eft, (u)pper-trian, (n)o-trans
+                // (n)o unit trian , and store x in rG
+                blasfeo_dtrsv_unn(nK, dG_dK_ss, 0, 0, rG, 0, rG, 0);
+            }
 
             timing_la += acados_toc(&timer_la);
 
@@ -1164,8 +1231,9 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
             blasfeo_daxpy(nx, step * b_vec[ii], K, ii * nx, xn, 0, xn, 0);
         }
 
-        // algebraic variables output and corresponding sensitivity propagation
-        if (ss == 0)
+        // algebraic variables output and corresponding sensitivity propagation,
+        // at the start of the interval if the tableau is not stiffly accurate
+        if (ss == 0 && !stiffly_accurate)
         {
             // generate z output
             if ((opts->output_z || opts->sens_algebraic) && nz > 0)
@@ -1320,6 +1388,23 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
             // store last xdot, z values for next initialization
             blasfeo_unpack_dvec(nx, K, (ns-1) * nx, mem->xdot, 1);
             blasfeo_unpack_dvec(nz, K, (ns-1) * nz + ns*nx, mem->z, 1);
+
+            // stiffly accurate: the last stage satisfies the DAE at the end of the interval,
+            // together with xn, so z and its sensitivities are taken from it directly
+            if (stiffly_accurate && nz > 0)
+            {
+                if (opts->output_z || opts->sens_algebraic)
+                    blasfeo_unpack_dvec(nz, K, (ns-1) * nz + ns*nx, out->zn, 1);
+
+                if (opts->sens_algebraic)
+                {
+                    // NOTE: dK_dxu_ss is -dK_dxu, see the forward sensitivity update
+                    for (int jj = 0; jj < nx+nu; jj++)
+                        for (int ii = 0; ii < nz; ii++)
+                            S_algebraic[ii+jj*nz] =
+                                -blasfeo_dgeex1(dK_dxu_ss, nx*ns+(ns-1)*nz+ii, jj);
+                }
+            }
         }
     }  // end step loop (ss)
 
@@ -125,6 +125,12 @@ typedef struct
     struct blasfeo_dvec *xn_traj;  // xn trajectory
     struct blasfeo_dvec *K_traj;   // K trajectory
 
+    // only allocated if (opts->scheme->type != exact), simplified Newton
+    struct blasfeo_dmat dG_dK_simplified;  // factorized real blocks of the transformed
+                                           // Newton matrix ((nx+nz)*ns, 2*(nx+nz))
+    struct blasfeo_dvec rG_simplified;     // transformed residuals ((nx+nz)*ns)
+    int *ipiv_simplified;                  // pivots of the blocks ((nx+nz)*ns)
+
     /* the following variables are only available if (opts->sens_hess) */
     // For Hessian propagation
     struct blasfeo_dmat Hess;   // temporary Hessian (nx + nu, nx + nu)
@@ -200,8 +200,10 @@ int sim_lifted_irk_opts_calculate_size(void *config_, void *dims)
     size += ns_max * sizeof(double);           // b_vec
     size += ns_max * sizeof(double);           // c_vec
 
-    int tmp0 = gauss_nodes_work_calculate_size(ns_max);
-    int tmp1 = butcher_table_work_calculate_size(ns_max);
+    size += newton_scheme_calculate_size(ns_max);  // scheme
+
+    int tmp0 = calculate_butcher_tableau_work_size(ns_max);
+    int tmp1 = gauss_simplified_work_calculate_size(ns_max);
     int work_size = tmp0 > tmp1 ? tmp0 : tmp1;
     size += work_size;  // work
 
@@ -228,9 +230,13 @@ void *sim_lifted_irk_opts_assign(void *config_, void *dims, void *raw_memory)
     assign_and_advance_double(ns_max, &opts->b_vec, &c_ptr);
     assign_and_advance_double(ns_max, &opts->c_vec, &c_ptr);
 
+    // scheme
+    opts->scheme = newton_scheme_assign(ns_max, c_ptr);
+    c_ptr += newton_scheme_calculate_size(ns_max);
+
     // work
-    int tmp0 = gauss_nodes_work_calculate_size(ns_max);
-    int tmp1 = butcher_table_work_calculate_size(ns_max);
+    int tmp0 = calculate_butcher_tableau_work_size(ns_max);
+    int tmp1 = gauss_simplified_work_calculate_size(ns_max);
     int work_size = tmp0 > tmp1 ? tmp0 : tmp1;
     opts->work = c_ptr;
     c_ptr += work_size;
@@ -257,15 +263,16 @@ void sim_lifted_irk_opts_initialize_default(void *config_, void *dims_, void *op
     // set tableau size
     opts->tableau_size = opts->ns;
 
-    // gauss collocation nodes
-    gauss_nodes(ns, opts->c_vec, opts->work);
+    // collocation nodes
+    opts->collocation_type = GAUSS_LEGENDRE;
 
     // butcher tableau
-    butcher_table(ns, opts->c_vec, opts->b_vec, opts->A_mat, opts->work);
+    calculate_butcher_tableau(ns, opts->collocation_type, opts->c_vec, opts->b_vec, opts->A_mat,
+                              opts->work);
 
     // default options
     opts->newton_iter = 1;
-    opts->scheme = NULL;
+    opts->scheme->type = exact;
     opts->num_steps = 1;
     opts->num_forw_sens = nx + nu;
     opts->sens_forw = true;
@@ -291,11 +298,13 @@ void sim_lifted_irk_opts_update(void *config_, void *dims, void *opts_)
     // set tableau size
     opts->tableau_size = opts->ns;
 
-    // gauss collocation nodes
-    gauss_nodes(ns, opts->c_vec, opts->work);
-
     // butcher tableau
-    butcher_table(ns, opts->c_vec, opts->b_vec, opts->A_mat, opts->work);
+    calculate_butcher_tableau(ns, opts->collocation_type, opts->c_vec, opts->b_vec, opts->A_mat,
+                              opts->work);
+
+    // simplified Newton transformation
+    if (opts->scheme->type != exact)
+        gauss_simplified(ns, opts->collocation_type, opts->scheme, opts->work);
 
     return;
 }
@@ -528,6 +537,15 @@ int sim_lifted_irk_workspace_calculate_size(void *config_, void *dims_, void *op
 
     size += nx * ns * sizeof(int);  // ipiv
 
+    size += 3 * sizeof(struct blasfeo_dmat);  // JGK_simplified, JKf_update, JKf_tmp
+    size += 1 * sizeof(struct blasfeo_dvec);  // rG_simplified
+    if (opts->scheme->type != exact)
+    {
+        size += blasfeo_memsize_dmat(nx * ns, 2 * nx);       // JGK_simplified
+        size += 2 * blasfeo_memsize_dmat(nx * ns, nx + nu);  // JKf_update, JKf_tmp
+        size += blasfeo_memsize_dvec(nx * ns);               // rG_simplified
+    }
+
     make_int_multiple_of(64, &size);
     size += 1 * 64;
 
@@ -578,11 +596,22 @@ static void *sim_lifted_irk_cast_workspace(void *config_, void *dims_, void *opt
     workspace->w = (struct blasfeo_dvec *) c_ptr;
     c_ptr += sizeof(struct blasfeo_dvec);
 
+    assign_and_advance_blasfeo_dmat_structs(1, &workspace->JGK_simplified, &c_ptr);
+    assign_and_advance_blasfeo_dmat_structs(1, &workspace->JKf_update, &c_ptr);
+    assign_and_advance_blasfeo_dmat_structs(1, &workspace->JKf_tmp, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(1, &workspace->rG_simplified, &c_ptr);
+
     align_char_to(64, &c_ptr);
 
     assign_and_advance_blasfeo_dmat_mem(nx, nx, workspace->J_temp_x, &c_ptr);
     assign_and_advance_blasfeo_dmat_mem(nx, nx, workspace->J_temp_xdot, &c_ptr);
     assign_and_advance_blasfeo_dmat_mem(nx, nu, workspace->J_temp_u, &c_ptr);
+    if (opts->scheme->type != exact)
+    {
+        assign_and_advance_blasfeo_dmat_mem(nx * ns, 2 * nx, workspace->JGK_simplified, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nx * ns, nx + nu, workspace->JKf_update, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nx * ns, nx + nu, workspace->JKf_tmp, &c_ptr);
+    }
 
     assign_and_advance_blasfeo_dvec_mem(nx * ns, workspace->rG, &c_ptr);
     assign_and_advance_blasfeo_dvec_mem(nx, workspace->xt, &c_ptr);
@@ -590,6 +619,8 @@ static void *sim_lifted_irk_cast_workspace(void *config_, void *dims_, void *opt
     assign_and_advance_blasfeo_dvec_mem(nx, workspace->xn_out, &c_ptr);
     assign_and_advance_blasfeo_dvec_mem(nx, workspace->dxn, &c_ptr);
     assign_and_advance_blasfeo_dvec_mem(nx + nu, workspace->w, &c_ptr);
+    if (opts->scheme->type != exact)
+        assign_and_advance_blasfeo_dvec_mem(nx * ns, workspace->rG_simplified, &c_ptr);
 
     assign_and_advance_int(nx * ns, &workspace->ipiv, &c_ptr);
 
@@ -694,6 +725,13 @@ int sim_lifted_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *m
 
     struct blasfeo_dvec *w = workspace->w;
 
+    // simplified Newton
+    bool simplified_newton = opts->scheme->type != exact;
+    struct blasfeo_dmat *JGK_simplified = workspace->JGK_simplified;
+    struct blasfeo_dmat *JKf_update = workspace->JKf_update;
+    struct blasfeo_dmat *JKf_tmp = workspace->JKf_tmp;
+    struct blasfeo_dvec *rG_simplified = workspace->rG_simplified;
+
     double *x_out = out->xn;
     double *S_forw_out = out->S_forw;
 
@@ -754,8 +792,9 @@ int sim_lifted_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *m
         blasfeo_pack_dvec(nx, in->x, 1, mem->x, 0);
         blasfeo_pack_dvec(nu, in->u, 1, mem->u, 0);
 
-        // reset value of JKf
-        blasfeo_dgese(nx * ns, nx + nu, 0.0, &JKf[ss], 0, 0);
+        // reset value of JKf, kept as initial guess for the iterated sensitivities otherwise
+        if (!simplified_newton)
+            blasfeo_dgese(nx * ns, nx + nu, 0.0, &JKf[ss], 0, 0);
 
         for (ii = 0; ii < ns; ii++)  // ii-th row of tableau
         {
@@ -831,6 +870,15 @@ int sim_lifted_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *m
                 blasfeo_dgecp(nx, nx, J_temp_x, 0, 0, JGf, ii * nx, 0);
                 blasfeo_dgecp(nx, nu, J_temp_u, 0, 0, JGf, ii * nx, nx);
 
+                // simplified Newton: factorize the transformed blocks with the first stage jacobians
+                if (simplified_newton && ii == 0)
+                {
+                    acados_tic(&timer_la);
+                    simplified_newton_factorize(ns, nx, 0, step, opts->scheme, J_temp_x,
+                                                J_temp_xdot, NULL, JGK_simplified, ipiv);
+                    out->info->LAtime += acados_toc(&timer_la);
+                }
+
                 for (jj = 0; jj < ns; jj++)
                 {
                     // compute the block (ii,jj)th block of JGK
@@ -855,7 +903,7 @@ int sim_lifted_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *m
         // DGETRF computes an LU factorization of a general M-by-N matrix A
         // using partial pivoting with row interchanges.
 
-        if (update_sens)
+        if (update_sens && !simplified_newton)
         {
             blasfeo_dgetrf_rp(nx * ns, nx * ns, JGK, 0, 0, JGK, 0, 0, ipiv);
         }
@@ -863,17 +911,24 @@ int sim_lifted_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *m
         // update r.h.s (6.23, Quirynen2017)
         blasfeo_dgemv_n(nx * ns, nx, 1.0, JGf, 0, 0, dxn, 0, 1.0, rG, 0, rG, 0);
 
+        if (simplified_newton)
+        {
+            simplified_newton_solve(ns, nx, 0, opts->scheme, JGK_simplified, ipiv, rG,
+                                    rG_simplified, rG);
+        }
+        else
+        {
+            // permute also the r.h.s
+            blasfeo_dvecpe(nx * ns, ipiv, rG, 0);
 
-        // permute also the r.h.s
-        blasfeo_dvecpe(nx * ns, ipiv, rG, 0);
-
-        // solve JGK * y = rG, JGK on the (l)eft, (l)ower-trian, (n)o-trans
-        //                    (u)nit trian
-        blasfeo_dtrsv_lnu(nx * ns, JGK, 0, 0, rG, 0, rG, 0);
+            // solve JGK * y = rG, JGK on the (l)eft, (l)ower-trian, (n)o-trans
+            //                    (u)nit trian
+            blasfeo_dtrsv_lnu(nx * ns, JGK, 0, 0, rG, 0, rG, 0);
 
-        // solve JGK * x = rG, JGK on the (l)eft, (u)pper-trian, (n)o-trans
-        //                    (n)o unit trian , and store x in rG
-        blasfeo_dtrsv_unn(nx * ns, JGK, 0, 0, rG, 0, rG, 0);
+            // solve JGK * x = rG, JGK on the (l)eft, (u)pper-trian, (n)o-trans
+            //                    (n)o unit trian , and store x in rG
+            blasfeo_dtrsv_unn(nx * ns, JGK, 0, 0, rG, 0, rG, 0);
+        }
 
 
         // scale and add a generic strmat into a generic strmat // K = K - rG, where rG is DeltaK
@@ -883,23 +938,47 @@ int sim_lifted_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *m
         for (ii = 0; ii < ns; ii++)
             blasfeo_daxpy(nx, -step * b_vec[ii], rG, ii * nx, dxn, 0, dxn, 0);
 
-        // update JKf
-        // JKf[ss] = JGf * S_forw;
-        if (in->identity_seed && ss == 0) // omit matrix multiplication for identity seed
-            blasfeo_dgecp(nx * ns, nx + nu, JGf, 0, 0, &JKf[ss], 0, 0);
-        else
+        if (simplified_newton)
         {
-            blasfeo_dgemm_nn(nx * ns, nx + nu, nx, 1.0, JGf, 0, 0, S_forw, 0, 0, 0.0, &JKf[ss], 0, 0,
-                            &JKf[ss], 0, 0);
-            blasfeo_dgead(nx * ns, nu, 1.0, JGf, 0, nx, &JKf[ss], 0, nx);
+            // iterated sensitivities: one simplified Newton step on JGK * JKf = JGf * S_forw
+            // JKf_update = JGf * S_forw - JGK * JKf[ss]
+            if (in->identity_seed && ss == 0) // omit matrix multiplication for identity seed
+                blasfeo_dgecp(nx * ns, nx + nu, JGf, 0, 0, JKf_update, 0, 0);
+            else
+            {
+                blasfeo_dgemm_nn(nx * ns, nx + nu, nx, 1.0, JGf, 0, 0, S_forw, 0, 0, 0.0,
+                                 JKf_update, 0, 0, JKf_update, 0, 0);
+                blasfeo_dgead(nx * ns, nu, 1.0, JGf, 0, nx, JKf_update, 0, nx);
+            }
+            acados_tic(&timer_la);
+            blasfeo_dgemm_nn(nx * ns, nx + nu, nx * ns, -1.0, JGK, 0, 0, &JKf[ss], 0, 0, 1.0,
+                             JKf_update, 0, 0, JKf_update, 0, 0);
+
+            simplified_newton_solve_mat(ns, nx, 0, nx + nu, opts->scheme, JGK_simplified, ipiv,
+                                        JKf_update, JKf_tmp, JKf_update);
+            blasfeo_dgead(nx * ns, nx + nu, 1.0, JKf_update, 0, 0, &JKf[ss], 0, 0);
+            out->info->LAtime += acados_toc(&timer_la);
         }
+        else
+        {
+            // update JKf
+            // JKf[ss] = JGf * S_forw;
+            if (in->identity_seed && ss == 0) // omit matrix multiplication for identity seed
+                blasfeo_dgecp(nx * ns, nx + nu, JGf, 0, 0, &JKf[ss], 0, 0);
+            else
+            {
+                blasfeo_dgemm_nn(nx * ns, nx + nu, nx, 1.0, JGf, 0, 0, S_forw, 0, 0, 0.0,
+                                 &JKf[ss], 0, 0, &JKf[ss], 0, 0);
+                blasfeo_dgead(nx * ns, nu, 1.0, JGf, 0, nx, &JKf[ss], 0, nx);
+            }
 
-        // solve linear system
-        acados_tic(&timer_la);
-        blasfeo_drowpe(nx * ns, ipiv, &JKf[ss]);
-        blasfeo_dtrsm_llnu(nx * ns, nx + nu, 1.0, JGK, 0, 0, &JKf[ss], 0, 0, &JKf[ss], 0, 0);
-        blasfeo_dtrsm_lunn(nx * ns, nx + nu, 1.0, JGK, 0, 0, &JKf[ss], 0, 0, &JKf[ss], 0, 0);
-        out->info->LAtime += acados_toc(&timer_la);
+            // solve linear system
+            acados_tic(&timer_la);
+            blasfeo_drowpe(nx * ns, ipiv, &JKf[ss]);
+            blasfeo_dtrsm_llnu(nx * ns, nx + nu, 1.0, JGK, 0, 0, &JKf[ss], 0, 0, &JKf[ss], 0, 0);
+            blasfeo_dtrsm_lunn(nx * ns, nx + nu, 1.0, JGK, 0, 0, &JKf[ss], 0, 0, &JKf[ss], 0, 0);
+            out->info->LAtime += acados_toc(&timer_la);
+        }
 
         // update forward sensitivity
         for (jj = 0; jj < ns; jj++)
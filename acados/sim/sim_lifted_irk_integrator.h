@@ -77,6 +77,12 @@ typedef struct
     struct blasfeo_dvec *dxn;     // dx at each integration step
     struct blasfeo_dvec *w;       // stacked x and u
 
+    // simplified Newton, memory only allocated if (opts->scheme->type != exact)
+    struct blasfeo_dmat *JGK_simplified;  // factorized blocks of transformed JGK (nx*ns, 2*nx)
+    struct blasfeo_dmat *JKf_update;      // iterated sensitivity update (nx*ns, nx+nu)
+    struct blasfeo_dmat *JKf_tmp;         // temporary (nx*ns, nx+nu)
+    struct blasfeo_dvec *rG_simplified;   // transformed residuals (nx*ns)
+
     int *ipiv;  // index of pivot vector
 
 } sim_lifted_irk_workspace;
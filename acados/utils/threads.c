@@ -0,0 +1,122 @@
+/*
+ * Copyright 2019 Gianluca Frison, Dimitris Kouzoupis, Robin Verschueren,
+ * Andrea Zanelli, Niels van Duijkeren, Jonathan Frey, Tommaso Sartor,
+ * Branimir Novoselnik, Rien Quirynen, Rezart Qelibari, Dang Doan,
+ * Jonas Koenemann, Yutao Chen, Tobias Schöls, Jonas Schlagenhauf, Moritz Diehl
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE  // CPU_SET, sched_setaffinity
+#endif
+
+#include "acados/utils/threads.h"
+
+#include <stdlib.h>
+
+#if defined(__linux__)
+#include <sched.h>
+#elif defined _WIN32 || defined _WIN64
+#include <Windows.h>
+#endif
+
+#if defined(ACADOS_WITH_THREADS)
+#if (defined _WIN32 || defined _WIN64) && !(defined __MINGW32__ || defined __MINGW64__)
+
+#include <process.h>
+
+static unsigned __stdcall acados_thread_entry(void *arg)
+{
+    acados_thread *t = (acados_thread *) arg;
+    t->fun(t->arg);
+    return 0;
+}
+
+int acados_thread_create(acados_thread *t, void (*fun)(void *), void *arg)
+{
+    t->fun = fun;
+    t->arg = arg;
+    t->handle = (HANDLE) _beginthreadex(NULL, 0, &acados_thread_entry, t, 0, NULL);
+    return t->handle == 0;
+}
+
+void acados_thread_join(acados_thread *t)
+{
+    WaitForSingleObject(t->handle, INFINITE);
+    CloseHandle(t->handle);
+}
+
+#else
+
+static void *acados_thread_entry(void *arg)
+{
+    acados_thread *t = (acados_thread *) arg;
+    t->fun(t->arg);
+    return NULL;
+}
+
+int acados_thread_create(acados_thread *t, void (*fun)(void *), void *arg)
+{
+    t->fun = fun;
+    t->arg = arg;
+    return pthread_create(&t->handle, NULL, &acados_thread_entry, t);
+}
+
+void acados_thread_join(acados_thread *t) { pthread_join(t->handle, NULL); }
+
+#endif  // (defined _WIN32 || _WIN64)
+
+#else  // Run the task in place when threads are off
+
+int acados_thread_create(acados_thread *t, void (*fun)(void *), void *arg)
+{
+    t->fun = fun;
+    t->arg = arg;
+    t->fun(t->arg);
+    return 0;
+}
+
+void acados_thread_join(acados_thread *t) {}
+
+#endif  // ACADOS_WITH_THREADS
+
+
+
+int acados_thread_pin(int core)
+{
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    return sched_setaffinity(0, sizeof(cpu_set_t), &set);
+#elif defined _WIN32 || defined _WIN64
+    return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR) 1 << core) == 0;
+#else
+    return 1;
+#endif
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright 2019 Gianluca Frison, Dimitris Kouzoupis, Robin Verschueren,
+ * Andrea Zanelli, Niels van Duijkeren, Jonathan Frey, Tommaso Sartor,
+ * Branimir Novoselnik, Rien Quirynen, Rezart Qelibari, Dang Doan,
+ * Jonas Koenemann, Yutao Chen, Tobias Schöls, Jonas Schlagenhauf, Moritz Diehl
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+#ifndef ACADOS_UTILS_THREADS_H_
+#define ACADOS_UTILS_THREADS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(ACADOS_WITH_THREADS)
+#if (defined _WIN32 || defined _WIN64) && !(defined __MINGW32__ || defined __MINGW64__)
+
+#include <Windows.h>
+
+/** A structure for keeping a background thread and its task. */
+typedef struct acados_thread_
+{
+    HANDLE handle;
+    void (*fun)(void *);
+    void *arg;
+} acados_thread;
+
+#else
+
+#include <pthread.h>
+
+/** A structure for keeping a background thread and its task. */
+typedef struct acados_thread_
+{
+    pthread_t handle;
+    void (*fun)(void *);
+    void *arg;
+} acados_thread;
+
+#endif  // (defined _WIN32 || _WIN64)
+
+#else  // ACADOS_WITH_THREADS
+
+/** Without thread support the task is run synchronously in acados_thread_create. */
+typedef struct acados_thread_
+{
+    void (*fun)(void *);
+    void *arg;
+} acados_thread;
+
+#endif  // ACADOS_WITH_THREADS
+
+/** Runs fun(arg) on a new thread; returns 0 on success. */
+int acados_thread_create(acados_thread *t, void (*fun)(void *), void *arg);
+
+/** Blocks until the thread started by acados_thread_create has returned. */
+void acados_thread_join(acados_thread *t);
+
+/** Pins the calling thread to the given core (Linux and Windows); returns 0 on success. */
+int acados_thread_pin(int core);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif  // ACADOS_UTILS_THREADS_H_
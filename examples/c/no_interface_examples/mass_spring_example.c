@@ -53,7 +53,7 @@ ocp_qp_xcond_solver_dims *create_ocp_qp_dims_mass_spring(ocp_qp_xcond_solver_con
 ocp_qp_in *create_ocp_qp_in_mass_spring(ocp_qp_dims *dims);
 // soft constraints
 // TODO
-ocp_qp_dims *create_ocp_qp_dims_mass_spring_soft_constr(int N, int nx_, int nu_, int nb_, int ng_, int ngN);
+ocp_qp_xcond_solver_dims *create_ocp_qp_dims_mass_spring_soft_constr(ocp_qp_xcond_solver_config *config, int N, int nx_, int nu_, int nb_, int ng_, int ngN);
 ocp_qp_in *create_ocp_qp_in_mass_spring_soft_constr(ocp_qp_dims *dims);
 
 // #ifndef ACADOS_WITH_QPDUNES
@@ -175,7 +175,7 @@ int main() {
         // dims
 #ifdef SOFT_CONSTRAINTS
         // TODO
-        ocp_qp_dims *qp_dims = create_ocp_qp_dims_mass_spring_soft_constr(N, nx_, nu_, nb_, ng_, ngN);
+        ocp_qp_xcond_solver_dims *qp_dims = create_ocp_qp_dims_mass_spring_soft_constr(config, N, nx_, nu_, nb_, ng_, ngN);
 #else
         ocp_qp_xcond_solver_dims *qp_dims = create_ocp_qp_dims_mass_spring(config, N, nx_, nu_, nb_, ng_, ngN);
 #endif
@@ -231,6 +231,24 @@ int main() {
                     config->opts_set(config, opts, "mu0", &mu0);
 #endif
 
+                    break;
+                case PARTIAL_CONDENSING_RICCATI:
+                    N2 = N2_values[jj];
+                    printf("\nPartial condensing + Riccati (N2 = %d):\n\n", N2);
+
+                    // the mass spring QP has inequalities, the options go to the HPIPM fallback
+                    config->opts_set(config, opts, "cond_N", &N2);
+                    max_iter = 30;
+                    config->opts_set(config, opts, "iter_max", &max_iter);
+                    break;
+                case PARTIAL_CONDENSING_PARALLEL_RICCATI:
+                    N2 = N2_values[jj];
+                    printf("\nPartial condensing + parallel Riccati (N2 = %d):\n\n", N2);
+
+                    // the mass spring QP has inequalities, the options go to the HPIPM fallback
+                    config->opts_set(config, opts, "cond_N", &N2);
+                    max_iter = 30;
+                    config->opts_set(config, opts, "iter_max", &max_iter);
                     break;
 #ifdef ACADOS_WITH_HPMPC
                 case PARTIAL_CONDENSING_HPMPC:
@@ -597,7 +597,7 @@ ocp_qp_in *create_ocp_qp_in_mass_spring(ocp_qp_dims *dims)
 
 
 
-ocp_qp_dims *create_ocp_qp_dims_mass_spring_soft_constr(int N, int nx_, int nu_, int nb_, int ng_, int ngN)
+ocp_qp_xcond_solver_dims *create_ocp_qp_dims_mass_spring_soft_constr(ocp_qp_xcond_solver_config *config, int N, int nx_, int nu_, int nb_, int ng_, int ngN)
 {
 
     int nbu_ = nu_<nb_ ? nu_ : nb_;
@@ -637,42 +637,34 @@ ocp_qp_dims *create_ocp_qp_dims_mass_spring_soft_constr(int N, int nx_, int nu_,
         nbx[ii] = nbx_;
     }
 
-    int nb[N+1];
-    for (int ii = 0; ii <= N; ii++) {
-        nb[ii] = nbu[ii]+nbx[ii];
-    }
-
     int ng[N+1];
     for (int ii = 0; ii < N; ii++) {
         ng[ii] = ng_;
     }
     ng[N] = ngN;
 
-    int ns[N+1];
+    int nsbu[N+1];
     for (int ii = 0; ii <= N; ii++) {
-        ns[ii] = nbx[ii]+ng[ii];
+        nsbu[ii] = 0;
     }
 
 
 
     // dims
-    int dims_size = ocp_qp_dims_calculate_size(N);
+    int dims_size = ocp_qp_xcond_solver_dims_calculate_size(config, N);
     void *dims_mem = malloc(dims_size);
-    ocp_qp_dims *dims = ocp_qp_dims_assign(N, dims_mem);
+    ocp_qp_xcond_solver_dims *dims = ocp_qp_xcond_solver_dims_assign(config, N, dims_mem);
 
-    dims->N = N;
     for (int ii=0; ii<=N; ii++)
     {
-        dims->nx[ii] = nx[ii];
-        dims->nu[ii] = nu[ii];
-        dims->nb[ii] = nb[ii];
-        dims->ng[ii] = ng[ii];
-        dims->ns[ii] = ns[ii];
-        dims->nsbx[ii] = nbx[ii];
-        dims->nsbu[ii] = 0;
-        dims->nsg[ii] = ng[ii];
-        dims->nbu[ii] = nbu[ii];
-        dims->nbx[ii] = nbx[ii];
+		config->dims_set(config, dims, ii, "nx", &nx[ii]);
+		config->dims_set(config, dims, ii, "nu", &nu[ii]);
+		config->dims_set(config, dims, ii, "nbx", &nbx[ii]);
+		config->dims_set(config, dims, ii, "nbu", &nbu[ii]);
+		config->dims_set(config, dims, ii, "ng", &ng[ii]);
+		config->dims_set(config, dims, ii, "nsbx", &nbx[ii]);
+		config->dims_set(config, dims, ii, "nsbu", &nsbu[ii]);
+		config->dims_set(config, dims, ii, "nsg", &ng[ii]);
     }
 
     return dims;
@@ -1078,7 +1070,7 @@ ocp_qp_in *create_ocp_qp_in_mass_spring_soft_constr(ocp_qp_dims *dims)
 		d_ocp_qp_set_Zu(ii, hZu[ii], qp_in);
 		d_ocp_qp_set_zl(ii, hzl[ii], qp_in);
 		d_ocp_qp_set_zu(ii, hzu[ii], qp_in);
-		d_ocp_qp_set_idxb(ii, hidxs[ii], qp_in);
+		d_ocp_qp_set_idxs(ii, hidxs[ii], qp_in);
 	}
 	d_ocp_qp_set_R(ii, hR[ii], qp_in);
 	d_ocp_qp_set_S(ii, hS[ii], qp_in);
@@ -1096,7 +1088,7 @@ ocp_qp_in *create_ocp_qp_in_mass_spring_soft_constr(ocp_qp_dims *dims)
 	d_ocp_qp_set_Zu(ii, hZu[ii], qp_in);
 	d_ocp_qp_set_zl(ii, hzl[ii], qp_in);
 	d_ocp_qp_set_zu(ii, hzu[ii], qp_in);
-	d_ocp_qp_set_idxb(ii, hidxs[ii], qp_in);
+	d_ocp_qp_set_idxs(ii, hidxs[ii], qp_in);
 
     // free objective
     free(Q);
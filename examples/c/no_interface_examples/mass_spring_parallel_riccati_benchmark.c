@@ -0,0 +1,174 @@
+/*
+ * Copyright 2019 Gianluca Frison, Dimitris Kouzoupis, Robin Verschueren,
+ * Andrea Zanelli, Niels van Duijkeren, Jonathan Frey, Tommaso Sartor,
+ * Branimir Novoselnik, Rien Quirynen, Rezart Qelibari, Dang Doan,
+ * Jonas Koenemann, Yutao Chen, Tobias Schöls, Jonas Schlagenhauf, Moritz Diehl
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+// benchmark of the riccati solvers against hpipm on the mass spring problem without inequalities,
+// for increasing horizon lengths; reports the smallest N at which the parallel riccati is faster
+
+// external
+#include <stdio.h>
+#include <stdlib.h>
+
+// acados
+#include <acados/utils/print.h>
+
+// c interface
+#include <acados_c/ocp_qp_interface.h>
+
+// mass spring helper functions
+ocp_qp_xcond_solver_dims *create_ocp_qp_dims_mass_spring(ocp_qp_xcond_solver_config *config, int N, int nx_, int nu_, int nb_, int ng_, int ngN);
+ocp_qp_in *create_ocp_qp_in_mass_spring(ocp_qp_dims *dims);
+
+#define NREP 20
+
+int main() {
+    printf("\n");
+    printf(" mass spring example: parallel riccati benchmark\n");
+    printf("\n");
+
+    /************************************************
+     * set up dimensions
+     ************************************************/
+
+    int nx_ = 8;   // number of states (it has to be even for the mass-spring system test problem)
+    int nu_ = 3;   // number of inputs (it has to be at least 1 and at most nx_/2)
+    int nb_ = 0;   // only the initial state is bounded
+    int ng_ = 0;
+    int ngN = 0;
+
+    int num_N_values = 7;
+    int N_values[7] = {25, 50, 100, 200, 400, 800, 1600};
+
+    int num_solvers = 3;
+    ocp_qp_solver_t ocp_qp_solvers[3] =
+    {
+        PARTIAL_CONDENSING_HPIPM,
+        PARTIAL_CONDENSING_RICCATI,
+        PARTIAL_CONDENSING_PARALLEL_RICCATI,
+    };
+    const char *solver_names[3] = {"hpipm", "riccati", "parallel riccati"};
+
+    double min_time[7][3];
+
+    int crossover_N = -1;
+
+    /************************************************
+     * benchmark
+     ************************************************/
+
+    for (int jj = 0; jj < num_N_values; jj++)
+    {
+        int N = N_values[jj];
+
+        for (int ii = 0; ii < num_solvers; ii++)
+        {
+            ocp_qp_solver_plan plan;
+            plan.qp_solver = ocp_qp_solvers[ii];
+
+            ocp_qp_xcond_solver_config *config = ocp_qp_xcond_solver_config_create(plan);
+            ocp_qp_xcond_solver_dims *qp_dims = create_ocp_qp_dims_mass_spring(config, N, nx_, nu_, nb_, ng_, ngN);
+            ocp_qp_in *qp_in = create_ocp_qp_in_mass_spring(qp_dims->orig_dims);
+            ocp_qp_out *qp_out = ocp_qp_out_create(qp_dims->orig_dims);
+
+            ocp_qp_xcond_solver_opts *opts = ocp_qp_xcond_solver_opts_create(config, qp_dims);
+
+            // no condensing, all solvers work on the full horizon
+            config->opts_set(config, opts, "cond_N", &N);
+
+            if (plan.qp_solver != PARTIAL_CONDENSING_HPIPM)
+            {
+                int fallback = 0;
+                config->opts_set(config, opts, "fallback", &fallback);
+            }
+
+            ocp_qp_solver *qp_solver = ocp_qp_create(config, qp_dims, opts);
+
+            qp_info *info = (qp_info *) qp_out->misc;
+
+            int acados_return = 0;
+            min_time[jj][ii] = 1e12;
+
+            // run QP solver NREP times and record min timings
+            for (int rep = 0; rep < NREP; rep++)
+            {
+                acados_return += ocp_qp_solve(qp_solver, qp_in, qp_out);
+
+                if (info->total_time < min_time[jj][ii])
+                    min_time[jj][ii] = info->total_time;
+            }
+
+            double res[4];
+            ocp_qp_inf_norm_residuals(qp_dims->orig_dims, qp_in, qp_out, res);
+
+            double max_res = 0.0;
+            for (int kk = 0; kk < 4; kk++)
+                max_res = (res[kk] > max_res) ? res[kk] : max_res;
+
+            printf("N = %5d  %-17s  status %d  res %e  time %e s\n", N, solver_names[ii],
+                   acados_return, max_res, min_time[jj][ii]);
+
+            if (acados_return != 0)
+            {
+                printf("\nerror: %s failed for N = %d\n\n", solver_names[ii], N);
+                exit(1);
+            }
+
+            free(qp_solver);
+            ocp_qp_xcond_solver_config_free(config);
+            ocp_qp_xcond_solver_dims_free(qp_dims);
+            ocp_qp_xcond_solver_opts_free(opts);
+            ocp_qp_in_free(qp_in);
+            ocp_qp_out_free(qp_out);
+        }
+
+        if (crossover_N < 0 && min_time[jj][2] < min_time[jj][0])
+            crossover_N = N;
+    }
+
+    /************************************************
+     * summary
+     ************************************************/
+
+    printf("\n%7s %17s %17s %17s\n", "N", solver_names[0], solver_names[1], solver_names[2]);
+    for (int jj = 0; jj < num_N_values; jj++)
+        printf("%7d %17e %17e %17e\n", N_values[jj], min_time[jj][0], min_time[jj][1], min_time[jj][2]);
+
+    if (crossover_N > 0)
+        printf("\nparallel riccati faster than hpipm from N = %d\n", crossover_N);
+    else
+        printf("\nparallel riccati not faster than hpipm for N <= %d\n", N_values[num_N_values-1]);
+
+    printf("\nsuccess!\n\n");
+
+    return 0;
+}
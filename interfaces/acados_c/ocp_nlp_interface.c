@@ -57,6 +57,7 @@
 #include "acados/ocp_nlp/ocp_nlp_sqp.h"
 #include "acados/ocp_nlp/ocp_nlp_sqp_rti.h"
 #include "acados/utils/mem.h"
+#include "acados/utils/timing.h"
 
 
 /************************************************
@@ -876,6 +877,8 @@ ocp_nlp_solver *ocp_nlp_solver_create(ocp_nlp_config *config, ocp_nlp_dims *dims
 
 void ocp_nlp_solver_destroy(void *solver)
 {
+    ocp_nlp_preparation_wait((ocp_nlp_solver *) solver);
+
     free(solver);
 }
 
@@ -889,6 +892,210 @@ int ocp_nlp_solve(ocp_nlp_solver *solver, ocp_nlp_in *nlp_in, ocp_nlp_out *nlp_o
 
 
 
+// the solvers write to their options during the solve (e.g. the QP warm start in the first SQP
+// iteration), so concurrently solved instances need their own options
+static void ocp_nlp_check_distinct_opts(const char *caller, void **opts, int num_instances)
+{
+    for (int ii = 0; ii < num_instances; ii++)
+    {
+        for (int jj = 0; jj < ii; jj++)
+        {
+            if (opts[ii] == opts[jj])
+            {
+                printf("\nerror: %s: instances %d and %d share the same opts, ", caller, jj, ii);
+                printf("every instance needs its own opts\n");
+                exit(1);
+            }
+        }
+    }
+}
+
+
+
+ocp_nlp_solver **ocp_nlp_solver_batch_create(ocp_nlp_config *config, ocp_nlp_dims *dims,
+                                             void **opts, int num_instances)
+{
+    ocp_nlp_check_distinct_opts("ocp_nlp_solver_batch_create", opts, num_instances);
+
+    int bytes = num_instances * sizeof(ocp_nlp_solver *);
+    bytes += 64;  // align instances
+
+    for (int ii = 0; ii < num_instances; ii++)
+    {
+        config->opts_update(config, dims, opts[ii]);
+
+        // round instance size to cache lines, to avoid false sharing between threads
+        int instance_bytes = ocp_nlp_calculate_size(config, dims, opts[ii]);
+        make_int_multiple_of(64, &instance_bytes);
+        bytes += instance_bytes;
+    }
+
+    void *ptr = acados_calloc(1, bytes);
+
+    char *c_ptr = (char *) ptr;
+
+    ocp_nlp_solver **solvers = (ocp_nlp_solver **) c_ptr;
+    c_ptr += num_instances * sizeof(ocp_nlp_solver *);
+
+    align_char_to(64, &c_ptr);
+
+    for (int ii = 0; ii < num_instances; ii++)
+    {
+        solvers[ii] = ocp_nlp_assign(config, dims, opts[ii], c_ptr);
+
+        int instance_bytes = ocp_nlp_calculate_size(config, dims, opts[ii]);
+        make_int_multiple_of(64, &instance_bytes);
+        c_ptr += instance_bytes;
+    }
+
+    assert((char *) ptr + bytes >= c_ptr);
+
+    return solvers;
+}
+
+
+
+void ocp_nlp_solver_batch_destroy(ocp_nlp_solver **solvers, int num_instances)
+{
+    for (int ii = 0; ii < num_instances; ii++)
+        ocp_nlp_preparation_wait(solvers[ii]);
+
+    free(solvers);
+}
+
+
+
+int ocp_nlp_solve_batch(ocp_nlp_solver **solvers, ocp_nlp_in **nlp_in, ocp_nlp_out **nlp_out,
+                        int num_instances, int *status, double *time_tot)
+{
+    int batch_status = ACADOS_SUCCESS;
+    int first_failed = num_instances;
+
+    for (int ii = 0; ii < num_instances; ii++)
+    {
+        for (int jj = 0; jj < ii; jj++)
+        {
+            if (solvers[ii]->opts == solvers[jj]->opts)
+            {
+                printf("\nerror: ocp_nlp_solve_batch: solvers %d and %d share the same opts, ",
+                       jj, ii);
+                printf("every instance needs its own opts\n");
+                exit(1);
+            }
+        }
+    }
+
+#if defined(ACADOS_WITH_OPENMP)
+    #pragma omp parallel for schedule(dynamic)
+#endif
+    for (int ii = 0; ii < num_instances; ii++)
+    {
+        acados_timer timer;
+        acados_tic(&timer);
+
+        int instance_status = ocp_nlp_solve(solvers[ii], nlp_in[ii], nlp_out[ii]);
+
+        if (time_tot != NULL)
+            time_tot[ii] = acados_toc(&timer);
+        if (status != NULL)
+            status[ii] = instance_status;
+
+        if (instance_status != ACADOS_SUCCESS)
+        {
+#if defined(ACADOS_WITH_OPENMP)
+            #pragma omp critical
+#endif
+            {
+                if (ii < first_failed)
+                {
+                    first_failed = ii;
+                    batch_status = instance_status;
+                }
+            }
+        }
+    }
+
+    return batch_status;
+}
+
+
+
+static void ocp_nlp_rti_phase_solve(ocp_nlp_solver *solver, ocp_nlp_in *nlp_in,
+                                    ocp_nlp_out *nlp_out, int rti_phase, int *status)
+{
+    ocp_nlp_config *config = solver->config;
+    ocp_nlp_sqp_rti_opts *opts = solver->opts;
+
+    int rti_phase_bkp = opts->rti_phase;
+    config->opts_set(config, opts, "rti_phase", &rti_phase);
+
+    *status = ocp_nlp_solve(solver, nlp_in, nlp_out);
+
+    config->opts_set(config, opts, "rti_phase", &rti_phase_bkp);
+}
+
+
+
+static void ocp_nlp_preparation_task(void *solver_)
+{
+    ocp_nlp_solver *solver = solver_;
+
+    ocp_nlp_rti_phase_solve(solver, solver->prep_in, solver->prep_out, 1, &solver->prep_status);
+}
+
+
+
+int ocp_nlp_preparation_start(ocp_nlp_solver *solver, ocp_nlp_in *nlp_in, ocp_nlp_out *nlp_out)
+{
+    if (solver->config->evaluate != &ocp_nlp_sqp_rti)
+    {
+        printf("\nerror: ocp_nlp_preparation_start: only supported for SQP_RTI solver.\n");
+        exit(1);
+    }
+
+    ocp_nlp_preparation_wait(solver);
+
+    solver->prep_in = nlp_in;
+    solver->prep_out = nlp_out;
+    solver->prep_pending = 1;
+
+    if (acados_thread_create(&solver->prep_thread, &ocp_nlp_preparation_task, solver))
+    {
+        printf("\nerror: ocp_nlp_preparation_start: failed to create thread.\n");
+        exit(1);
+    }
+
+    return ACADOS_READY;
+}
+
+
+
+int ocp_nlp_preparation_wait(ocp_nlp_solver *solver)
+{
+    if (solver->prep_pending)
+    {
+        acados_thread_join(&solver->prep_thread);
+        solver->prep_pending = 0;
+    }
+
+    return solver->prep_status;
+}
+
+
+
+int ocp_nlp_feedback(ocp_nlp_solver *solver, ocp_nlp_in *nlp_in, ocp_nlp_out *nlp_out)
+{
+    int status;
+
+    ocp_nlp_preparation_wait(solver);
+
+    ocp_nlp_rti_phase_solve(solver, nlp_in, nlp_out, 2, &status);
+
+    return status;
+}
+
+
+
 int ocp_nlp_precompute(ocp_nlp_solver *solver, ocp_nlp_in *nlp_in, ocp_nlp_out *nlp_out)
 {
     return solver->config->precompute(solver->config, solver->dims, nlp_in, nlp_out,
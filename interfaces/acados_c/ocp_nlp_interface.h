@@ -46,6 +46,7 @@ extern "C" {
 #include "acados/sim/sim_irk_integrator.h"
 #include "acados/sim/sim_lifted_irk_integrator.h"
 #include "acados/sim/sim_gnsf.h"
+#include "acados/utils/threads.h"
 // acados_c
 #include "acados_c/ocp_qp_interface.h"
 #include "acados_c/sim_interface.h"
@@ -144,6 +145,12 @@ typedef struct ocp_nlp_solver
     void *opts;
     void *mem;
     void *work;
+    // asynchronous RTI preparation
+    acados_thread prep_thread;
+    ocp_nlp_in *prep_in;
+    ocp_nlp_out *prep_out;
+    int prep_pending;
+    int prep_status;
 } ocp_nlp_solver;
 
 
@@ -343,6 +350,40 @@ ocp_nlp_solver *ocp_nlp_solver_create(ocp_nlp_config *config, ocp_nlp_dims *dims
 /// \param solver The solver struct.
 void ocp_nlp_solver_destroy(void *solver);
 
+/// Creates a batch of solvers that share config and dims. Every instance has
+/// its own options struct, since the solvers write to their options during the
+/// solve. The memory and workspace of all instances are laid out contiguously
+/// in a single allocation.
+///
+/// \param config The configuration struct.
+/// \param dims The dimension struct.
+/// \param opts Array of num_instances distinct options structs.
+/// \param num_instances The number of solver instances.
+/// \return Array of num_instances solvers.
+ocp_nlp_solver **ocp_nlp_solver_batch_create(ocp_nlp_config *config, ocp_nlp_dims *dims,
+                                             void **opts, int num_instances);
+
+/// Destructor of a batch of solvers created by ocp_nlp_solver_batch_create.
+///
+/// \param solvers The array of solvers.
+/// \param num_instances The number of solver instances.
+void ocp_nlp_solver_batch_destroy(ocp_nlp_solver **solvers, int num_instances);
+
+/// Solves num_instances optimal control problems, in parallel over the
+/// OpenMP threads if acados is compiled with ACADOS_WITH_OPENMP.
+/// The solvers can come from ocp_nlp_solver_batch_create or be created
+/// individually, each with its own options struct.
+///
+/// \param solvers The array of solvers.
+/// \param nlp_in The array of inputs structs.
+/// \param nlp_out The array of output structs.
+/// \param num_instances The number of problems.
+/// \param status Array of per-instance return status (may be NULL).
+/// \param time_tot Array of per-instance solve time in seconds (may be NULL).
+/// \return ACADOS_SUCCESS, or the status of the first instance that did not succeed.
+int ocp_nlp_solve_batch(ocp_nlp_solver **solvers, ocp_nlp_in **nlp_in, ocp_nlp_out **nlp_out,
+                        int num_instances, int *status, double *time_tot);
+
 /// Solves the optimal control problem. Call ocp_nlp_precompute before
 /// calling this functions (TBC).
 ///
@@ -351,6 +392,31 @@ void ocp_nlp_solver_destroy(void *solver);
 /// \param nlp_out The output struct.
 int ocp_nlp_solve(ocp_nlp_solver *solver, ocp_nlp_in *nlp_in, ocp_nlp_out *nlp_out);
 
+/// Starts the RTI preparation phase (rti_phase 1) of an SQP_RTI solver on a
+/// background thread and returns immediately. Until ocp_nlp_preparation_wait or
+/// ocp_nlp_feedback is called, the solver, nlp_in and nlp_out must not be
+/// modified or queried; the new initial state is set after waiting.
+/// Without ACADOS_WITH_THREADS the preparation runs synchronously.
+///
+/// \param solver The solver struct.
+/// \param nlp_in The inputs struct.
+/// \param nlp_out The output struct.
+int ocp_nlp_preparation_start(ocp_nlp_solver *solver, ocp_nlp_in *nlp_in, ocp_nlp_out *nlp_out);
+
+/// Blocks until a preparation started by ocp_nlp_preparation_start has finished;
+/// returns immediately if none is pending.
+///
+/// \param solver The solver struct.
+/// \return The status of the preparation phase.
+int ocp_nlp_preparation_wait(ocp_nlp_solver *solver);
+
+/// Waits for a pending preparation and performs the RTI feedback phase (rti_phase 2).
+///
+/// \param solver The solver struct.
+/// \param nlp_in The inputs struct.
+/// \param nlp_out The output struct.
+int ocp_nlp_feedback(ocp_nlp_solver *solver, ocp_nlp_in *nlp_in, ocp_nlp_out *nlp_out);
+
 /// Performs precomputations for the solver. Needs to be called before
 /// ocl_nlp_solve (TBC).
 ///
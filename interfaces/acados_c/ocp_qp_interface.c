@@ -41,6 +41,7 @@
 // acados_c
 
 #include "acados/utils/mem.h"
+#include "acados/utils/timing.h"
 
 #include "acados/dense_qp/dense_qp_hpipm.h"
 #include "acados/ocp_qp/ocp_qp_xcond_solver.h"
@@ -56,6 +57,8 @@
 #endif
 
 #include "acados/ocp_qp/ocp_qp_hpipm.h"
+#include "acados/ocp_qp/ocp_qp_riccati.h"
+#include "acados/ocp_qp/ocp_qp_parallel_riccati.h"
 #ifdef ACADOS_WITH_HPMPC
 #include "acados/ocp_qp/ocp_qp_hpmpc.h"
 #endif
@@ -73,6 +76,10 @@
 #include "acados/ocp_qp/ocp_qp_osqp.h"
 #endif
 
+#if defined(ACADOS_WITH_OPENMP)
+#include <omp.h>
+#endif
+
 
 // TODO: no "plan" is entering, rename?!
 void ocp_qp_xcond_solver_config_initialize_from_plan(
@@ -114,6 +121,16 @@ void ocp_qp_xcond_solver_config_initialize_from_plan(
 			ocp_qp_partial_condensing_config_initialize_default(solver_config->xcond);
             break;
 #endif
+        case PARTIAL_CONDENSING_RICCATI:
+			ocp_qp_xcond_solver_config_initialize_default(solver_config);
+            ocp_qp_riccati_config_initialize_default(solver_config->qp_solver);
+			ocp_qp_partial_condensing_config_initialize_default(solver_config->xcond);
+            break;
+        case PARTIAL_CONDENSING_PARALLEL_RICCATI:
+			ocp_qp_xcond_solver_config_initialize_default(solver_config);
+            ocp_qp_parallel_riccati_config_initialize_default(solver_config->qp_solver);
+			ocp_qp_partial_condensing_config_initialize_default(solver_config->xcond);
+            break;
         case FULL_CONDENSING_HPIPM:
 			ocp_qp_xcond_solver_config_initialize_default(solver_config);
             dense_qp_hpipm_config_initialize_default(solver_config->qp_solver);
@@ -278,6 +295,7 @@ void ocp_qp_in_set(ocp_qp_xcond_solver_config *config, ocp_qp_in *in,
                    int stage, char *field, void *value)
 {
     d_ocp_qp_set(field, stage, value, in);
+    ocp_qp_in_mark_changed(in, stage, ocp_qp_in_field_block(field));
 }
 
 
@@ -426,6 +444,123 @@ void ocp_qp_solver_destroy(ocp_qp_solver *solver)
 }
 
 
+
+ocp_qp_solver **ocp_qp_solver_batch_create(ocp_qp_solver *solver, int num_workers)
+{
+    ocp_qp_xcond_solver_config *config = solver->config;
+    ocp_qp_xcond_solver_dims *dims = solver->dims;
+    void *opts = solver->opts;
+
+    if (num_workers <= 0)
+    {
+#if defined(ACADOS_WITH_OPENMP)
+        num_workers = omp_get_max_threads();
+#else
+        num_workers = 1;
+#endif
+    }
+
+    // round worker size to cache lines, to avoid false sharing between threads
+    int worker_bytes = ocp_qp_calculate_size(config, dims, opts);
+    make_int_multiple_of(64, &worker_bytes);
+
+    int bytes = num_workers * sizeof(ocp_qp_solver *);
+    bytes += 64;  // align workers
+    bytes += num_workers * worker_bytes;
+
+    void *ptr = acados_calloc(1, bytes);
+
+    char *c_ptr = (char *) ptr;
+
+    ocp_qp_solver **workers = (ocp_qp_solver **) c_ptr;
+    c_ptr += num_workers * sizeof(ocp_qp_solver *);
+
+    align_char_to(64, &c_ptr);
+
+    for (int ii = 0; ii < num_workers; ii++)
+    {
+        workers[ii] = ocp_qp_assign(config, dims, opts, c_ptr);
+        c_ptr += worker_bytes;
+    }
+
+    assert((char *) ptr + bytes >= c_ptr);
+
+    return workers;
+}
+
+
+
+void ocp_qp_solver_batch_destroy(ocp_qp_solver **workers)
+{
+    free(workers);
+}
+
+
+
+int ocp_qp_solve_batch(ocp_qp_solver **workers, int num_workers, ocp_qp_in **qp_in,
+                       ocp_qp_out **qp_out, int num_qp, int *status,
+                       ocp_qp_batch_info *batch_info)
+{
+    int batch_status = ACADOS_SUCCESS;
+    int first_failed = num_qp;
+    int num_failed = 0;
+    double solve_time = 0.0;
+
+    acados_timer batch_timer;
+    acados_tic(&batch_timer);
+
+#if defined(ACADOS_WITH_OPENMP)
+    #pragma omp parallel for num_threads(num_workers) schedule(dynamic) reduction(+:solve_time)
+#endif
+    for (int ii = 0; ii < num_qp; ii++)
+    {
+#if defined(ACADOS_WITH_OPENMP)
+        ocp_qp_solver *worker = workers[omp_get_thread_num()];
+#else
+        ocp_qp_solver *worker = workers[0];
+#endif
+
+        acados_timer timer;
+        acados_tic(&timer);
+
+        int qp_status = ocp_qp_solve(worker, qp_in[ii], qp_out[ii]);
+
+        solve_time += acados_toc(&timer);
+
+        if (status != NULL)
+            status[ii] = qp_status;
+
+        if (qp_status != ACADOS_SUCCESS)
+        {
+#if defined(ACADOS_WITH_OPENMP)
+            #pragma omp critical
+#endif
+            {
+                num_failed++;
+                if (ii < first_failed)
+                {
+                    first_failed = ii;
+                    batch_status = qp_status;
+                }
+            }
+        }
+    }
+
+    if (batch_info != NULL)
+    {
+        batch_info->num_qp = num_qp;
+        batch_info->num_failed = num_failed;
+        batch_info->num_workers = num_workers;
+        batch_info->total_time = acados_toc(&batch_timer);
+        batch_info->solve_time = solve_time;
+        batch_info->qp_per_second = batch_info->total_time > 0.0 ?
+                                    num_qp / batch_info->total_time : 0.0;
+    }
+
+    return batch_status;
+}
+
+
 // qp residual
 static ocp_qp_res *ocp_qp_res_create(ocp_qp_dims *dims)
 {
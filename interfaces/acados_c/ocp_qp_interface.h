@@ -51,6 +51,8 @@ extern "C" {
 ///   PARTIAL_CONDENSING_OOQP
 ///   PARTIAL_CONDENSING_OSQP
 ///   PARTIAL_CONDENSING_QPDUNES
+///   PARTIAL_CONDENSING_RICCATI
+///   PARTIAL_CONDENSING_PARALLEL_RICCATI
 ///   FULL_CONDENSING_HPIPM
 ///   FULL_CONDENSING_QPOASES
 ///   FULL_CONDENSING_QORE
@@ -81,6 +83,8 @@ typedef enum {
 #else
     PARTIAL_CONDENSING_QPDUNES_NOT_AVAILABLE,
 #endif
+    PARTIAL_CONDENSING_RICCATI,
+    PARTIAL_CONDENSING_PARALLEL_RICCATI,  // chunked over num_threads, O(N/num_threads + num_threads)
     FULL_CONDENSING_HPIPM,
 #ifdef ACADOS_WITH_QPOASES
     FULL_CONDENSING_QPOASES,
@@ -244,6 +248,52 @@ void ocp_qp_x_cond_solver_free(ocp_qp_xcond_solver_config *config,
 /// \param qp_out The output struct.
 int ocp_qp_solve(ocp_qp_solver *solver, ocp_qp_in *qp_in, ocp_qp_out *qp_out);
 
+/// Statistics of a batch of qp solves.
+typedef struct
+{
+    int num_qp;            // number of qps in the batch
+    int num_failed;        // number of qps that did not return ACADOS_SUCCESS
+    int num_workers;       // number of workers available to the batch
+    double total_time;     // wall time of the batch, in seconds
+    double solve_time;     // sum of the per-qp solve times, in seconds
+    double qp_per_second;  // throughput, num_qp / total_time
+} ocp_qp_batch_info;
+
+/// Creates num_workers clones of a qp solver. The clones share config, dims and
+/// opts with the template; their memory and workspace are laid out contiguously
+/// in a single allocation. The memory is cloned once and reused by every call
+/// to ocp_qp_solve_batch.
+///
+/// \param solver The template solver.
+/// \param num_workers The number of workers, the OpenMP maximum number of threads if <= 0.
+/// \return Array of num_workers solvers.
+ocp_qp_solver **ocp_qp_solver_batch_create(ocp_qp_solver *solver, int num_workers);
+
+/// Destructor of a batch of solvers created by ocp_qp_solver_batch_create.
+///
+/// \param workers The array of solvers.
+void ocp_qp_solver_batch_destroy(ocp_qp_solver **workers);
+
+/// Solves num_qp independent qps with the dims of the template solver, in parallel
+/// over the workers if acados is compiled with ACADOS_WITH_OPENMP. The qps are
+/// handed out one at a time, so idle workers take over the remaining qps.
+/// The per-qp qp_info is available in qp_out[ii]->misc. A worker keeps its memory
+/// between qps, so with warm start enabled the result depends on the schedule.
+/// Matrix data kept in the memory (condensed or factorized) is only reused for the
+/// qp_in of the previous solve of the worker, if its matrices were not marked changed.
+///
+/// \param workers The array of solvers from ocp_qp_solver_batch_create.
+/// \param num_workers The number of workers.
+/// \param qp_in The array of inputs structs.
+/// \param qp_out The array of output structs.
+/// \param num_qp The number of qps.
+/// \param status Array of per-qp return status (may be NULL).
+/// \param batch_info Aggregate statistics of the batch (may be NULL).
+/// \return ACADOS_SUCCESS, or the status of the first qp that did not succeed.
+int ocp_qp_solve_batch(ocp_qp_solver **workers, int num_workers, ocp_qp_in **qp_in,
+                       ocp_qp_out **qp_out, int num_qp, int *status,
+                       ocp_qp_batch_info *batch_info);
+
 
 /// Calculates the infinity norm of the residuals.
 ///
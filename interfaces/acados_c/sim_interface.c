@@ -309,6 +309,54 @@ int sim_solve(sim_solver *solver, sim_in *in, sim_out *out)
     return status;
 }
 
+int sim_solve_batch(sim_solver **solver, sim_in **in, sim_out **out, int num_instances, int M,
+                    double *x, double *u, double *xn, double *S_forw)
+{
+    int nx, nu;
+    sim_config *config = solver[0]->config;
+    config->dims_get(config, solver[0]->dims, "nx", &nx);
+    config->dims_get(config, solver[0]->dims, "nu", &nu);
+
+    int nS = nx * (nx + nu);
+    int status = ACADOS_SUCCESS;
+
+#if defined(ACADOS_WITH_OPENMP)
+    #pragma omp parallel for num_threads(num_instances) schedule(static, 1)
+#endif
+    for (int ii = 0; ii < num_instances; ii++)
+    {
+        int jj_start = (ii * M) / num_instances;
+        int jj_end = ((ii + 1) * M) / num_instances;
+
+        for (int jj = jj_start; jj < jj_end; jj++)
+        {
+            for (int kk = 0; kk < nx; kk++)
+                in[ii]->x[kk] = x[jj * nx + kk];
+            for (int kk = 0; kk < nu; kk++)
+                in[ii]->u[kk] = u[jj * nu + kk];
+
+            int flag = sim_solve(solver[ii], in[ii], out[ii]);
+            if (flag != ACADOS_SUCCESS)
+            {
+#if defined(ACADOS_WITH_OPENMP)
+                #pragma omp critical
+#endif
+                status = flag;
+            }
+
+            for (int kk = 0; kk < nx; kk++)
+                xn[jj * nx + kk] = out[ii]->xn[kk];
+            if (S_forw)
+            {
+                for (int kk = 0; kk < nS; kk++)
+                    S_forw[jj * nS + kk] = out[ii]->S_forw[kk];
+            }
+        }
+    }
+
+    return status;
+}
+
 int sim_precompute(sim_solver *solver, sim_in *in, sim_out *out)
 {
     return solver->config->precompute(solver->config, in, out, solver->opts, solver->mem,
@@ -126,6 +126,16 @@ sim_solver *sim_solver_create(sim_config *config, void *dims, void *opts_);
 void sim_solver_destroy(void *solver);
 //
 int sim_solve(sim_solver *solver, sim_in *in, sim_out *out);
+// simulates M trajectories with the same model and options, one trajectory after the other
+// with sim_solve: column jj of x (nx x M) and u (nu x M) is the jj-th initial state and
+// control, column jj of xn (nx x M) and S_forw ((nx * (nx+nu)) x M, may be NULL) the
+// corresponding results; solver, in, out hold num_instances instances created from the same
+// config, dims and opts, each with its own model functions (external functions keep internal
+// workspace), and the trajectories are split into num_instances contiguous chunks (one OpenMP
+// thread each); the speedup over a loop of sim_solve calls comes from the threads only, the
+// integration itself is not vectorized across trajectories
+int sim_solve_batch(sim_solver **solver, sim_in **in, sim_out **out, int num_instances, int M,
+                    double *x, double *u, double *xn, double *S_forw);
 //
 int sim_precompute(sim_solver *solver, sim_in *in, sim_out *out);
 //
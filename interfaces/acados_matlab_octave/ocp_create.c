@@ -354,10 +354,18 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
         plan->ocp_qp_solver_plan.qp_solver = PARTIAL_CONDENSING_QPDUNES;
     }
 #endif
+    else if (!strcmp(qp_solver, "partial_condensing_riccati"))
+    {
+        plan->ocp_qp_solver_plan.qp_solver = PARTIAL_CONDENSING_RICCATI;
+    }
+    else if (!strcmp(qp_solver, "partial_condensing_parallel_riccati"))
+    {
+        plan->ocp_qp_solver_plan.qp_solver = PARTIAL_CONDENSING_PARALLEL_RICCATI;
+    }
     else
     {
         MEX_FIELD_VALUE_NOT_SUPPORTED_SUGGEST(fun_name, "qp_solver", qp_solver,
-             "partial_condensing_hpipm, full_condensing_hpipm, full_condensing_qpoases, partial_condensing_osqp, partial_condensing_hpmpc, partial_condensing_qpdunes");
+             "partial_condensing_hpipm, full_condensing_hpipm, full_condensing_qpoases, partial_condensing_osqp, partial_condensing_hpmpc, partial_condensing_qpdunes, partial_condensing_riccati, partial_condensing_parallel_riccati");
     }
 
 
@@ -838,6 +846,14 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
         {
             ocp_nlp_solver_opts_set(config, opts, "qp_cond_N", &qp_solver_cond_N);
         }
+        else if ( plan->ocp_qp_solver_plan.qp_solver == PARTIAL_CONDENSING_RICCATI )
+        {
+            ocp_nlp_solver_opts_set(config, opts, "qp_cond_N", &qp_solver_cond_N);
+        }
+        else if ( plan->ocp_qp_solver_plan.qp_solver == PARTIAL_CONDENSING_PARALLEL_RICCATI )
+        {
+            ocp_nlp_solver_opts_set(config, opts, "qp_cond_N", &qp_solver_cond_N);
+        }
         #if defined( ACADOS_WITH_HPMPC )
         else if ( plan->ocp_qp_solver_plan.qp_solver == PARTIAL_CONDENSING_HPMPC )
         {
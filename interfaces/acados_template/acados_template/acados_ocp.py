@@ -1965,7 +1965,8 @@ class AcadosOcpOptions:
     def qp_solver(self, qp_solver):
         qp_solvers = ('PARTIAL_CONDENSING_HPIPM', \
                 'FULL_CONDENSING_QPOASES', 'FULL_CONDENSING_HPIPM', \
-                'PARTIAL_CONDENSING_QPDUNES', 'PARTIAL_CONDENSING_OSQP')
+                'PARTIAL_CONDENSING_QPDUNES', 'PARTIAL_CONDENSING_OSQP', \
+                'PARTIAL_CONDENSING_RICCATI', 'PARTIAL_CONDENSING_PARALLEL_RICCATI')
         if qp_solver in qp_solvers:
             self.__qp_solver = qp_solver
         else:
@@ -1194,9 +1194,9 @@ class AcadosOcpSolver:
             :param field_: string, e.g. 'print_level', 'rti_phase', 'initialize_t_slacks', 'step_length'
             :param value_: of type int, float
         """
-        int_fields = ['print_level', 'rti_phase', 'initialize_t_slacks']
-        double_fields = ['step_length', 'tol_eq', 'tol_stat', 'tol_ineq', 'tol_comp']
-        string_fields = ['globalization']
+        int_fields = ['print_level', 'rti_phase', 'initialize_t_slacks', 'cond_in_prep', 'rti_level', 'dyn_sens_reuse']
+        double_fields = ['step_length', 'tol_eq', 'tol_stat', 'tol_ineq', 'tol_comp', 'time_budget']
+        string_fields = ['globalization', 'hess_update']
 
         # check field availability and type
         if field_ in int_fields:
@@ -169,6 +169,8 @@ class AcadosSimSolver:
     """
     def __init__(self, acados_sim_, json_file='acados_sim.json'):
 
+        self.solver_created = False
+
         if isinstance(acados_sim_, AcadosOcp):
             # set up acados_sim_
             acados_sim = AcadosSim()
@@ -211,22 +213,35 @@ class AcadosSimSolver:
         model_name = self.sim_struct.model.name
 
         self.shared_lib = CDLL(shared_lib)
-        getattr(self.shared_lib, f"{model_name}_acados_sim_create")()
 
+        # create capsule
+        getattr(self.shared_lib, f"{model_name}_acados_sim_solver_create_capsule").restype = c_void_p
+        self.capsule = getattr(self.shared_lib, f"{model_name}_acados_sim_solver_create_capsule")()
+
+        getattr(self.shared_lib, f"{model_name}_acados_sim_create").argtypes = [c_void_p]
+        getattr(self.shared_lib, f"{model_name}_acados_sim_create").restype = c_int
+        assert getattr(self.shared_lib, f"{model_name}_acados_sim_create")(self.capsule)==0
+        self.solver_created = True
+
+        getattr(self.shared_lib, f"{model_name}_acados_get_sim_opts").argtypes = [c_void_p]
         getattr(self.shared_lib, f"{model_name}_acados_get_sim_opts").restype = c_void_p
-        self.sim_opts = getattr(self.shared_lib, f"{model_name}_acados_get_sim_opts")()
+        self.sim_opts = getattr(self.shared_lib, f"{model_name}_acados_get_sim_opts")(self.capsule)
 
+        getattr(self.shared_lib, f"{model_name}_acados_get_sim_dims").argtypes = [c_void_p]
         getattr(self.shared_lib, f"{model_name}_acados_get_sim_dims").restype = c_void_p
-        self.sim_dims = getattr(self.shared_lib, f"{model_name}_acados_get_sim_dims")()
+        self.sim_dims = getattr(self.shared_lib, f"{model_name}_acados_get_sim_dims")(self.capsule)
 
+        getattr(self.shared_lib, f"{model_name}_acados_get_sim_config").argtypes = [c_void_p]
         getattr(self.shared_lib, f"{model_name}_acados_get_sim_config").restype = c_void_p
-        self.sim_config = getattr(self.shared_lib, f"{model_name}_acados_get_sim_config")()
+        self.sim_config = getattr(self.shared_lib, f"{model_name}_acados_get_sim_config")(self.capsule)
 
+        getattr(self.shared_lib, f"{model_name}_acados_get_sim_out").argtypes = [c_void_p]
         getattr(self.shared_lib, f"{model_name}_acados_get_sim_out").restype = c_void_p
-        self.sim_out = getattr(self.shared_lib, f"{model_name}_acados_get_sim_out")()
+        self.sim_out = getattr(self.shared_lib, f"{model_name}_acados_get_sim_out")(self.capsule)
 
+        getattr(self.shared_lib, f"{model_name}_acados_get_sim_in").argtypes = [c_void_p]
         getattr(self.shared_lib, f"{model_name}_acados_get_sim_in").restype = c_void_p
-        self.sim_in = getattr(self.shared_lib, f"{model_name}_acados_get_sim_in")()
+        self.sim_in = getattr(self.shared_lib, f"{model_name}_acados_get_sim_in")(self.capsule)
 
         nu = self.sim_struct.dims.nu
         nx = self.sim_struct.dims.nx
@@ -252,7 +267,9 @@ class AcadosSimSolver:
         """
         solve the simulation problem with current input
         """
-        status = getattr(self.shared_lib, f"{self.model_name}_acados_sim_solve")()
+        getattr(self.shared_lib, f"{self.model_name}_acados_sim_solve").argtypes = [c_void_p]
+        getattr(self.shared_lib, f"{self.model_name}_acados_sim_solve").restype = c_int
+        status = getattr(self.shared_lib, f"{self.model_name}_acados_sim_solve")(self.capsule)
         return status
 
 
@@ -320,9 +337,9 @@ class AcadosSimSolver:
         # treat parameters separately
         if field_ == 'p':
             model_name = self.sim_struct.model.name
-            getattr(self.shared_lib, f"{model_name}_acados_sim_update_params").argtypes = [POINTER(c_double)]
+            getattr(self.shared_lib, f"{model_name}_acados_sim_update_params").argtypes = [c_void_p, POINTER(c_double), c_int]
             value_data = cast(value_.ctypes.data, POINTER(c_double))
-            getattr(self.shared_lib, f"{model_name}_acados_sim_update_params")(value_data, value_.shape[0])
+            getattr(self.shared_lib, f"{model_name}_acados_sim_update_params")(self.capsule, value_data, value_.shape[0])
 
         elif field_ in self.settable:
             # TODO(oj): perform dimension check!
@@ -336,7 +353,14 @@ class AcadosSimSolver:
 
 
     def __del__(self):
-        getattr(self.shared_lib, f"{self.model_name}_acados_sim_free")()
+        if self.solver_created:
+            getattr(self.shared_lib, f"{self.model_name}_acados_sim_free").argtypes = [c_void_p]
+            getattr(self.shared_lib, f"{self.model_name}_acados_sim_free").restype = c_int
+            getattr(self.shared_lib, f"{self.model_name}_acados_sim_free")(self.capsule)
+
+            getattr(self.shared_lib, f"{self.model_name}_acados_sim_solver_free_capsule").argtypes = [c_void_p]
+            getattr(self.shared_lib, f"{self.model_name}_acados_sim_solver_free_capsule").restype = c_int
+            getattr(self.shared_lib, f"{self.model_name}_acados_sim_solver_free_capsule")(self.capsule)
 
         try:
             self.dlclose(self.shared_lib._handle)
@@ -1708,6 +1708,26 @@ int {{ model.name }}_acados_solve(nlp_solver_capsule * capsule)
     return solver_status;
 }
 
+{% if solver_options.nlp_solver_type == "SQP_RTI" %}
+int {{ model.name }}_acados_preparation_start(nlp_solver_capsule * capsule)
+{
+    // start the RTI preparation phase, on a background thread with ACADOS_WITH_THREADS
+    return ocp_nlp_preparation_start(capsule->nlp_solver, capsule->nlp_in, capsule->nlp_out);
+}
+
+
+int {{ model.name }}_acados_preparation_wait(nlp_solver_capsule * capsule)
+{
+    return ocp_nlp_preparation_wait(capsule->nlp_solver);
+}
+
+
+int {{ model.name }}_acados_feedback(nlp_solver_capsule * capsule)
+{
+    // wait for the preparation and perform the RTI feedback phase
+    return ocp_nlp_feedback(capsule->nlp_solver, capsule->nlp_in, capsule->nlp_out);
+}
+{% endif %}
 
 int {{ model.name }}_acados_free(nlp_solver_capsule * capsule)
 {
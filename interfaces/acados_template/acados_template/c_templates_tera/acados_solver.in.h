@@ -107,6 +107,13 @@ int {{ model.name }}_acados_free_capsule(nlp_solver_capsule *capsule);
 int {{ model.name }}_acados_create(nlp_solver_capsule * capsule);
 int {{ model.name }}_acados_update_params(nlp_solver_capsule * capsule, int stage, double *value, int np);
 int {{ model.name }}_acados_solve(nlp_solver_capsule * capsule);
+{%- if solver_options.nlp_solver_type == "SQP_RTI" %}
+// RTI in two phases: start the preparation, set the new initial state after waiting for it,
+// then call the feedback
+int {{ model.name }}_acados_preparation_start(nlp_solver_capsule * capsule);
+int {{ model.name }}_acados_preparation_wait(nlp_solver_capsule * capsule);
+int {{ model.name }}_acados_feedback(nlp_solver_capsule * capsule);
+{%- endif %}
 int {{ model.name }}_acados_free(nlp_solver_capsule * capsule);
 void {{ model.name }}_acados_print_stats(nlp_solver_capsule * capsule);
 
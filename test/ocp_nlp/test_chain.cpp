@@ -35,7 +35,9 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <cmath>
 #include <cstdlib>
+#include <cstring>
 
 #include "test/test_utils/eigen.h"
 #include "catch/include/catch.hpp"
@@ -55,6 +57,7 @@
 #include "acados/utils/types.h"
 
 #include "acados/ocp_nlp/ocp_nlp_sqp.h"
+#include "acados/ocp_nlp/ocp_nlp_sqp_rti.h"
 #include "acados/ocp_nlp/ocp_nlp_cost_common.h"
 #include "acados/ocp_nlp/ocp_nlp_cost_ls.h"
 #include "acados/ocp_nlp/ocp_nlp_cost_nls.h"
@@ -91,6 +94,19 @@ typedef enum {
     GENERAL_NONLINEAR
 } constraints_t;
 
+// second solve of the chain, checked against the SQP solution
+typedef enum {
+    CHECK_NONE = 0,
+    CHECK_RTI_LEVEL_C,
+    CHECK_FILTER_LINE_SEARCH,
+    CHECK_RTI_ASYNC,
+    CHECK_DYN_SENS_REUSE,
+    CHECK_TIME_BUDGET,
+    CHECK_HESS_UPDATE,
+    CHECK_INEXACT_QP,
+    CHECK_PARALLEL_WEIGHTED,
+} chain_check_t;
+
 ocp_qp_solver_t qp_solver_enum(std::string const& inString)
 {
     if (inString == "SPARSE_HPIPM") return PARTIAL_CONDENSING_HPIPM;
@@ -759,13 +775,94 @@ void read_final_state(const int nx, const int num_free_masses, double *xN)
 // BROKEN & removed since external function convention changed, input is x, u now.
 
 
+// integrator options of the chain, for the opts of any nlp solver
+static void set_chain_sim_opts(int NN, ocp_nlp_plan *plan, ocp_nlp_opts *nlp_opts)
+{
+    for (int i = 0; i < NN; ++i)
+    {
+        if (plan->nlp_dynamics[i] == CONTINUOUS_MODEL)
+        {
+            ocp_nlp_dynamics_cont_opts *dynamics_stage_opts = (ocp_nlp_dynamics_cont_opts *)
+                                                              nlp_opts->dynamics[i];
+            sim_opts *sim_opts_ = (sim_opts *) dynamics_stage_opts->sim_solver;
+
+            if (plan->sim_solver_plan[i].sim_solver == ERK)
+            {
+                sim_opts_->ns = 4;
+            }
+            else if (plan->sim_solver_plan[i].sim_solver == IRK)
+            {
+                sim_opts_->ns = 2;
+                sim_opts_->jac_reuse = true;
+            }
+        }
+    }
+}
+
+
+
+// largest residual of the last solve
+static double chain_max_res(ocp_nlp_config *config, ocp_nlp_solver *solver)
+{
+    double res[4];
+    ocp_nlp_get(config, solver, "res_stat", &res[0]);
+    ocp_nlp_get(config, solver, "res_eq", &res[1]);
+    ocp_nlp_get(config, solver, "res_ineq", &res[2]);
+    ocp_nlp_get(config, solver, "res_comp", &res[3]);
+
+    double max_res = 0.0;
+    for (int ii = 0; ii < 4; ii++)
+        max_res = (res[ii] > max_res) ? res[ii] : max_res;
+
+    return max_res;
+}
+
+
+
+// largest deviation of the primal variables of out from the ones of ref
+static double chain_max_err(int NN, int *nx, int *nu, ocp_nlp_out *out, ocp_nlp_out *ref)
+{
+    double max_err = 0.0;
+    for (int i = 0; i <= NN; i++)
+    {
+        for (int j = 0; j < nu[i]+nx[i]; j++)
+        {
+            double err = fabs(BLASFEO_DVECEL(out->ux+i, j) - BLASFEO_DVECEL(ref->ux+i, j));
+            max_err = (err > max_err) ? err : max_err;
+        }
+    }
+
+    return max_err;
+}
+
+
+
+// SQP opts with the chain integrators and the same tolerance on all residuals
+static void *chain_sqp_opts_create(int NN, ocp_nlp_plan *plan, ocp_nlp_config *config,
+                                   ocp_nlp_dims *dims, int max_iter, double tol)
+{
+    void *opts = ocp_nlp_solver_opts_create(config, dims);
+    set_chain_sim_opts(NN, plan, ((ocp_nlp_sqp_opts *) opts)->nlp_opts);
+
+    ocp_nlp_solver_opts_set(config, opts, "max_iter", &max_iter);
+    ocp_nlp_solver_opts_set(config, opts, "tol_stat", &tol);
+    ocp_nlp_solver_opts_set(config, opts, "tol_eq", &tol);
+    ocp_nlp_solver_opts_set(config, opts, "tol_ineq", &tol);
+    ocp_nlp_solver_opts_set(config, opts, "tol_comp", &tol);
+
+    return opts;
+}
+
+
+
 void setup_and_solve_nlp(int NN,
     int NMF,
     std::string const& con_str,
     std::string const& cost_str,
     std::string const& qp_solver_str,
     std::string const& model_str,
-    std::string const& integrator_str
+    std::string const& integrator_str,
+    chain_check_t check = CHECK_NONE
     )
 {
     /************************************************
@@ -1380,25 +1477,8 @@ void setup_and_solve_nlp(int NN,
     void *nlp_opts = ocp_nlp_solver_opts_create(config, dims);
     ocp_nlp_sqp_opts *sqp_opts = (ocp_nlp_sqp_opts *) nlp_opts;
 
-    for (int i = 0; i < NN; ++i)
-    {
-        if (plan->nlp_dynamics[i] == CONTINUOUS_MODEL)
-        {
-            ocp_nlp_dynamics_cont_opts *dynamics_stage_opts = (ocp_nlp_dynamics_cont_opts *)
-                                                              sqp_opts->nlp_opts->dynamics[i];
-            sim_opts *sim_opts_ = (sim_opts *) dynamics_stage_opts->sim_solver;
+    set_chain_sim_opts(NN, plan, sqp_opts->nlp_opts);
 
-            if (plan->sim_solver_plan[i].sim_solver == ERK)
-            {
-                sim_opts_->ns = 4;
-            }
-            else if (plan->sim_solver_plan[i].sim_solver == IRK)
-            {
-                sim_opts_->ns = 2;
-                sim_opts_->jac_reuse = true;
-            }
-        }
-    }
     int max_iter = MAX_SQP_ITERS;
     double tol_stat = 1e-6;
     double tol_eq   = 1e-6;
@@ -1436,23 +1516,408 @@ void setup_and_solve_nlp(int NN,
     // call nlp solver
     status = ocp_nlp_solve(solver, nlp_in, nlp_out);
 
-    double max_res = 0.0;
-
-    double inf_norm_res_stat, inf_norm_res_eq, inf_norm_res_ineq, inf_norm_res_comp;
-    ocp_nlp_get(config, solver, "res_stat", &inf_norm_res_stat);
-    ocp_nlp_get(config, solver, "res_eq", &inf_norm_res_eq);
-    ocp_nlp_get(config, solver, "res_ineq", &inf_norm_res_ineq);
-    ocp_nlp_get(config, solver, "res_comp", &inf_norm_res_comp);
-
-    max_res = (inf_norm_res_stat > max_res) ? inf_norm_res_stat : max_res;
-    max_res = (inf_norm_res_eq > max_res) ? inf_norm_res_eq : max_res;
-    max_res = (inf_norm_res_ineq > max_res) ? inf_norm_res_ineq : max_res;
-    max_res = (inf_norm_res_comp > max_res) ? inf_norm_res_comp : max_res;
+    double max_res = chain_max_res(config, solver);
 
     std::cout << "max residuals: " << max_res << std::endl;
     REQUIRE(status == 0);
     REQUIRE(max_res <= TOL);
 
+    /************************************************
+    * rti level C
+    ************************************************/
+
+    if (check == CHECK_RTI_LEVEL_C)
+    {
+        // level C keeps the QP matrices of the last level D iterate, with the adjoint-based
+        // gradient correction its fixed point is the KKT point found by the SQP solver
+        ocp_nlp_plan plan_rti = *plan;
+        plan_rti.nlp_solver = SQP_RTI;
+        ocp_nlp_config *config_rti = ocp_nlp_config_create(plan_rti);
+
+        void *rti_opts = ocp_nlp_solver_opts_create(config_rti, dims);
+        ocp_nlp_sqp_rti_opts *sqp_rti_opts = (ocp_nlp_sqp_rti_opts *) rti_opts;
+
+        set_chain_sim_opts(NN, plan, sqp_rti_opts->nlp_opts);
+
+        ocp_nlp_out *rti_out = ocp_nlp_out_create(config_rti, dims);
+        ocp_nlp_solver *rti_solver = ocp_nlp_solver_create(config_rti, dims, rti_opts);
+
+        for (int i=0; i <= NN; i++)
+        {
+            blasfeo_pack_dvec(nu[i], uref, 1, rti_out->ux+i, 0);
+            blasfeo_pack_dvec(nx[i], xref, 1, rti_out->ux+i, nu[i]);
+        }
+
+        // a few level D iterations to get close to the solution
+        int rti_level = 3;
+        ocp_nlp_solver_opts_set(config_rti, rti_opts, "rti_level", &rti_level);
+        for (int iter = 0; iter < 3; iter++)
+        {
+            status = ocp_nlp_solve(rti_solver, nlp_in, rti_out);
+            REQUIRE(status == 0);
+        }
+
+        rti_level = 2;
+        ocp_nlp_solver_opts_set(config_rti, rti_opts, "rti_level", &rti_level);
+        for (int iter = 0; iter < 100; iter++)
+        {
+            status = ocp_nlp_solve(rti_solver, nlp_in, rti_out);
+            REQUIRE(status == 0);
+        }
+
+        double max_err = chain_max_err(NN, nx, nu, rti_out, nlp_out);
+
+        std::cout << "rti level C: max deviation from SQP solution: " << max_err << std::endl;
+        REQUIRE(max_err <= 1e-5);
+
+        ocp_nlp_solver_opts_destroy(rti_opts);
+        ocp_nlp_out_destroy(rti_out);
+        ocp_nlp_solver_destroy(rti_solver);
+        ocp_nlp_config_destroy(config_rti);
+    }
+
+    /************************************************
+    * rti with separate preparation and feedback
+    ************************************************/
+
+    if (check == CHECK_RTI_ASYNC)
+    {
+        // preparation (on a background thread with ACADOS_WITH_THREADS) followed by the
+        // feedback has to give the same iterates as the combined RTI step
+        ocp_nlp_plan plan_rti = *plan;
+        plan_rti.nlp_solver = SQP_RTI;
+        ocp_nlp_config *config_rti = ocp_nlp_config_create(plan_rti);
+
+        void *rti_opts = ocp_nlp_solver_opts_create(config_rti, dims);
+        void *async_opts = ocp_nlp_solver_opts_create(config_rti, dims);
+
+        set_chain_sim_opts(NN, plan, ((ocp_nlp_sqp_rti_opts *) rti_opts)->nlp_opts);
+        set_chain_sim_opts(NN, plan, ((ocp_nlp_sqp_rti_opts *) async_opts)->nlp_opts);
+
+        ocp_nlp_out *rti_out = ocp_nlp_out_create(config_rti, dims);
+        ocp_nlp_out *async_out = ocp_nlp_out_create(config_rti, dims);
+        ocp_nlp_solver *rti_solver = ocp_nlp_solver_create(config_rti, dims, rti_opts);
+        ocp_nlp_solver *async_solver = ocp_nlp_solver_create(config_rti, dims, async_opts);
+
+        for (int i=0; i <= NN; i++)
+        {
+            blasfeo_pack_dvec(nu[i], uref, 1, rti_out->ux+i, 0);
+            blasfeo_pack_dvec(nx[i], xref, 1, rti_out->ux+i, nu[i]);
+            blasfeo_pack_dvec(nu[i], uref, 1, async_out->ux+i, 0);
+            blasfeo_pack_dvec(nx[i], xref, 1, async_out->ux+i, nu[i]);
+        }
+
+        for (int iter = 0; iter < 10; iter++)
+        {
+            status = ocp_nlp_solve(rti_solver, nlp_in, rti_out);
+            REQUIRE(status == 0);
+
+            status = ocp_nlp_preparation_start(async_solver, nlp_in, async_out);
+            REQUIRE(status == ACADOS_READY);
+            status = ocp_nlp_preparation_wait(async_solver);
+            REQUIRE(status == 0);
+            status = ocp_nlp_feedback(async_solver, nlp_in, async_out);
+            REQUIRE(status == 0);
+
+            REQUIRE(chain_max_err(NN, nx, nu, async_out, rti_out) <= 1e-10);
+        }
+
+        // feedback directly after the start has to wait for the pending preparation
+        status = ocp_nlp_solve(rti_solver, nlp_in, rti_out);
+        REQUIRE(status == 0);
+        ocp_nlp_preparation_start(async_solver, nlp_in, async_out);
+        status = ocp_nlp_feedback(async_solver, nlp_in, async_out);
+        REQUIRE(status == 0);
+
+        double max_err = chain_max_err(NN, nx, nu, async_out, rti_out);
+
+        std::cout << "rti async: max deviation from combined RTI step: " << max_err << std::endl;
+        REQUIRE(max_err <= 1e-10);
+
+        ocp_nlp_solver_opts_destroy(rti_opts);
+        ocp_nlp_solver_opts_destroy(async_opts);
+        ocp_nlp_out_destroy(rti_out);
+        ocp_nlp_out_destroy(async_out);
+        ocp_nlp_solver_destroy(rti_solver);
+        ocp_nlp_solver_destroy(async_solver);
+        ocp_nlp_config_destroy(config_rti);
+    }
+
+    /************************************************
+    * filter line search
+    ************************************************/
+
+    if (check == CHECK_FILTER_LINE_SEARCH)
+    {
+        // the filter accepts the full steps close to the solution, so it converges to the
+        // same KKT point as the SQP solver with full steps
+        void *filter_opts = chain_sqp_opts_create(NN, plan, config, dims, max_iter, tol_stat);
+        ocp_nlp_solver_opts_set(config, filter_opts, "globalization", (void *) "filter_line_search");
+
+        ocp_nlp_out *filter_out = ocp_nlp_out_create(config, dims);
+        ocp_nlp_solver *filter_solver = ocp_nlp_solver_create(config, dims, filter_opts);
+
+        for (int i=0; i <= NN; i++)
+        {
+            blasfeo_pack_dvec(nu[i], uref, 1, filter_out->ux+i, 0);
+            blasfeo_pack_dvec(nx[i], xref, 1, filter_out->ux+i, nu[i]);
+        }
+
+        status = ocp_nlp_solve(filter_solver, nlp_in, filter_out);
+
+        max_res = chain_max_res(config, filter_solver);
+        double max_err = chain_max_err(NN, nx, nu, filter_out, nlp_out);
+
+        std::cout << "filter line search: max residuals: " << max_res
+                  << ", max deviation from SQP solution: " << max_err << std::endl;
+        REQUIRE(status == 0);
+        REQUIRE(max_res <= TOL);
+        REQUIRE(max_err <= 1e-5);
+
+        ocp_nlp_solver_opts_destroy(filter_opts);
+        ocp_nlp_out_destroy(filter_out);
+        ocp_nlp_solver_destroy(filter_solver);
+    }
+
+    /************************************************
+    * reuse of the dynamics sensitivities
+    ************************************************/
+
+    if (check == CHECK_DYN_SENS_REUSE)
+    {
+        // with frozen dynamics Jacobians the adjoint correction keeps the exact gradient of
+        // the Lagrangian, so the iterates converge (linearly) to the same KKT point
+        int reuse_max_iter = 4 * max_iter;
+        void *reuse_opts = chain_sqp_opts_create(NN, plan, config, dims, reuse_max_iter, tol_stat);
+
+        int dyn_sens_reuse = 1;
+        ocp_nlp_solver_opts_set(config, reuse_opts, "dyn_sens_reuse", &dyn_sens_reuse);
+
+        ocp_nlp_out *reuse_out = ocp_nlp_out_create(config, dims);
+        ocp_nlp_solver *reuse_solver = ocp_nlp_solver_create(config, dims, reuse_opts);
+
+        for (int i=0; i <= NN; i++)
+        {
+            blasfeo_pack_dvec(nu[i], uref, 1, reuse_out->ux+i, 0);
+            blasfeo_pack_dvec(nx[i], xref, 1, reuse_out->ux+i, nu[i]);
+        }
+
+        status = ocp_nlp_solve(reuse_solver, nlp_in, reuse_out);
+
+        max_res = chain_max_res(config, reuse_solver);
+        double max_err = chain_max_err(NN, nx, nu, reuse_out, nlp_out);
+
+        std::cout << "dyn_sens_reuse: max residuals: " << max_res
+                  << ", max deviation from SQP solution: " << max_err << std::endl;
+        REQUIRE(status == 0);
+        REQUIRE(max_res <= TOL);
+        REQUIRE(max_err <= 1e-5);
+
+        ocp_nlp_solver_opts_destroy(reuse_opts);
+        ocp_nlp_out_destroy(reuse_out);
+        ocp_nlp_solver_destroy(reuse_solver);
+    }
+
+    /************************************************
+    * time budget
+    ************************************************/
+
+    if (check == CHECK_TIME_BUDGET)
+    {
+        ocp_nlp_out *init_out = ocp_nlp_out_create(config, dims);
+        ocp_nlp_out *budget_out = ocp_nlp_out_create(config, dims);
+
+        for (int i=0; i <= NN; i++)
+        {
+            blasfeo_pack_dvec(nu[i], uref, 1, init_out->ux+i, 0);
+            blasfeo_pack_dvec(nx[i], xref, 1, init_out->ux+i, nu[i]);
+        }
+
+        // a budget that is exhausted by the first linearization: the solver stops before the
+        // first QP and returns the best iterate so far, which is the initial guess
+        void *budget_opts = chain_sqp_opts_create(NN, plan, config, dims, max_iter, tol_stat);
+        double time_budget = 1e-9;
+        ocp_nlp_solver_opts_set(config, budget_opts, "time_budget", &time_budget);
+        ocp_nlp_solver *budget_solver = ocp_nlp_solver_create(config, dims, budget_opts);
+
+        for (int i=0; i <= NN; i++)
+            blasfeo_dveccp(nu[i]+nx[i], init_out->ux+i, 0, budget_out->ux+i, 0);
+
+        status = ocp_nlp_solve(budget_solver, nlp_in, budget_out);
+
+        int sqp_iter;
+        ocp_nlp_get(config, budget_solver, "sqp_iter", &sqp_iter);
+        double max_err = chain_max_err(NN, nx, nu, budget_out, init_out);
+
+        std::cout << "tiny time budget: status " << status << ", sqp_iter " << sqp_iter
+                  << ", max deviation from initial guess: " << max_err << std::endl;
+        REQUIRE(status == ACADOS_TIMEOUT);
+        REQUIRE(sqp_iter == 0);
+        REQUIRE(max_err == 0.0);
+
+        ocp_nlp_solver_opts_destroy(budget_opts);
+        ocp_nlp_solver_destroy(budget_solver);
+
+        // a budget that is never reached does not change the iterates
+        budget_opts = chain_sqp_opts_create(NN, plan, config, dims, max_iter, tol_stat);
+        time_budget = 100.0;
+        ocp_nlp_solver_opts_set(config, budget_opts, "time_budget", &time_budget);
+        budget_solver = ocp_nlp_solver_create(config, dims, budget_opts);
+
+        for (int i=0; i <= NN; i++)
+            blasfeo_dveccp(nu[i]+nx[i], init_out->ux+i, 0, budget_out->ux+i, 0);
+
+        status = ocp_nlp_solve(budget_solver, nlp_in, budget_out);
+
+        max_res = chain_max_res(config, budget_solver);
+        max_err = chain_max_err(NN, nx, nu, budget_out, nlp_out);
+
+        std::cout << "large time budget: max residuals: " << max_res
+                  << ", max deviation from SQP solution: " << max_err << std::endl;
+        REQUIRE(status == 0);
+        REQUIRE(max_res <= TOL);
+        REQUIRE(max_err <= 1e-10);
+
+        ocp_nlp_solver_opts_destroy(budget_opts);
+        ocp_nlp_out_destroy(init_out);
+        ocp_nlp_out_destroy(budget_out);
+        ocp_nlp_solver_destroy(budget_solver);
+    }
+
+    /************************************************
+    * quasi-Newton hessian updates
+    ************************************************/
+
+    if (check == CHECK_HESS_UPDATE)
+    {
+        // the updates only change the hessian blocks, not the KKT conditions, so the
+        // iterates converge (superlinearly) to the same KKT point
+        int qn_max_iter = 4 * max_iter;
+
+        // "mixed": bfgs on the even, sr1 on the odd stages
+        for (std::string hess_update : {"bfgs", "sr1", "mixed"})
+        {
+            void *qn_opts = chain_sqp_opts_create(NN, plan, config, dims, qn_max_iter, tol_stat);
+
+            if (hess_update == "mixed")
+            {
+                for (int i = 0; i <= NN; i++)
+                    ocp_nlp_solver_opts_set_at_stage(config, qn_opts, i, "hess_update",
+                                                     (void *) (i % 2 ? "sr1" : "bfgs"));
+            }
+            else
+            {
+                ocp_nlp_solver_opts_set(config, qn_opts, "hess_update",
+                                        (void *) hess_update.c_str());
+            }
+
+            ocp_nlp_out *qn_out = ocp_nlp_out_create(config, dims);
+            ocp_nlp_solver *qn_solver = ocp_nlp_solver_create(config, dims, qn_opts);
+
+            for (int i=0; i <= NN; i++)
+            {
+                blasfeo_pack_dvec(nu[i], uref, 1, qn_out->ux+i, 0);
+                blasfeo_pack_dvec(nx[i], xref, 1, qn_out->ux+i, nu[i]);
+            }
+
+            status = ocp_nlp_solve(qn_solver, nlp_in, qn_out);
+
+            max_res = chain_max_res(config, qn_solver);
+            double max_err = chain_max_err(NN, nx, nu, qn_out, nlp_out);
+
+            std::cout << "hess_update " << hess_update << ": max residuals: " << max_res
+                      << ", max deviation from SQP solution: " << max_err << std::endl;
+            REQUIRE(status == 0);
+            REQUIRE(max_res <= TOL);
+            REQUIRE(max_err <= 1e-5);
+
+            ocp_nlp_solver_opts_destroy(qn_opts);
+            ocp_nlp_out_destroy(qn_out);
+            ocp_nlp_solver_destroy(qn_solver);
+        }
+    }
+
+    /************************************************
+    * inexact qp solves
+    ************************************************/
+
+    if (check == CHECK_INEXACT_QP)
+    {
+        // the QP tolerances tighten with the NLP residuals, so the last QPs are solved to the
+        // NLP tolerances and the iterates converge to the same KKT point
+        void *inexact_opts = chain_sqp_opts_create(NN, plan, config, dims, max_iter, tol_stat);
+
+        int inexact_qp = 1;
+        ocp_nlp_solver_opts_set(config, inexact_opts, "inexact_qp", &inexact_qp);
+
+        ocp_nlp_out *inexact_out = ocp_nlp_out_create(config, dims);
+        ocp_nlp_solver *inexact_solver = ocp_nlp_solver_create(config, dims, inexact_opts);
+
+        for (int i=0; i <= NN; i++)
+        {
+            blasfeo_pack_dvec(nu[i], uref, 1, inexact_out->ux+i, 0);
+            blasfeo_pack_dvec(nx[i], xref, 1, inexact_out->ux+i, nu[i]);
+        }
+
+        // the HPIPM mode and tolerances set during the solve must not leak into the opts
+        void *qp_opts = ((ocp_nlp_sqp_opts *) inexact_opts)->nlp_opts->qp_solver_opts;
+        int qp_opts_size = config->qp_solver->opts_calculate_size(config->qp_solver,
+                                                                  dims->qp_solver);
+        std::vector<char> qp_opts_ref((char *) qp_opts, (char *) qp_opts + qp_opts_size);
+
+        status = ocp_nlp_solve(inexact_solver, nlp_in, inexact_out);
+
+        max_res = chain_max_res(config, inexact_solver);
+        double max_err = chain_max_err(NN, nx, nu, inexact_out, nlp_out);
+
+        std::cout << "inexact qp: max residuals: " << max_res
+                  << ", max deviation from SQP solution: " << max_err << std::endl;
+        REQUIRE(status == 0);
+        REQUIRE(max_res <= TOL);
+        REQUIRE(max_err <= 1e-5);
+        REQUIRE(memcmp(qp_opts_ref.data(), qp_opts, qp_opts_size) == 0);
+
+        ocp_nlp_solver_opts_destroy(inexact_opts);
+        ocp_nlp_out_destroy(inexact_out);
+        ocp_nlp_solver_destroy(inexact_solver);
+    }
+
+    /************************************************
+    * weighted schedule of the linearization
+    ************************************************/
+
+    if (check == CHECK_PARALLEL_WEIGHTED)
+    {
+        // the chunks change from call to call with the measured stage times,
+        // the stage evaluations and so the iterates must not
+        void *weighted_opts = chain_sqp_opts_create(NN, plan, config, dims, max_iter, tol_stat);
+        ocp_nlp_solver_opts_set(config, weighted_opts, "parallel_schedule", (void *) "weighted");
+
+        ocp_nlp_out *weighted_out = ocp_nlp_out_create(config, dims);
+        ocp_nlp_solver *weighted_solver = ocp_nlp_solver_create(config, dims, weighted_opts);
+
+        for (int i=0; i <= NN; i++)
+        {
+            blasfeo_pack_dvec(nu[i], uref, 1, weighted_out->ux+i, 0);
+            blasfeo_pack_dvec(nx[i], xref, 1, weighted_out->ux+i, nu[i]);
+        }
+
+        status = ocp_nlp_solve(weighted_solver, nlp_in, weighted_out);
+
+        max_res = chain_max_res(config, weighted_solver);
+        double max_err = chain_max_err(NN, nx, nu, weighted_out, nlp_out);
+
+        std::cout << "weighted schedule: max residuals: " << max_res
+                  << ", max deviation from SQP solution: " << max_err << std::endl;
+        REQUIRE(status == 0);
+        REQUIRE(max_res <= TOL);
+        REQUIRE(max_err <= 1e-10);
+
+        ocp_nlp_solver_opts_destroy(weighted_opts);
+        ocp_nlp_out_destroy(weighted_out);
+        ocp_nlp_solver_destroy(weighted_solver);
+    }
+
     /************************************************
     * free memory
     ************************************************/
@@ -1634,3 +2099,115 @@ TEST_CASE("chain example", "[NLP solver]")
         }  // horizon lenght
     }
 }  // TEST_CASE
+
+
+
+TEST_CASE("chain example rti level C", "[NLP solver]")
+{
+    for (std::string model_str : {"DISCRETE", "CONTINUOUS"})
+    {
+        SECTION("Type of model: " + model_str)
+        {
+            setup_and_solve_nlp(20, 3, "GENERAL", "MIXED", "SPARSE_HPIPM", model_str, "MIXED",
+                                CHECK_RTI_LEVEL_C);
+        }
+    }
+}  // TEST_CASE
+
+
+
+TEST_CASE("chain example filter line search", "[NLP solver]")
+{
+    for (std::string model_str : {"DISCRETE", "CONTINUOUS"})
+    {
+        SECTION("Type of model: " + model_str)
+        {
+            setup_and_solve_nlp(20, 3, "GENERAL", "MIXED", "SPARSE_HPIPM", model_str, "MIXED",
+                                CHECK_FILTER_LINE_SEARCH);
+        }
+    }
+}  // TEST_CASE
+
+
+
+TEST_CASE("chain example rti preparation and feedback", "[NLP solver]")
+{
+    for (std::string model_str : {"DISCRETE", "CONTINUOUS"})
+    {
+        SECTION("Type of model: " + model_str)
+        {
+            setup_and_solve_nlp(20, 3, "GENERAL", "MIXED", "SPARSE_HPIPM", model_str, "MIXED",
+                                CHECK_RTI_ASYNC);
+        }
+    }
+}  // TEST_CASE
+
+
+
+TEST_CASE("chain example dyn_sens_reuse", "[NLP solver]")
+{
+    for (std::string model_str : {"DISCRETE", "CONTINUOUS"})
+    {
+        SECTION("Type of model: " + model_str)
+        {
+            setup_and_solve_nlp(20, 3, "GENERAL", "MIXED", "SPARSE_HPIPM", model_str, "MIXED",
+                                CHECK_DYN_SENS_REUSE);
+        }
+    }
+}  // TEST_CASE
+
+
+
+TEST_CASE("chain example time budget", "[NLP solver]")
+{
+    for (std::string model_str : {"DISCRETE", "CONTINUOUS"})
+    {
+        SECTION("Type of model: " + model_str)
+        {
+            setup_and_solve_nlp(20, 3, "GENERAL", "MIXED", "SPARSE_HPIPM", model_str, "MIXED",
+                                CHECK_TIME_BUDGET);
+        }
+    }
+}  // TEST_CASE
+
+
+
+TEST_CASE("chain example hess_update", "[NLP solver]")
+{
+    for (std::string model_str : {"DISCRETE", "CONTINUOUS"})
+    {
+        SECTION("Type of model: " + model_str)
+        {
+            setup_and_solve_nlp(20, 3, "GENERAL", "MIXED", "SPARSE_HPIPM", model_str, "MIXED",
+                                CHECK_HESS_UPDATE);
+        }
+    }
+}  // TEST_CASE
+
+
+
+TEST_CASE("chain example inexact qp", "[NLP solver]")
+{
+    for (std::string model_str : {"DISCRETE", "CONTINUOUS"})
+    {
+        SECTION("Type of model: " + model_str)
+        {
+            setup_and_solve_nlp(20, 3, "GENERAL", "MIXED", "SPARSE_HPIPM", model_str, "MIXED",
+                                CHECK_INEXACT_QP);
+        }
+    }
+}  // TEST_CASE
+
+
+
+TEST_CASE("chain example weighted parallel schedule", "[NLP solver]")
+{
+    for (std::string model_str : {"DISCRETE", "CONTINUOUS"})
+    {
+        SECTION("Type of model: " + model_str)
+        {
+            setup_and_solve_nlp(20, 3, "GENERAL", "MIXED", "SPARSE_HPIPM", model_str, "MIXED",
+                                CHECK_PARALLEL_WEIGHTED);
+        }
+    }
+}  // TEST_CASE
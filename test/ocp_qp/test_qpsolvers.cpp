@@ -32,6 +32,8 @@
  */
 
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -40,10 +42,13 @@
 //#include "test/test_utils/eigen.h"
 
 #include "acados_c/ocp_qp_interface.h"
+#include "acados/ocp_qp/ocp_qp_snapshot.h"
 
 extern "C" {
 ocp_qp_xcond_solver_dims *create_ocp_qp_dims_mass_spring(ocp_qp_xcond_solver_config *config, int N, int nx_, int nu_, int nb_, int ng_, int ngN);
 ocp_qp_in *create_ocp_qp_in_mass_spring(ocp_qp_dims *dims);
+ocp_qp_xcond_solver_dims *create_ocp_qp_dims_mass_spring_soft_constr(ocp_qp_xcond_solver_config *config, int N, int nx_, int nu_, int nb_, int ng_, int ngN);
+ocp_qp_in *create_ocp_qp_in_mass_spring_soft_constr(ocp_qp_dims *dims);
 }
 
 using std::vector;
@@ -53,6 +58,8 @@ using std::vector;
 ocp_qp_solver_t hashit(std::string const &inString)
 {
     if (inString == "SPARSE_HPIPM") return PARTIAL_CONDENSING_HPIPM;
+    if (inString == "SPARSE_RICCATI") return PARTIAL_CONDENSING_RICCATI;
+    if (inString == "SPARSE_PARALLEL_RICCATI") return PARTIAL_CONDENSING_PARALLEL_RICCATI;
     if (inString == "DENSE_HPIPM") return FULL_CONDENSING_HPIPM;
 #ifdef ACADOS_WITH_HPMPC
     if (inString == "SPARSE_HPMPC") return PARTIAL_CONDENSING_HPMPC;
@@ -81,6 +88,8 @@ ocp_qp_solver_t hashit(std::string const &inString)
 double solver_tolerance(std::string const &inString)
 {
     if (inString == "SPARSE_HPIPM") return 1e-8;
+    if (inString == "SPARSE_RICCATI") return 1e-8;
+    if (inString == "SPARSE_PARALLEL_RICCATI") return 1e-8;
     if (inString == "SPARSE_HPMPC") return 1e-5;
     // if (inString == "SPARSE_QPDUNES") return 1e-8;
     if (inString == "DENSE_HPIPM") return 1e-8;
@@ -99,7 +108,7 @@ void set_N2(std::string const &inString, ocp_qp_xcond_solver_config *config, voi
 {
     bool option_found = false;
 
-    if ( inString=="SPARSE_HPIPM" | inString=="SPARSE_HPMPC" | inString == "SPARSE_OOQP" | inString == "SPARSE_OSQP" )
+    if ( inString=="SPARSE_HPIPM" | inString=="SPARSE_RICCATI" | inString=="SPARSE_PARALLEL_RICCATI" | inString=="SPARSE_HPMPC" | inString == "SPARSE_OOQP" | inString == "SPARSE_OSQP" )
     {
 		config->opts_set(config, opts, "cond_N", &N2);
     }
@@ -118,6 +127,8 @@ TEST_CASE("mass spring example", "[QP solvers]")
     vector<std::string> solvers = {
                                     "DENSE_HPIPM"
                                    ,"SPARSE_HPIPM"
+                                   ,"SPARSE_RICCATI"
+                                   ,"SPARSE_PARALLEL_RICCATI"
 #ifdef ACADOS_WITH_HPMPC
                                    ,"SPARSE_HPMPC"
 #endif
@@ -245,6 +256,128 @@ TEST_CASE("mass spring example", "[QP solvers]")
                 }
             }
 
+            if (plan.qp_solver == PARTIAL_CONDENSING_HPIPM)
+            {
+                SECTION("N2 = auto")
+                {
+                    int cond_N_auto = 1;
+                    config->opts_set(config, opts, "cond_N_auto", &cond_N_auto);
+
+                    qp_solver = ocp_qp_create(config, qp_dims, opts);
+
+                    // two workers sharing dims and opts, each switches the horizon on its own
+                    int num_workers = 2;
+                    ocp_qp_solver **workers = ocp_qp_solver_batch_create(qp_solver, num_workers);
+
+                    int num_cand, done, cond_N;
+                    config->memory_get(config, workers[0]->mem, "cond_N_auto_num", &num_cand);
+                    REQUIRE(num_cand > 0);
+
+                    // time all candidates, then solve once more with the locked-in horizon;
+                    // the second worker lags behind by one solve
+                    for (int jj = 0; jj <= num_cand * OCP_QP_XCOND_N2_AUTO_REPS + 1; jj++)
+                    {
+                        for (int kk = 0; kk < num_workers; kk++)
+                        {
+                            if (kk == 1 && jj == 0)
+                                continue;
+                            if (kk == 0 && jj == num_cand * OCP_QP_XCOND_N2_AUTO_REPS + 1)
+                                continue;
+
+                            acados_return = ocp_qp_solve(workers[kk], qp_in, qp_out);
+
+                            REQUIRE(acados_return == 0);
+
+                            ocp_qp_inf_norm_residuals(qp_dims->orig_dims, qp_in, qp_out, res);
+
+                            max_res = 0.0;
+                            for (int ii = 0; ii < 4; ii++)
+                            {
+                                max_res = (res[ii] > max_res) ? res[ii] : max_res;
+                            }
+                            REQUIRE(max_res <= tol);
+                        }
+                    }
+
+                    for (int kk = 0; kk < num_workers; kk++)
+                    {
+                        config->memory_get(config, workers[kk]->mem, "cond_N_auto_done", &done);
+                        config->memory_get(config, workers[kk]->mem, "cond_N", &cond_N);
+                        REQUIRE(done == 1);
+                        REQUIRE(cond_N >= 1);
+                        REQUIRE(cond_N <= N);
+
+                        std::cout << "\n---> " << solver << " worker " << kk << " selected N2 = "
+                                  << cond_N << "\n";
+                    }
+
+                    // the shared opts keep the horizon set by the user
+                    REQUIRE(((ocp_qp_xcond_solver_opts *) opts)->cond_N == N);
+
+                    ocp_qp_solver_batch_destroy(workers);
+                    free(qp_solver);
+                }
+            }
+
+#ifdef ACADOS_WITH_QPOASES
+            if (plan.qp_solver == FULL_CONDENSING_QPOASES)
+            {
+                SECTION("active set guess from HPIPM")
+                {
+                    // cold start
+                    int warm_start = 0;
+                    config->opts_set(config, opts, "warm_start", &warm_start);
+
+                    qp_solver = ocp_qp_create(config, qp_dims, opts);
+                    acados_return = ocp_qp_solve(qp_solver, qp_in, qp_out);
+                    REQUIRE(acados_return == 0);
+                    int iter_cold = ((qp_info *) qp_out->misc)->num_iter;
+                    free(qp_solver);
+
+                    // interior point solution
+                    ocp_qp_solver_plan plan_ipm;
+                    plan_ipm.qp_solver = PARTIAL_CONDENSING_HPIPM;
+                    ocp_qp_xcond_solver_config *config_ipm = ocp_qp_xcond_solver_config_create(plan_ipm);
+                    void *opts_ipm = ocp_qp_xcond_solver_opts_create(config_ipm, qp_dims);
+                    ocp_qp_solver *qp_solver_ipm = ocp_qp_create(config_ipm, qp_dims, opts_ipm);
+                    ocp_qp_out *qp_out_ipm = ocp_qp_out_create(qp_dims->orig_dims);
+                    acados_return = ocp_qp_solve(qp_solver_ipm, qp_in, qp_out_ipm);
+                    REQUIRE(acados_return == 0);
+
+                    // qpOASES started from the working set of the interior point solution
+                    int guess_active_set = 1;
+                    config->opts_set(config, opts, "guess_active_set", &guess_active_set);
+
+                    qp_solver = ocp_qp_create(config, qp_dims, opts);
+                    acados_return = ocp_qp_solve(qp_solver, qp_in, qp_out_ipm);
+                    REQUIRE(acados_return == 0);
+                    int iter_guess = ((qp_info *) qp_out_ipm->misc)->num_iter;
+
+                    ocp_qp_inf_norm_residuals(qp_dims->orig_dims, qp_in, qp_out_ipm, res);
+
+                    max_res = 0.0;
+                    for (int ii = 0; ii < 4; ii++)
+                    {
+                        max_res = (res[ii] > max_res) ? res[ii] : max_res;
+                    }
+
+                    std::cout << "\n---> " << solver << " working set recalculations: cold "
+                              << iter_cold << ", from HPIPM " << iter_guess << "\n";
+                    REQUIRE(max_res <= tol);
+                    REQUIRE(iter_guess <= iter_cold);
+
+                    guess_active_set = 0;
+                    config->opts_set(config, opts, "guess_active_set", &guess_active_set);
+
+                    free(qp_solver);
+                    free(qp_out_ipm);
+                    free(qp_solver_ipm);
+                    free(opts_ipm);
+                    free(config_ipm);
+                }
+            }
+#endif
+
 			free(qp_out);
 			free(qp_in);
 			free(qp_dims);
@@ -257,3 +390,664 @@ TEST_CASE("mass spring example", "[QP solvers]")
     }  // END_FOR_SOLVERS
 
 }  // END_TEST_CASE
+
+
+
+TEST_CASE("mass spring example without inequalities", "[QP solvers]")
+{
+    // only the initial state is bounded: solved by the riccati recursion, without falling back to hpipm
+    vector<std::string> solvers = {"SPARSE_RICCATI", "SPARSE_PARALLEL_RICCATI"};
+
+    int nx_ = 8;
+    int nu_ = 3;
+    int N = 15;
+    int nb_ = 0;
+    int ng_ = 0;
+    int ngN = 0;
+
+    double N2_values[] = {15, 5, 3};
+
+    ocp_qp_solver_plan plan;
+
+    double res[4];
+    double max_res;
+
+    for (std::string const &solver : solvers)
+    {
+        SECTION(solver)
+        {
+            plan.qp_solver = hashit(solver);
+
+            double tol = solver_tolerance(solver);
+
+            for (int ii = 0; ii < 3; ii++)
+            {
+                SECTION("N2 = " + std::to_string((int)N2_values[ii]))
+                {
+                    ocp_qp_xcond_solver_config *config = ocp_qp_xcond_solver_config_create(plan);
+
+                    ocp_qp_xcond_solver_dims *qp_dims = create_ocp_qp_dims_mass_spring(config, N, nx_, nu_, nb_, ng_, ngN);
+                    ocp_qp_in *qp_in = create_ocp_qp_in_mass_spring(qp_dims->orig_dims);
+                    ocp_qp_out *qp_out = ocp_qp_out_create(qp_dims->orig_dims);
+
+                    void *opts = ocp_qp_xcond_solver_opts_create(config, qp_dims);
+                    set_N2(solver, config, opts, N2_values[ii], N);
+
+                    int fallback = 0;
+                    config->opts_set(config, opts, "fallback", &fallback);
+
+                    if (solver == "SPARSE_PARALLEL_RICCATI")
+                    {
+                        // more chunks than threads is fine, the chunks are then processed in turn
+                        int num_threads = 3;
+                        config->opts_set(config, opts, "num_threads", &num_threads);
+                    }
+
+                    ocp_qp_solver *qp_solver = ocp_qp_create(config, qp_dims, opts);
+
+                    int acados_return = ocp_qp_solve(qp_solver, qp_in, qp_out);
+
+                    REQUIRE(acados_return == 0);
+
+                    ocp_qp_xcond_solver_memory *mem = (ocp_qp_xcond_solver_memory *) qp_solver->mem;
+                    int riccati = 0;
+                    config->qp_solver->memory_get(config->qp_solver, mem->solver_memory, "riccati", &riccati);
+                    REQUIRE(riccati != 0);
+
+                    ocp_qp_inf_norm_residuals(qp_dims->orig_dims, qp_in, qp_out, res);
+
+                    max_res = 0.0;
+                    for (int jj = 0; jj < 4; jj++)
+                    {
+                        max_res = (res[jj] > max_res) ? res[jj] : max_res;
+                    }
+
+                    std::cout << "\n---> residuals of " << solver << " without inequalities (N2 = "
+                                                        << N2_values[ii] << ")\n";
+                    printf("\ninf norm res: %e, %e, %e, %e\n", res[0], res[1], res[2], res[3]);
+                    REQUIRE(max_res <= tol);
+
+                    free(qp_solver);
+                    free(qp_out);
+                    free(qp_in);
+                    free(qp_dims);
+                    free(opts);
+                    free(config);
+                }
+            }
+        }
+    }
+
+}  // END_TEST_CASE
+
+
+
+// largest difference between the entries of two matrices
+static double max_abs_diff_dmat(int m, int n, struct blasfeo_dmat *A, struct blasfeo_dmat *B)
+{
+    double diff = 0.0;
+    for (int ii = 0; ii < m; ii++)
+        for (int jj = 0; jj < n; jj++)
+            diff = std::max(diff, std::abs(blasfeo_dgeex1(A, ii, jj) - blasfeo_dgeex1(B, ii, jj)));
+    return diff;
+}
+
+
+
+// largest difference between the entries of two vectors
+static double max_abs_diff_dvec(int m, struct blasfeo_dvec *a, struct blasfeo_dvec *b)
+{
+    double diff = 0.0;
+    for (int ii = 0; ii < m; ii++)
+        diff = std::max(diff, std::abs(a->pa[ii] - b->pa[ii]));
+    return diff;
+}
+
+
+
+TEST_CASE("mass spring example batch", "[QP solvers]")
+{
+    vector<std::string> solvers = {
+                                    "SPARSE_HPIPM"
+#ifdef ACADOS_WITH_OSQP
+                                   ,"SPARSE_OSQP"
+#endif
+    };
+
+    int nx_ = 8;
+    int nu_ = 3;
+    int N = 15;
+    int nb_ = 11;
+    int ng_ = 0;
+    int ngN = 4;
+
+    int N2 = 5;
+    int num_qp = 16;
+    int num_workers[2] = {3, 2};  // the second batch reuses the workers on other qps
+
+    double res[4];
+    double max_res;
+
+    for (std::string solver : solvers)
+    {
+        SECTION(solver)
+        {
+            ocp_qp_solver_plan plan;
+            plan.qp_solver = hashit(solver);
+
+            double tol = solver_tolerance(solver);
+
+            ocp_qp_xcond_solver_config *config = ocp_qp_xcond_solver_config_create(plan);
+            ocp_qp_xcond_solver_dims *qp_dims = create_ocp_qp_dims_mass_spring(config, N, nx_, nu_, nb_, ng_, ngN);
+
+            void *opts = ocp_qp_xcond_solver_opts_create(config, qp_dims);
+            set_N2(solver, config, opts, N2, N);
+
+            ocp_qp_solver *qp_solver = ocp_qp_create(config, qp_dims, opts);
+
+            // qps with different initial states and state cost matrices
+            vector<ocp_qp_in *> qp_in(num_qp);
+            vector<ocp_qp_out *> qp_out(num_qp);
+            vector<ocp_qp_out *> qp_out_ref(num_qp);
+            vector<int> num_iter(num_qp);
+            vector<double> x0(nx_, 0.0);
+            vector<double> Q(nx_ * nx_, 0.0);
+            qp_info *info;
+
+            for (int ii = 0; ii < num_qp; ii++)
+            {
+                qp_in[ii] = create_ocp_qp_in_mass_spring(qp_dims->orig_dims);
+                qp_out[ii] = ocp_qp_out_create(qp_dims->orig_dims);
+                qp_out_ref[ii] = ocp_qp_out_create(qp_dims->orig_dims);
+
+                x0[0] = 2.5 - 0.25 * ii / num_qp;
+                x0[1] = -2.5 + 0.25 * ii / num_qp;
+                ocp_qp_in_set(config, qp_in[ii], 0, (char *) "lbx", x0.data());
+                ocp_qp_in_set(config, qp_in[ii], 0, (char *) "ubx", x0.data());
+
+                for (int jj = 0; jj < nx_; jj++)
+                    Q[jj * (nx_ + 1)] = 1.0 + (double) ii / num_qp;
+                for (int kk = 1; kk <= N; kk++)
+                    ocp_qp_in_set(config, qp_in[ii], kk, (char *) "Q", Q.data());
+
+                // reference: one by one with the template solver
+                REQUIRE(ocp_qp_solve(qp_solver, qp_in[ii], qp_out_ref[ii]) == 0);
+                ocp_qp_out_get(qp_out_ref[ii], "qp_info", &info);
+                num_iter[ii] = info->num_iter;
+            }
+
+            ocp_qp_solver **workers = ocp_qp_solver_batch_create(qp_solver, num_workers[0]);
+
+            for (int kk = 0; kk < 2; kk++)
+            {
+                vector<int> status(num_qp, -1);
+                ocp_qp_batch_info batch_info;
+
+                int acados_return = ocp_qp_solve_batch(workers, num_workers[kk], qp_in.data(),
+                                                       qp_out.data(), num_qp, status.data(),
+                                                       &batch_info);
+
+                REQUIRE(acados_return == 0);
+                REQUIRE(batch_info.num_qp == num_qp);
+                REQUIRE(batch_info.num_failed == 0);
+                REQUIRE(batch_info.num_workers == num_workers[kk]);
+                REQUIRE(batch_info.qp_per_second > 0.0);
+
+                std::cout << "\n---> batch of " << num_qp << " qps with " << solver << " and "
+                          << num_workers[kk] << " workers: " << batch_info.qp_per_second
+                          << " qps per second\n";
+
+                for (int ii = 0; ii < num_qp; ii++)
+                {
+                    REQUIRE(status[ii] == 0);
+
+                    // cold started solves, same iterations as the reference
+                    if (plan.qp_solver == PARTIAL_CONDENSING_HPIPM)
+                    {
+                        ocp_qp_out_get(qp_out[ii], "qp_info", &info);
+                        REQUIRE(info->num_iter == num_iter[ii]);
+                    }
+
+                    ocp_qp_inf_norm_residuals(qp_dims->orig_dims, qp_in[ii], qp_out[ii], res);
+
+                    max_res = 0.0;
+                    for (int jj = 0; jj < 4; jj++)
+                    {
+                        max_res = (res[jj] > max_res) ? res[jj] : max_res;
+                    }
+                    REQUIRE(max_res <= tol);
+
+                    // same solution as the one by one solve
+                    ocp_qp_dims *dims = qp_dims->orig_dims;
+                    for (int jj = 0; jj <= N; jj++)
+                    {
+                        int nv = dims->nu[jj] + dims->nx[jj] + 2 * dims->ns[jj];
+                        REQUIRE(max_abs_diff_dvec(nv, qp_out[ii]->ux+jj, qp_out_ref[ii]->ux+jj) <= 1e-6);
+                    }
+                }
+            }
+
+            for (int ii = 0; ii < num_qp; ii++)
+            {
+                free(qp_out_ref[ii]);
+                free(qp_out[ii]);
+                free(qp_in[ii]);
+            }
+
+            ocp_qp_solver_batch_destroy(workers);
+            free(qp_solver);
+            free(qp_dims);
+            free(opts);
+            free(config);
+        }
+    }
+
+}  // END_TEST_CASE
+
+
+
+TEST_CASE("mass spring example partial condensing parallel", "[QP solvers]")
+{
+    std::string solver = "SPARSE_HPIPM";
+
+    int nx_ = 8;
+    int nu_ = 3;
+    int N = 15;
+    int nb_ = 11;
+    int ng_ = 0;
+    int ngN = 4;
+
+    int N2 = 4;  // blocks of uneven size
+    int num_threads[2] = {1, 4};  // serial reference, per-block parallel condensing
+
+    double tol = 1e-12;
+
+    ocp_qp_solver_plan plan;
+    plan.qp_solver = hashit(solver);
+
+    ocp_qp_xcond_solver_config *config = ocp_qp_xcond_solver_config_create(plan);
+    ocp_qp_xcond_solver_dims *qp_dims = create_ocp_qp_dims_mass_spring(config, N, nx_, nu_, nb_, ng_, ngN);
+    ocp_qp_in *qp_in = create_ocp_qp_in_mass_spring(qp_dims->orig_dims);
+
+    vector<void *> opts(2);
+    vector<ocp_qp_solver *> qp_solver(2);
+    vector<ocp_qp_out *> qp_out(2);
+
+    for (int ii = 0; ii < 2; ii++)
+    {
+        opts[ii] = ocp_qp_xcond_solver_opts_create(config, qp_dims);
+        set_N2(solver, config, opts[ii], N2, N);
+        config->opts_set(config, opts[ii], "cond_num_threads", &num_threads[ii]);
+
+        qp_solver[ii] = ocp_qp_create(config, qp_dims, opts[ii]);
+        qp_out[ii] = ocp_qp_out_create(qp_dims->orig_dims);
+    }
+
+    // the second solve with unchanged matrices condenses the rhs only
+    for (int kk = 0; kk < 2; kk++)
+    {
+        double x0[8] = {2.5 - 0.5 * kk, -2.5 + 0.5 * kk, 0, 0, 0, 0, 0, 0};
+        ocp_qp_in_set(config, qp_in, 0, (char *) "lbx", x0);
+        ocp_qp_in_set(config, qp_in, 0, (char *) "ubx", x0);
+
+        for (int ii = 0; ii < 2; ii++)
+            REQUIRE(ocp_qp_solve(qp_solver[ii], qp_in, qp_out[ii]) == 0);
+
+        // same partially condensed qp
+        ocp_qp_in *pcond_qp[2];
+        for (int ii = 0; ii < 2; ii++)
+            pcond_qp[ii] = (ocp_qp_in *) ((ocp_qp_xcond_solver_memory *) qp_solver[ii]->mem)->xcond_qp_in;
+
+        ocp_qp_dims *pcond_dims = pcond_qp[0]->dim;
+        REQUIRE(pcond_dims->N == N2);
+
+        for (int ii = 0; ii <= N2; ii++)
+        {
+            int nx = pcond_dims->nx[ii];
+            int nu = pcond_dims->nu[ii];
+            int nb = pcond_dims->nb[ii];
+            int ng = pcond_dims->ng[ii];
+            int ns = pcond_dims->ns[ii];
+
+            if (ii < N2)
+            {
+                int nx1 = pcond_dims->nx[ii+1];
+                REQUIRE(max_abs_diff_dmat(nu+nx+1, nx1, pcond_qp[0]->BAbt+ii, pcond_qp[1]->BAbt+ii) <= tol);
+                REQUIRE(max_abs_diff_dvec(nx1, pcond_qp[0]->b+ii, pcond_qp[1]->b+ii) <= tol);
+            }
+            REQUIRE(max_abs_diff_dmat(nu+nx+1, nu+nx, pcond_qp[0]->RSQrq+ii, pcond_qp[1]->RSQrq+ii) <= tol);
+            REQUIRE(max_abs_diff_dvec(2*ns+nu+nx, pcond_qp[0]->rqz+ii, pcond_qp[1]->rqz+ii) <= tol);
+            REQUIRE(max_abs_diff_dmat(nu+nx, ng, pcond_qp[0]->DCt+ii, pcond_qp[1]->DCt+ii) <= tol);
+            REQUIRE(max_abs_diff_dvec(2*nb+2*ng+2*ns, pcond_qp[0]->d+ii, pcond_qp[1]->d+ii) <= tol);
+            for (int jj = 0; jj < nb; jj++)
+                REQUIRE(pcond_qp[0]->idxb[ii][jj] == pcond_qp[1]->idxb[ii][jj]);
+        }
+
+        // same expanded solution
+        ocp_qp_dims *dims = qp_dims->orig_dims;
+        for (int ii = 0; ii <= N; ii++)
+        {
+            int nv = dims->nu[ii] + dims->nx[ii] + 2 * dims->ns[ii];
+            int ni = 2 * dims->nb[ii] + 2 * dims->ng[ii] + 2 * dims->ns[ii];
+
+            REQUIRE(max_abs_diff_dvec(nv, qp_out[0]->ux+ii, qp_out[1]->ux+ii) <= tol);
+            if (ii < N)
+                REQUIRE(max_abs_diff_dvec(dims->nx[ii+1], qp_out[0]->pi+ii, qp_out[1]->pi+ii) <= tol);
+            REQUIRE(max_abs_diff_dvec(ni, qp_out[0]->lam+ii, qp_out[1]->lam+ii) <= tol);
+            REQUIRE(max_abs_diff_dvec(ni, qp_out[0]->t+ii, qp_out[1]->t+ii) <= tol);
+        }
+    }
+
+    for (int ii = 0; ii < 2; ii++)
+    {
+        free(qp_out[ii]);
+        free(qp_solver[ii]);
+        free(opts[ii]);
+    }
+    free(qp_in);
+    free(qp_dims);
+    free(config);
+
+}  // END_TEST_CASE
+
+
+
+TEST_CASE("mass spring example shared qp_in", "[QP solvers]")
+{
+    vector<std::string> solvers = {
+                                    "SPARSE_HPIPM"
+#ifdef ACADOS_WITH_OSQP
+                                   ,"SPARSE_OSQP"
+#endif
+    };
+
+    int nx_ = 8;
+    int nu_ = 3;
+    int N = 15;
+    int nb_ = 11;
+    int ng_ = 0;
+    int ngN = 4;
+
+    int N2 = 5;
+
+    double res[4];
+    double max_res;
+
+    for (std::string solver : solvers)
+    {
+        SECTION(solver)
+        {
+            ocp_qp_solver_plan plan;
+            plan.qp_solver = hashit(solver);
+
+            double tol = solver_tolerance(solver);
+
+            ocp_qp_xcond_solver_config *config = ocp_qp_xcond_solver_config_create(plan);
+            ocp_qp_xcond_solver_dims *qp_dims = create_ocp_qp_dims_mass_spring(config, N, nx_, nu_, nb_, ng_, ngN);
+            ocp_qp_in *qp_in = create_ocp_qp_in_mass_spring(qp_dims->orig_dims);
+
+            void *opts = ocp_qp_xcond_solver_opts_create(config, qp_dims);
+            set_N2(solver, config, opts, N2, N);
+
+            // two solvers read the same qp_in, each has to see the changes since its last solve
+            vector<ocp_qp_solver *> qp_solver(2);
+            vector<ocp_qp_out *> qp_out(2);
+            for (int ii = 0; ii < 2; ii++)
+            {
+                qp_solver[ii] = ocp_qp_create(config, qp_dims, opts);
+                qp_out[ii] = ocp_qp_out_create(qp_dims->orig_dims);
+            }
+
+            vector<double> Q(nx_ * nx_, 0.0);
+
+            for (int kk = 0; kk < 3; kk++)
+            {
+                // new state cost matrices after the first solve
+                if (kk > 0)
+                {
+                    for (int jj = 0; jj < nx_; jj++)
+                        Q[jj * (nx_ + 1)] = 1.0 + kk;
+                    for (int ii = 1; ii <= N; ii++)
+                        ocp_qp_in_set(config, qp_in, ii, (char *) "Q", Q.data());
+                }
+
+                for (int ii = 0; ii < 2; ii++)
+                {
+                    REQUIRE(ocp_qp_solve(qp_solver[ii], qp_in, qp_out[ii]) == 0);
+
+                    ocp_qp_inf_norm_residuals(qp_dims->orig_dims, qp_in, qp_out[ii], res);
+
+                    max_res = 0.0;
+                    for (int jj = 0; jj < 4; jj++)
+                    {
+                        max_res = (res[jj] > max_res) ? res[jj] : max_res;
+                    }
+                    REQUIRE(max_res <= tol);
+                }
+            }
+
+            for (int ii = 0; ii < 2; ii++)
+            {
+                free(qp_out[ii]);
+                free(qp_solver[ii]);
+            }
+            free(qp_in);
+            free(qp_dims);
+            free(opts);
+            free(config);
+        }
+    }
+
+}  // END_TEST_CASE
+
+
+
+TEST_CASE("mass spring example snapshot", "[QP solvers]")
+{
+    std::string solver = "SPARSE_HPIPM";
+
+    int nx_ = 8;
+    int nu_ = 3;
+    int N = 15;
+    int nb_ = 11;
+    int ng_ = 0;
+    int ngN = 4;
+
+    const char *filename = "mass_spring_snapshot.bin";
+
+    ocp_qp_solver_plan plan;
+    plan.qp_solver = hashit(solver);
+
+    ocp_qp_xcond_solver_config *config = ocp_qp_xcond_solver_config_create(plan);
+    ocp_qp_xcond_solver_dims *qp_dims = create_ocp_qp_dims_mass_spring(config, N, nx_, nu_, nb_, ng_, ngN);
+
+    void *opts = ocp_qp_xcond_solver_opts_create(config, qp_dims);
+    ocp_qp_solver *qp_solver = ocp_qp_create(config, qp_dims, opts);
+
+    ocp_qp_in *qp_in = create_ocp_qp_in_mass_spring(qp_dims->orig_dims);
+    ocp_qp_out *qp_out = ocp_qp_out_create(qp_dims->orig_dims);
+
+    REQUIRE(ocp_qp_solve(qp_solver, qp_in, qp_out) == 0);
+
+    qp_info *info;
+    ocp_qp_out_get(qp_out, "qp_info", &info);
+    int num_iter = info->num_iter;
+
+    ocp_qp_snapshot_writer *writer = ocp_qp_snapshot_writer_open(filename);
+    ocp_qp_snapshot_write_in(writer, qp_in);
+    ocp_qp_snapshot_write_out(writer, qp_out);
+    ocp_qp_snapshot_writer_close(writer);
+
+    ocp_qp_snapshot *snap = ocp_qp_snapshot_open(filename);
+
+    REQUIRE(snap->num_records == 2);
+    REQUIRE(ocp_qp_snapshot_record_kind(snap, 0) == OCP_QP_SNAPSHOT_IN);
+    REQUIRE(ocp_qp_snapshot_record_kind(snap, 1) == OCP_QP_SNAPSHOT_OUT);
+    REQUIRE(ocp_qp_snapshot_record_N(snap, 0) == N);
+
+    // replay: the mapped qp gives the same solution
+    ocp_qp_in *qp_in_snap = ocp_qp_in_create(qp_dims->orig_dims);
+    ocp_qp_out *qp_out_snap = ocp_qp_out_create(qp_dims->orig_dims);
+
+    ocp_qp_snapshot_map_in(snap, 0, qp_in_snap);
+    REQUIRE(ocp_qp_solve(qp_solver, qp_in_snap, qp_out_snap) == 0);
+
+    ocp_qp_out_get(qp_out_snap, "qp_info", &info);
+    REQUIRE(info->num_iter == num_iter);
+    for (int ii = 0; ii <= N; ii++)
+    {
+        for (int jj = 0; jj < qp_out->ux[ii].m; jj++)
+            REQUIRE(qp_out_snap->ux[ii].pa[jj] == qp_out->ux[ii].pa[jj]);
+    }
+
+    // the logged solution
+    ocp_qp_snapshot_get_out(snap, 1, qp_out_snap);
+
+    ocp_qp_out_get(qp_out_snap, "qp_info", &info);
+    REQUIRE(info->num_iter == num_iter);
+    for (int ii = 0; ii < N; ii++)
+    {
+        for (int jj = 0; jj < qp_out->pi[ii].m; jj++)
+            REQUIRE(qp_out_snap->pi[ii].pa[jj] == qp_out->pi[ii].pa[jj]);
+    }
+
+    ocp_qp_snapshot_close(snap);
+    remove(filename);
+
+    free(qp_out_snap);
+    free(qp_in_snap);
+    free(qp_out);
+    free(qp_in);
+    free(qp_solver);
+    free(qp_dims);
+    free(opts);
+    free(config);
+
+}  // END_TEST_CASE
+
+
+
+TEST_CASE("mass spring example soft constraints slacks", "[QP solvers]")
+{
+    int nx_ = 8;
+    int nu_ = 3;
+    int N = 15;
+    int nb_ = 11;
+    int ng_ = 0;
+    int ngN = 4;
+
+    ocp_qp_solver_plan plan;
+    plan.qp_solver = hashit("SPARSE_HPIPM");
+
+    ocp_qp_xcond_solver_config *config = ocp_qp_xcond_solver_config_create(plan);
+    ocp_qp_xcond_solver_dims *qp_dims =
+        create_ocp_qp_dims_mass_spring_soft_constr(config, N, nx_, nu_, nb_, ng_, ngN);
+    ocp_qp_dims *dims = qp_dims->orig_dims;
+
+    ocp_qp_in *qp_in = create_ocp_qp_in_mass_spring_soft_constr(dims);
+    ocp_qp_out *qp_out = ocp_qp_out_create(dims);
+
+    // arbitrary primal point, with nonzero slacks of the softened constraints
+    for (int ii = 0; ii <= N; ii++)
+    {
+        for (int jj = 0; jj < qp_out->ux[ii].m; jj++)
+            qp_out->ux[ii].pa[jj] = 0.1 * (ii + 1) - 0.05 * jj;
+    }
+
+    void *res_mem = malloc(ocp_qp_res_calculate_size(dims));
+    ocp_qp_res *qp_res = ocp_qp_res_assign(dims, res_mem);
+    void *res_ws_mem = malloc(ocp_qp_res_workspace_calculate_size(dims));
+    ocp_qp_res_ws *qp_res_ws = ocp_qp_res_workspace_assign(dims, res_ws_mem);
+
+    // the slacks t of ocp_qp_compute_t satisfy the inequality constraints of the residuals
+    // lb - sl <= C ux <= ub + su exactly
+    ocp_qp_res_compute(qp_in, qp_out, qp_res, qp_res_ws);
+
+    double res[4];
+    ocp_qp_res_compute_nrm_inf(qp_res, res);
+    REQUIRE(res[2] <= 1e-12);
+
+    free(res_ws_mem);
+    free(res_mem);
+    free(qp_out);
+    free(qp_in);
+    free(qp_dims);
+    free(config);
+
+}  // END_TEST_CASE
+
+
+
+#ifdef ACADOS_WITH_OSQP
+TEST_CASE("mass spring example soft constraints OSQP", "[QP solvers]")
+{
+    int nx_ = 8;
+    int nu_ = 3;
+    int N = 15;
+    int nb_ = 11;
+    int ng_ = 0;
+    int ngN = 4;
+
+    vector<std::string> solvers = {"SPARSE_HPIPM", "SPARSE_OSQP"};
+    vector<ocp_qp_out *> qp_out(2);
+
+    double res[4];
+    double max_res;
+
+    ocp_qp_solver_plan plan;
+    plan.qp_solver = hashit(solvers[0]);
+    ocp_qp_xcond_solver_config *config = ocp_qp_xcond_solver_config_create(plan);
+    ocp_qp_xcond_solver_dims *qp_dims =
+        create_ocp_qp_dims_mass_spring_soft_constr(config, N, nx_, nu_, nb_, ng_, ngN);
+    ocp_qp_in *qp_in = create_ocp_qp_in_mass_spring_soft_constr(qp_dims->orig_dims);
+
+    for (int ii = 0; ii < 2; ii++)
+    {
+        plan.qp_solver = hashit(solvers[ii]);
+        ocp_qp_xcond_solver_config *solver_config = ocp_qp_xcond_solver_config_create(plan);
+        ocp_qp_xcond_solver_dims *solver_dims =
+            create_ocp_qp_dims_mass_spring_soft_constr(solver_config, N, nx_, nu_, nb_, ng_, ngN);
+
+        void *opts = ocp_qp_xcond_solver_opts_create(solver_config, solver_dims);
+        set_N2(solvers[ii], solver_config, opts, N, N);
+
+        ocp_qp_solver *qp_solver = ocp_qp_create(solver_config, solver_dims, opts);
+        qp_out[ii] = ocp_qp_out_create(solver_dims->orig_dims);
+
+        REQUIRE(ocp_qp_solve(qp_solver, qp_in, qp_out[ii]) == 0);
+
+        // the stationarity residual includes the multipliers of the slack bounds
+        ocp_qp_inf_norm_residuals(solver_dims->orig_dims, qp_in, qp_out[ii], res);
+
+        max_res = 0.0;
+        for (int jj = 0; jj < 4; jj++)
+        {
+            max_res = (res[jj] > max_res) ? res[jj] : max_res;
+        }
+        std::cout << "\n---> soft constrained qp with " << solvers[ii] << ": max residual "
+                  << max_res << "\n";
+        REQUIRE(max_res <= solver_tolerance(solvers[ii]));
+
+        free(qp_solver);
+        free(opts);
+        free(solver_dims);
+        free(solver_config);
+    }
+
+    // same multipliers as HPIPM, in its convention lb - sl <= C ux <= ub + su
+    for (int ii = 0; ii <= N; ii++)
+    {
+        for (int jj = 0; jj < qp_out[0]->ux[ii].m; jj++)
+            REQUIRE(qp_out[1]->ux[ii].pa[jj] == Approx(qp_out[0]->ux[ii].pa[jj]).margin(1e-5));
+        for (int jj = 0; jj < qp_out[0]->lam[ii].m; jj++)
+            REQUIRE(qp_out[1]->lam[ii].pa[jj] == Approx(qp_out[0]->lam[ii].pa[jj]).margin(1e-5));
+    }
+
+    free(qp_out[0]);
+    free(qp_out[1]);
+    free(qp_in);
+    free(qp_dims);
+    free(config);
+
+}  // END_TEST_CASE
+#endif
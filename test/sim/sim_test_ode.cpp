@@ -69,9 +69,13 @@ using std::vector;
 sim_solver_t hashitsim(std::string const& inString)
 {
     if (inString == "ERK") return ERK;
+    if (inString == "ERK_ADAPTIVE") return ERK;
     if (inString == "IRK") return IRK;
+    if (inString == "IRK_SIMPLIFIED") return IRK;
+    if (inString == "IRK_RADAU") return IRK;
     if (inString == "GNSF") return GNSF;
     if (inString == "LIFTED_IRK") return LIFTED_IRK;
+    if (inString == "LIFTED_IRK_SIMPLIFIED") return LIFTED_IRK;
 
     return (sim_solver_t) -1;
 }
@@ -79,9 +83,13 @@ sim_solver_t hashitsim(std::string const& inString)
 double sim_solver_tolerance(std::string const& inString)
 {
     if (inString == "ERK") return 1e-7;
+    if (inString == "ERK_ADAPTIVE") return 1e-7;
     if (inString == "IRK") return 1e-7;
+    if (inString == "IRK_SIMPLIFIED") return 1e-7;
+    if (inString == "IRK_RADAU") return 1e-7;
     if (inString == "GNSF") return 1e-7;
     if (inString == "LIFTED_IRK") return 1e-5;
+    if (inString == "LIFTED_IRK_SIMPLIFIED") return 1e-5;
 
     return -1;
 }
@@ -91,7 +99,8 @@ double sim_solver_tolerance(std::string const& inString)
 
 TEST_CASE("wt_nx3_example", "[integrators]")
 {
-    vector<std::string> solvers = {"ERK", "IRK", "GNSF", "LIFTED_IRK"};
+    vector<std::string> solvers = {"ERK", "ERK_ADAPTIVE", "IRK", "IRK_SIMPLIFIED", "IRK_RADAU",
+                                   "GNSF", "LIFTED_IRK", "LIFTED_IRK_SIMPLIFIED"};
     // initialize dimensions
     int ii, jj;
 
@@ -392,11 +401,32 @@ TEST_CASE("wt_nx3_example", "[integrators]")
                     case ERK:
                          // ERK
                         opts->ns = 4;  // number of stages in rk integrator
+                        if (solver == "ERK_ADAPTIVE")
+                        {
+                            bool adaptive_step = true;
+                            double erk_tol = 1e-10;
+                            sim_opts_set(config, opts, "adaptive_step", &adaptive_step);
+                            sim_opts_set(config, opts, "abs_tol", &erk_tol);
+                            sim_opts_set(config, opts, "rel_tol", &erk_tol);
+                            opts->ns = 7;  // Dormand-Prince 5(4)
+                        }
                         break;
 
                     case IRK:
                          // IRK
                         opts->ns = 2;  // number of stages in rk integrator
+                        if (solver == "IRK_SIMPLIFIED")
+                        {
+                            bool simplified_newton = true;
+                            sim_opts_set(config, opts, "simplified_newton", &simplified_newton);
+                            opts->newton_iter = 4;
+                        }
+                        if (solver == "IRK_RADAU")
+                        {
+                            sim_collocation_type collocation_type = GAUSS_RADAU_IIA;
+                            sim_opts_set(config, opts, "collocation_type", &collocation_type);
+                            opts->ns = 3;
+                        }
                         break;
 
                     case GNSF:
@@ -416,6 +446,11 @@ TEST_CASE("wt_nx3_example", "[integrators]")
                     case LIFTED_IRK:
                         // new lifted IRK
                         opts->ns = 2;  // number of stages in rk integrator
+                        if (solver == "LIFTED_IRK_SIMPLIFIED")
+                        {
+                            bool simplified_newton = true;
+                            sim_opts_set(config, opts, "simplified_newton", &simplified_newton);
+                        }
                         break;
 
                     default :
@@ -499,6 +534,10 @@ TEST_CASE("wt_nx3_example", "[integrators]")
 
                 sim_precompute(sim_solver, in, out);
 
+                // the lifted scheme does one (simplified) Newton iteration per call, started from
+                // the stages and their sensitivities of the previous call
+                int num_calls = (solver == "LIFTED_IRK_SIMPLIFIED") ? 20 : 1;
+
                 for (ii=0; ii < nsim0; ii++)
                 {
                     // x
@@ -509,8 +548,11 @@ TEST_CASE("wt_nx3_example", "[integrators]")
                     for (jj = 0; jj < nu; jj++)
                         in->u[jj] = u_sim[ii*nu+jj];
 
-                    acados_return = sim_solve(sim_solver, in, out);
-                    REQUIRE(acados_return == 0);
+                    for (int kk = 0; kk < num_calls; kk++)
+                    {
+                        acados_return = sim_solve(sim_solver, in, out);
+                        REQUIRE(acados_return == 0);
+                    }
 
                     for (jj = 0; jj < nx; jj++){
                         x_sim[(ii+1)*nx+jj] = out->xn[jj];
@@ -576,6 +618,157 @@ TEST_CASE("wt_nx3_example", "[integrators]")
                 // REQUIRE( time_tot >= time_ad + time_la ); // failed on travis..
                 // printf("time_tot %f, time_ad %f, time_la %f", time_tot, time_ad, time_la);
 
+                // adaptive ERK: step statistics, frozen step sequence, and max_num_steps changed
+                // after the creation, bounded by the capacity of the memory
+                if (solver == "ERK_ADAPTIVE")
+                {
+                    int num_accepted, num_rejected, num_accepted_tmp, num_rejected_tmp;
+                    sim_out_get(config, dims, out, "num_steps_accepted", &num_accepted);
+                    sim_out_get(config, dims, out, "num_steps_rejected", &num_rejected);
+                    REQUIRE(num_accepted >= 1);
+                    REQUIRE(num_rejected >= 0);
+
+                    // same inputs as the last call: same steps, none rejected, same result
+                    double xn_adaptive[nx];
+                    for (jj = 0; jj < nx; jj++)
+                        xn_adaptive[jj] = out->xn[jj];
+
+                    bool freeze_steps = true;
+                    sim_opts_set(config, opts, "freeze_steps", &freeze_steps);
+                    REQUIRE(sim_solve(sim_solver, in, out) == ACADOS_SUCCESS);
+                    sim_out_get(config, dims, out, "num_steps_accepted", &num_accepted_tmp);
+                    sim_out_get(config, dims, out, "num_steps_rejected", &num_rejected_tmp);
+                    REQUIRE(num_accepted_tmp == num_accepted);
+                    REQUIRE(num_rejected_tmp == 0);
+                    for (jj = 0; jj < nx; jj++)
+                        REQUIRE(fabs(out->xn[jj] - xn_adaptive[jj]) <= 1e-12);
+
+                    freeze_steps = false;
+                    sim_opts_set(config, opts, "freeze_steps", &freeze_steps);
+
+                    // fewer steps than needed
+                    int max_num_steps = 1;
+                    sim_opts_set(config, opts, "max_num_steps", &max_num_steps);
+                    acados_return = sim_solve(sim_solver, in, out);
+                    if (num_accepted > 1)
+                        REQUIRE(acados_return == ACADOS_MAXITER);
+
+                    // more steps than the memory holds: bounded by the capacity, same solution
+                    max_num_steps = 100 * 1000;
+                    sim_opts_set(config, opts, "max_num_steps", &max_num_steps);
+                    REQUIRE(sim_solve(sim_solver, in, out) == ACADOS_SUCCESS);
+                    for (jj = 0; jj < nx; jj++)
+                        REQUIRE(fabs(out->xn[jj] - xn_adaptive[jj]) <= tol);
+
+                    max_num_steps = 1000;
+                    sim_opts_set(config, opts, "max_num_steps", &max_num_steps);
+                }
+
+                // batch simulation: M copies of the first simulation point,
+                // ERK only, the implicit integrators depend on the initial guess in memory
+                if (plan.sim_solver == ERK)
+                {
+                    const int M = 3;
+                    double x_batch[nx * M], u_batch[nu * M], xn_batch[nx * M];
+                    for (ii = 0; ii < M; ii++)
+                    {
+                        for (jj = 0; jj < nx; jj++)
+                            x_batch[ii * nx + jj] = x_sim[jj];
+                        for (jj = 0; jj < nu; jj++)
+                            u_batch[ii * nu + jj] = u_sim[jj];
+                    }
+                    decltype(sim_solver) batch_solver[1] = {sim_solver};
+                    sim_in *batch_in[1] = {in};
+                    sim_out *batch_out[1] = {out};
+                    acados_return = sim_solve_batch(batch_solver, batch_in, batch_out, 1, M,
+                                                    x_batch, u_batch, xn_batch, NULL);
+                    REQUIRE(acados_return == 0);
+                    for (ii = 0; ii < M; ii++)
+                    {
+                        for (jj = 0; jj < nx; jj++)
+                            REQUIRE(fabs(xn_batch[ii * nx + jj] - x_sim[nx + jj]) <= tol);
+                    }
+
+                    // several instances, M not a multiple of num_instances, with forward
+                    // sensitivities; reference: one by one with the solver above
+                    const int num_instances = 3;
+                    const int M_multi = 7;
+                    double x_multi[nx * M_multi], u_multi[nu * M_multi], xn_multi[nx * M_multi];
+                    double S_forw_multi[nx * NF * M_multi];
+                    double xn_multi_ref[nx * M_multi], S_forw_multi_ref[nx * NF * M_multi];
+                    for (ii = 0; ii < M_multi; ii++)
+                    {
+                        for (jj = 0; jj < nx; jj++)
+                            x_multi[ii * nx + jj] = x_sim[jj] * (1.0 + 0.01 * ii);
+                        for (jj = 0; jj < nu; jj++)
+                            u_multi[ii * nu + jj] = u_sim[jj] * (1.0 - 0.01 * ii);
+
+                        for (jj = 0; jj < nx; jj++)
+                            in->x[jj] = x_multi[ii * nx + jj];
+                        for (jj = 0; jj < nu; jj++)
+                            in->u[jj] = u_multi[ii * nu + jj];
+                        REQUIRE(sim_solve(sim_solver, in, out) == 0);
+
+                        for (jj = 0; jj < nx; jj++)
+                            xn_multi_ref[ii * nx + jj] = out->xn[jj];
+                        for (jj = 0; jj < nx * NF; jj++)
+                            S_forw_multi_ref[ii * nx * NF + jj] = out->S_forw[jj];
+                    }
+
+                    // one solver with its own model functions per instance
+                    external_function_casadi multi_ode_fun[num_instances];
+                    external_function_casadi multi_vde_for[num_instances];
+                    external_function_casadi multi_vde_adj[num_instances];
+                    decltype(sim_solver) multi_solver[num_instances];
+                    sim_in *multi_in[num_instances];
+                    sim_out *multi_out[num_instances];
+                    for (int kk = 0; kk < num_instances; kk++)
+                    {
+                        multi_ode_fun[kk] = expl_ode_fun;
+                        multi_vde_for[kk] = expl_vde_for;
+                        multi_vde_adj[kk] = expl_vde_adj;
+                        external_function_casadi_create(&multi_ode_fun[kk]);
+                        external_function_casadi_create(&multi_vde_for[kk]);
+                        external_function_casadi_create(&multi_vde_adj[kk]);
+
+                        multi_in[kk] = sim_in_create(config, dims);
+                        multi_out[kk] = sim_out_create(config, dims);
+                        multi_in[kk]->T = T;
+                        sim_in_set(config, dims, multi_in[kk], "expl_ode_fun", &multi_ode_fun[kk]);
+                        sim_in_set(config, dims, multi_in[kk], "expl_vde_for", &multi_vde_for[kk]);
+                        sim_in_set(config, dims, multi_in[kk], "expl_vde_adj", &multi_vde_adj[kk]);
+                        for (ii = 0; ii < nx * NF; ii++)
+                            multi_in[kk]->S_forw[ii] = in->S_forw[ii];
+                        for (ii = 0; ii < nx; ii++)
+                            multi_in[kk]->S_adj[ii] = in->S_adj[ii];
+
+                        multi_solver[kk] = sim_solver_create(config, dims, opts);
+                    }
+
+                    acados_return = sim_solve_batch(multi_solver, multi_in, multi_out,
+                                                    num_instances, M_multi, x_multi, u_multi,
+                                                    xn_multi, S_forw_multi);
+                    REQUIRE(acados_return == 0);
+                    for (ii = 0; ii < M_multi; ii++)
+                    {
+                        for (jj = 0; jj < nx; jj++)
+                            REQUIRE(fabs(xn_multi[ii * nx + jj] - xn_multi_ref[ii * nx + jj]) <= tol);
+                        for (jj = 0; jj < nx * NF; jj++)
+                            REQUIRE(fabs(S_forw_multi[ii * nx * NF + jj]
+                                         - S_forw_multi_ref[ii * nx * NF + jj]) <= tol);
+                    }
+
+                    for (int kk = 0; kk < num_instances; kk++)
+                    {
+                        sim_solver_destroy(multi_solver[kk]);
+                        sim_in_destroy(multi_in[kk]);
+                        sim_out_destroy(multi_out[kk]);
+                        external_function_casadi_free(&multi_ode_fun[kk]);
+                        external_function_casadi_free(&multi_vde_for[kk]);
+                        external_function_casadi_free(&multi_vde_adj[kk]);
+                    }
+                }
+
                 sim_config_destroy(config);
                 sim_dims_destroy(dims);
                 sim_opts_destroy(opts);